@@ -0,0 +1,143 @@
+/**
+ * @file flight_compression.cpp
+ * @author Ashot Vardanian
+ *
+ * @brief Measures the throughput of Arrow IPC payloads, as sent by the Flight client
+ * and server, against the compression codec and level over a bandwidth-limited link.
+ *
+ * The link is simulated with a token bucket, just like `tc qdisc ... tbf rate`:
+ * every payload costs `bytes / rate` seconds on the wire, on top of the CPU time
+ * spent serializing, compressing, decompressing and deserializing it.
+ * For end-to-end runs, the same `compression` settings can be passed in the
+ * Flight client URI, with a real `tc` rule applied to the loopback interface.
+ */
+#include <chrono> // `std::chrono::high_resolution_clock`
+#include <random> // `std::mt19937`
+#include <string> // `std::string`
+
+#include <fmt/format.h> // `fmt::format_to`
+#include <benchmark/benchmark.h>
+#include <arrow/builder.h>
+#include <arrow/io/memory.h>
+
+#include "helpers/arrow.hpp"
+
+namespace bm = benchmark;
+using namespace unum::ukv;
+using hrc_t = std::chrono::high_resolution_clock;
+
+constexpr std::size_t docs_count_k = 64 * 1024;
+constexpr std::size_t collections_count_k = 4;
+
+static std::shared_ptr<ar::RecordBatch> dataset;
+
+/**
+ * @brief Generates JSON documents with repetitive field names and
+ * low-entropy values, typical for document collections.
+ */
+std::shared_ptr<ar::RecordBatch> make_dataset() {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> age(18, 99);
+    std::uniform_int_distribution<int> city(0, 31);
+    std::uniform_int_distribution<std::size_t> collection(0, collections_count_k - 1);
+
+    ar::Int64Builder keys;
+    ar::UInt64Builder collections;
+    ar::BinaryBuilder values;
+    std::string doc;
+    for (std::size_t i = 0; i != docs_count_k; ++i) {
+        doc.clear();
+        fmt::format_to(std::back_inserter(doc),
+                       R"({{"id":{},"name":"user_{}","age":{},"city":"city_{}","verified":{},"tags":["a","b"]}})",
+                       i,
+                       i,
+                       age(rng),
+                       city(rng),
+                       i % 2 ? "true" : "false");
+        (void)keys.Append(static_cast<std::int64_t>(i));
+        (void)collections.Append(collection(rng));
+        (void)values.Append(doc);
+    }
+
+    auto schema = ar::schema({
+        ar::field(kArgCols, ar::uint64(), false),
+        ar::field(kArgKeys, ar::int64(), false),
+        ar::field(kArgVals, ar::binary()),
+    });
+    return ar::RecordBatch::Make( //
+        schema,
+        docs_count_k,
+        {collections.Finish().ValueOrDie(), keys.Finish().ValueOrDie(), values.Finish().ValueOrDie()});
+}
+
+/**
+ * @param state.range(0) Codec: 0 for none, 1 for LZ4, 2 for Zstd.
+ * @param state.range(1) Compression level.
+ * @param state.range(2) Link bandwidth in MBit/s.
+ * @param state.range(3) Whether to dictionary-encode the collections and keys.
+ */
+static void transfer(bm::State& state) {
+
+    arrow_compression_t compression;
+    compression.codec = state.range(0) == 0   ? ar::Compression::UNCOMPRESSED
+                        : state.range(0) == 1 ? ar::Compression::LZ4_FRAME
+                                              : ar::Compression::ZSTD;
+    compression.level = static_cast<int>(state.range(1));
+    double const link_bytes_per_second = state.range(2) * 1e6 / 8;
+    bool const dictionaries = state.range(3);
+
+    std::size_t raw_bytes = 0;
+    std::size_t wire_bytes = 0;
+    for (auto _ : state) {
+        auto start = hrc_t::now();
+
+        std::shared_ptr<ar::RecordBatch> batch = dataset;
+        if (dictionaries)
+            batch = encode_dictionaries(batch, {kArgCols, kArgKeys}).ValueOrDie();
+
+        ar::ipc::IpcWriteOptions options = ar::ipc::IpcWriteOptions::Defaults();
+        compress_if_worth(options, compression, *batch).Abort();
+        auto sink = ar::io::BufferOutputStream::Create().ValueOrDie();
+        auto writer = ar::ipc::MakeStreamWriter(sink, batch->schema(), options).ValueOrDie();
+        writer->WriteRecordBatch(*batch).Abort();
+        writer->Close().Abort();
+        std::shared_ptr<ar::Buffer> payload = sink->Finish().ValueOrDie();
+
+        auto source = std::make_shared<ar::io::BufferReader>(payload);
+        auto reader = ar::ipc::RecordBatchStreamReader::Open(source).ValueOrDie();
+        auto received = decode_dictionaries(reader->ToTable().ValueOrDie()).ValueOrDie();
+        bm::DoNotOptimize(received);
+
+        auto cpu_seconds = std::chrono::duration<double>(hrc_t::now() - start).count();
+        auto wire_seconds = payload->size() / link_bytes_per_second;
+        state.SetIterationTime(cpu_seconds + wire_seconds);
+
+        raw_bytes += ar::util::TotalBufferSize(*dataset);
+        wire_bytes += payload->size();
+    }
+
+    state.counters["bytes/s"] = bm::Counter(raw_bytes, bm::Counter::kIsRate);
+    state.counters["docs/s"] = bm::Counter(state.iterations() * docs_count_k, bm::Counter::kIsRate);
+    state.counters["ratio"] = bm::Counter(double(raw_bytes) / std::max<std::size_t>(wire_bytes, 1));
+}
+
+static void compression_levels(bm::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"codec", "level", "mbit/s", "dict"});
+    for (std::int64_t bandwidth : {100, 1'000, 10'000}) {
+        benchmark->Args({0, 0, bandwidth, 0});
+        benchmark->Args({0, 0, bandwidth, 1});
+        benchmark->Args({1, 1, bandwidth, 0});
+        for (std::int64_t level : {1, 3, 6, 9, 15})
+            benchmark->Args({2, level, bandwidth, 1});
+    }
+}
+
+BENCHMARK(transfer)->Apply(compression_levels)->UseManualTime()->Unit(bm::kMillisecond);
+
+int main(int argc, char** argv) {
+    bm::Initialize(&argc, argv);
+    dataset = make_dataset();
+    bm::RunSpecifiedBenchmarks();
+    bm::Shutdown();
+    return 0;
+}
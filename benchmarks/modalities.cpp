@@ -0,0 +1,563 @@
+/**
+ * @file modalities.cpp
+ * @author Ashot Vardanian
+ *
+ * @brief Benchmarks of Vectors, Paths and Docs modalities on generated data,
+ * built against every engine, so no external datasets are needed.
+ *
+ * - "vectors": Approximate Nearest Neighbors search over Gaussian-mixture
+ *   embeddings of different dimensionality. Reports "queries/s" and the
+ *   "recall" against exact top-K by cosine similarity, forming a recall/QPS curve.
+ * - "paths": Prefix and RegEx matching over a generated tree of file paths.
+ *   Reports "patterns/s" and "matches/s".
+ * - "docs_gather": Columnar `ukv_docs_gather` from nested JSON documents with
+ *   a varying number of fields. Reports "docs/s" and "cells/s".
+ *
+ * Results are written in JSON to "modalities.json", unless another destination
+ * is passed with "--benchmark_out=", to be compared between revisions.
+ *
+ * Options, passed after the Google Benchmark ones:
+ * - "--modalities_vectors=": Number of vectors, 10'000 by default.
+ * - "--modalities_dimensions=": Comma-separated list, "32,128,768" by default.
+ * - "--modalities_files=": Number of file paths, 100'000 by default.
+ * - "--modalities_docs=": Number of documents, 100'000 by default.
+ * - "--modalities_fields=": Comma-separated list, "4,16,64" by default.
+ * - "--modalities_path=": Directory for persistent engines or the URI of the Flight server.
+ */
+#include <cmath>         // `std::sqrt`
+#include <random>        // `std::mt19937_64`
+#include <string>        // `std::string`
+#include <string_view>   // `std::string_view`
+#include <vector>        // `std::vector`
+#include <numeric>       // `std::iota`
+#include <algorithm>     // `std::partial_sort`
+#include <filesystem>    // `std::filesystem::create_directories`
+#include <unordered_set> // `std::unordered_set`
+
+#include <benchmark/benchmark.h>
+
+#include <ukv/ukv.hpp>
+
+namespace bm = benchmark;
+using namespace unum::ukv;
+
+constexpr std::size_t load_batch_size_k = 1024;
+constexpr std::size_t vectors_queries_k = 64;
+constexpr std::size_t vectors_clusters_k = 64;
+constexpr ukv_length_t vectors_max_limit_k = 100;
+constexpr ukv_size_t docs_batch_size_k = 256;
+
+struct modalities_config_t {
+    std::size_t vectors = 10'000;
+    std::vector<std::int64_t> dimensions = {32, 128, 768};
+    std::size_t files = 100'000;
+    std::size_t docs = 100'000;
+    std::vector<std::int64_t> fields = {4, 16, 64};
+    std::string path;
+};
+
+static modalities_config_t config;
+static database_t db;
+
+/// Name of the dataset currently loaded into the main collection.
+static std::string loaded_dataset;
+
+/**
+ * @brief Replaces the contents of the DB with a generated dataset, unless it is already there.
+ * Google Benchmark calls every function multiple times, but loading happens once per dataset.
+ */
+template <typename loader_at>
+static void prepare(std::string const& name, loader_at&& loader) {
+    if (loaded_dataset == name)
+        return;
+    db.clear().throw_unhandled();
+    loaded_dataset.clear();
+    loader();
+    loaded_dataset = name;
+}
+
+/*********************************************************/
+/*****************	       Vectors  	  ****************/
+/*********************************************************/
+
+/**
+ * @brief Points sampled around random cluster centers, scaled into `[-1, 1]`,
+ * so that quantization into 8-bit integers keeps as much precision as possible.
+ */
+struct embeddings_t {
+    std::size_t dimensions = 0;
+    std::vector<float> vectors;
+    std::vector<float> queries;
+    /// Exact top `vectors_max_limit_k` keys for every query, best first.
+    std::vector<ukv_key_t> truth;
+
+    float const* vector(std::size_t i) const noexcept { return vectors.data() + i * dimensions; }
+    float const* query(std::size_t i) const noexcept { return queries.data() + i * dimensions; }
+    /// Keys must be positive, as their negations are used for quantized copies.
+    static ukv_key_t key(std::size_t i) noexcept { return static_cast<ukv_key_t>(i + 1); }
+};
+
+static embeddings_t embeddings;
+
+static void sample_gaussian_mixture(std::vector<float> const& centers,
+                                    std::size_t dimensions,
+                                    std::size_t count,
+                                    std::mt19937_64& random,
+                                    std::vector<float>& points) {
+    std::normal_distribution<float> noise(0, 0.5f);
+    std::uniform_int_distribution<std::size_t> cluster(0, vectors_clusters_k - 1);
+    points.resize(count * dimensions);
+    for (std::size_t i = 0; i != count; ++i) {
+        float const* center = centers.data() + cluster(random) * dimensions;
+        float* point = points.data() + i * dimensions;
+        float max_abs = 0;
+        for (std::size_t d = 0; d != dimensions; ++d)
+            point[d] = center[d] + noise(random), max_abs = std::max(max_abs, std::abs(point[d]));
+        for (std::size_t d = 0; d != dimensions; ++d)
+            point[d] /= max_abs;
+    }
+}
+
+static float cosine(float const* a, float const* b, std::size_t dimensions) noexcept {
+    float ab = 0, aa = 0, bb = 0;
+    for (std::size_t d = 0; d != dimensions; ++d)
+        ab += a[d] * b[d], aa += a[d] * a[d], bb += b[d] * b[d];
+    return ab / (std::sqrt(aa) * std::sqrt(bb));
+}
+
+static void load_vectors(std::size_t dimensions) {
+    embeddings.dimensions = dimensions;
+    std::mt19937_64 random(dimensions);
+    std::normal_distribution<float> coordinate(0, 1);
+    std::vector<float> centers(vectors_clusters_k * dimensions);
+    for (float& c : centers)
+        c = coordinate(random);
+    sample_gaussian_mixture(centers, dimensions, config.vectors, random, embeddings.vectors);
+    sample_gaussian_mixture(centers, dimensions, vectors_queries_k, random, embeddings.queries);
+
+    // Brute-force the ground truth
+    std::size_t const limit = std::min<std::size_t>(vectors_max_limit_k, config.vectors);
+    std::vector<std::size_t> order(config.vectors);
+    std::vector<float> similarities(config.vectors);
+    embeddings.truth.resize(vectors_queries_k * vectors_max_limit_k);
+    for (std::size_t q = 0; q != vectors_queries_k; ++q) {
+        for (std::size_t i = 0; i != config.vectors; ++i)
+            similarities[i] = cosine(embeddings.query(q), embeddings.vector(i), dimensions);
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(order.begin(), order.begin() + limit, order.end(), [&](std::size_t a, std::size_t b) {
+            return similarities[a] > similarities[b];
+        });
+        for (std::size_t j = 0; j != limit; ++j)
+            embeddings.truth[q * vectors_max_limit_k + j] = embeddings_t::key(order[j]);
+    }
+
+    status_t status;
+    arena_t arena(db);
+    std::vector<ukv_key_t> keys(load_batch_size_k);
+    for (std::size_t first = 0; first < config.vectors; first += load_batch_size_k) {
+        std::size_t count = std::min(load_batch_size_k, config.vectors - first);
+        for (std::size_t i = 0; i != count; ++i)
+            keys[i] = embeddings_t::key(first + i);
+        auto vectors_begin = reinterpret_cast<ukv_bytes_cptr_t>(embeddings.vector(first));
+
+        ukv_vectors_write_t write {};
+        write.db = db;
+        write.error = status.member_ptr();
+        write.arena = arena.member_ptr();
+        write.tasks_count = static_cast<ukv_size_t>(count);
+        write.dimensions = static_cast<ukv_length_t>(dimensions);
+        write.scalar_type = ukv_vector_scalar_f32_k;
+        write.keys = keys.data();
+        write.keys_stride = sizeof(ukv_key_t);
+        write.vectors_starts = &vectors_begin;
+        write.vectors_stride = static_cast<ukv_size_t>(dimensions * sizeof(float));
+        ukv_vectors_write(&write);
+        status.throw_unhandled();
+    }
+}
+
+/**
+ * @param state.range(0) Number of dimensions in every vector.
+ * @param state.range(1) Number of neighbors to retrieve for every query.
+ */
+static void vectors(bm::State& state) {
+
+    auto const dimensions = static_cast<std::size_t>(state.range(0));
+    auto const limit = static_cast<ukv_length_t>(state.range(1));
+    prepare("vectors/" + std::to_string(dimensions), [=] { load_vectors(dimensions); });
+
+    status_t status;
+    arena_t arena(db);
+    auto queries_begin = reinterpret_cast<ukv_bytes_cptr_t>(embeddings.queries.data());
+    ukv_length_t* found_counts = nullptr;
+    ukv_length_t* found_offsets = nullptr;
+    ukv_key_t* found_keys = nullptr;
+
+    ukv_vectors_search_t search {};
+    search.db = db;
+    search.error = status.member_ptr();
+    search.arena = arena.member_ptr();
+    search.tasks_count = vectors_queries_k;
+    search.dimensions = static_cast<ukv_length_t>(dimensions);
+    search.scalar_type = ukv_vector_scalar_f32_k;
+    search.metric = ukv_vector_metric_cos_k;
+    search.metric_threshold = -1;
+    search.match_counts_limits = &limit;
+    search.queries_starts = &queries_begin;
+    search.queries_stride = static_cast<ukv_size_t>(dimensions * sizeof(float));
+    search.match_counts = &found_counts;
+    search.match_offsets = &found_offsets;
+    search.match_keys = &found_keys;
+
+    for (auto _ : state) {
+        ukv_vectors_search(&search);
+        status.throw_unhandled();
+    }
+
+    // Share of the exact top-K neighbors found by the last search
+    std::size_t const expected = std::min<std::size_t>(limit, config.vectors);
+    std::size_t hits = 0;
+    for (std::size_t q = 0; q != vectors_queries_k; ++q) {
+        auto truth_begin = embeddings.truth.begin() + q * vectors_max_limit_k;
+        std::unordered_set<ukv_key_t> truth(truth_begin, truth_begin + expected);
+        for (std::size_t j = 0; j != found_counts[q]; ++j)
+            hits += truth.count(found_keys[found_offsets[q] + j]);
+    }
+    state.counters["recall"] = static_cast<double>(hits) / (expected * vectors_queries_k);
+    state.counters["queries/s"] = bm::Counter(state.iterations() * vectors_queries_k, bm::Counter::kIsRate);
+}
+
+/*********************************************************/
+/*****************	        Paths   	  ****************/
+/*********************************************************/
+
+enum class pattern_kind_t : std::int64_t { prefix_k = 0, regex_k = 1 };
+
+/**
+ * @brief Prefixes of different selectivity. None of them contains RegEx
+ * special characters, so they are matched as plain prefixes.
+ */
+static ukv_str_view_t const prefixes_k[] = {
+    "/home/",
+    "/home/user7/",
+    "/home/user7/project3/",
+    "/home/user7/project3/src/module11/",
+    "/var/log/",
+    "/var/log/service5/",
+    "/home/user42/project0/docs/",
+    "/nonexistent/",
+};
+
+static ukv_str_view_t const regexes_k[] = {
+    "^/home/user[0-9]/.*\\.py$",
+    "^/home/user7/project[0-9]+/src/module1[0-9]/",
+    ".*/file[0-9]*7\\.cpp$",
+    "^/var/log/service[0-9]+/.*\\.log$",
+    "module(3|5|7)/file",
+    "^/home/[a-z]+4[0-9]/project1/",
+    "\\.(md|json)$",
+    "^/nonexistent/.*",
+};
+
+constexpr std::size_t patterns_count_k = sizeof(prefixes_k) / sizeof(prefixes_k[0]);
+
+static std::string generate_path(std::size_t index, std::mt19937_64& random) {
+    static char const* extensions[] = {"cpp", "hpp", "py", "md", "json"};
+    std::uniform_int_distribution<int> user(0, 63), project(0, 15), module(0, 31), service(0, 15), kind(0, 9);
+    std::string path;
+    if (kind(random) == 0)
+        path = "/var/log/service" + std::to_string(service(random)) + "/" + std::to_string(index) + ".log";
+    else
+        path = "/home/user" + std::to_string(user(random)) + "/project" + std::to_string(project(random)) +
+               (kind(random) < 2 ? "/docs/" : "/src/module" + std::to_string(module(random)) + "/") + "file" +
+               std::to_string(index) + "." + extensions[index % 5];
+    return path;
+}
+
+static void load_paths() {
+    std::mt19937_64 random(42);
+    status_t status;
+    arena_t arena(db);
+    std::vector<std::string> paths(load_batch_size_k);
+    std::vector<ukv_str_view_t> paths_begins(load_batch_size_k);
+    for (std::size_t first = 0; first < config.files; first += load_batch_size_k) {
+        std::size_t count = std::min(load_batch_size_k, config.files - first);
+        for (std::size_t i = 0; i != count; ++i)
+            paths[i] = generate_path(first + i, random), paths_begins[i] = paths[i].c_str();
+
+        // Every path maps to itself, like a file storing its own name
+        ukv_paths_write_t write {};
+        write.db = db;
+        write.error = status.member_ptr();
+        write.arena = arena.member_ptr();
+        write.tasks_count = static_cast<ukv_size_t>(count);
+        write.paths = paths_begins.data();
+        write.paths_stride = sizeof(ukv_str_view_t);
+        write.values_bytes = reinterpret_cast<ukv_bytes_cptr_t const*>(paths_begins.data());
+        write.values_bytes_stride = sizeof(ukv_str_view_t);
+        ukv_paths_write(&write);
+        status.throw_unhandled();
+    }
+}
+
+/**
+ * @param state.range(0) Kind of patterns, a `pattern_kind_t`.
+ * @param state.range(1) Maximum number of matches for every pattern.
+ */
+static void paths(bm::State& state) {
+
+    auto const kind = static_cast<pattern_kind_t>(state.range(0));
+    auto const limit = static_cast<ukv_length_t>(state.range(1));
+    prepare("paths", &load_paths);
+
+    status_t status;
+    arena_t arena(db);
+    ukv_length_t* found_counts = nullptr;
+    ukv_length_t* found_offsets = nullptr;
+    ukv_char_t* found_strings = nullptr;
+
+    ukv_paths_match_t match {};
+    match.db = db;
+    match.error = status.member_ptr();
+    match.arena = arena.member_ptr();
+    match.tasks_count = patterns_count_k;
+    match.match_counts_limits = &limit;
+    match.patterns = kind == pattern_kind_t::prefix_k ? prefixes_k : regexes_k;
+    match.patterns_stride = sizeof(ukv_str_view_t);
+    match.match_counts = &found_counts;
+    match.paths_offsets = &found_offsets;
+    match.paths_strings = &found_strings;
+
+    std::size_t matches = 0;
+    for (auto _ : state) {
+        ukv_paths_match(&match);
+        status.throw_unhandled();
+        for (std::size_t i = 0; i != patterns_count_k; ++i)
+            matches += found_counts[i];
+    }
+
+    state.counters["patterns/s"] = bm::Counter(state.iterations() * patterns_count_k, bm::Counter::kIsRate);
+    state.counters["matches/s"] = bm::Counter(matches, bm::Counter::kIsRate);
+}
+
+/*********************************************************/
+/*****************	      Documents 	  ****************/
+/*********************************************************/
+
+/**
+ * @brief Fields are spread across three levels of nesting and four types.
+ */
+struct doc_fields_t {
+    std::vector<std::string> paths;
+    std::vector<ukv_str_view_t> paths_begins;
+    std::vector<ukv_doc_field_type_t> types;
+
+    explicit doc_fields_t(std::size_t count) : paths(count), paths_begins(count), types(count) {
+        static char const* parents[] = {"/", "/nested/", "/nested/deeper/"};
+        static ukv_doc_field_type_t const kinds[] = {
+            ukv_doc_field_i64_k,
+            ukv_doc_field_f64_k,
+            ukv_doc_field_str_k,
+            ukv_doc_field_bool_k,
+        };
+        for (std::size_t i = 0; i != count; ++i) {
+            paths[i] = parents[i % 3] + ("f" + std::to_string(i));
+            paths_begins[i] = paths[i].c_str();
+            types[i] = kinds[i % 4];
+        }
+    }
+};
+
+static std::string generate_doc(std::size_t index, std::size_t fields_count, std::mt19937_64& random) {
+    std::string levels[3];
+    for (std::size_t i = 0; i != fields_count; ++i) {
+        std::string& level = levels[i % 3];
+        level += level.empty() ? "" : ",";
+        level += "\"f" + std::to_string(i) + "\":";
+        switch (i % 4) {
+        case 0: level += std::to_string(random() % 1'000'000); break;
+        case 1: level += std::to_string(static_cast<double>(random() % 1'000'000) / 1000); break;
+        case 2: level += "\"text" + std::to_string(random() % 1'000'000) + "\""; break;
+        case 3: level += random() % 2 ? "true" : "false"; break;
+        }
+    }
+    std::string deeper = "{" + levels[2] + "}";
+    std::string nested = "{" + levels[1] + (levels[1].empty() ? "" : ",") + "\"deeper\":" + deeper + "}";
+    return "{\"id\":" + std::to_string(index) + (levels[0].empty() ? "" : ",") + levels[0] + ",\"nested\":" + nested +
+           "}";
+}
+
+static void load_docs(std::size_t fields_count) {
+    std::mt19937_64 random(fields_count);
+    status_t status;
+    arena_t arena(db);
+    std::vector<ukv_key_t> keys(load_batch_size_k);
+    std::vector<std::string> docs(load_batch_size_k);
+    std::vector<value_view_t> docs_views(load_batch_size_k);
+    for (std::size_t first = 0; first < config.docs; first += load_batch_size_k) {
+        std::size_t count = std::min(load_batch_size_k, config.docs - first);
+        for (std::size_t i = 0; i != count; ++i) {
+            keys[i] = static_cast<ukv_key_t>(first + i);
+            docs[i] = generate_doc(first + i, fields_count, random);
+            docs_views[i] = value_view_t {docs[i]};
+        }
+
+        ukv_docs_write_t write {};
+        write.db = db;
+        write.error = status.member_ptr();
+        write.arena = arena.member_ptr();
+        write.tasks_count = static_cast<ukv_size_t>(count);
+        write.type = ukv_doc_field_json_k;
+        write.modification = ukv_doc_modify_upsert_k;
+        write.keys = keys.data();
+        write.keys_stride = sizeof(ukv_key_t);
+        write.lengths = docs_views.front().member_length();
+        write.lengths_stride = sizeof(value_view_t);
+        write.values = docs_views.front().member_ptr();
+        write.values_stride = sizeof(value_view_t);
+        ukv_docs_write(&write);
+        status.throw_unhandled();
+    }
+}
+
+/**
+ * @param state.range(0) Number of fields in every document, all of which are gathered.
+ */
+static void docs_gather(bm::State& state) {
+
+    auto const fields_count = static_cast<std::size_t>(state.range(0));
+    prepare("docs/" + std::to_string(fields_count), [=] { load_docs(fields_count); });
+
+    status_t status;
+    arena_t arena(db);
+    doc_fields_t fields(fields_count);
+    std::vector<ukv_key_t> keys(docs_batch_size_k);
+    std::mt19937_64 random(fields_count);
+    std::uniform_int_distribution<std::size_t> choose(0, config.docs - 1);
+    ukv_octet_t** validities = nullptr;
+    ukv_byte_t** scalars = nullptr;
+    ukv_length_t** offsets = nullptr;
+    ukv_length_t** lengths = nullptr;
+    ukv_byte_t* strings = nullptr;
+
+    ukv_docs_gather_t gather {};
+    gather.db = db;
+    gather.error = status.member_ptr();
+    gather.arena = arena.member_ptr();
+    gather.docs_count = docs_batch_size_k;
+    gather.fields_count = static_cast<ukv_size_t>(fields_count);
+    gather.keys = keys.data();
+    gather.keys_stride = sizeof(ukv_key_t);
+    gather.fields = fields.paths_begins.data();
+    gather.fields_stride = sizeof(ukv_str_view_t);
+    gather.types = fields.types.data();
+    gather.types_stride = sizeof(ukv_doc_field_type_t);
+    gather.columns_validities = &validities;
+    gather.columns_scalars = &scalars;
+    gather.columns_offsets = &offsets;
+    gather.columns_lengths = &lengths;
+    gather.joined_strings = &strings;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (ukv_key_t& key : keys)
+            key = static_cast<ukv_key_t>(choose(random));
+        state.ResumeTiming();
+
+        ukv_docs_gather(&gather);
+        status.throw_unhandled();
+    }
+
+    state.counters["docs/s"] = bm::Counter(state.iterations() * docs_batch_size_k, bm::Counter::kIsRate);
+    state.counters["cells/s"] =
+        bm::Counter(state.iterations() * docs_batch_size_k * fields_count, bm::Counter::kIsRate);
+}
+
+/*********************************************************/
+/*****************	       Driver   	  ****************/
+/*********************************************************/
+
+template <typename number_at>
+static std::vector<number_at> parse_list(std::string_view list) {
+    std::vector<number_at> numbers;
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        numbers.push_back(static_cast<number_at>(std::stoll(std::string(list.substr(0, comma)))));
+        list = comma == std::string_view::npos ? std::string_view {} : list.substr(comma + 1);
+    }
+    return numbers;
+}
+
+static void parse_config(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value_of = [&](std::string_view name) {
+            return arg.substr(0, name.size()) == name ? arg.substr(name.size()) : std::string_view {};
+        };
+        if (auto value = value_of("--modalities_vectors="); !value.empty())
+            config.vectors = std::stoull(std::string(value));
+        else if (auto value = value_of("--modalities_dimensions="); !value.empty())
+            config.dimensions = parse_list<std::int64_t>(value);
+        else if (auto value = value_of("--modalities_files="); !value.empty())
+            config.files = std::stoull(std::string(value));
+        else if (auto value = value_of("--modalities_docs="); !value.empty())
+            config.docs = std::stoull(std::string(value));
+        else if (auto value = value_of("--modalities_fields="); !value.empty())
+            config.fields = parse_list<std::int64_t>(value);
+        else if (auto value = value_of("--modalities_path="); !value.empty())
+            config.path = value;
+    }
+#if defined(UKV_DEBUG)
+    config.vectors = std::min<std::size_t>(config.vectors, 1'000);
+    config.files = std::min<std::size_t>(config.files, 10'000);
+    config.docs = std::min<std::size_t>(config.docs, 10'000);
+#endif
+}
+
+int main(int argc, char** argv) {
+
+    // Unless told otherwise, keep a machine-readable copy of the results
+    std::vector<char*> args(argv, argv + argc);
+    bool has_out = std::any_of(args.begin(), args.end(), [](char const* arg) {
+        return std::string_view(arg).substr(0, 16) == "--benchmark_out=";
+    });
+    char default_out[] = "--benchmark_out=modalities.json";
+    char default_out_format[] = "--benchmark_out_format=json";
+    if (!has_out)
+        args.push_back(default_out), args.push_back(default_out_format);
+    int args_count = static_cast<int>(args.size());
+
+    bm::Initialize(&args_count, args.data());
+    parse_config(args_count, args.data());
+
+#if defined(UKV_ENGINE_IS_LEVELDB) || defined(UKV_ENGINE_IS_ROCKSDB) || defined(UKV_ENGINE_IS_UDISK)
+    if (config.path.empty())
+        config.path = "./tmp/modalities/";
+    std::filesystem::create_directories(config.path);
+#endif
+    db.open(config.path.empty() ? nullptr : config.path.c_str()).throw_unhandled();
+
+    // Benchmarks sharing a dataset are registered together, to load it once
+    auto vectors_benchmark = bm::RegisterBenchmark("vectors", &vectors);
+    vectors_benchmark->ArgNames({"dims", "top"})->Unit(bm::kMillisecond)->UseRealTime();
+    for (std::int64_t dimensions : config.dimensions)
+        for (std::int64_t limit : {1, 10, 100})
+            vectors_benchmark->Args({dimensions, limit});
+
+    auto paths_benchmark = bm::RegisterBenchmark("paths", &paths);
+    paths_benchmark->ArgNames({"regex", "limit"})->Unit(bm::kMillisecond)->UseRealTime();
+    for (auto kind : {pattern_kind_t::prefix_k, pattern_kind_t::regex_k})
+        for (std::int64_t limit : {16, 1024})
+            paths_benchmark->Args({static_cast<std::int64_t>(kind), limit});
+
+    auto docs_benchmark = bm::RegisterBenchmark("docs_gather", &docs_gather);
+    docs_benchmark->ArgNames({"fields"})->Unit(bm::kMicrosecond)->UseRealTime();
+    for (std::int64_t fields : config.fields)
+        docs_benchmark->Arg(fields);
+
+    bm::RunSpecifiedBenchmarks();
+    bm::Shutdown();
+
+    db.clear().throw_unhandled();
+    return 0;
+}
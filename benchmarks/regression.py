@@ -0,0 +1,234 @@
+# @file regression.py
+# @brief Detects performance regressions of native benchmarks against stored baselines.
+#
+# Runs the YCSB and Modalities suites of one engine with a fixed set of
+# arguments and seeds, repeating every benchmark multiple times. The wall-time
+# samples of every benchmark are compared to the ones in the baseline with a
+# one-sided Mann-Whitney U test. A benchmark is reported as regressed, if it
+# is slower with statistical significance AND its median slowed down by more
+# than the threshold. Accuracy counters, like the "recall" of vector search,
+# are compared by their medians.
+#
+# Exit codes:
+# > 0: no significant regressions, or a new baseline was recorded.
+# > 1: at least one benchmark regressed.
+# > 2: missing benchmark binaries or an outdated baseline format.
+#
+# If there is no baseline for the engine yet, the run is recorded as one,
+# to be committed into "benchmarks/baselines/", instead of failing.
+#
+# Usage:
+#   python benchmarks/regression.py --engine ukv_embedded_umem            # compare
+#   python benchmarks/regression.py --engine ukv_embedded_umem --update   # record new baseline
+#
+# Only the Python standard library is used, so it can run on any Linux box.
+
+import os
+import sys
+import json
+import math
+import socket
+import argparse
+import tempfile
+import subprocess
+import statistics
+
+FORMAT_VERSION = 1
+REPO_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BASELINES_DIR = os.path.join(REPO_DIR, 'benchmarks', 'baselines')
+
+# Small datasets, so that the whole run takes minutes, not hours.
+# The generators inside the binaries are seeded with constants.
+SUITES = {
+    'ycsb': [
+        '--ycsb_records=100000',
+        '--ycsb_batch_sizes=1,256',
+        '--ycsb_threads=1',
+        '--ycsb_seconds=0.5',
+    ],
+    'modalities': [
+        '--modalities_vectors=5000',
+        '--modalities_dimensions=32,256',
+        '--modalities_files=20000',
+        '--modalities_docs=20000',
+        '--modalities_fields=4,32',
+    ],
+}
+
+# Counters, where higher is better and which don't depend on the hardware.
+ACCURACY_COUNTERS = ['recall']
+
+
+def run_suite(binary: str, args: list, repetitions: int) -> dict:
+    """Runs a Google Benchmark binary and groups its repeated samples by benchmark name."""
+    with tempfile.TemporaryDirectory() as directory:
+        output_path = os.path.join(directory, 'output.json')
+        command = [
+            binary,
+            f'--benchmark_repetitions={repetitions}',
+            '--benchmark_report_aggregates_only=false',
+            f'--benchmark_out={output_path}',
+            '--benchmark_out_format=json',
+            *args,
+        ]
+        print('Running:', ' '.join(command), flush=True)
+        subprocess.run(command, check=True, cwd=directory, stdout=subprocess.DEVNULL)
+        with open(output_path) as file:
+            output = json.load(file)
+
+    results = {}
+    for run in output['benchmarks']:
+        if run.get('run_type', 'iteration') != 'iteration':
+            continue
+        result = results.setdefault(run.get('run_name', run['name']), {
+            'time_unit': run.get('time_unit', 'ns'),
+            'real_time': [],
+            'counters': {},
+        })
+        result['real_time'].append(run['real_time'])
+        for counter in ACCURACY_COUNTERS:
+            if counter in run:
+                result['counters'].setdefault(counter, []).append(run[counter])
+    return {'context': output.get('context', {}), 'benchmarks': results}
+
+
+def mann_whitney_greater(current: list, baseline: list) -> float:
+    """
+    One-sided p-value of `current` being stochastically greater than `baseline`,
+    using the normal approximation with the correction for ties.
+    """
+    n1, n2 = len(current), len(baseline)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+    merged = sorted([(x, 0) for x in current] + [(x, 1) for x in baseline])
+
+    # Assign average ranks to ties
+    ranks = [0.0] * len(merged)
+    ties_correction = 0.0
+    i = 0
+    while i != len(merged):
+        j = i
+        while j + 1 != len(merged) and merged[j + 1][0] == merged[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        ties = j - i + 1
+        ties_correction += ties ** 3 - ties
+        i = j + 1
+
+    rank_sum = sum(rank for rank, (_, group) in zip(ranks, merged) if group == 0)
+    u = rank_sum - n1 * (n1 + 1) / 2
+    n = n1 + n2
+    mean = n1 * n2 / 2
+    variance = n1 * n2 / 12 * ((n + 1) - ties_correction / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (u - mean - 0.5) / math.sqrt(variance)
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def compare(baseline: dict, current: dict, alpha: float, threshold: float) -> list:
+    """Returns the list of regressions, printing a report for every benchmark."""
+    regressions = []
+    for suite, results in current['suites'].items():
+        old_results = baseline['suites'].get(suite, {}).get('benchmarks', {})
+        for name, result in results['benchmarks'].items():
+            old = old_results.get(name)
+            if old is None:
+                print(f'  new     {name}')
+                continue
+
+            old_median = statistics.median(old['real_time'])
+            new_median = statistics.median(result['real_time'])
+            ratio = new_median / old_median if old_median else 1.0
+            p_value = mann_whitney_greater(result['real_time'], old['real_time'])
+            slower = p_value < alpha and ratio > 1 + threshold
+            faster = mann_whitney_greater(old['real_time'], result['real_time']) < alpha and ratio < 1 - threshold
+            status = 'SLOWER' if slower else 'faster' if faster else 'same'
+            print(f'  {status:7} {name}: {old_median:.4g} -> {new_median:.4g} {result["time_unit"]}'
+                  f' ({ratio - 1:+.1%}, p={p_value:.3g})')
+            if slower:
+                regressions.append(name)
+
+            for counter, samples in result['counters'].items():
+                old_samples = old['counters'].get(counter)
+                if not old_samples:
+                    continue
+                old_value, new_value = statistics.median(old_samples), statistics.median(samples)
+                if new_value < old_value - threshold * abs(old_value):
+                    print(f'  WORSE   {name}: {counter} {old_value:.4g} -> {new_value:.4g}')
+                    regressions.append(f'{name}/{counter}')
+
+    return regressions
+
+
+def git_commit() -> str:
+    try:
+        return subprocess.run(['git', 'rev-parse', 'HEAD'], cwd=REPO_DIR,
+                              capture_output=True, text=True, check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return ''
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Compares native benchmarks to a stored baseline')
+    parser.add_argument('--engine', default='ukv_embedded_umem', help='Client library, like "ukv_embedded_rocksdb"')
+    parser.add_argument('--bin-dir', default=os.path.join(REPO_DIR, 'build', 'bin'), help='Directory with binaries')
+    parser.add_argument('--baseline', help='Baseline path, "benchmarks/baselines/<engine>.json" by default')
+    parser.add_argument('--suites', default=','.join(SUITES), help='Comma-separated subset of suites')
+    parser.add_argument('--repetitions', type=int, default=10, help='Samples per benchmark')
+    parser.add_argument('--alpha', type=float, default=0.01, help='Significance level of the test')
+    parser.add_argument('--threshold', type=float, default=0.05, help='Tolerated relative slowdown')
+    parser.add_argument('--update', action='store_true', help='Overwrite the baseline with this run')
+    args = parser.parse_args()
+
+    baseline_path = args.baseline or os.path.join(BASELINES_DIR, f'{args.engine}.json')
+    record = args.update or not os.path.exists(baseline_path)
+    if record and not args.update:
+        print(f'No baseline at {baseline_path} yet, this run will be recorded as one')
+
+    with open(os.path.join(REPO_DIR, 'VERSION')) as file:
+        version = file.read().strip()
+    current = {
+        'format': FORMAT_VERSION,
+        'version': version,
+        'commit': git_commit(),
+        'engine': args.engine,
+        'host': socket.gethostname(),
+        'repetitions': args.repetitions,
+        'suites': {},
+    }
+    for suite in args.suites.split(','):
+        binary = os.path.join(args.bin_dir, f'bench_{suite}_{args.engine}')
+        if not os.path.exists(binary):
+            print(f'Missing {binary}, build it with -DUKV_BUILD_BENCHMARKS=1', file=sys.stderr)
+            return 2
+        current['suites'][suite] = run_suite(binary, SUITES[suite], args.repetitions)
+
+    if record:
+        os.makedirs(os.path.dirname(baseline_path), exist_ok=True)
+        with open(baseline_path, 'w') as file:
+            json.dump(current, file, indent=2, sort_keys=True)
+            file.write('\n')
+        print(f'Saved baseline of version {version} into {baseline_path}, commit it to track regressions')
+        return 0
+
+    with open(baseline_path) as file:
+        baseline = json.load(file)
+    if baseline.get('format') != FORMAT_VERSION:
+        print(f'Baseline format {baseline.get("format")} is outdated, record a new one with --update', file=sys.stderr)
+        return 2
+    if baseline.get('host') != current['host']:
+        print(f'Warning: baseline was recorded on "{baseline.get("host")}", timings may not be comparable')
+
+    print(f'Comparing to baseline of version {baseline.get("version")} at {baseline.get("commit", "")[:10]}:')
+    regressions = compare(baseline, current, args.alpha, args.threshold)
+    if regressions:
+        print(f'{len(regressions)} significant regressions:', ', '.join(regressions))
+        return 1
+    print('No significant regressions')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
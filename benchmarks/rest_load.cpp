@@ -0,0 +1,185 @@
+/**
+ * @file rest_load.cpp
+ * @author Ashot Vardanian
+ *
+ * @brief A `wrk`-style load generator for the REST server.
+ *
+ * Every thread keeps one HTTP/1.1 connection alive, and sends batches of
+ * pipelined `GET /one/<key>` requests for random keys, reading the responses
+ * back in order. At the end, it reports the throughput and latency percentiles,
+ * just like `wrk --latency` would, but without the need for Lua scripts.
+ *
+ * Before the measurement, the keys are populated through a series of `PUT /batch/`
+ * requests, each small enough to fit into the default body limit of the server.
+ */
+#include <cstdlib>  // `std::atoi`
+#include <chrono>   // `std::chrono::steady_clock`
+#include <random>   // `std::mt19937`
+#include <thread>   // `std::thread`
+#include <vector>   // `std::vector`
+#include <string>   // `std::string`
+#include <limits>   // `std::numeric_limits`
+#include <iostream> // `std::cerr`
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+using steady_t = std::chrono::steady_clock;
+
+static constexpr std::size_t value_length_k = 64;
+/// Keeps every populating request at about 350 KB, well below the body limits of servers.
+static constexpr std::size_t populate_batch_keys_k = 4096;
+
+struct thread_stats_t {
+    std::size_t requests = 0;
+    std::size_t errors = 0;
+    std::size_t received_bytes = 0;
+    std::vector<double> latencies_us;
+};
+
+static void populate(tcp::endpoint const& endpoint, std::size_t keys_count) {
+    net::io_context io_context;
+    beast::tcp_stream stream(io_context);
+    stream.connect(endpoint);
+
+    std::string value(value_length_k, 'x');
+    std::string host = endpoint.address().to_string();
+    beast::flat_buffer buffer;
+    for (std::size_t first_key = 0; first_key < keys_count; first_key += populate_batch_keys_k) {
+        std::size_t last_key = std::min(first_key + populate_batch_keys_k, keys_count);
+        http::request<http::string_body> req {http::verb::put, "/batch/", 11};
+        req.set(http::field::host, host);
+        req.set(http::field::content_type, "application/x-ndjson");
+        for (std::size_t key = first_key; key != last_key; ++key)
+            fmt::format_to(std::back_inserter(req.body()), "{{\"key\":{},\"value\":\"{}\"}}\n", key, value);
+        req.prepare_payload();
+        http::write(stream, req);
+
+        http::response<http::string_body> res;
+        http::read(stream, buffer, res);
+        if (res.result() != http::status::ok) {
+            std::cerr << "Failed to populate the collection: " << res.body() << std::endl;
+            return;
+        }
+    }
+}
+
+static void load(tcp::endpoint const& endpoint,
+                 std::size_t keys_count,
+                 std::size_t pipeline_depth,
+                 steady_t::time_point deadline,
+                 std::size_t thread_idx,
+                 thread_stats_t& stats) {
+
+    net::io_context io_context;
+    beast::tcp_stream stream(io_context);
+    stream.connect(endpoint);
+    stream.socket().set_option(tcp::no_delay(true));
+
+    std::mt19937_64 rng(thread_idx);
+    std::uniform_int_distribution<std::size_t> keys(0, keys_count - 1);
+    std::string host = endpoint.address().to_string();
+    std::string requests;
+    beast::flat_buffer buffer;
+    buffer.reserve(64 * 1024);
+
+    while (steady_t::now() < deadline) {
+        // Concatenate the requests to send them with a single syscall
+        requests.clear();
+        for (std::size_t i = 0; i != pipeline_depth; ++i)
+            fmt::format_to(std::back_inserter(requests), "GET /one/{} HTTP/1.1\r\nHost: {}\r\n\r\n", keys(rng), host);
+
+        auto start = steady_t::now();
+        beast::error_code ec;
+        net::write(stream, net::buffer(requests), ec);
+        if (ec)
+            break;
+
+        for (std::size_t i = 0; i != pipeline_depth; ++i) {
+            http::response_parser<http::string_body> parser;
+            parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+            http::read(stream, buffer, parser, ec);
+            if (ec)
+                return;
+            auto latency = std::chrono::duration<double, std::micro>(steady_t::now() - start).count();
+            stats.latencies_us.push_back(latency);
+            stats.requests++;
+            stats.errors += parser.get().result() != http::status::ok;
+            stats.received_bytes += parser.get().body().size();
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        std::cerr << "Usage: bench_rest_load <address> <port> <connections>? <seconds>? <pipeline>? <keys>?\n"
+                  << "Example:\n"
+                  << "    bench_rest_load 127.0.0.1 8080\n"
+                  << "    bench_rest_load 127.0.0.1 8080 64 10 16 1000000\n"
+                  << "";
+        return EXIT_FAILURE;
+    }
+
+    auto const address = net::ip::make_address(argv[1]);
+    auto const port = static_cast<unsigned short>(std::atoi(argv[2]));
+    auto const connections = argc > 3 ? std::max(1, std::atoi(argv[3])) : 16;
+    auto const seconds = argc > 4 ? std::max(1, std::atoi(argv[4])) : 10;
+    auto const pipeline_depth = argc > 5 ? std::max(1, std::atoi(argv[5])) : 1;
+    auto const keys_count = argc > 6 ? std::max(1, std::atoi(argv[6])) : 100'000;
+    auto const endpoint = tcp::endpoint {address, port};
+
+    populate(endpoint, static_cast<std::size_t>(keys_count));
+
+    std::vector<thread_stats_t> stats(connections);
+    std::vector<std::thread> threads;
+    auto const start = steady_t::now();
+    auto const deadline = start + std::chrono::seconds(seconds);
+    for (int i = 0; i != connections; ++i)
+        threads.emplace_back(load,
+                             std::cref(endpoint),
+                             static_cast<std::size_t>(keys_count),
+                             static_cast<std::size_t>(pipeline_depth),
+                             deadline,
+                             static_cast<std::size_t>(i),
+                             std::ref(stats[i]));
+    for (auto& thread : threads)
+        thread.join();
+    auto const elapsed = std::chrono::duration<double>(steady_t::now() - start).count();
+
+    thread_stats_t total;
+    for (auto& thread_stats : stats) {
+        total.requests += thread_stats.requests;
+        total.errors += thread_stats.errors;
+        total.received_bytes += thread_stats.received_bytes;
+        total.latencies_us.insert(total.latencies_us.end(),
+                                  thread_stats.latencies_us.begin(),
+                                  thread_stats.latencies_us.end());
+    }
+    if (total.latencies_us.empty()) {
+        std::cerr << "No requests were answered" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::sort(total.latencies_us.begin(), total.latencies_us.end());
+    auto percentile = [&](double fraction) {
+        auto idx = static_cast<std::size_t>(fraction * (total.latencies_us.size() - 1));
+        return total.latencies_us[idx];
+    };
+
+    fmt::print("{} connections, {} pipelined requests each, {:.1f} seconds\n", connections, pipeline_depth, elapsed);
+    fmt::print("  Requests/sec: {:.0f}\n", total.requests / elapsed);
+    fmt::print("  Transfer/sec: {:.2f} MB\n", total.received_bytes / elapsed / 1e6);
+    fmt::print("  Non-2xx responses: {}\n", total.errors);
+    fmt::print("  Latency p50: {:.1f} us, p99: {:.1f} us, p99.9: {:.1f} us\n",
+               percentile(0.5),
+               percentile(0.99),
+               percentile(0.999));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,407 @@
+/**
+ * @file ycsb.cpp
+ * @author Ashot Vardanian
+ *
+ * @brief Self-contained Yahoo! Cloud Serving Benchmark workloads A-F,
+ * built against every engine, to compare them on identical access patterns.
+ *
+ * | Workload | Mix                               | Keys    |
+ * | :------: | :-------------------------------- | :------ |
+ * |    A     | 50% reads, 50% updates            | Zipfian |
+ * |    B     | 95% reads, 5% updates             | Zipfian |
+ * |    C     | 100% reads                        | Zipfian |
+ * |    D     | 95% reads, 5% inserts             | Latest  |
+ * |    E     | 95% short scans, 5% inserts       | Zipfian |
+ * |    F     | 50% reads, 50% read-modify-writes | Zipfian |
+ *
+ * Every workload also runs with uniformly distributed keys. Every iteration
+ * is a single batched call of `--ycsb_batch_sizes` tasks, and its latency is
+ * reported in microseconds as "p50", "p99" and "p999" counters. Those are
+ * computed by every thread separately and averaged across the threads.
+ *
+ * Options, passed after the Google Benchmark ones:
+ * - "--ycsb_records=": Number of records loaded before the run, 1'000'000 by default.
+ * - "--ycsb_value_size=": Bytes in every value, 100 by default.
+ * - "--ycsb_batch_sizes=": Comma-separated list, "1,16,256" by default.
+ * - "--ycsb_threads=": Comma-separated list, "1,<half of the cores>" by default.
+ * - "--ycsb_seconds=": Minimal duration of each benchmark, 10 by default.
+ * - "--ycsb_workloads=": Subset of "ABCDEF" to run.
+ * - "--ycsb_path=": Directory for persistent engines or the URI of the Flight server.
+ */
+#include <cmath>       // `std::pow`
+#include <atomic>      // `std::atomic`
+#include <chrono>      // `std::chrono::steady_clock`
+#include <random>      // `std::mt19937_64`
+#include <string>      // `std::string`
+#include <string_view> // `std::string_view`
+#include <thread>      // `std::thread::hardware_concurrency`
+#include <vector>      // `std::vector`
+#include <algorithm>   // `std::sort`
+#include <filesystem>  // `std::filesystem::create_directories`
+
+#include <benchmark/benchmark.h>
+
+#include <ukv/ukv.hpp>
+
+namespace bm = benchmark;
+using namespace unum::ukv;
+using steady_t = std::chrono::steady_clock;
+
+constexpr ukv_length_t max_scan_length_k = 100;
+constexpr std::size_t load_batch_size_k = 1024;
+
+struct ycsb_config_t {
+    std::size_t records = 1'000'000;
+    std::size_t value_size = 100;
+    std::vector<std::int64_t> batch_sizes = {1, 16, 256};
+    std::vector<int> threads = {1, std::max(1, static_cast<int>(std::thread::hardware_concurrency() / 2))};
+    double seconds = 10;
+    std::string workloads = "ABCDEF";
+    std::string path;
+};
+
+enum class distribution_t : std::int64_t { zipfian_k = 0, uniform_k = 1 };
+enum class operation_t { read_k, update_k, insert_k, scan_k, read_modify_write_k };
+
+/**
+ * @brief Share of each operation in a workload, that sum up to one.
+ */
+struct workload_t {
+    char name;
+    double read = 0;
+    double update = 0;
+    double insert = 0;
+    double scan = 0;
+    double read_modify_write = 0;
+    /// Whether the Zipfian distribution favors the most recently inserted keys.
+    bool latest = false;
+
+    operation_t operation(double choice) const noexcept {
+        if ((choice -= read) < 0)
+            return operation_t::read_k;
+        if ((choice -= update) < 0)
+            return operation_t::update_k;
+        if ((choice -= insert) < 0)
+            return operation_t::insert_k;
+        if ((choice -= scan) < 0)
+            return operation_t::scan_k;
+        return operation_t::read_modify_write_k;
+    }
+};
+
+static workload_t const workloads_k[] = {
+    {'A', 0.50, 0.50, 0, 0, 0, false},
+    {'B', 0.95, 0.05, 0, 0, 0, false},
+    {'C', 1.00, 0, 0, 0, 0, false},
+    {'D', 0.95, 0, 0.05, 0, 0, true},
+    {'E', 0, 0, 0.05, 0.95, 0, false},
+    {'F', 0.50, 0, 0, 0, 0.50, false},
+};
+
+static ycsb_config_t config;
+static database_t db;
+static std::atomic<ukv_key_t> inserted_keys {0};
+
+/**
+ * @brief Zipfian distribution over `[0, items)` with the YCSB constant of 0.99,
+ * using the rejection-free method by Gray et al. from "Quickly Generating
+ * Billion-Record Synthetic Databases". Shared by all threads, as it is immutable.
+ */
+class zipfian_distribution_t {
+    std::uint64_t items_ = 0;
+    double theta_ = 0.99;
+    double alpha_ = 0;
+    double zeta_n_ = 0;
+    double eta_ = 0;
+    double half_pow_theta_ = 0;
+
+    static double zeta(std::uint64_t n, double theta) noexcept {
+        double sum = 0;
+        for (std::uint64_t i = 1; i <= n; ++i)
+            sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+  public:
+    zipfian_distribution_t() = default;
+    zipfian_distribution_t(std::uint64_t items, double theta = 0.99) noexcept : items_(items), theta_(theta) {
+        double zeta_2 = zeta(2, theta);
+        zeta_n_ = zeta(items, theta);
+        alpha_ = 1.0 / (1.0 - theta);
+        eta_ = (1.0 - std::pow(2.0 / items, 1.0 - theta)) / (1.0 - zeta_2 / zeta_n_);
+        half_pow_theta_ = 1.0 + std::pow(0.5, theta);
+    }
+
+    /// Returns the rank of the item, where zero is the most popular one.
+    template <typename generator_at>
+    std::uint64_t operator()(generator_at& generator) const noexcept {
+        double u = std::uniform_real_distribution<double>(0, 1)(generator);
+        double uz = u * zeta_n_;
+        if (uz < 1.0)
+            return 0;
+        if (uz < half_pow_theta_)
+            return 1;
+        auto rank = static_cast<std::uint64_t>(items_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+        return std::min(rank, items_ - 1);
+    }
+};
+
+static zipfian_distribution_t zipfian;
+
+/// Spreads the popular ranks across the whole key space, like YCSB "scrambled" generators.
+static std::uint64_t fnv1a(std::uint64_t value) noexcept {
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    for (int i = 0; i != 8; ++i, value >>= 8)
+        hash = (hash ^ (value & 0xFF)) * 0x100000001B3ull;
+    return hash;
+}
+
+/**
+ * @brief Generates keys for the requests of a single thread.
+ */
+class keys_generator_t {
+    std::mt19937_64 random_;
+    distribution_t distribution_;
+    bool latest_;
+
+  public:
+    keys_generator_t(std::size_t seed, distribution_t distribution, bool latest) noexcept
+        : random_(seed), distribution_(distribution), latest_(latest) {}
+
+    std::mt19937_64& random() noexcept { return random_; }
+
+    ukv_key_t existing() noexcept {
+        auto count = static_cast<std::uint64_t>(inserted_keys.load(std::memory_order_relaxed));
+        if (distribution_ == distribution_t::uniform_k)
+            return static_cast<ukv_key_t>(std::uniform_int_distribution<std::uint64_t>(0, count - 1)(random_));
+        std::uint64_t rank = zipfian(random_);
+        if (latest_)
+            return static_cast<ukv_key_t>(count - 1 - std::min(rank, count - 1));
+        return static_cast<ukv_key_t>(fnv1a(rank) % count);
+    }
+
+    ukv_key_t fresh() noexcept { return inserted_keys.fetch_add(1, std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Reusable buffers and call descriptors of a single thread.
+ */
+struct ycsb_session_t {
+    status_t status;
+    arena_t arena;
+    std::vector<ukv_key_t> keys;
+    std::vector<ukv_length_t> offsets;
+    std::vector<ukv_length_t> scan_lengths;
+    std::string values;
+    ukv_bytes_cptr_t values_begin = nullptr;
+    ukv_length_t value_length = 0;
+
+    ycsb_session_t(std::size_t batch_size) : arena(db), keys(batch_size), offsets(batch_size + 1) {
+        values.resize(batch_size * config.value_size);
+        std::mt19937 random(static_cast<unsigned>(batch_size));
+        for (char& c : values)
+            c = static_cast<char>('a' + random() % 26);
+        for (std::size_t i = 0; i <= batch_size; ++i)
+            offsets[i] = static_cast<ukv_length_t>(i * config.value_size);
+        values_begin = reinterpret_cast<ukv_bytes_cptr_t>(values.data());
+        value_length = static_cast<ukv_length_t>(config.value_size);
+        scan_lengths.resize(batch_size);
+    }
+
+    std::size_t read() {
+        ukv_length_t* found_lengths = nullptr;
+        ukv_byte_t* found_values = nullptr;
+        ukv_read_t read {};
+        read.db = db;
+        read.error = status.member_ptr();
+        read.arena = arena.member_ptr();
+        read.tasks_count = static_cast<ukv_size_t>(keys.size());
+        read.keys = keys.data();
+        read.keys_stride = sizeof(ukv_key_t);
+        read.lengths = &found_lengths;
+        read.values = &found_values;
+        ukv_read(&read);
+        status.throw_unhandled();
+
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i != keys.size(); ++i)
+            bytes += found_lengths[i] != ukv_length_missing_k ? found_lengths[i] : 0;
+        return bytes;
+    }
+
+    std::size_t write() {
+        ukv_write_t write {};
+        write.db = db;
+        write.error = status.member_ptr();
+        write.arena = arena.member_ptr();
+        write.tasks_count = static_cast<ukv_size_t>(keys.size());
+        write.keys = keys.data();
+        write.keys_stride = sizeof(ukv_key_t);
+        write.offsets = offsets.data();
+        write.offsets_stride = sizeof(ukv_length_t);
+        write.lengths = &value_length;
+        write.values = &values_begin;
+        ukv_write(&write);
+        status.throw_unhandled();
+        return values.size();
+    }
+
+    std::size_t scan() {
+        ukv_length_t* found_counts = nullptr;
+        ukv_key_t* found_keys = nullptr;
+        ukv_length_t* found_offsets = nullptr;
+        ukv_byte_t* found_values = nullptr;
+        ukv_scan_t scan {};
+        scan.db = db;
+        scan.error = status.member_ptr();
+        scan.arena = arena.member_ptr();
+        scan.tasks_count = static_cast<ukv_size_t>(keys.size());
+        scan.start_keys = keys.data();
+        scan.start_keys_stride = sizeof(ukv_key_t);
+        scan.count_limits = scan_lengths.data();
+        scan.count_limits_stride = sizeof(ukv_length_t);
+        scan.counts = &found_counts;
+        scan.keys = &found_keys;
+        scan.values_offsets = &found_offsets;
+        scan.values = &found_values;
+        ukv_scan(&scan);
+        status.throw_unhandled();
+
+        std::size_t found = 0;
+        for (std::size_t i = 0; i != keys.size(); ++i)
+            found += found_counts[i];
+        return found_offsets[found];
+    }
+};
+
+/**
+ * @param state.range(0) Number of tasks in every batched call.
+ * @param state.range(1) Distribution of keys, a `distribution_t`.
+ */
+static void ycsb(bm::State& state, workload_t workload) {
+
+    auto const batch_size = static_cast<std::size_t>(state.range(0));
+    auto const distribution = static_cast<distribution_t>(state.range(1));
+    ycsb_session_t session(batch_size);
+    keys_generator_t generator(state.thread_index() * 7919 + 1, distribution, workload.latest);
+    std::uniform_real_distribution<double> choose(0, 1);
+    std::uniform_int_distribution<ukv_length_t> scan_length(1, max_scan_length_k);
+
+    std::vector<double> latencies;
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        operation_t operation = workload.operation(choose(generator.random()));
+        for (ukv_key_t& key : session.keys)
+            key = operation == operation_t::insert_k ? generator.fresh() : generator.existing();
+        if (operation == operation_t::scan_k)
+            for (ukv_length_t& length : session.scan_lengths)
+                length = scan_length(generator.random());
+
+        auto start = steady_t::now();
+        switch (operation) {
+        case operation_t::read_k: bytes += session.read(); break;
+        case operation_t::update_k: bytes += session.write(); break;
+        case operation_t::insert_k: bytes += session.write(); break;
+        case operation_t::scan_k: bytes += session.scan(); break;
+        case operation_t::read_modify_write_k: bytes += session.read() + session.write(); break;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(steady_t::now() - start).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double share) {
+        return latencies.empty() ? 0.0 : latencies[static_cast<std::size_t>(share * (latencies.size() - 1))];
+    };
+    state.counters["p50"] = bm::Counter(percentile(0.5), bm::Counter::kAvgThreads);
+    state.counters["p99"] = bm::Counter(percentile(0.99), bm::Counter::kAvgThreads);
+    state.counters["p999"] = bm::Counter(percentile(0.999), bm::Counter::kAvgThreads);
+    state.counters["ops/s"] = bm::Counter(state.iterations() * batch_size, bm::Counter::kIsRate);
+    state.counters["bytes/s"] = bm::Counter(bytes, bm::Counter::kIsRate);
+}
+
+static void load() {
+    ycsb_session_t session(load_batch_size_k);
+    for (std::size_t first = 0; first < config.records; first += load_batch_size_k) {
+        std::size_t count = std::min(load_batch_size_k, config.records - first);
+        session.keys.resize(count);
+        for (std::size_t i = 0; i != count; ++i)
+            session.keys[i] = static_cast<ukv_key_t>(first + i);
+        session.write();
+    }
+    inserted_keys = static_cast<ukv_key_t>(config.records);
+}
+
+template <typename number_at>
+static std::vector<number_at> parse_list(std::string_view list) {
+    std::vector<number_at> numbers;
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        numbers.push_back(static_cast<number_at>(std::stoll(std::string(list.substr(0, comma)))));
+        list = comma == std::string_view::npos ? std::string_view {} : list.substr(comma + 1);
+    }
+    return numbers;
+}
+
+static void parse_config(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value_of = [&](std::string_view name) {
+            return arg.substr(0, name.size()) == name ? arg.substr(name.size()) : std::string_view {};
+        };
+        if (auto value = value_of("--ycsb_records="); !value.empty())
+            config.records = std::stoull(std::string(value));
+        else if (auto value = value_of("--ycsb_value_size="); !value.empty())
+            config.value_size = std::stoull(std::string(value));
+        else if (auto value = value_of("--ycsb_batch_sizes="); !value.empty())
+            config.batch_sizes = parse_list<std::int64_t>(value);
+        else if (auto value = value_of("--ycsb_threads="); !value.empty())
+            config.threads = parse_list<int>(value);
+        else if (auto value = value_of("--ycsb_seconds="); !value.empty())
+            config.seconds = std::stod(std::string(value));
+        else if (auto value = value_of("--ycsb_workloads="); !value.empty())
+            config.workloads = value;
+        else if (auto value = value_of("--ycsb_path="); !value.empty())
+            config.path = value;
+    }
+#if defined(UKV_DEBUG)
+    config.records = std::min<std::size_t>(config.records, 10'000);
+    config.seconds = std::min(config.seconds, 1.0);
+#endif
+}
+
+int main(int argc, char** argv) {
+    bm::Initialize(&argc, argv);
+    parse_config(argc, argv);
+
+#if defined(UKV_ENGINE_IS_LEVELDB) || defined(UKV_ENGINE_IS_ROCKSDB) || defined(UKV_ENGINE_IS_UDISK)
+    if (config.path.empty())
+        config.path = "./tmp/ycsb/";
+    std::filesystem::create_directories(config.path);
+#endif
+    db.open(config.path.empty() ? nullptr : config.path.c_str()).throw_unhandled();
+    db.clear().throw_unhandled();
+
+    std::printf("Will load %zu records of %zu bytes...\n", config.records, config.value_size);
+    zipfian = zipfian_distribution_t(config.records);
+    load();
+
+    std::printf("Will benchmark...\n");
+    for (workload_t const& workload : workloads_k) {
+        if (config.workloads.find(workload.name) == std::string::npos)
+            continue;
+        std::string name = std::string("ycsb_") + workload.name;
+        auto benchmark = bm::RegisterBenchmark(name.c_str(), &ycsb, workload);
+        benchmark->ArgNames({"batch", "uniform"})->MinTime(config.seconds)->UseRealTime();
+        for (std::int64_t batch_size : config.batch_sizes)
+            for (auto distribution : {distribution_t::zipfian_k, distribution_t::uniform_k})
+                benchmark->Args({batch_size, static_cast<std::int64_t>(distribution)});
+        for (int threads : config.threads)
+            benchmark->Threads(threads);
+    }
+
+    bm::RunSpecifiedBenchmarks();
+    bm::Shutdown();
+
+    db.clear().throw_unhandled();
+    return 0;
+}
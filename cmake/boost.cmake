@@ -63,7 +63,7 @@ else()
         INSTALL_COMMAND ""
     )
 
-    set(BOOST_ROOT _deps/boost-src)
-    set(BOOST_INCLUDE_DIR _deps/boost-src)
-    set(BOOST_LIB_DIR _deps/boost-src/stage/lib)
+    set(BOOST_ROOT ${CMAKE_CURRENT_BINARY_DIR}/_deps/boost-src)
+    set(BOOST_INCLUDE_DIR ${CMAKE_CURRENT_BINARY_DIR}/_deps/boost-src)
+    set(BOOST_LIB_DIR ${CMAKE_CURRENT_BINARY_DIR}/_deps/boost-src/stage/lib)
 endif()
\ No newline at end of file
@@ -15,6 +15,17 @@
  * a client-server setup. Regardless of IO layer, a lot of synchronization and locks
  * must be issued to provide consistency.
  *
+ * ## Asynchronous Calls
+ *
+ * `ukv_read_async()` and `ukv_write_async()` take the same task structures as
+ * their blocking counterparts, but return right after submission. A callback
+ * is invoked exactly once, when the task is completed or has failed. So a server can keep thousands of
+ * requests in flight without dedicating a thread to each of them. One submission
+ * can still carry a whole batch of `tasks_count` keys, and is completed at once.
+ * Engines with native asynchronous interfaces use them: the Flight client queues
+ * requests for its dispatchers, and RocksDB overlaps the disk reads of a batch.
+ * Others run the blocking call on a shared pool of threads.
+ *
  * ## Why use offsets?
  *
  * In the underlying layer, using offsets to adds no additional overhead,
@@ -234,6 +245,17 @@ typedef struct ukv_write_t {
  */
 void ukv_write(ukv_write_t*);
 
+/**
+ * @brief Submits a write without waiting for it to complete.
+ * @see `ukv_write()`, "Asynchronous Calls".
+ *
+ * Once the `error` of the passed task is filled, the `callback` is invoked
+ * with the `payload`, usually from a background thread. Until then, the task,
+ * its inputs and its arena must stay untouched. If the submission itself fails,
+ * the `callback` is invoked with the `error` set, before returning.
+ */
+void ukv_write_async(ukv_write_t*, ukv_callback_t callback, ukv_callback_payload_t payload);
+
 /**
  * @brief Main "getter" or "gather" interface.
  * @see `ukv_read()`.
@@ -392,14 +414,27 @@ typedef struct ukv_read_t {
  */
 void ukv_read(ukv_read_t*);
 
+/**
+ * @brief Submits a read without waiting for its results.
+ * @see `ukv_read()`, "Asynchronous Calls".
+ *
+ * Once all the outputs and the `error` of the passed task are filled,
+ * the `callback` is invoked with the `payload`, usually from a background thread.
+ * Until then, the task, its inputs and its arena must stay untouched.
+ * If the submission itself fails, the `callback` is invoked with the `error` set,
+ * before returning.
+ */
+void ukv_read_async(ukv_read_t*, ukv_callback_t callback, ukv_callback_payload_t payload);
+
 /**
  * @brief Main "scanning", "range selection", "iteration", "enumeration" interface.
  * @see `ukv_scan()`.
  *
  * Retrieves the following (upto) `count_limits[i]` keys starting
  * from `start_key[i]` or the smallest following key in each collection.
- * Values are not exported, for that - follow up with a `ukv_read()` or
- * a higher-level interface for Graphs, Docs or other modalities.
+ * Values can be exported alongside, via `values_offsets` and `values`,
+ * or fetched later with a `ukv_read()` or a higher-level interface for
+ * Graphs, Docs or other modalities.
  *
  * ## Scans vs Iterators
  *
@@ -408,6 +443,10 @@ void ukv_read(ukv_read_t*);
  *
  * ## Bulk Scans
  *
+ * Ordered pagination is the wrong tool for full exports and Machine Learning
+ * data-loaders, that only need every entry once and as fast as possible.
+ * For those use `ukv_scan_bulk_init()`, which splits a collection into
+ * partitions, that separate threads can drain with `ukv_scan_bulk_next()`.
  */
 typedef struct ukv_scan_t {
 
@@ -539,6 +578,29 @@ typedef struct ukv_scan_t {
      * runtime- or library-specific implementations.
      */
     ukv_key_t** keys;
+    /**
+     * @brief Output offsets of values in the `values` tape.
+     *
+     * Will contain a pointer to an array of one more offset, than the number of
+     * exported `keys`. Values of scanned entries are fetched from the same iterator,
+     * that produced the keys, avoiding a second lookup pass, like `ukv_read()`.
+     * Just like with `keys`, the `offsets` of every scan task index this array.
+     * Is @b optional.
+     */
+    ukv_length_t** values_offsets;
+    /**
+     * @brief Output lengths of values, one for each of exported `keys`.
+     * Is @b optional.
+     */
+    ukv_length_t** values_lengths;
+    /**
+     * @brief Output values tape.
+     *
+     * Will contain the base pointer for the values of all exported `keys`,
+     * joined into a single tape. Is @b optional. Values are only fetched,
+     * if this, `values_offsets` or `values_lengths` is requested.
+     */
+    ukv_byte_t** values;
     /// @}
 
 } ukv_scan_t;
@@ -549,6 +611,177 @@ typedef struct ukv_scan_t {
  */
 void ukv_scan(ukv_scan_t*);
 
+/**
+ * @brief Opaque handle of a partitioned bulk scan.
+ * @see `ukv_scan_bulk_init()`, `ukv_scan_bulk_next()`, `ukv_scan_bulk_free()`.
+ *
+ * Properties:
+ * - Thread safety: Different partitions can be drained concurrently,
+ *   but each partition must be drained by one thread at a time.
+ * - Lifetime: Must be freed before the @c ukv_database_t is closed.
+ * - Ordering: None. Keys are ordered neither across, nor within partitions.
+ */
+typedef void* ukv_scan_bulk_t;
+
+/**
+ * @brief Starts an unordered high-throughput scan over the whole collection.
+ * @see `ukv_scan_bulk_init()`.
+ *
+ * Underlying engines pick the cheapest way to split the collection:
+ * - UMem splits the sorted set into equal-cardinality key ranges.
+ * - RocksDB and LevelDB split the key range into parts of similar size on disk.
+ *   RocksDB reads ahead, bypassing the block cache, within an implicit snapshot,
+ *   unless one is provided.
+ *
+ * Every partition exports only the latest present version of every key.
+ */
+typedef struct ukv_scan_bulk_init_t {
+
+    /// @name Context
+    /// @{
+
+    /** @brief Already open database instance. */
+    ukv_database_t db;
+    /**
+     * @brief Pointer to exported error message.
+     * If not NULL, must be deallocated with `ukv_error_free()`.
+     */
+    ukv_error_t* error;
+    /**
+     * @brief The snapshot captures a view of the database at the time it's created.
+     * @see `ukv_snapshot_list()`, `ukv_snapshot_create()`, `ukv_snapshot_drop()`.
+     */
+    ukv_snapshot_t snapshot;
+    /**
+     * @brief Reusable memory handle.
+     * @see `ukv_arena_free()`.
+     */
+    ukv_arena_t* arena;
+    /**
+     * @brief Bulk scan options.
+     *
+     * Possible values:
+     * - `::ukv_option_dont_discard_memory_k`: Won't reset the `arena` before the operation begins.
+     */
+    ukv_options_t options;
+
+    /// @}
+    /// @name Inputs
+    /// @{
+
+    /**
+     * @brief The collection to export.
+     * If `0`, the default collection is assumed.
+     */
+    ukv_collection_t collection;
+    /**
+     * @brief Desired number of partitions, generally matching the number of consumer threads.
+     * Some partitions may end up empty, if the collection is too small.
+     */
+    ukv_size_t partitions_count;
+
+    /// @}
+    /// @name Outputs
+    /// @{
+
+    /** @brief Output handle, to be passed into `ukv_scan_bulk_next()`. */
+    ukv_scan_bulk_t* scan;
+
+    /// @}
+
+} ukv_scan_bulk_init_t;
+
+/**
+ * @brief Starts an unordered high-throughput scan over the whole collection.
+ * @see `ukv_scan_bulk_init_t`.
+ */
+void ukv_scan_bulk_init(ukv_scan_bulk_init_t*);
+
+/**
+ * @brief Exports the next batch of entries from one partition of a bulk scan.
+ * @see `ukv_scan_bulk_next()`.
+ *
+ * Once the partition is drained, zero entries are exported.
+ */
+typedef struct ukv_scan_bulk_next_t {
+
+    /// @name Context
+    /// @{
+
+    /** @brief Already open database instance. */
+    ukv_database_t db;
+    /**
+     * @brief Pointer to exported error message.
+     * If not NULL, must be deallocated with `ukv_error_free()`.
+     */
+    ukv_error_t* error;
+    /**
+     * @brief Reusable memory handle.
+     * Every consumer thread should have its own.
+     * @see `ukv_arena_free()`.
+     */
+    ukv_arena_t* arena;
+    /**
+     * @brief Bulk scan options.
+     *
+     * Possible values:
+     * - `::ukv_option_dont_discard_memory_k`: Won't reset the `arena` before the operation begins.
+     */
+    ukv_options_t options;
+
+    /// @}
+    /// @name Inputs
+    /// @{
+
+    /** @brief Handle from `ukv_scan_bulk_init()`. */
+    ukv_scan_bulk_t scan;
+    /** @brief Index of the partition to continue, smaller than `partitions_count`. */
+    ukv_size_t partition;
+    /** @brief Maximum number of entries to export in this batch. */
+    ukv_length_t count_limit;
+
+    /// @}
+    /// @name Outputs
+    /// @{
+
+    /** @brief Output number of exported entries. */
+    ukv_length_t* count;
+    /** @brief Output keys, not guaranteed to be sorted. */
+    ukv_key_t** keys;
+    /**
+     * @brief Output offsets of values in the `values` tape.
+     * Contains one more offset, than the number of exported `keys`.
+     * Is @b optional.
+     */
+    ukv_length_t** values_offsets;
+    /**
+     * @brief Output lengths of values, one for each of exported `keys`.
+     * Is @b optional.
+     */
+    ukv_length_t** values_lengths;
+    /**
+     * @brief Output values tape.
+     * Values are only fetched, if this, `values_offsets` or `values_lengths` is requested.
+     * Is @b optional.
+     */
+    ukv_byte_t** values;
+
+    /// @}
+
+} ukv_scan_bulk_next_t;
+
+/**
+ * @brief Exports the next batch of entries from one partition of a bulk scan.
+ * @see `ukv_scan_bulk_next_t`.
+ */
+void ukv_scan_bulk_next(ukv_scan_bulk_next_t*);
+
+/**
+ * @brief Releases the bulk scan and any snapshots or resources it has pinned.
+ * @see `ukv_scan_bulk_init()`.
+ */
+void ukv_scan_bulk_free(ukv_scan_bulk_t);
+
 /**
  * @brief Uniformly randomly samples keys from provided collections.
  * @see `ukv_sample()`.
@@ -800,6 +1033,84 @@ typedef struct ukv_measure_t {
  */
 void ukv_measure(ukv_measure_t*);
 
+/**
+ * @brief Splits a range of keys into parts of similar size for parallel processing.
+ * @see `ukv_collection_split()`.
+ *
+ * Boundaries are derived from the engines metadata, without scanning the data:
+ * - UMem counts the entries, splitting the range into equal-cardinality parts.
+ * - RocksDB and LevelDB bisect the range with `GetApproximateSizes`.
+ * - Flight forwards the request to the server engine.
+ *
+ * The `i`-th part spans from `boundaries[i]` inclusive to `boundaries[i + 1]` exclusive.
+ * Boundaries are sorted, but may repeat, producing empty parts.
+ */
+typedef struct ukv_collection_split_t {
+
+    /// @name Context
+    /// @{
+
+    /** @brief Already open database instance. */
+    ukv_database_t db;
+    /**
+     * @brief Pointer to exported error message.
+     * If not NULL, must be deallocated with `ukv_error_free()`.
+     */
+    ukv_error_t* error;
+    /**
+     * @brief The snapshot captures a view of the database at the time it's created.
+     * @see `ukv_snapshot_list()`, `ukv_snapshot_create()`, `ukv_snapshot_drop()`.
+     */
+    ukv_snapshot_t snapshot;
+    /**
+     * @brief Reusable memory handle.
+     * @see `ukv_arena_free()`.
+     */
+    ukv_arena_t* arena;
+    /**
+     * @brief Splitting options.
+     *
+     * Possible values:
+     * - `::ukv_option_dont_discard_memory_k`: Won't reset the `arena` before the operation begins.
+     */
+    ukv_options_t options;
+
+    /// @}
+    /// @name Inputs
+    /// @{
+
+    /**
+     * @brief The collection to split.
+     * If `0`, the default collection is assumed.
+     */
+    ukv_collection_t collection;
+    /** @brief Inclusive lower bound of the range to split. */
+    ukv_key_t start_key;
+    /** @brief Exclusive upper bound of the range to split. */
+    ukv_key_t end_key;
+    /** @brief Number of parts to split into. */
+    ukv_size_t count;
+
+    /// @}
+    /// @name Outputs
+    /// @{
+
+    /**
+     * @brief Output boundaries of parts.
+     * Will contain `count + 1` keys, starting with `start_key` and ending with `end_key`.
+     */
+    ukv_key_t** boundaries;
+
+    /// @}
+
+} ukv_collection_split_t;
+
+/**
+ * @brief Splits a range of keys into parts of similar size for parallel processing.
+ * @see `ukv_collection_split_t`.
+ */
+void ukv_collection_split(ukv_collection_split_t*);
+
 #ifdef __cplusplus
 } /* end extern "C" */
 #endif
@@ -0,0 +1,120 @@
+/**
+ * @file async.hpp
+ * @author Ashot Vardanian
+ * @addtogroup Cpp
+ *
+ * @brief Completion tokens for the asynchronous `ukv_read_async()` and `ukv_write_async()`.
+ *
+ * A `completion_t` can be polled with `ready()`, blocked on with `wait()`,
+ * or, in C++20, awaited from a coroutine:
+ *
+ * ```cpp
+ * completion_t done;
+ * co_await submit(read, done);
+ * ```
+ */
+
+#pragma once
+#include <utility>            // `std::exchange`
+#include <mutex>              // `std::mutex`
+#include <condition_variable> // `std::condition_variable`
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine> // `std::coroutine_handle`
+#define UKV_HAS_COROUTINES 1
+#endif
+
+#include "ukv/blobs.h"
+
+namespace unum::ukv {
+
+/**
+ * @brief Tracks a single asynchronous call. Must outlive it and can't be reused.
+ * Either block on it with `wait()` or `co_await` it, but not both at once.
+ */
+class completion_t {
+    /// Either `nullptr` while pending, `done_tag()` once done, or the address of an awaiting coroutine.
+    void* state_ {nullptr};
+    /// Guards the `state_`, so that the completing thread never touches this object after publishing it.
+    mutable std::mutex mutex_;
+    std::condition_variable done_;
+
+    static void* done_tag() noexcept {
+        static char tag;
+        return &tag;
+    }
+
+  public:
+    completion_t() = default;
+    completion_t(completion_t const&) = delete;
+    completion_t& operator=(completion_t const&) = delete;
+
+    /**
+     * @brief Marks the call as completed, resuming the awaiting coroutine, if any.
+     * The coroutine is resumed on the calling thread, and may destroy this object.
+     */
+    static void complete(ukv_callback_payload_t payload) noexcept {
+        completion_t& self = *reinterpret_cast<completion_t*>(payload);
+        std::unique_lock<std::mutex> lock(self.mutex_);
+        [[maybe_unused]] void* awaiting = std::exchange(self.state_, done_tag());
+#if defined(UKV_HAS_COROUTINES)
+        if (awaiting) {
+            lock.unlock();
+            std::coroutine_handle<>::from_address(awaiting).resume();
+            return;
+        }
+#endif
+        self.done_.notify_all();
+    }
+
+    ukv_callback_t callback() const noexcept { return &completion_t::complete; }
+    ukv_callback_payload_t payload() noexcept { return this; }
+
+    bool ready() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_ == done_tag();
+    }
+
+    void wait() noexcept {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return state_ == done_tag(); });
+    }
+
+#if defined(UKV_HAS_COROUTINES)
+    struct awaiter_t {
+        completion_t& completion;
+
+        bool await_ready() const noexcept { return completion.ready(); }
+        bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            std::lock_guard<std::mutex> lock(completion.mutex_);
+            if (completion.state_ == done_tag())
+                return false;
+            completion.state_ = awaiting.address();
+            return true;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    awaiter_t operator co_await() noexcept { return {*this}; }
+#endif
+};
+
+/**
+ * @brief Submits the read with `ukv_read_async()`, so that `done` is completed with it.
+ * @return The same `done` token, to be awaited or polled.
+ */
+inline completion_t& submit(ukv_read_t& read, completion_t& done) noexcept {
+    ukv_read_async(&read, done.callback(), done.payload());
+    return done;
+}
+
+/**
+ * @brief Submits the write with `ukv_write_async()`, so that `done` is completed with it.
+ * @return The same `done` token, to be awaited or polled.
+ */
+inline completion_t& submit(ukv_write_t& write, completion_t& done) noexcept {
+    ukv_write_async(&write, done.callback(), done.payload());
+    return done;
+}
+
+} // namespace unum::ukv
@@ -194,6 +194,8 @@ class pairs_stream_t {
 
         ukv_length_t* found_counts = nullptr;
         ukv_key_t* found_keys = nullptr;
+        ukv_length_t* found_offs = nullptr;
+        ukv_bytes_ptr_t found_vals = nullptr;
         status_t status;
         ukv_scan_t scan {};
         scan.db = db_;
@@ -206,6 +208,8 @@ class pairs_stream_t {
         scan.count_limits = &read_ahead_;
         scan.counts = &found_counts;
         scan.keys = &found_keys;
+        scan.values_offsets = &found_offs;
+        scan.values = &found_vals;
 
         ukv_scan(&scan);
         if (!status)
@@ -215,25 +219,6 @@ class pairs_stream_t {
         fetched_offset_ = 0;
         auto count = static_cast<ukv_size_t>(fetched_keys_.size());
 
-        ukv_bytes_ptr_t found_vals {};
-        ukv_length_t* found_offs {};
-        ukv_read_t read {};
-        read.db = db_;
-        read.error = status.member_ptr();
-        read.transaction = txn_;
-        read.arena = arena_.member_ptr();
-        read.options = ukv_option_dont_discard_memory_k;
-        read.tasks_count = count;
-        read.collections = &collection_;
-        read.keys = found_keys;
-        read.keys_stride = sizeof(ukv_key_t);
-        read.offsets = &found_offs;
-        read.values = &found_vals;
-
-        ukv_read(&read);
-        if (!status)
-            return status;
-
         values_view_ = joined_blobs_t {count, found_offs, found_vals};
         values_iterator_ = values_view_.begin();
         next_min_key_ = count < read_ahead_ ? ukv_key_unknown_k : fetched_keys_[count - 1] + 1;
@@ -446,6 +431,30 @@ class blobs_range_t {
         return result;
     }
 
+    /**
+     * @brief Splits the range into `count` parts of similar size, using the engines metadata.
+     * @return `count + 1` sorted boundaries, where the `i`-th part spans `[boundaries[i], boundaries[i + 1])`.
+     */
+    expected_gt<ptr_range_gt<ukv_key_t>> split(std::size_t count, ukv_arena_t* arena) noexcept {
+        status_t status;
+        ukv_key_t* boundaries = nullptr;
+        ukv_collection_split_t split {};
+        split.db = db_;
+        split.error = status.member_ptr();
+        split.snapshot = snap_;
+        split.arena = arena;
+        split.collection = collection_;
+        split.start_key = min_key_;
+        split.end_key = max_key_;
+        split.count = static_cast<ukv_size_t>(count);
+        split.boundaries = &boundaries;
+
+        ukv_collection_split(&split);
+        if (!status)
+            return std::move(status);
+        return ptr_range_gt<ukv_key_t> {boundaries, count + 1};
+    }
+
     blobs_range_t& since(ukv_key_t min_key) noexcept {
         min_key_ = min_key;
         return *this;
@@ -213,12 +213,14 @@ class context_t : public std::enable_shared_from_this<context_t> {
      *                 must be created for this transaction. Is required for
      *                 long-running analytical tasks with strong consistency
      *                 requirements.
+     * @param pessimistic Locks the accessed keys instead of validating them on commit.
      */
-    status_t reset() noexcept {
+    status_t reset(bool pessimistic = false) noexcept {
         status_t status;
         ukv_transaction_init_t txn_init {};
         txn_init.db = db_;
         txn_init.error = status.member_ptr();
+        txn_init.options = pessimistic ? ukv_option_transaction_pessimistic_k : ukv_options_default_k;
         txn_init.transaction = &txn_;
 
         ukv_transaction_init(&txn_init);
@@ -298,13 +300,14 @@ class database_t : public std::enable_shared_from_this<database_t> {
             close();
     }
 
-    expected_gt<context_t> transact() noexcept {
+    expected_gt<context_t> transact(bool pessimistic = false) noexcept {
 
         status_t status {};
         ukv_transaction_t raw {};
         ukv_transaction_init_t txn_init {};
         txn_init.db = db_;
         txn_init.error = status.member_ptr();
+        txn_init.options = pessimistic ? ukv_option_transaction_pessimistic_k : ukv_options_default_k;
         txn_init.transaction = &raw;
 
         ukv_transaction_init(&txn_init);
@@ -347,7 +347,9 @@ inline void validate_transaction_begin(ukv_transaction_t const c_txn,
                                        ukv_error_t* c_error) noexcept {
 
     return_error_if_m(c_txn, c_error, args_wrong_k, "Transaction is uninitialized");
-    return_error_if_m(enum_is_subset(c_options, ukv_option_transaction_dont_watch_k),
+    return_error_if_m(enum_is_subset(c_options,
+                                     ukv_option_transaction_dont_watch_k | ukv_option_transaction_pessimistic_k |
+                                         ukv_option_transaction_read_only_k),
                       c_error,
                       args_wrong_k,
                       "Invalid options!");
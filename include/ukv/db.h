@@ -181,6 +181,13 @@ typedef enum {
      * detection on separate parts of transactional reads and writes.
      */
     ukv_option_transaction_dont_watch_k = 1 << 2,
+    /**
+     * @brief Declares, that the transaction will only read. Engines may skip
+     * tracking its reads altogether, as if every read was issued with
+     * `::ukv_option_transaction_dont_watch_k`, and reject its writes.
+     * Saves the bookkeeping in long analytical transactions.
+     */
+    ukv_option_transaction_read_only_k = 1 << 3,
     /**
      * @brief On every API call, the arena is cleared for reuse.
      * If the arguments of the function are results of another UKV call,
@@ -199,8 +206,20 @@ typedef enum {
      * and may include irrelevant (deleted & duplicate) keys in order to maximize
      * throughput. The purpose is not accelerating the `ukv_scan()`, but the
      * following `ukv_read()`. Generally used for Machine Learning applications.
+     * When passed to `ukv_scan()`, the engines read ahead and bypass the block cache.
+     * To scan in parallel and out of order, use `ukv_scan_bulk_init()`.
      */
-    ukv_option_scan_bulk_k = 0, // TODO
+    ukv_option_scan_bulk_k = 1 << 6,
+    /**
+     * @brief Makes the transaction lock the keys it reads and writes,
+     * blocking other pessimistic transactions, instead of failing on commit.
+     * Helps with highly contended keys, where optimistic transactions abort
+     * and retry in storms. Locks are held until the transaction is committed,
+     * reset or freed. Deadlocks are detected and fail the blocked call.
+     * Only individual keys are locked. Scans take no range locks, so others
+     * may insert into a scanned range, and repeating the scan shows such phantoms.
+     */
+    ukv_option_transaction_pessimistic_k = 1 << 7,
 
 } ukv_options_t;
 
@@ -492,6 +511,54 @@ typedef struct ukv_database_control_t {
  */
 void ukv_database_control(ukv_database_control_t*);
 
+/**
+ * @brief Exports the counters and latency histograms of every entry point.
+ * @see `ukv_metrics()`.
+ *
+ * Collection is off by default, as it costs two clock reads per call.
+ * It can be enabled with this call or with the "UKV_METRICS" environment variable.
+ * Metrics are shared by all the databases in the process, and are labeled
+ * by operation, like "read" or "docs_gather", and by layer:
+ *
+ * - "api":    Time spent in the `ukv_*` entry points, including the engine.
+ * - "engine": Time spent in the underlying engine alone, like RocksDB.
+ * - "memory": Chunks allocated by the arenas.
+ *
+ * Every operation reports its number of calls and errors, the bytes it has
+ * exported or imported, and its 50th, 90th, 99th and 99.9th latency percentiles.
+ *
+ * Builds with the `UKV_ENABLE_TRACING` CMake option also record nested spans
+ * of every call, including the internal round trips, like a graph upsert
+ * reading and writing the adjacency lists. The latest spans of every thread
+ * can be exported in the Chrome Trace Event format for "ui.perfetto.dev".
+ */
+typedef struct ukv_metrics_t {
+    /** @brief Already open database instance. */
+    ukv_database_t db;
+    /** @brief Pointer to exported error message. */
+    ukv_error_t* error;
+    /** @brief Reusable memory handle. */
+    ukv_arena_t* arena;
+    /** @brief Whether to collect metrics after this call. */
+    bool collect;
+    /**
+     * @brief Optional output of the Prometheus text exposition format,
+     * as a NULL-terminated string. Can be NULL, to only toggle the collection.
+     */
+    ukv_str_view_t* prometheus;
+    /**
+     * @brief Optional output of the Chrome Trace Event JSON, as a NULL-terminated string.
+     * Contains no events, unless built with `UKV_ENABLE_TRACING`.
+     */
+    ukv_str_view_t* chrome_trace;
+} ukv_metrics_t;
+
+/**
+ * @brief Exports the counters and latency histograms of every entry point.
+ * @see `ukv_metrics_t`.
+ */
+void ukv_metrics(ukv_metrics_t*);
+
 /*********************************************************/
 /*****************		Transactions	  ****************/
 /*********************************************************/
@@ -512,11 +579,19 @@ typedef struct ukv_transaction_init_t {
      *
      * Possible values:
      * - `::ukv_option_dont_discard_memory_k`: Won't reset the `arena` before the operation begins.
+     * - `::ukv_option_transaction_pessimistic_k`: Locks the keys instead of validating them on commit.
+     * - `::ukv_option_transaction_read_only_k`: Won't track the reads and will reject the writes.
      */
     ukv_options_t options;
 
     /** @brief In-out transaction handle. */
     ukv_transaction_t* transaction;
+
+    /**
+     * @brief Milliseconds, a pessimistic transaction may wait for a single key lock.
+     * Zero means the default of one second.
+     */
+    ukv_size_t lock_timeout;
 } ukv_transaction_init_t;
 
 /**
@@ -593,6 +668,47 @@ void ukv_transaction_commit(ukv_transaction_commit_t*);
  */
 void ukv_arena_free(ukv_arena_t);
 
+/**
+ * @brief Memory usage of a single arena.
+ * @see `ukv_arena_stats()`.
+ */
+typedef struct ukv_arena_stats_t {
+    /** @brief Bytes reserved by all the chunks of the arena. */
+    ukv_size_t capacity;
+    /** @brief Bytes handed out by the arena since its last reset. */
+    ukv_size_t used;
+    /** @brief The largest `capacity` the arena has ever reached. */
+    ukv_size_t peak_capacity;
+    /** @brief Number of chunks the arena holds. */
+    ukv_size_t chunks;
+    /** @brief Cap on the `capacity`, set with `ukv_arena_limit()`, or zero. */
+    ukv_size_t limit;
+    /** @brief Bytes of released chunks, kept by the process for reuse by any arena. */
+    ukv_size_t pooled;
+} ukv_arena_stats_t;
+
+/**
+ * @brief Exports the memory usage of an arena.
+ * Passing NULL arenas is safe and reports zero usage.
+ */
+void ukv_arena_stats(ukv_arena_t, ukv_arena_stats_t*);
+
+/**
+ * @brief Caps the total capacity of an arena, allocating it, if needed.
+ * Calls, that would need more memory, fail with an "out of memory" error,
+ * leaving the arena intact. The first chunk of 1 MB is always allowed.
+ * Passing zero removes the limit.
+ */
+void ukv_arena_limit(ukv_arena_t*, ukv_size_t limit, ukv_error_t*);
+
+/**
+ * @brief Releases all, but the first chunk of an arena, discarding the
+ * data exported into it. Chunks return into a process-wide pool, shared
+ * by all arenas, which frees them beyond the "UKV_ARENA_POOL_BYTES" limit.
+ * Passing NULLs is safe.
+ */
+void ukv_arena_trim(ukv_arena_t);
+
 /**
  * @brief Resets the transaction and deallocates the underlying memory.
  * Passing NULLs is safe.
@@ -0,0 +1,120 @@
+/**
+ * @file flight.h
+ * @author Ashot Vardanian
+ * @addtogroup C
+ *
+ * @brief Extensions of the Binary Interface, specific to the Apache Arrow Flight client.
+ *
+ * ## Coalescing Reads
+ *
+ * Remote calls are expensive, so many small concurrent `ukv_read()`-s from
+ * different threads are better sent as one batch. If the connection URI has
+ * a "coalesce" parameter, like "grpc://0.0.0.0:38709?coalesce=20", reads of up
+ * to 256 keys wait for that many microseconds for other reads to join them.
+ * Then one `DoExchange` call serves the whole batch, and its results are scattered
+ * back into the arenas of every caller. Reads submitted with `ukv_read_async()`
+ * go through the same queue, whether the window is set or not, while
+ * `ukv_write_async()` calls are sent from a shared pool of threads.
+ *
+ * ## Follower Reads
+ *
+ * When connecting to a read replica, a "max_staleness" parameter in milliseconds,
+ * like "grpc://0.0.0.0:38710?max_staleness=100", makes reads and scans fail,
+ * unless the replica has been fully caught up with its primary within that time.
+ *
+ * ## Streaming Scans
+ *
+ * Exporting a big range with `ukv_scan()` materializes all of it at once, on both
+ * sides of the connection. `ukv_scan_stream()` instead returns an Arrow C Stream,
+ * which pulls the range from the server one batch at a time.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ukv/blobs.h"
+
+struct ArrowArrayStream;
+
+/**
+ * @brief Streams a range of a collection as a sequence of Arrow record batches.
+ * @see `ukv_scan_stream()`.
+ *
+ * Every batch has a "keys" column and, if `values` are requested, a "vals" column.
+ * Batches are independent from each other and from any arena: they stay valid
+ * until released, even after the stream itself is released.
+ */
+typedef struct ukv_scan_stream_t {
+
+    /// @name Context
+    /// @{
+
+    /** @brief Already open database instance. */
+    ukv_database_t db;
+    /**
+     * @brief Pointer to exported error message.
+     * If not NULL, must be deallocated with `ukv_error_free()`.
+     */
+    ukv_error_t* error;
+    /**
+     * @brief The transaction in which the operation will be watched.
+     * @see `ukv_transaction_init()`, `ukv_transaction_commit()`, `ukv_transaction_free()`.
+     */
+    ukv_transaction_t transaction;
+    /**
+     * @brief A snapshot captures a point-in-time view of the DB at the time it's created.
+     * @see `ukv_snapshot_list()`, `ukv_snapshot_create()`, `ukv_snapshot_drop()`.
+     */
+    ukv_snapshot_t snapshot;
+    /**
+     * @brief Scan options.
+     *
+     * Possible values:
+     * - `::ukv_option_transaction_dont_watch_k`: Disables collision-detection for transactional reads.
+     */
+    ukv_options_t options;
+
+    /// @}
+    /// @name Inputs
+    /// @{
+
+    /**
+     * @brief The collection to scan.
+     * If `0`, the default collection is assumed.
+     */
+    ukv_collection_t collection;
+    /** @brief Inclusive lower bound of the range. */
+    ukv_key_t start_key;
+    /** @brief Maximum number of entries to export. If `0`, the whole range is exported. */
+    ukv_length_t count_limit;
+    /** @brief Maximum number of entries in every batch. If `0`, the server default is used. */
+    ukv_length_t batch_size;
+    /** @brief Whether to export values alongside the keys. */
+    bool values;
+
+    /// @}
+    /// @name Outputs
+    /// @{
+
+    /**
+     * @brief Output stream, that must be released with its own `release` callback.
+     * @see https://arrow.apache.org/docs/format/CStreamInterface.html
+     */
+    struct ArrowArrayStream* stream;
+
+    /// @}
+
+} ukv_scan_stream_t;
+
+/**
+ * @brief Starts a streaming scan, that fetches batches lazily, as they are consumed.
+ * @see `ukv_scan_stream_t`.
+ */
+void ukv_scan_stream(ukv_scan_stream_t*);
+
+#ifdef __cplusplus
+} /* end extern "C" */
+#endif
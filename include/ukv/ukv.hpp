@@ -11,3 +11,4 @@
 
 #pragma once
 #include "ukv/cpp/db.hpp"
+#include "ukv/cpp/async.hpp"
@@ -0,0 +1,130 @@
+/**
+ * @file pagerank.cpp
+ * @author Ashot Vardanian
+ *
+ * @brief PageRank with power iterations, matching the defaults of `networkx.pagerank`.
+ *
+ * The adjacency is pulled from the graph collection once, in batches of vertices,
+ * and compacted into a Compressed Sparse Row matrix with 32-bit indices.
+ * Iterations then run entirely in memory, never touching the engine.
+ */
+#include <vector>    // `std::vector`
+#include <algorithm> // `std::lower_bound`
+#include <cmath>     // `std::abs`
+#include <cstdint>   // `std::uint32_t`
+#include <limits>    // `std::numeric_limits`
+#include <stdexcept> // `std::runtime_error`
+
+#include "ukv/ukv.hpp"
+
+using namespace unum::ukv;
+using namespace unum;
+
+static constexpr std::size_t compress_batch_k = 4096;
+
+/**
+ * @brief Outgoing edges of every vertex, addressed by the index of the vertex in `vertices`.
+ * Edges of undirected graphs are present in both directions.
+ */
+struct compressed_graph_t {
+    std::vector<ukv_key_t> vertices;
+    std::vector<std::size_t> offsets;
+    std::vector<std::uint32_t> targets;
+
+    std::size_t size() const noexcept { return vertices.size(); }
+    std::size_t out_degree(std::size_t i) const noexcept { return offsets[i + 1] - offsets[i]; }
+};
+
+inline compressed_graph_t compress(graph_collection_t& graph, bool directed) noexcept(false) {
+
+    compressed_graph_t result;
+    auto stream = graph.vertex_stream().throw_or_release();
+    while (!stream.is_end()) {
+        auto batch = stream.keys_batch();
+        result.vertices.insert(result.vertices.end(), batch.begin(), batch.end());
+        stream.seek_to_next_batch().throw_unhandled();
+    }
+    if (result.vertices.size() > std::numeric_limits<std::uint32_t>::max())
+        throw std::runtime_error("Graph is too large for in-memory PageRank");
+
+    auto index_of = [&](ukv_key_t vertex) {
+        auto it = std::lower_bound(result.vertices.begin(), result.vertices.end(), vertex);
+        return static_cast<std::uint32_t>(it - result.vertices.begin());
+    };
+
+    // Every stored edge is listed exactly once among the outgoing edges of its source
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> links;
+    ukv_vertex_role_t const role = ukv_vertex_source_k;
+    for (std::size_t offset = 0; offset < result.size(); offset += compress_batch_k) {
+        std::size_t count = std::min(compress_batch_k, result.size() - offset);
+        strided_range_gt<ukv_key_t const> batch {{result.vertices.data() + offset, sizeof(ukv_key_t)}, count};
+        strided_range_gt<ukv_vertex_role_t const> roles {{&role, 0}, count};
+        edges_span_t edges = graph.edges_containing(batch, roles, false).throw_or_release();
+        for (std::size_t i = 0; i != edges.size(); ++i) {
+            std::uint32_t source = index_of(edges.source_ids[i]);
+            std::uint32_t target = index_of(edges.target_ids[i]);
+            links.emplace_back(source, target);
+            if (!directed && source != target)
+                links.emplace_back(target, source);
+        }
+    }
+
+    result.offsets.assign(result.size() + 1, 0);
+    for (auto link : links)
+        ++result.offsets[link.first + 1];
+    for (std::size_t i = 0; i != result.size(); ++i)
+        result.offsets[i + 1] += result.offsets[i];
+
+    std::vector<std::size_t> filled(result.offsets.begin(), result.offsets.end() - 1);
+    result.targets.resize(links.size());
+    for (auto link : links)
+        result.targets[filled[link.first]++] = link.second;
+    return result;
+}
+
+/**
+ * @brief Computes the PageRank of every vertex, following `networkx.pagerank`:
+ * the mass of dangling vertices is spread uniformly, and the iterations stop,
+ * once the L1 change of ranks drops below `size * tolerance`.
+ * @return Ranks, aligned with `graph.vertices`.
+ */
+inline std::vector<double> pagerank( //
+    compressed_graph_t const& graph,
+    double alpha,
+    std::size_t max_iterations,
+    double tolerance) noexcept(false) {
+
+    std::size_t const count = graph.size();
+    if (!count)
+        return {};
+
+    std::vector<double> ranks(count, 1.0 / count);
+    std::vector<double> last(count);
+    for (std::size_t iteration = 0; iteration != max_iterations; ++iteration) {
+        std::swap(ranks, last);
+
+        double dangling_mass = 0;
+        for (std::size_t i = 0; i != count; ++i)
+            if (!graph.out_degree(i))
+                dangling_mass += last[i];
+
+        double const base = (alpha * dangling_mass + 1.0 - alpha) / count;
+        std::fill(ranks.begin(), ranks.end(), base);
+        for (std::size_t i = 0; i != count; ++i) {
+            std::size_t degree = graph.out_degree(i);
+            if (!degree)
+                continue;
+            double share = alpha * last[i] / degree;
+            for (std::size_t j = graph.offsets[i]; j != graph.offsets[i + 1]; ++j)
+                ranks[graph.targets[j]] += share;
+        }
+
+        double error = 0;
+        for (std::size_t i = 0; i != count; ++i)
+            error += std::abs(ranks[i] - last[i]);
+        if (error < count * tolerance)
+            return ranks;
+    }
+
+    throw std::runtime_error("PageRank failed to converge in the given number of iterations");
+}
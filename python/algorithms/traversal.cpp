@@ -0,0 +1,140 @@
+/**
+ * @file traversal.cpp
+ * @author Ashot Vardanian
+ *
+ * @brief Breadth-First Search and unweighted shortest paths.
+ *
+ * Instead of visiting vertices one by one, the whole frontier is expanded at once:
+ * the edges of up to `frontier_batch_k` vertices are fetched in a single
+ * `ukv_graph_find_edges` call, amortizing the cost of every round-trip to the engine.
+ */
+#include <unordered_map> // `std::unordered_map`
+#include <unordered_set> // `std::unordered_set`
+#include <vector>        // `std::vector`
+#include <algorithm>     // `std::reverse`
+#include <limits>        // `std::numeric_limits`
+
+#include "ukv/ukv.hpp"
+
+using namespace unum::ukv;
+using namespace unum;
+
+static constexpr std::size_t frontier_batch_k = 4096;
+static constexpr std::size_t unlimited_depth_k = std::numeric_limits<std::size_t>::max();
+
+/**
+ * @brief Role of the frontier vertices in the edges, that lead to their neighbors.
+ */
+inline ukv_vertex_role_t traversal_role(bool directed) noexcept {
+    return directed ? ukv_vertex_source_k : ukv_vertex_role_any_k;
+}
+
+/**
+ * @brief Visits the vertices reachable from `sources` layer by layer, up to `depth_limit`.
+ * Calls `on_discovered(parent, child)` for every newly reached vertex. If the callback
+ * returns `false`, the search stops. The `layers` receive the vertices of every level.
+ *
+ * Every fetched edge has one endpoint in the frontier. In undirected graphs it may come
+ * in either order, so the endpoint, that wasn't visited yet, is the discovered one.
+ */
+template <typename callback_at>
+void bfs_layers(graph_collection_t& graph,
+                std::vector<ukv_key_t> sources,
+                ukv_vertex_role_t role,
+                std::size_t depth_limit,
+                std::vector<std::vector<ukv_key_t>>& layers,
+                callback_at&& on_discovered) noexcept(false) {
+
+    auto presences = graph.contains({{sources.data(), sizeof(ukv_key_t)}, sources.size()}).throw_or_release();
+    for (std::size_t i = 0; i != sources.size(); ++i)
+        if (!presences[i])
+            throw std::invalid_argument("Source node is not in the graph");
+
+    std::unordered_set<ukv_key_t> visited(sources.begin(), sources.end());
+    sources.assign(visited.begin(), visited.end());
+    layers.push_back(std::move(sources));
+
+    for (std::size_t depth = 0; depth != depth_limit; ++depth) {
+        std::vector<ukv_key_t> const& frontier = layers.back();
+        std::vector<ukv_key_t> next;
+        for (std::size_t offset = 0; offset < frontier.size(); offset += frontier_batch_k) {
+            std::size_t count = std::min(frontier_batch_k, frontier.size() - offset);
+            strided_range_gt<ukv_key_t const> batch {{frontier.data() + offset, sizeof(ukv_key_t)}, count};
+            strided_range_gt<ukv_vertex_role_t const> roles {{&role, 0}, count};
+            edges_span_t edges = graph.edges_containing(batch, roles, false).throw_or_release();
+
+            for (std::size_t i = 0; i != edges.size(); ++i) {
+                ukv_key_t source = edges.source_ids[i];
+                ukv_key_t target = edges.target_ids[i];
+                bool proceed = true;
+                if (visited.insert(target).second)
+                    next.push_back(target), proceed = on_discovered(source, target);
+                else if (visited.insert(source).second)
+                    next.push_back(source), proceed = on_discovered(target, source);
+                if (!proceed) {
+                    layers.push_back(std::move(next));
+                    return;
+                }
+            }
+        }
+
+        if (next.empty())
+            break;
+        layers.push_back(std::move(next));
+    }
+}
+
+/**
+ * @brief Distances from the `source` to every reachable vertex, not farther than `cutoff`.
+ */
+inline std::unordered_map<ukv_key_t, std::size_t> single_source_shortest_path_length( //
+    graph_collection_t& graph,
+    ukv_key_t source,
+    bool directed,
+    std::size_t cutoff = unlimited_depth_k) noexcept(false) {
+
+    std::vector<std::vector<ukv_key_t>> layers;
+    bfs_layers(graph, {source}, traversal_role(directed), cutoff, layers, [](ukv_key_t, ukv_key_t) { return true; });
+
+    std::unordered_map<ukv_key_t, std::size_t> distances;
+    for (std::size_t depth = 0; depth != layers.size(); ++depth)
+        for (ukv_key_t vertex : layers[depth])
+            distances.emplace(vertex, depth);
+    return distances;
+}
+
+/**
+ * @brief One of the shortest paths from `source` to `target`, including both.
+ * The search stops as soon as the `target` is reached. Is empty, if there is no path.
+ */
+inline std::vector<ukv_key_t> shortest_path( //
+    graph_collection_t& graph,
+    ukv_key_t source,
+    ukv_key_t target,
+    bool directed) noexcept(false) {
+
+    if (source == target) {
+        if (!graph.contains(source).throw_or_release())
+            throw std::invalid_argument("Source node is not in the graph");
+        return {source};
+    }
+
+    bool found = false;
+    std::vector<std::vector<ukv_key_t>> layers;
+    std::unordered_map<ukv_key_t, ukv_key_t> parents;
+    auto on_discovered = [&](ukv_key_t parent, ukv_key_t child) {
+        parents.emplace(child, parent);
+        return !(found = child == target);
+    };
+    bfs_layers(graph, {source}, traversal_role(directed), unlimited_depth_k, layers, on_discovered);
+
+    std::vector<ukv_key_t> path;
+    if (!found)
+        return path;
+
+    for (ukv_key_t vertex = target; vertex != source; vertex = parents[vertex])
+        path.push_back(vertex);
+    path.push_back(source);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
@@ -1,10 +1,13 @@
 
 #pragma once
-#include <vector> // `std::vector`
+#include <vector>  // `std::vector`
+#include <memory>  // `std::shared_ptr`
+#include <utility> // `std::exchange`
 
 #include <pybind11/pybind11.h> // `gil_scoped_release`
 #include <Python.h>            // `PyObject`
 #include <arrow/array.h>
+#include <arrow/buffer.h>
 #include <arrow/python/pyarrow.h>
 
 #include "ukv/ukv.h"
@@ -20,6 +23,49 @@ struct py_bin_req_t {
     ukv_length_t len {0};
 };
 
+/**
+ * @brief Arena, taken away from a collection after a read, so that the
+ * exported NumPy and PyArrow views stay valid, when the next call resets
+ * the collection's own arena. Its chunks return to the process-wide pool,
+ * once the last Python object referencing them is garbage collected.
+ */
+struct pinned_arena_t {
+    ukv_arena_t memory {nullptr};
+
+    pinned_arena_t(ukv_arena_t* arena) noexcept : memory(std::exchange(*arena, nullptr)) {}
+    pinned_arena_t(pinned_arena_t const&) = delete;
+    pinned_arena_t& operator=(pinned_arena_t const&) = delete;
+    ~pinned_arena_t() noexcept { ukv_arena_free(memory); }
+};
+
+using pinned_arena_ptr_t = std::shared_ptr<pinned_arena_t>;
+
+/**
+ * @brief Arrow buffer, aliasing the memory of a `pinned_arena_t`.
+ */
+class pinned_buffer_t final : public arrow::Buffer {
+    pinned_arena_ptr_t arena_;
+
+  public:
+    pinned_buffer_t(pinned_arena_ptr_t arena, void const* data, int64_t size) noexcept
+        : arrow::Buffer(reinterpret_cast<uint8_t const*>(data), size), arena_(std::move(arena)) {}
+};
+
+inline std::shared_ptr<arrow::Buffer> pinned_buffer(pinned_arena_ptr_t const& arena, void const* data, int64_t size) {
+    return std::make_shared<pinned_buffer_t>(arena, data, size);
+}
+
+/**
+ * @brief Wraps arena memory into a NumPy array without copies.
+ * The capsule, passed as the `base` object, holds the arena alive.
+ */
+template <typename scalar_at>
+py::array_t<scalar_at> pinned_array(pinned_arena_ptr_t const& arena, scalar_at const* data, std::size_t count) {
+    auto owner = new pinned_arena_ptr_t(arena);
+    py::capsule base(owner, [](void* ptr) { delete reinterpret_cast<pinned_arena_ptr_t*>(ptr); });
+    return py::array_t<scalar_at>(count, data, base);
+}
+
 #pragma region Writes
 
 /**
@@ -257,16 +303,11 @@ static py::object read_many_binaries(py_blobs_collection_t& collection, PyObject
     }
 
     if (export_arrow) {
+        auto arena = std::make_shared<pinned_arena_t>(collection.member_arena());
         auto shared_length = static_cast<int64_t>(places.count);
-        auto shared_offsets = std::make_shared<arrow::Buffer>( //
-            reinterpret_cast<uint8_t*>(found_offsets),
-            (shared_length + 1) * sizeof(ukv_length_t));
-        auto shared_data = std::make_shared<arrow::Buffer>( //
-            reinterpret_cast<uint8_t*>(found_values),
-            static_cast<int64_t>(found_offsets[places.count]));
-        auto shared_bitmap = std::make_shared<arrow::Buffer>( //
-            reinterpret_cast<uint8_t*>(found_presences),
-            divide_round_up<int64_t>(shared_length, CHAR_BIT));
+        auto shared_offsets = pinned_buffer(arena, found_offsets, (shared_length + 1) * sizeof(ukv_length_t));
+        auto shared_data = pinned_buffer(arena, found_values, static_cast<int64_t>(found_offsets[places.count]));
+        auto shared_bitmap = pinned_buffer(arena, found_presences, divide_round_up<int64_t>(shared_length, CHAR_BIT));
         auto shared = std::make_shared<arrow::BinaryArray>(shared_length, shared_offsets, shared_data, shared_bitmap);
         PyObject* obj_ptr = arrow::py::wrap_array(std::static_pointer_cast<arrow::Array>(shared));
         return py::reinterpret_steal<py::object>(obj_ptr);
@@ -377,18 +418,17 @@ static py::array_t<ukv_key_t> scan_binary( //
 
     status.throw_unhandled();
 
+    auto arena = std::make_shared<pinned_arena_t>(collection.member_arena());
     if (export_arrow) {
         auto shared_length = static_cast<int64_t>(found_lengths[0]);
-        auto shared_data = std::make_shared<arrow::Buffer>( //
-            reinterpret_cast<uint8_t*>(found_keys),
-            shared_length * sizeof(ukv_key_t));
+        auto shared_data = pinned_buffer(arena, found_keys, shared_length * sizeof(ukv_key_t));
         static_assert(std::is_same_v<ukv_key_t, int64_t>, "Change the following line!");
         auto shared = std::make_shared<arrow::NumericArray<arrow::Int64Type>>(shared_length, shared_data);
         PyObject* obj_ptr = arrow::py::wrap_array(std::static_pointer_cast<arrow::Array>(shared));
         return py::reinterpret_steal<py::object>(obj_ptr);
     }
     else
-        return py::array_t<ukv_key_t>(found_lengths[0], found_keys);
+        return pinned_array(arena, found_keys, found_lengths[0]);
 }
 
 template <typename collection_at>
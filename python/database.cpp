@@ -66,6 +66,24 @@ range_at& until(range_at& range, ukv_key_t key) {
     return range;
 }
 
+template <typename range_at>
+std::vector<range_at> split(range_at& range, std::size_t count) {
+    arena_t arena(range.members.db());
+    ptr_range_gt<ukv_key_t> boundaries = range.members.split(count, arena.member_ptr()).throw_or_release();
+
+    // Boundaries are half-open, while Python ranges end with an inclusive key.
+    std::vector<range_at> parts;
+    parts.reserve(count);
+    for (std::size_t i = 0; i != count; ++i) {
+        range_at part = range;
+        part.members.since(boundaries[i]);
+        if (i + 1 != count)
+            part.members.until(boundaries[i + 1] - 1);
+        parts.push_back(std::move(part));
+    }
+    return parts;
+}
+
 py::object sample(py_blobs_collection_t& py_collection, std::size_t count) {
     blobs_range_t members(py_collection.db(), py_collection.txn(), *py_collection.member_collection());
     keys_range_t range {members};
@@ -292,6 +310,8 @@ void ukv::wrap_database(py::module& m) {
     py_kvrange.def("__iter__", &iterate<pairs_range_t>);
     py_kvrange.def("since", &since<pairs_range_t>);
     py_kvrange.def("until", &until<pairs_range_t>);
+    py_krange.def("split", &split<keys_range_t>, py::arg("count"));
+    py_kvrange.def("split", &split<pairs_range_t>, py::arg("count"));
 
     // Using slices on the keys view is too cumbersome!
     // It's never clear if we want a range of IDs or offsets.
@@ -310,7 +330,7 @@ void ukv::wrap_database(py::module& m) {
 
     py_kstream.def("__next__", [](py_kstream_t& kstream) {
         ukv_key_t key = kstream.native.key();
-        if (kstream.native.is_end() || kstream.stop)
+        if (kstream.native.is_end() || kstream.stop || key > kstream.terminal)
             throw py::stop_iteration();
         kstream.stop = kstream.terminal == key;
         ++kstream.native;
@@ -318,7 +338,7 @@ void ukv::wrap_database(py::module& m) {
     });
     py_kvstream.def("__next__", [](py_kvstream_t& kvstream) {
         ukv_key_t key = kvstream.native.key();
-        if (kvstream.native.is_end() || kvstream.stop)
+        if (kvstream.native.is_end() || kvstream.stop || key > kvstream.terminal)
             throw py::stop_iteration();
         kvstream.stop = kvstream.terminal == key;
         value_view_t value_view = kvstream.native.value();
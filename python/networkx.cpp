@@ -5,6 +5,8 @@
 #include "nlohmann.hpp"
 #include "cast_args.hpp"
 #include "algorithms/louvain.cpp"
+#include "algorithms/traversal.cpp"
+#include "algorithms/pagerank.cpp"
 
 using namespace unum::ukv::pyb;
 using namespace unum::ukv;
@@ -289,6 +291,20 @@ py::object wrap_into_buffer(py_graph_t& g, strided_range_gt<element_at> range) {
     return py::reinterpret_steal<py::object>(obj);
 }
 
+/**
+ * @brief Graph handle with a private arena, so that algorithms can run without
+ * the GIL, while Python threads keep using the shared arena of the `py_graph_t`.
+ */
+graph_collection_t detached_ref(py_graph_t& g) {
+    return graph_collection_t(g.index.db(), g.index, g.index.txn(), g.index.snap());
+}
+
+std::vector<ukv_key_t> keys_from_py(py::handle keys_py) {
+    if (!PySequence_Check(keys_py.ptr()))
+        return {py_to_scalar<ukv_key_t>(keys_py.ptr())};
+    return py::cast<std::vector<ukv_key_t>>(keys_py);
+}
+
 void ukv::wrap_networkx(py::module& m) {
 
     auto degs = py::class_<degree_view_t>(m, "DegreeView", py::module_local());
@@ -1016,6 +1032,112 @@ void ukv::wrap_networkx(py::module& m) {
         return 0.0;
     });
 
+    // Traversals and Centrality, running natively without the GIL
+    // https://networkx.org/documentation/stable/reference/algorithms/traversal.html
+    // https://networkx.org/documentation/stable/reference/algorithms/shortest_paths.html
+    // https://networkx.org/documentation/stable/reference/algorithms/link_analysis.html
+    m.def(
+        "bfs_layers",
+        [](py_graph_t& g, py::object sources_py) {
+            std::vector<ukv_key_t> sources = keys_from_py(sources_py);
+            std::vector<std::vector<ukv_key_t>> layers;
+            {
+                [[maybe_unused]] py::gil_scoped_release release;
+                graph_collection_t graph = detached_ref(g);
+                auto role = traversal_role(g.is_directed);
+                auto ignore = [](ukv_key_t, ukv_key_t) { return true; };
+                bfs_layers(graph, std::move(sources), role, unlimited_depth_k, layers, ignore);
+            }
+            return py::cast(layers);
+        },
+        py::arg("G"),
+        py::arg("sources"),
+        "Returns the lists of nodes at every distance from the sources.");
+    m.def(
+        "single_source_shortest_path_length",
+        [](py_graph_t& g, ukv_key_t source, std::optional<std::size_t> cutoff) {
+            std::unordered_map<ukv_key_t, std::size_t> distances;
+            {
+                [[maybe_unused]] py::gil_scoped_release release;
+                graph_collection_t graph = detached_ref(g);
+                distances = single_source_shortest_path_length(graph,
+                                                               source,
+                                                               g.is_directed,
+                                                               cutoff.value_or(unlimited_depth_k));
+            }
+            return py::cast(distances);
+        },
+        py::arg("G"),
+        py::arg("source"),
+        py::arg("cutoff") = std::nullopt,
+        "Returns the number of hops from the source to every reachable node.");
+    m.def(
+        "shortest_path",
+        [](py_graph_t& g, ukv_key_t source, ukv_key_t target) {
+            std::vector<ukv_key_t> path;
+            {
+                [[maybe_unused]] py::gil_scoped_release release;
+                graph_collection_t graph = detached_ref(g);
+                path = shortest_path(graph, source, target, g.is_directed);
+            }
+            if (path.empty())
+                throw std::runtime_error("No path between the nodes");
+            return py::cast(path);
+        },
+        py::arg("G"),
+        py::arg("source"),
+        py::arg("target"),
+        "Returns the nodes along one of the shortest unweighted paths.");
+    m.def(
+        "shortest_path_length",
+        [](py_graph_t& g, ukv_key_t source, ukv_key_t target) {
+            std::vector<ukv_key_t> path;
+            {
+                [[maybe_unused]] py::gil_scoped_release release;
+                graph_collection_t graph = detached_ref(g);
+                path = shortest_path(graph, source, target, g.is_directed);
+            }
+            if (path.empty())
+                throw std::runtime_error("No path between the nodes");
+            return path.size() - 1;
+        },
+        py::arg("G"),
+        py::arg("source"),
+        py::arg("target"),
+        "Returns the number of hops along the shortest unweighted path.");
+    m.def(
+        "has_path",
+        [](py_graph_t& g, ukv_key_t source, ukv_key_t target) {
+            [[maybe_unused]] py::gil_scoped_release release;
+            graph_collection_t graph = detached_ref(g);
+            return !shortest_path(graph, source, target, g.is_directed).empty();
+        },
+        py::arg("G"),
+        py::arg("source"),
+        py::arg("target"),
+        "Checks if the target is reachable from the source.");
+    m.def(
+        "pagerank",
+        [](py_graph_t& g, double alpha, std::size_t max_iter, double tol) {
+            compressed_graph_t compressed;
+            std::vector<double> ranks;
+            {
+                [[maybe_unused]] py::gil_scoped_release release;
+                graph_collection_t graph = detached_ref(g);
+                compressed = compress(graph, g.is_directed);
+                ranks = pagerank(compressed, alpha, max_iter, tol);
+            }
+            py::dict result;
+            for (std::size_t i = 0; i != ranks.size(); ++i)
+                result[py::int_(compressed.vertices[i])] = py::float_(ranks[i]);
+            return result;
+        },
+        py::arg("G"),
+        py::arg("alpha") = 0.85,
+        py::arg("max_iter") = 100,
+        py::arg("tol") = 1.0e-6,
+        "Returns the PageRank of every node, ignoring edge weights.");
+
     // Reading and Writing Graphs
     // https://networkx.org/documentation/stable/reference/readwrite/
     // https://networkx.org/documentation/stable/reference/readwrite/adjlist.html
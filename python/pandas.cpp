@@ -1,3 +1,9 @@
+#include <thread>    // `std::thread`
+#include <atomic>    // `std::atomic`
+#include <mutex>     // `std::mutex`
+#include <numeric>   // `std::iota`
+#include <exception> // `std::exception_ptr`
+
 #include <fmt/os.h>
 #include <fmt/format.h>
 
@@ -6,6 +12,7 @@
 #include <arrow/ipc/api.h>
 #include <arrow/c/bridge.h>
 #include <arrow/util/type_fwd.h>
+#include <arrow/util/bitmap_ops.h>
 #include <arrow/python/pyarrow.h>
 #include <parquet/arrow/writer.h>
 
@@ -254,6 +261,53 @@ void add_key_value<arrow::BinaryArray>( //
                    std::string_view(value.data(), value.size()));
 }
 
+/**
+ * @brief Serializes every row of the `record_batch` into a JSON object, appending them to `jsons`.
+ * The `offsets` receive the start of every object, followed by the end of the last one.
+ * @param skipped_column Index of a column to exclude, like the one holding the keys.
+ */
+static void rows_to_jsons(arrow::RecordBatch const& record_batch,
+                          std::string& jsons,
+                          std::vector<ukv_length_t>& offsets,
+                          int skipped_column = -1) {
+
+    for (size_t row_idx = 0; row_idx != record_batch.num_rows(); ++row_idx) {
+
+        offsets.push_back(static_cast<ukv_length_t>(jsons.size()));
+        jsons += "{";
+        for (int column_idx = 0; column_idx != record_batch.num_columns(); ++column_idx) {
+            if (column_idx == skipped_column)
+                continue;
+
+            std::string_view name = record_batch.column_name(column_idx);
+            std::shared_ptr<arrow::Array> array = record_batch.column(column_idx);
+
+            using type = arrow::Type;
+            switch (array->type_id()) {
+            case type::HALF_FLOAT: add_key_value<arrow::HalfFloatArray>(array, jsons, name, row_idx); break;
+            case type::FLOAT: add_key_value<arrow::FloatArray>(array, jsons, name, row_idx); break;
+            case type::DOUBLE: add_key_value<arrow::DoubleArray>(array, jsons, name, row_idx); break;
+            case type::BOOL: add_key_value<arrow::BooleanArray>(array, jsons, name, row_idx); break;
+            case type::UINT8: add_key_value<arrow::UInt8Array>(array, jsons, name, row_idx); break;
+            case type::INT8: add_key_value<arrow::Int8Array>(array, jsons, name, row_idx); break;
+            case type::UINT16: add_key_value<arrow::UInt16Array>(array, jsons, name, row_idx); break;
+            case type::INT16: add_key_value<arrow::Int16Array>(array, jsons, name, row_idx); break;
+            case type::UINT32: add_key_value<arrow::UInt32Array>(array, jsons, name, row_idx); break;
+            case type::INT32: add_key_value<arrow::Int32Array>(array, jsons, name, row_idx); break;
+            case type::UINT64: add_key_value<arrow::UInt64Array>(array, jsons, name, row_idx); break;
+            case type::INT64: add_key_value<arrow::Int64Array>(array, jsons, name, row_idx); break;
+            case type::STRING:
+            case type::BINARY: add_key_value<arrow::BinaryArray>(array, jsons, name, row_idx); break;
+            }
+        }
+        if (jsons.back() == ',')
+            jsons.back() = '}';
+        else
+            jsons += "}";
+    }
+    offsets.push_back(static_cast<ukv_length_t>(jsons.size()));
+}
+
 void update(py_table_collection_t& df, py::object obj) {
     if (!arrow::py::is_batch(obj.ptr()))
         throw std::invalid_argument("Expected Arrow Table!");
@@ -278,45 +332,257 @@ void update(py_table_collection_t& df, py::object obj) {
 
     std::string jsons_to_merge;
     jsons_to_merge.reserve(record_batch->num_rows() * (column_names_length + (record_batch->num_columns() * 3) + 2));
-    std::vector<ukv_length_t> offsets(keys.size() + 1);
+    std::vector<ukv_length_t> offsets;
+    offsets.reserve(keys.size() + 1);
+    rows_to_jsons(*record_batch, jsons_to_merge, offsets);
+    auto vals_begin = reinterpret_cast<ukv_bytes_ptr_t>(jsons_to_merge.data());
+    contents_arg_t values {};
+    values.offsets_begin = {offsets.data(), sizeof(ukv_length_t)};
+    values.contents_begin = {&vals_begin, 0};
 
-    for (size_t row_idx = 0; row_idx != record_batch->num_rows(); ++row_idx) {
+    collection[keys].merge(values);
+}
+
+#pragma region Parallel Ingestion
+
+/// Non-null address for the values of chunks with only empty strings, where Arrow may omit the buffer.
+static std::int64_t const zero_size_data_k[1] = {0};
+
+/**
+ * @brief Record batch of a table, being written, and the index of its first row.
+ */
+struct table_chunk_t {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    std::size_t first_row = 0;
+};
+
+/**
+ * @brief Imports a PyArrow table through the Arrow C Stream Interface, slicing
+ * it into record batches of at most `chunk_rows` rows. No data is copied.
+ * Pandas DataFrames and other objects, that `pyarrow.table` accepts, are converted first.
+ */
+static std::vector<table_chunk_t> import_chunks(py::handle table_py, std::size_t chunk_rows) {
+    py::module_ pa = py::module_::import("pyarrow");
+    py::object table = py::isinstance(table_py, pa.attr("Table")) ? py::reinterpret_borrow<py::object>(table_py)
+                                                                  : pa.attr("table")(table_py);
+
+    // https://arrow.apache.org/docs/format/CStreamInterface.html
+    ArrowArrayStream c_stream {};
+    py::object reader = table.attr("to_reader")(py::arg("max_chunksize") = chunk_rows);
+    reader.attr("_export_to_c")(reinterpret_cast<std::uintptr_t>(&c_stream));
+    auto maybe_reader = arrow::ImportRecordBatchReader(&c_stream);
+    if (!maybe_reader.ok())
+        throw std::runtime_error("Failed to import the table: " + maybe_reader.status().ToString());
+    auto maybe_batches = maybe_reader.ValueUnsafe()->ToRecordBatches();
+    if (!maybe_batches.ok())
+        throw std::runtime_error("Failed to read the table: " + maybe_batches.status().ToString());
+    auto batches = std::move(maybe_batches).ValueUnsafe();
+
+    std::vector<table_chunk_t> chunks(batches.size());
+    std::size_t first_row = 0;
+    for (std::size_t i = 0; i != batches.size(); ++i) {
+        chunks[i].first_row = first_row;
+        first_row += batches[i]->num_rows();
+        chunks[i].batch = std::move(batches[i]);
+    }
+    return chunks;
+}
 
-        offsets[row_idx] = jsons_to_merge.size();
-        jsons_to_merge += "{";
-        for (size_t column_idx = 0; column_idx != record_batch->num_columns(); ++column_idx) {
+/**
+ * @brief Keys of a chunk: either the `key_column`, or the global row indices, if it's empty.
+ * @return The index of the keys column or -1.
+ */
+static int chunk_keys(table_chunk_t const& chunk,
+                      std::string const& key_column,
+                      std::vector<ukv_key_t>& generated,
+                      ukv_key_t const*& keys) {
+
+    if (key_column.empty()) {
+        generated.resize(chunk.batch->num_rows());
+        std::iota(generated.begin(), generated.end(), static_cast<ukv_key_t>(chunk.first_row));
+        keys = generated.data();
+        return -1;
+    }
 
-            std::string_view name = record_batch->column_name(column_idx);
-            std::shared_ptr<arrow::Array> array = record_batch->column(column_idx);
+    int column_idx = chunk.batch->schema()->GetFieldIndex(key_column);
+    if (column_idx < 0)
+        throw std::invalid_argument("Missing keys column: " + key_column);
+    auto array = chunk.batch->column(column_idx);
+    static_assert(std::is_same_v<ukv_key_t, int64_t>, "Change the following line!");
+    if (array->type_id() != arrow::Type::INT64 || array->null_count())
+        throw std::invalid_argument("Keys column must contain non-null 64-bit integers");
+    keys = std::static_pointer_cast<arrow::Int64Array>(array)->raw_values();
+    return column_idx;
+}
 
-            using type = arrow::Type;
-            switch (array->type_id()) {
-            case type::HALF_FLOAT: add_key_value<arrow::HalfFloatArray>(array, jsons_to_merge, name, row_idx); break;
-            case type::FLOAT: add_key_value<arrow::FloatArray>(array, jsons_to_merge, name, row_idx); break;
-            case type::DOUBLE: add_key_value<arrow::DoubleArray>(array, jsons_to_merge, name, row_idx); break;
-            case type::BOOL: add_key_value<arrow::BooleanArray>(array, jsons_to_merge, name, row_idx); break;
-            case type::UINT8: add_key_value<arrow::UInt8Array>(array, jsons_to_merge, name, row_idx); break;
-            case type::INT8: add_key_value<arrow::Int8Array>(array, jsons_to_merge, name, row_idx); break;
-            case type::UINT16: add_key_value<arrow::UInt16Array>(array, jsons_to_merge, name, row_idx); break;
-            case type::INT16: add_key_value<arrow::Int16Array>(array, jsons_to_merge, name, row_idx); break;
-            case type::UINT32: add_key_value<arrow::UInt32Array>(array, jsons_to_merge, name, row_idx); break;
-            case type::INT32: add_key_value<arrow::Int32Array>(array, jsons_to_merge, name, row_idx); break;
-            case type::UINT64: add_key_value<arrow::UInt64Array>(array, jsons_to_merge, name, row_idx); break;
-            case type::INT64: add_key_value<arrow::Int64Array>(array, jsons_to_merge, name, row_idx); break;
-            case type::STRING:
-            case type::BINARY: add_key_value<arrow::BinaryArray>(array, jsons_to_merge, name, row_idx); break;
+/**
+ * @brief Calls `write_chunk(chunk, arena, status)` for every chunk on the
+ * given number of threads. The caller must release the GIL beforehand.
+ * Every thread uses its own arena. The first exception is rethrown at the end, preserving its type.
+ */
+template <typename write_chunk_at>
+static void write_chunks_parallel(std::vector<table_chunk_t> const& chunks,
+                                  std::size_t threads_count,
+                                  ukv_database_t db,
+                                  write_chunk_at&& write_chunk) {
+
+    std::atomic<std::size_t> next_chunk {0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto work = [&] {
+        try {
+            arena_t arena(db);
+            for (std::size_t i = next_chunk++; i < chunks.size(); i = next_chunk++) {
+                status_t status;
+                write_chunk(chunks[i], arena, status);
+                status.throw_unhandled();
             }
         }
-        jsons_to_merge.back() = '}';
-    }
+        catch (...) {
+            next_chunk = chunks.size();
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    threads_count = std::min(std::max<std::size_t>(threads_count, 1), chunks.size());
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count);
+    for (std::size_t i = 1; i < threads_count; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
 
-    offsets.back() = jsons_to_merge.size();
-    auto vals_begin = reinterpret_cast<ukv_bytes_ptr_t>(jsons_to_merge.data());
-    contents_arg_t values {};
-    values.offsets_begin = {offsets.data(), sizeof(ukv_length_t)};
-    values.contents_begin = {&vals_begin, 0};
+/**
+ * @brief Default number of writing threads: one per core, unless the collection
+ * belongs to a transaction, as those aren't safe to update concurrently.
+ */
+template <typename collection_at>
+static std::size_t writing_threads(py_collection_gt<collection_at>& collection, std::size_t threads_count) {
+    if (collection.in_txn)
+        return 1;
+    return threads_count ? threads_count : std::max(std::thread::hardware_concurrency(), 1u);
+}
 
-    collection[keys].merge(values);
+/**
+ * @brief Writes a binary or string `value_column` into a blobs collection. Every chunk is
+ * passed to `ukv_write` as is, as UKV and Arrow share the layout of variable-length arrays.
+ */
+static void write_blobs_table(py_blobs_collection_t& collection,
+                              py::handle table_py,
+                              std::string const& key_column,
+                              std::string const& value_column,
+                              std::size_t threads_count,
+                              std::size_t chunk_rows) {
+
+    std::vector<table_chunk_t> chunks = import_chunks(table_py, chunk_rows);
+    threads_count = writing_threads(collection, threads_count);
+
+    auto write_chunk = [&](table_chunk_t const& chunk, arena_t& arena, status_t& status) {
+        std::vector<ukv_key_t> generated_keys;
+        ukv_key_t const* keys = nullptr;
+        chunk_keys(chunk, key_column, generated_keys, keys);
+
+        auto array = chunk.batch->GetColumnByName(value_column);
+        if (!array)
+            throw std::invalid_argument("Missing values column: " + value_column);
+        if (array->type_id() != arrow::Type::BINARY && array->type_id() != arrow::Type::STRING)
+            throw std::invalid_argument("Values column must contain binary strings");
+
+        // Slices of the table may start in the middle of a byte of the validity bitmap
+        auto values = std::static_pointer_cast<arrow::BinaryArray>(array);
+        std::shared_ptr<arrow::Buffer> realigned_presences;
+        ukv_octet_t const* presences = nullptr;
+        if (values->null_count() && values->offset() % CHAR_BIT == 0)
+            presences = values->null_bitmap_data() + values->offset() / CHAR_BIT;
+        else if (values->null_count()) {
+            auto maybe_presences = arrow::internal::CopyBitmap( //
+                arrow::default_memory_pool(),
+                values->null_bitmap_data(),
+                values->offset(),
+                values->length());
+            if (!maybe_presences.ok())
+                throw std::runtime_error("Failed to realign the validity bitmap: " +
+                                         maybe_presences.status().ToString());
+            realigned_presences = std::move(maybe_presences).ValueUnsafe();
+            presences = realigned_presences->data();
+        }
+
+        static_assert(sizeof(ukv_length_t) == sizeof(arrow::BinaryArray::offset_type));
+        ukv_bytes_cptr_t contents = values->value_data() && values->value_data()->data()
+                                        ? values->value_data()->data()
+                                        : reinterpret_cast<ukv_bytes_cptr_t>(&zero_size_data_k);
+        ukv_write_t write {};
+        write.db = collection.db();
+        write.error = status.member_ptr();
+        write.transaction = collection.txn();
+        write.arena = arena.member_ptr();
+        write.options = collection.options();
+        write.tasks_count = static_cast<ukv_size_t>(chunk.batch->num_rows());
+        write.collections = collection.member_collection();
+        write.keys = keys;
+        write.keys_stride = sizeof(ukv_key_t);
+        write.presences = presences;
+        write.offsets = reinterpret_cast<ukv_length_t const*>(values->raw_value_offsets());
+        write.offsets_stride = sizeof(ukv_length_t);
+        write.values = &contents;
+        ukv_write(&write);
+    };
+
+    [[maybe_unused]] py::gil_scoped_release release;
+    write_chunks_parallel(chunks, threads_count, collection.db(), write_chunk);
+}
+
+/**
+ * @brief Writes every row as a separate document, with a field per column.
+ * Rows are serialized into JSON by the writing threads, without touching Python objects.
+ */
+static void write_docs_table(py_docs_collection_t& collection,
+                             py::handle table_py,
+                             std::string const& key_column,
+                             std::size_t threads_count,
+                             std::size_t chunk_rows) {
+
+    std::vector<table_chunk_t> chunks = import_chunks(table_py, chunk_rows);
+    threads_count = writing_threads(collection, threads_count);
+
+    auto write_chunk = [&](table_chunk_t const& chunk, arena_t& arena, status_t& status) {
+        std::vector<ukv_key_t> generated_keys;
+        ukv_key_t const* keys = nullptr;
+        int keys_column_idx = chunk_keys(chunk, key_column, generated_keys, keys);
+
+        std::string jsons;
+        std::vector<ukv_length_t> offsets;
+        offsets.reserve(chunk.batch->num_rows() + 1);
+        rows_to_jsons(*chunk.batch, jsons, offsets, keys_column_idx);
+
+        ukv_bytes_cptr_t contents = reinterpret_cast<ukv_bytes_cptr_t>(jsons.data());
+        ukv_docs_write_t docs_write {};
+        docs_write.db = collection.db();
+        docs_write.error = status.member_ptr();
+        docs_write.transaction = collection.txn();
+        docs_write.arena = arena.member_ptr();
+        docs_write.options = collection.options();
+        docs_write.tasks_count = static_cast<ukv_size_t>(chunk.batch->num_rows());
+        docs_write.type = ukv_doc_field_json_k;
+        docs_write.modification = ukv_doc_modify_upsert_k;
+        docs_write.collections = collection.member_collection();
+        docs_write.keys = keys;
+        docs_write.keys_stride = sizeof(ukv_key_t);
+        docs_write.offsets = offsets.data();
+        docs_write.offsets_stride = sizeof(ukv_length_t);
+        docs_write.values = &contents;
+        ukv_docs_write(&docs_write);
+    };
+
+    [[maybe_unused]] py::gil_scoped_release release;
+    write_chunks_parallel(chunks, threads_count, collection.db(), write_chunk);
 }
 
 void ukv::wrap_pandas(py::module& m) {
@@ -755,4 +1021,20 @@ void ukv::wrap_pandas(py::module& m) {
         df->binary = binary.native;
         return df;
     });
+
+    m.def("write_table",
+          &write_blobs_table,
+          py::arg("collection"),
+          py::arg("table"),
+          py::arg("key_column") = "key",
+          py::arg("value_column") = "value",
+          py::arg("threads") = 0,
+          py::arg("chunk_rows") = 65536);
+    m.def("write_table",
+          &write_docs_table,
+          py::arg("collection"),
+          py::arg("table"),
+          py::arg("key_column") = "key",
+          py::arg("threads") = 0,
+          py::arg("chunk_rows") = 65536);
 }
@@ -1,5 +1,6 @@
 import pytest
 import numpy as np
+import pyarrow as pa
 
 import ukv.umem as ukv
 
@@ -118,6 +119,37 @@ def scan(col):
     keys = col.scan(60, 1)
     assert np.array_equal(keys, [60])
 
+    # Earlier results own their memory, so later calls don't overwrite them
+    first = col.scan(10, 3)
+    second = col.scan(40, 3)
+    col.get([10, 20, 30])
+    assert np.array_equal(first, [10, 20, 30])
+    assert np.array_equal(second, [40, 50, 60])
+
+
+def read_many_alive(col):
+    col.clear()
+    col.set((1, 2, 3), (b'a', b'bb', b'ccc'))
+
+    # Batch reads export PyArrow arrays, that alias the arena of the read.
+    # Later reads on the same collection mustn't overwrite the earlier results.
+    first = col.get((1, 2, 3, 4))
+    assert isinstance(first, pa.BinaryArray)
+    second = col.get((3, 2))
+    col.set((2, 3), (b'xx', b'xxx'))
+    for _ in range(10):
+        col.get((3, 2, 1))
+    third = col.get((2, 3))
+
+    assert first.to_pylist() == [b'a', b'bb', b'ccc', None]
+    assert second.to_pylist() == [b'ccc', b'bb']
+    assert third.to_pylist() == [b'xx', b'xxx']
+
+    # Dropped results return their memory, while the others stay intact
+    del first
+    assert col.get((1, 2)).to_pylist() == [b'a', b'xx']
+    assert second.to_pylist() == [b'ccc', b'bb']
+
 
 def iterate(col):
     col.clear()
@@ -176,6 +208,7 @@ def test_main_collection():
     only_operators(main)
     batch_insert(main)
     scan(main)
+    read_many_alive(main)
     iterate(main)
 
 
@@ -195,6 +228,8 @@ def test_named_collections():
     only_operators(col_dub)
     batch_insert(col_sub)
     batch_insert(col_dub)
+    read_many_alive(col_sub)
+    read_many_alive(col_dub)
 
 
 def test_main_collection_txn():
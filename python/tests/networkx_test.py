@@ -126,6 +126,38 @@ def test_neighbors():
     net.clear()
 
 
+
+def test_traversals():
+    net = ukv.DataBase().main.graph
+
+    # 0 - 1 - 2 - ... - 10, and a disconnected 20 - 21
+    net.add_edges_from(np.arange(10), np.arange(1, 11))
+    net.add_edge(20, 21)
+
+    layers = ukv.bfs_layers(net, 0)
+    assert [list(layer) for layer in layers] == [[node] for node in range(11)]
+    assert sorted(ukv.bfs_layers(net, [0, 10])[1]) == [1, 9]
+
+    distances = ukv.single_source_shortest_path_length(net, 5)
+    assert distances == {node: abs(node - 5) for node in range(11)}
+    assert len(ukv.single_source_shortest_path_length(net, 5, cutoff=2)) == 5
+
+    assert ukv.shortest_path(net, 10, 7) == [10, 9, 8, 7]
+    assert ukv.shortest_path_length(net, 0, 10) == 10
+    assert ukv.has_path(net, 20, 21)
+    assert not ukv.has_path(net, 0, 21)
+    with pytest.raises(Exception):
+        ukv.shortest_path(net, 0, 21)
+
+    ranks = ukv.pagerank(net)
+    assert len(ranks) == 13
+    assert abs(sum(ranks.values()) - 1) < 1e-6
+    assert abs(ranks[0] - ranks[10]) < 1e-6
+    assert ranks[5] > ranks[0]
+    assert abs(ranks[20] - ranks[21]) < 1e-6
+
+    net.clear()
+
 def test_degree():
     db = ukv.DataBase()
     net = ukv.Network(db, 'graph', 'nodes', 'edges')
@@ -327,6 +327,23 @@ def test_from_records():
     assert pa.RecordBatch.from_pylist(data) == table.to_arrow()
 
 
+def test_write_table():
+    main = ukv.DataBase().main
+    blobs = pa.table({'key': pa.array([5, 6, 7], type=pa.int64()),
+                      'value': [b'a', None, b'ccc']})
+    ukv.write_table(main, blobs, threads=2, chunk_rows=2)
+    assert main[5] == b'a'
+    assert 6 not in main
+    assert main[7] == b'ccc'
+
+    main.clear()
+    data = {'col1': [3, 2, 1, 0], 'col2': [b'a', b'b', b'c', b'd']}
+    ukv.write_table(main.docs, pd.DataFrame(data), key_column='', threads=2, chunk_rows=3)
+    table = main.table
+    table.astype({'col1': 'int64', 'col2': 'bytes'})
+    assert pa.RecordBatch.from_pydict(data) == table.to_arrow()
+
+
 def test_rename():
     main = ukv.DataBase().main
     data = [{'col1': 3, 'col2': b'a'},
@@ -0,0 +1,146 @@
+/**
+ * @file arena.cpp
+ * @author Ashot Vardanian
+ *
+ * @brief Process-wide pool of memory chunks, shared by all the engines,
+ * and the introspection of `linked_memory_t` arenas.
+ */
+#include <sys/mman.h> // `mmap`, `madvise`
+#include <cstdlib>    // `std::getenv`, `std::strtoull`
+#include <map>        // `std::multimap`
+#include <mutex>      // `std::mutex`
+
+#include "ukv/db.h"
+#include "helpers/linked_memory.hpp" // `linked_memory_t`
+
+/*********************************************************/
+/*****************	 C++ Implementation	  ****************/
+/*********************************************************/
+
+using namespace unum::ukv;
+using namespace unum;
+
+static constexpr std::size_t huge_page_size_k = 2ul * 1024ul * 1024ul;
+static constexpr std::size_t default_pool_capacity_k = 256ul * 1024ul * 1024ul;
+
+/**
+ * @brief Idle chunks, ordered by capacity. Released chunks beyond the
+ * `capacity_limit` go straight back to the system.
+ * Never destroyed, as arenas may be released during the shutdown.
+ */
+struct chunks_pool_t {
+    std::mutex mutex;
+    std::multimap<std::size_t, pooled_chunk_t> idle;
+    std::size_t idle_capacity = 0;
+    std::size_t capacity_limit = default_pool_capacity_k;
+    bool huge_pages = false;
+
+    chunks_pool_t() noexcept {
+        if (char const* limit = std::getenv("UKV_ARENA_POOL_BYTES"); limit)
+            capacity_limit = std::strtoull(limit, nullptr, 10);
+        huge_pages = std::getenv("UKV_ARENA_HUGE_PAGES") != nullptr;
+    }
+
+    static chunks_pool_t& global() noexcept {
+        static chunks_pool_t* pool = new chunks_pool_t;
+        return *pool;
+    }
+
+    pooled_chunk_t allocate(std::size_t min_length, std::size_t max_length) const noexcept {
+#if defined(MADV_HUGEPAGE)
+        std::size_t rounded = divide_round_up(min_length, huge_page_size_k) * huge_page_size_k;
+        if (huge_pages && min_length >= huge_page_size_k && rounded <= max_length) {
+            void* begin = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (begin != MAP_FAILED) {
+                madvise(begin, rounded, MADV_HUGEPAGE);
+                return {begin, rounded, true};
+            }
+        }
+#endif
+        return {std::malloc(min_length), min_length, false};
+    }
+
+    static void free(pooled_chunk_t chunk) noexcept {
+        if (chunk.mapped)
+            munmap(chunk.begin, chunk.capacity);
+        else
+            std::free(chunk.begin);
+    }
+};
+
+pooled_chunk_t unum::ukv::pooled_chunk_acquire(std::size_t min_length, std::size_t max_length) noexcept {
+    chunks_pool_t& pool = chunks_pool_t::global();
+    max_length = std::max(min_length, max_length);
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        auto it = pool.idle.lower_bound(min_length);
+        if (it != pool.idle.end() && it->first <= max_length) {
+            pooled_chunk_t chunk = it->second;
+            pool.idle.erase(it);
+            pool.idle_capacity -= chunk.capacity;
+            return chunk;
+        }
+    }
+    pooled_chunk_t chunk = pool.allocate(min_length, max_length);
+    return chunk.begin ? chunk : pooled_chunk_t {};
+}
+
+void unum::ukv::pooled_chunk_release(pooled_chunk_t chunk) noexcept {
+    chunks_pool_t& pool = chunks_pool_t::global();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.idle_capacity + chunk.capacity <= pool.capacity_limit) {
+            try {
+                pool.idle.emplace(chunk.capacity, chunk);
+                pool.idle_capacity += chunk.capacity;
+                return;
+            }
+            catch (...) {
+            }
+        }
+    }
+    chunks_pool_t::free(chunk);
+}
+
+std::size_t unum::ukv::pooled_chunks_capacity() noexcept {
+    chunks_pool_t& pool = chunks_pool_t::global();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.idle_capacity;
+}
+
+/*********************************************************/
+/*****************	    C Interface 	  ****************/
+/*********************************************************/
+
+void ukv_arena_stats(ukv_arena_t c_arena, ukv_arena_stats_t* c_stats) {
+    ukv_arena_stats_t& stats = *c_stats;
+    stats = {};
+    stats.pooled = pooled_chunks_capacity();
+
+    linked_memory_t& memory = reinterpret_cast<linked_memory_t&>(c_arena);
+    if (!memory.first_ptr_)
+        return;
+
+    linked_memory_t::arena_header_t const& first = memory.first_ref();
+    stats.capacity = first.total_capacity;
+    stats.peak_capacity = first.peak_capacity;
+    stats.limit = first.limit;
+    for (auto current = memory.first_ptr_; current != nullptr; current = current->next) {
+        stats.used += current->used - sizeof(linked_memory_t::arena_header_t);
+        stats.chunks++;
+    }
+}
+
+void ukv_arena_limit(ukv_arena_t* c_arena, ukv_size_t c_limit, ukv_error_t* c_error) {
+    return_error_if_m(c_arena, c_error, args_wrong_k, "No arena to limit");
+
+    linked_memory_t& memory = *reinterpret_cast<linked_memory_t*>(c_arena);
+    bool started = memory.first_ptr_ || memory.start_if_null(linked_memory_t::kind_t::sys_k);
+    return_error_if_m(started, c_error, out_of_memory_k, "Couldn't allocate the arena");
+    memory.first_ref().limit = c_limit;
+}
+
+void ukv_arena_trim(ukv_arena_t c_arena) {
+    linked_memory_t& memory = reinterpret_cast<linked_memory_t&>(c_arena);
+    memory.release_partially();
+}
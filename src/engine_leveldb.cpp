@@ -17,7 +17,9 @@
 #include "ukv/db.h"
 #include "ukv/cpp/ranges_args.hpp"  // `places_arg_t`
 #include "helpers/linked_array.hpp" // `uninitialized_array_gt`
-#include "helpers/full_scan.hpp"    // `reservoir_sample_iterator`
+#include "helpers/async.hpp"        // `submit_blocking`
+#include "helpers/full_scan.hpp"    // `reservoir_sample_iterator`, `ranged_bulk_scan_t`
+#include "helpers/cache.hpp"        // `value_cache_t`
 
 using namespace unum::ukv;
 using namespace unum;
@@ -73,6 +75,8 @@ struct level_db_t {
     std::unordered_map<ukv_size_t, level_snapshot_t*> snapshots;
     std::unique_ptr<level_native_t> native;
     std::mutex mutex;
+    /// Decoded values of hot keys, unlike the `block_cache`, that keeps whole compressed blocks.
+    std::unique_ptr<value_cache_t> cache;
 };
 
 /*********************************************************/
@@ -117,6 +121,7 @@ void ukv_database_init(ukv_database_init_t* c_ptr) {
 
     ukv_database_init_t& c = *c_ptr;
     try {
+        std::size_t value_cache_size = 0;
         level_options_t options;
         options.comparator = &key_comparator_k;
         options.compression = leveldb::kNoCompression;
@@ -148,6 +153,8 @@ void ukv_database_init(ukv_database_init_t* c_ptr) {
                 options.max_open_files = js["max_open_files"];
             if (js.contains("cache_size"))
                 options.block_cache = leveldb::NewLRUCache(js["cache_size"]);
+            if (js.contains("value_cache_size"))
+                value_cache_size = js["value_cache_size"];
             if (js.contains("create_if_missing"))
                 options.create_if_missing = js["create_if_missing"];
             if (js.contains("error_if_exists"))
@@ -167,6 +174,8 @@ void ukv_database_init(ukv_database_init_t* c_ptr) {
             return;
         }
         db_ptr->native = std::unique_ptr<level_native_t>(native_db);
+        if (value_cache_size)
+            db_ptr->cache = std::make_unique<value_cache_t>(value_cache_size);
         *c.db = db_ptr;
     }
     catch (json_t::type_error const&) {
@@ -253,6 +262,7 @@ void write_one( //
     auto place = places[0];
     auto content = contents[0];
     auto key = to_slice(place.key);
+    metric_scope_t engine_metric(metric_op_t::engine_write_k, c_error);
     level_status_t status =
         !content ? db.native->Delete(options, key) : db.native->Put(options, key, to_slice(content));
     export_error(status, c_error);
@@ -277,6 +287,7 @@ void write_many( //
             batch.Put(key, to_slice(content));
     }
 
+    metric_scope_t engine_metric(metric_op_t::engine_write_k, c_error);
     level_status_t status = db.native->Write(options, &batch);
     export_error(status, c_error);
 }
@@ -284,6 +295,7 @@ void write_many( //
 void ukv_write(ukv_write_t* c_ptr) {
 
     ukv_write_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::write_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     level_db_t& db = *reinterpret_cast<level_db_t*>(c.db);
@@ -299,6 +311,9 @@ void ukv_write(ukv_write_t* c_ptr) {
 
     validate_write(c.transaction, places, contents, c.options, c.error);
     return_if_error_m(c.error);
+    if (metric.enabled())
+        for (std::size_t i = 0; i != contents.size(); ++i)
+            metric.add_bytes(contents[i].size());
 
     leveldb::WriteOptions options;
     if (c.options & ukv_option_write_flush_k)
@@ -311,6 +326,11 @@ void ukv_write(ukv_write_t* c_ptr) {
     catch (...) {
         *c.error = "Write Failure";
     }
+
+    // Collections aren't supported, so all the keys belong to the main one
+    if (db.cache)
+        for (std::size_t i = 0; i != places.size(); ++i)
+            db.cache->invalidate(collection_key_t {places[i].key});
 }
 
 template <typename value_enumerator_at>
@@ -322,24 +342,36 @@ void read_enumerate( //
     value_enumerator_at enumerator,
     ukv_error_t* c_error) {
 
+    // Snapshots may hold older values, than the cached ones
+    value_cache_t* cache = options.snapshot ? nullptr : db.cache.get();
     for (std::size_t i = 0; i != tasks.size(); ++i) {
         place_t place = tasks[i];
+        collection_key_t key {place.key};
+        if (cache && cache->find(key, [&](value_view_t cached) { enumerator(i, cached); }))
+            continue;
+
+        value_cache_t::ticket_t ticket = cache ? cache->ticket(key) : 0;
+        metric_scope_t engine_metric(metric_op_t::engine_read_k, nullptr);
         level_status_t status = db.native->Get(options, to_slice(place.key), &value);
+        engine_metric.stop();
+        value_view_t found;
         if (!status.IsNotFound()) {
             if (export_error(status, c_error))
                 return;
             auto begin = reinterpret_cast<ukv_bytes_cptr_t>(value.data());
             auto length = static_cast<ukv_length_t>(value.size());
-            enumerator(i, value_view_t {begin, length});
+            found = value_view_t {begin, length};
         }
-        else
-            enumerator(i, value_view_t {});
+        if (cache)
+            cache->insert(key, found, ticket);
+        enumerator(i, found);
     }
 }
 
 void ukv_read(ukv_read_t* c_ptr) {
 
     ukv_read_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::read_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -378,6 +410,7 @@ void ukv_read(ukv_read_t* c_ptr) {
         auto data_enumerator = [&](std::size_t i, value_view_t value) {
             presences[i] = bool(value);
             lens[i] = value ? value.size() : ukv_length_missing_k;
+            metric.add_bytes(value.size());
             offs[i] = contents.size();
             if (needs_export)
                 contents.insert(contents.size(), value.begin(), value.end(), c.error);
@@ -392,9 +425,18 @@ void ukv_read(ukv_read_t* c_ptr) {
     }
 }
 
+void ukv_read_async(ukv_read_t* c_ptr, ukv_callback_t callback, ukv_callback_payload_t payload) {
+    submit_blocking(c_ptr, &ukv_read, callback, payload);
+}
+
+void ukv_write_async(ukv_write_t* c_ptr, ukv_callback_t callback, ukv_callback_payload_t payload) {
+    submit_blocking(c_ptr, &ukv_write, callback, payload);
+}
+
 void ukv_scan(ukv_scan_t* c_ptr) {
 
     ukv_scan_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -418,6 +460,14 @@ void ukv_scan(ukv_scan_t* c_ptr) {
     auto keys_output = *c.keys = arena.alloc<ukv_key_t>(total_keys, c.error).begin();
     return_if_error_m(c.error);
 
+    // Values are optional, but are cheap to take from the iterator, that has just visited them
+    bool const needs_values = c.values || c.values_offsets || c.values_lengths;
+    auto values_offsets = arena.alloc_or_dummy(total_keys + 1, c.error, c.values_offsets);
+    return_if_error_m(c.error);
+    auto values_lengths = arena.alloc_or_dummy(total_keys, c.error, c.values_lengths);
+    return_if_error_m(c.error);
+    uninitialized_array_gt<byte_t> contents(arena);
+
     // 2. Fetch the data
     leveldb::ReadOptions options;
     options.fill_cache = false;
@@ -443,6 +493,15 @@ void ukv_scan(ukv_scan_t* c_ptr) {
         ukv_size_t j = 0;
         while (it->Valid() && j != task.limit) {
             std::memcpy(keys_output, it->key().data(), sizeof(ukv_key_t));
+            if (needs_values) {
+                auto entry_idx = keys_output - *c.keys;
+                auto begin = reinterpret_cast<ukv_bytes_cptr_t>(it->value().data());
+                auto length = static_cast<ukv_length_t>(it->value().size());
+                values_offsets[entry_idx] = static_cast<ukv_length_t>(contents.size());
+                values_lengths[entry_idx] = length;
+                contents.insert(contents.size(), begin, begin + length, c.error);
+                return_if_error_m(c.error);
+            }
             ++keys_output;
             ++j;
             it->Next();
@@ -452,11 +511,79 @@ void ukv_scan(ukv_scan_t* c_ptr) {
     }
 
     offsets[scans.size()] = keys_output - *c.keys;
+    values_offsets[keys_output - *c.keys] = static_cast<ukv_length_t>(contents.size());
+    if (c.values)
+        *c.values = reinterpret_cast<ukv_bytes_ptr_t>(contents.begin());
+}
+
+void split_range(level_db_t& db,
+                 leveldb::ReadOptions const& options,
+                 ukv_key_t start_key,
+                 ukv_key_t end_key,
+                 ptr_range_gt<ukv_key_t> boundaries) noexcept(false) {
+    auto size_between = [&](ukv_key_t min_key, ukv_key_t max_key) {
+        uint64_t approximate_size = 0;
+        leveldb::Range range(to_slice(min_key), to_slice(max_key));
+        db.native->GetApproximateSizes(&range, 1, &approximate_size);
+        return approximate_size;
+    };
+    level_iter_uptr_t it(db.native->NewIterator(options));
+    split_range_by_size(it, start_key, end_key, boundaries, size_between);
+}
+
+void ukv_scan_bulk_init(ukv_scan_bulk_init_t* c_ptr) {
+
+    ukv_scan_bulk_init_t& c = *c_ptr;
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.scan, c.error, args_wrong_k, "Output handle is missing");
+    return_error_if_m(c.collection == ukv_collection_main_k, c.error, args_wrong_k, "Collections not supported");
+
+    level_db_t& db = *reinterpret_cast<level_db_t*>(c.db);
+    leveldb::ReadOptions options;
+    options.fill_cache = false;
+    if (c.snapshot) {
+        auto it = db.snapshots.find(c.snapshot);
+        return_error_if_m(it != db.snapshots.end(), c.error, args_wrong_k, "The snapshot does'nt exist!");
+        options.snapshot = it->second->snapshot;
+    }
+
+    // LevelDB doesn't expose its tables, so we split the keys range
+    // into parts of similar size on disk and scan them in parallel
+    safe_section("Partitioning the collection", c.error, [&] {
+        auto scan = std::make_unique<ranged_bulk_scan_t>();
+        scan->db = c.db;
+        scan->snapshot = c.snapshot;
+
+        std::size_t const partitions_count = std::max<std::size_t>(c.partitions_count, 1u);
+        std::vector<ukv_key_t> boundaries(partitions_count + 1);
+        split_range(db,
+                    options,
+                    std::numeric_limits<ukv_key_t>::min(),
+                    std::numeric_limits<ukv_key_t>::max(),
+                    {boundaries.data(), boundaries.size()});
+
+        scan->split({boundaries.data() + 1, partitions_count - 1}, partitions_count);
+        *c.scan = scan.release();
+    });
+}
+
+void ukv_scan_bulk_next(ukv_scan_bulk_next_t* c_ptr) {
+
+    ukv_scan_bulk_next_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_bulk_k, c.error);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.scan, c.error, uninitialized_state_k, "Bulk scan is uninitialized");
+    ranged_bulk_scan_next(*reinterpret_cast<ranged_bulk_scan_t*>(c.scan), c);
+}
+
+void ukv_scan_bulk_free(ukv_scan_bulk_t c_scan) {
+    delete reinterpret_cast<ranged_bulk_scan_t*>(c_scan);
 }
 
 void ukv_sample(ukv_sample_t* c_ptr) {
 
     ukv_sample_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::sample_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     if (!c.tasks_count)
         return;
@@ -510,6 +637,7 @@ void ukv_sample(ukv_sample_t* c_ptr) {
 void ukv_measure(ukv_measure_t* c_ptr) {
 
     ukv_measure_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::measure_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -553,6 +681,34 @@ void ukv_measure(ukv_measure_t* c_ptr) {
     }
 }
 
+void ukv_collection_split(ukv_collection_split_t* c_ptr) {
+
+    ukv_collection_split_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::split_k, c.error, c.count);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.collection == ukv_collection_main_k, c.error, args_wrong_k, "Collections not supported");
+    return_error_if_m(c.count, c.error, args_wrong_k, "Can't split into zero parts");
+
+    linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
+    return_if_error_m(c.error);
+
+    auto boundaries = *c.boundaries = arena.alloc<ukv_key_t>(c.count + 1, c.error).begin();
+    return_if_error_m(c.error);
+
+    level_db_t& db = *reinterpret_cast<level_db_t*>(c.db);
+    leveldb::ReadOptions options;
+    options.fill_cache = false;
+    if (c.snapshot) {
+        auto it = db.snapshots.find(c.snapshot);
+        return_error_if_m(it != db.snapshots.end(), c.error, args_wrong_k, "The snapshot does'nt exist!");
+        options.snapshot = it->second->snapshot;
+    }
+
+    safe_section("Splitting the collection", c.error, [&] {
+        split_range(db, options, c.start_key, c.end_key, {boundaries, c.count + 1});
+    });
+}
+
 /*********************************************************/
 /*****************	Collections Management	****************/
 /*********************************************************/
@@ -592,6 +748,8 @@ void ukv_collection_drop(ukv_collection_drop_t* c_ptr) {
     leveldb::WriteOptions options;
     options.sync = true;
     level_status_t status = db.native->Write(options, &batch);
+    if (db.cache)
+        db.cache->clear();
     export_error(status, c.error);
 }
 
@@ -632,6 +790,7 @@ void ukv_transaction_init(ukv_transaction_init_t* c_ptr) {
 void ukv_transaction_commit(ukv_transaction_commit_t* c_ptr) {
 
     ukv_transaction_commit_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::transaction_commit_k, c.error);
     *c.error = "Transactions not supported by LevelDB!";
 }
 
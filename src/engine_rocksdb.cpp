@@ -28,7 +28,9 @@
 #include "ukv/db.h"
 #include "ukv/cpp/ranges_args.hpp"  // `places_arg_t`
 #include "helpers/linked_array.hpp" // `uninitialized_array_gt`
-#include "helpers/full_scan.hpp"    // `reservoir_sample_iterator`
+#include "helpers/async.hpp"        // `async_executor_t`
+#include "helpers/full_scan.hpp"    // `reservoir_sample_iterator`, `ranged_bulk_scan_t`
+#include "helpers/lock_table.hpp"   // `lock_table_t`
 
 namespace stdfs = std::filesystem;
 using namespace unum::ukv;
@@ -48,10 +50,11 @@ bool const ukv_supports_snapshots_k = true;
 using rocks_native_t = rocksdb::OptimisticTransactionDB;
 using rocks_status_t = rocksdb::Status;
 using rocks_value_t = rocksdb::PinnableSlice;
-using rocks_txn_t = rocksdb::Transaction;
+using rocks_native_txn_t = rocksdb::Transaction;
 using rocks_collection_t = rocksdb::ColumnFamilyHandle;
 
 static constexpr char const* config_name_k = "config_rocksdb.ini";
+static constexpr std::size_t bulk_readahead_k = 2ul * 1024ul * 1024ul;
 
 struct key_comparator_t final : public rocksdb::Comparator {
     inline int Compare(rocksdb::Slice const& a, rocksdb::Slice const& b) const override {
@@ -78,11 +81,27 @@ struct rocks_snapshot_t {
     rocksdb::Snapshot const* snapshot = nullptr;
 };
 
+struct rocks_db_t;
+
+/**
+ * @brief RocksDB can't mix optimistic and pessimistic transactions in one DB,
+ * so pessimistic ones lock the keys in our own `lock_table_t`, before accessing
+ * them in an optimistic transaction, that will still be validated on commit.
+ */
+struct rocks_txn_t {
+    rocks_db_t* db = nullptr;
+    std::unique_ptr<rocks_native_txn_t> native;
+    bool pessimistic = false;
+    lock_table_t::clock_t::duration lock_timeout = lock_table_t::default_timeout_k;
+    std::vector<collection_key_t> locked;
+};
+
 struct rocks_db_t {
     std::vector<rocks_collection_t*> columns;
     std::unordered_map<ukv_size_t, rocks_snapshot_t*> snapshots;
     std::unique_ptr<rocks_native_t> native;
     std::mutex mutex;
+    lock_table_t locks;
 };
 
 inline rocksdb::Slice to_slice(ukv_key_t const& key) noexcept {
@@ -121,6 +140,20 @@ rocks_collection_t* rocks_collection(rocks_db_t& db, ukv_collection_t collection
                                                : reinterpret_cast<rocks_collection_t*>(collection);
 }
 
+void lock_places(rocks_db_t& db, rocks_txn_t& txn, places_arg_t const& places, ukv_error_t* c_error) noexcept(false) {
+    std::vector<collection_key_t> keys(places.size());
+    for (std::size_t i = 0; i != places.size(); ++i)
+        keys[i] = places[i].collection_key();
+    lock_keys(db.locks, &txn, keys, txn.lock_timeout, txn.locked, c_error);
+}
+
+void unlock_all(rocks_txn_t& txn) noexcept {
+    if (txn.locked.empty())
+        return;
+    txn.db->locks.unlock(&txn, txn.locked);
+    txn.locked.clear();
+}
+
 /*********************************************************/
 /*****************	    C Interface 	  ****************/
 /*********************************************************/
@@ -260,7 +293,7 @@ void ukv_snapshot_drop(ukv_snapshot_drop_t* c_ptr) {
 
 void write_one( //
     rocks_db_t& db,
-    rocks_txn_t* txn_ptr,
+    rocks_native_txn_t* txn_ptr,
     places_arg_t const& places,
     contents_arg_t const& contents,
     ukv_options_t const c_options,
@@ -278,6 +311,7 @@ void write_one( //
     auto collection = rocks_collection(db, place.collection);
     auto key = to_slice(place.key);
     rocks_status_t status;
+    metric_scope_t engine_metric(metric_op_t::engine_write_k, c_error);
 
     if (txn_ptr)
         status =        //
@@ -299,7 +333,7 @@ void write_one( //
 
 void write_many( //
     rocks_db_t& db,
-    rocks_txn_t* txn_ptr,
+    rocks_native_txn_t* txn_ptr,
     places_arg_t const& places,
     contents_arg_t const& contents,
     ukv_options_t const c_options,
@@ -343,6 +377,7 @@ void write_many( //
             export_error(status, c_error);
         }
 
+        metric_scope_t engine_metric(metric_op_t::engine_write_k, c_error);
         rocks_status_t status = db.native->Write(options, &batch);
         export_error(status, c_error);
     }
@@ -351,6 +386,7 @@ void write_many( //
 void ukv_write(ukv_write_t* c_ptr) {
 
     ukv_write_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::write_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     if (!c.tasks_count)
         return;
@@ -369,17 +405,23 @@ void ukv_write(ukv_write_t* c_ptr) {
 
     validate_write(c.transaction, places, contents, c.options, c.error);
     return_if_error_m(c.error);
+    if (metric.enabled())
+        for (std::size_t i = 0; i != contents.size(); ++i)
+            metric.add_bytes(contents[i].size());
 
     safe_section("Writing into RocksDB", c.error, [&] {
+        if (c.transaction && txn.pessimistic)
+            lock_places(db, txn, places, c.error);
+        return_if_error_m(c.error);
         auto func = c.tasks_count == 1 ? &write_one : &write_many;
-        func(db, &txn, places, contents, c.options, c.error);
+        func(db, c.transaction ? txn.native.get() : nullptr, places, contents, c.options, c.error);
     });
 }
 
 template <typename value_enumerator_at>
 void read_one( //
     rocks_db_t& db,
-    rocks_txn_t* txn_ptr,
+    rocks_native_txn_t* txn_ptr,
     rocks_snapshot_t* snap_ptr,
     places_arg_t places,
     ukv_options_t const c_options,
@@ -402,12 +444,14 @@ void read_one( //
     return_if_error_m(c_error);
 
     rocks_value_t& value = *value_uptr.get();
+    metric_scope_t engine_metric(metric_op_t::engine_read_k, nullptr);
     rocks_status_t status = //
         txn_ptr             //
             ? watch         //
                   ? txn_ptr->GetForUpdate(options, col, key, &value)
                   : txn_ptr->Get(options, col, key, &value)
             : db.native->Get(options, col, key, &value);
+    engine_metric.stop();
     if (!status.IsNotFound()) {
         if (export_error(status, c_error))
             return;
@@ -422,12 +466,13 @@ void read_one( //
 template <typename value_enumerator_at>
 void read_many( //
     rocks_db_t& db,
-    rocks_txn_t* txn_ptr,
+    rocks_native_txn_t* txn_ptr,
     rocks_snapshot_t* snap_ptr,
     places_arg_t places,
     ukv_options_t const c_options,
     value_enumerator_at enumerator,
-    ukv_error_t* c_error) noexcept(false) {
+    ukv_error_t* c_error,
+    bool async_io = false) noexcept(false) {
 
     rocksdb::ReadOptions options;
     if (snap_ptr) {
@@ -435,6 +480,9 @@ void read_many( //
         return_error_if_m(it != db.snapshots.end(), c_error, args_wrong_k, "The snapshot does'nt exist!");
         options.snapshot = snap_ptr->snapshot;
     }
+    // Issues the reads from different files of the batch concurrently,
+    // instead of one after another, which only pays off for background calls.
+    options.async_io = async_io;
 
     bool watch = !(c_options & ukv_option_transaction_dont_watch_k);
     std::vector<rocks_collection_t*> cols(places.count);
@@ -446,12 +494,14 @@ void read_many( //
         keys[i] = to_slice(place.key);
     }
 
+    metric_scope_t engine_metric(metric_op_t::engine_read_k, nullptr);
     std::vector<rocks_status_t> statuses = //
         txn_ptr                            //
             ? watch                        //
                   ? txn_ptr->MultiGetForUpdate(options, cols, keys, &vals)
                   : txn_ptr->MultiGet(options, cols, keys, &vals)
             : db.native->MultiGet(options, cols, keys, &vals);
+    engine_metric.stop();
     for (std::size_t i = 0; i != places.size(); ++i) {
         if (!statuses[i].IsNotFound()) {
             if (export_error(statuses[i], c_error))
@@ -465,10 +515,9 @@ void read_many( //
     }
 }
 
-void ukv_read(ukv_read_t* c_ptr) {
-
-    ukv_read_t& c = *c_ptr;
+void read_blobs(ukv_read_t& c, bool async_io) noexcept {
 
+    metric_scope_t metric(metric_op_t::read_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     if (!c.tasks_count)
         return;
@@ -500,6 +549,7 @@ void ukv_read(ukv_read_t* c_ptr) {
     auto data_enumerator = [&](std::size_t i, value_view_t value) {
         presences[i] = bool(value);
         lens[i] = value ? value.size() : ukv_length_missing_k;
+        metric.add_bytes(value.size());
         if (needs_export) {
             offs[i] = contents.size();
             contents.insert(contents.size(), value.begin(), value.end(), c.error);
@@ -507,9 +557,13 @@ void ukv_read(ukv_read_t* c_ptr) {
     };
 
     safe_section("Reading from RocksDB", c.error, [&] {
+        if (c.transaction && txn.pessimistic)
+            lock_places(db, txn, places, c.error);
+        return_if_error_m(c.error);
+        rocks_native_txn_t* txn_ptr = c.transaction ? txn.native.get() : nullptr;
         c.tasks_count == 1 //
-            ? read_one(db, &txn, &snap, places, c.options, data_enumerator, c.error)
-            : read_many(db, &txn, &snap, places, c.options, data_enumerator, c.error);
+            ? read_one(db, txn_ptr, &snap, places, c.options, data_enumerator, c.error)
+            : read_many(db, txn_ptr, &snap, places, c.options, data_enumerator, c.error, async_io);
         offs[places.count] = contents.size();
 
         if (needs_export)
@@ -517,9 +571,35 @@ void ukv_read(ukv_read_t* c_ptr) {
     });
 }
 
+void ukv_read(ukv_read_t* c_ptr) {
+    read_blobs(*c_ptr, false);
+}
+
+void ukv_read_async(ukv_read_t* c_ptr, ukv_callback_t callback, ukv_callback_payload_t payload) {
+
+    ukv_read_t& c = *c_ptr;
+    return_error_if_m(callback, c.error, args_wrong_k, "Asynchronous reads need a callback");
+
+    bool submitted = false;
+    safe_section("Submitting read", c.error, [&] {
+        async_executor_t::global().submit([=] {
+            read_blobs(*c_ptr, true);
+            callback(payload);
+        });
+        submitted = true;
+    });
+    if (!submitted)
+        callback(payload);
+}
+
+void ukv_write_async(ukv_write_t* c_ptr, ukv_callback_t callback, ukv_callback_payload_t payload) {
+    submit_blocking(c_ptr, &ukv_write, callback, payload);
+}
+
 void ukv_scan(ukv_scan_t* c_ptr) {
 
     ukv_scan_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -546,9 +626,19 @@ void ukv_scan(ukv_scan_t* c_ptr) {
     auto keys_output = *c.keys = arena.alloc<ukv_key_t>(total_keys, c.error).begin();
     return_if_error_m(c.error);
 
+    // Values are optional, but are cheap to take from the iterator, that has just visited them
+    bool const needs_values = c.values || c.values_offsets || c.values_lengths;
+    auto values_offsets = arena.alloc_or_dummy(total_keys + 1, c.error, c.values_offsets);
+    return_if_error_m(c.error);
+    auto values_lengths = arena.alloc_or_dummy(total_keys, c.error, c.values_lengths);
+    return_if_error_m(c.error);
+    uninitialized_array_gt<byte_t> contents(arena);
+
     // 2. Fetch the data
     rocksdb::ReadOptions options;
     options.fill_cache = false;
+    if (c.options & ukv_option_scan_bulk_k)
+        options.readahead_size = bulk_readahead_k;
 
     if (c.snapshot)
         options.snapshot = snap.snapshot;
@@ -560,7 +650,7 @@ void ukv_scan(ukv_scan_t* c_ptr) {
         std::unique_ptr<rocksdb::Iterator> it;
         safe_section("Creating a RocksDB iterator", c.error, [&] {
             it = c.transaction //
-                     ? std::unique_ptr<rocksdb::Iterator>(txn.GetIterator(options, collection))
+                     ? std::unique_ptr<rocksdb::Iterator>(txn.native->GetIterator(options, collection))
                      : std::unique_ptr<rocksdb::Iterator>(db.native->NewIterator(options, collection));
         });
         return_if_error_m(c.error);
@@ -568,9 +658,20 @@ void ukv_scan(ukv_scan_t* c_ptr) {
         offsets[i] = keys_output - *c.keys;
 
         ukv_size_t j = 0;
+        metric_scope_t engine_metric(metric_op_t::engine_seek_k, nullptr);
         it->Seek(to_slice(task.min_key));
+        engine_metric.stop();
         while (it->Valid() && j != task.limit) {
             std::memcpy(keys_output, it->key().data(), sizeof(ukv_key_t));
+            if (needs_values) {
+                auto entry_idx = keys_output - *c.keys;
+                auto begin = reinterpret_cast<ukv_bytes_cptr_t>(it->value().data());
+                auto length = static_cast<ukv_length_t>(it->value().size());
+                values_offsets[entry_idx] = static_cast<ukv_length_t>(contents.size());
+                values_lengths[entry_idx] = length;
+                contents.insert(contents.size(), begin, begin + length, c.error);
+                return_if_error_m(c.error);
+            }
             ++keys_output;
             ++j;
             it->Next();
@@ -580,11 +681,105 @@ void ukv_scan(ukv_scan_t* c_ptr) {
     }
 
     offsets[tasks.size()] = keys_output - *c.keys;
+    values_offsets[keys_output - *c.keys] = static_cast<ukv_length_t>(contents.size());
+    if (c.values)
+        *c.values = reinterpret_cast<ukv_bytes_ptr_t>(contents.begin());
+}
+
+/**
+ * @brief Bulk scan over disjoint key ranges, drained by ordered iterators.
+ * SST files of different levels overlap and carry stale versions and
+ * tombstones, so they can't be exported independently. Without a user
+ * snapshot, the scan pins its own one, to present a consistent state.
+ */
+struct rocks_bulk_scan_t {
+    rocks_db_t* db = nullptr;
+    rocks_snapshot_t own_snapshot;
+    ranged_bulk_scan_t ranged;
+
+    ~rocks_bulk_scan_t() noexcept {
+        if (own_snapshot.snapshot)
+            db->native->ReleaseSnapshot(own_snapshot.snapshot);
+    }
+};
+
+void split_range(rocks_db_t& db,
+                 rocks_collection_t* collection,
+                 rocksdb::ReadOptions const& options,
+                 ukv_key_t start_key,
+                 ukv_key_t end_key,
+                 ptr_range_gt<ukv_key_t> boundaries) noexcept(false) {
+    auto size_between = [&](ukv_key_t min_key, ukv_key_t max_key) {
+        uint64_t approximate_size = 0;
+        rocksdb::Range range(to_slice(min_key), to_slice(max_key));
+        db.native->GetApproximateSizes(collection,
+                                       &range,
+                                       1,
+                                       &approximate_size,
+                                       rocksdb::DB::SizeApproximationFlags::INCLUDE_MEMTABLES |
+                                           rocksdb::DB::SizeApproximationFlags::INCLUDE_FILES);
+        return approximate_size;
+    };
+    std::unique_ptr<rocksdb::Iterator> it(db.native->NewIterator(options, collection));
+    split_range_by_size(it, start_key, end_key, boundaries, size_between);
+}
+
+void ukv_scan_bulk_init(ukv_scan_bulk_init_t* c_ptr) {
+
+    ukv_scan_bulk_init_t& c = *c_ptr;
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.scan, c.error, args_wrong_k, "Output handle is missing");
+
+    rocks_db_t& db = *reinterpret_cast<rocks_db_t*>(c.db);
+    rocks_collection_t* collection = rocks_collection(db, c.collection);
+    std::size_t const partitions_count = std::max<std::size_t>(c.partitions_count, 1u);
+
+    safe_section("Partitioning the collection", c.error, [&] {
+        auto scan = std::make_unique<rocks_bulk_scan_t>();
+        scan->db = &db;
+
+        if (!c.snapshot)
+            scan->own_snapshot.snapshot = db.native->GetSnapshot();
+        auto snapshot = c.snapshot ? c.snapshot : reinterpret_cast<ukv_snapshot_t>(&scan->own_snapshot);
+
+        rocksdb::ReadOptions options;
+        options.fill_cache = false;
+        options.snapshot = reinterpret_cast<rocks_snapshot_t*>(snapshot)->snapshot;
+
+        std::vector<ukv_key_t> boundaries(partitions_count + 1);
+        split_range(db,
+                    collection,
+                    options,
+                    std::numeric_limits<ukv_key_t>::min(),
+                    std::numeric_limits<ukv_key_t>::max(),
+                    {boundaries.data(), boundaries.size()});
+
+        scan->ranged.db = c.db;
+        scan->ranged.collection = c.collection;
+        scan->ranged.snapshot = snapshot;
+        scan->ranged.split({boundaries.data() + 1, partitions_count - 1}, partitions_count);
+        *c.scan = scan.release();
+    });
+}
+
+void ukv_scan_bulk_next(ukv_scan_bulk_next_t* c_ptr) {
+
+    ukv_scan_bulk_next_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_bulk_k, c.error);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.scan, c.error, uninitialized_state_k, "Bulk scan is uninitialized");
+
+    ranged_bulk_scan_next(reinterpret_cast<rocks_bulk_scan_t*>(c.scan)->ranged, c);
+}
+
+void ukv_scan_bulk_free(ukv_scan_bulk_t c_scan) {
+    delete reinterpret_cast<rocks_bulk_scan_t*>(c_scan);
 }
 
 void ukv_sample(ukv_sample_t* c_ptr) {
 
     ukv_sample_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::sample_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     if (!c.tasks_count)
         return;
@@ -624,7 +819,7 @@ void ukv_sample(ukv_sample_t* c_ptr) {
         std::unique_ptr<rocksdb::Iterator> it;
         safe_section("Creating a RocksDB iterator", c.error, [&] {
             it = c.transaction //
-                     ? std::unique_ptr<rocksdb::Iterator>(txn.GetIterator(options, collection))
+                     ? std::unique_ptr<rocksdb::Iterator>(txn.native->GetIterator(options, collection))
                      : std::unique_ptr<rocksdb::Iterator>(db.native->NewIterator(options, collection));
         });
         return_if_error_m(c.error);
@@ -641,6 +836,7 @@ void ukv_sample(ukv_sample_t* c_ptr) {
 void ukv_measure(ukv_measure_t* c_ptr) {
 
     ukv_measure_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::measure_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -689,6 +885,31 @@ void ukv_measure(ukv_measure_t* c_ptr) {
     }
 }
 
+void ukv_collection_split(ukv_collection_split_t* c_ptr) {
+
+    ukv_collection_split_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::split_k, c.error, c.count);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.count, c.error, args_wrong_k, "Can't split into zero parts");
+
+    linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
+    return_if_error_m(c.error);
+
+    auto boundaries = *c.boundaries = arena.alloc<ukv_key_t>(c.count + 1, c.error).begin();
+    return_if_error_m(c.error);
+
+    rocks_db_t& db = *reinterpret_cast<rocks_db_t*>(c.db);
+    rocks_collection_t* collection = rocks_collection(db, c.collection);
+    rocksdb::ReadOptions options;
+    options.fill_cache = false;
+    if (c.snapshot)
+        options.snapshot = reinterpret_cast<rocks_snapshot_t*>(c.snapshot)->snapshot;
+
+    safe_section("Splitting the collection", c.error, [&] {
+        split_range(db, collection, options, c.start_key, c.end_key, {boundaries, c.count + 1});
+    });
+}
+
 void ukv_collection_create(ukv_collection_create_t* c_ptr) {
 
     ukv_collection_create_t& c = *c_ptr;
@@ -836,21 +1057,33 @@ void ukv_transaction_init(ukv_transaction_init_t* c_ptr) {
 
     bool const safe = c.options & ukv_option_write_flush_k;
     rocks_db_t& db = *reinterpret_cast<rocks_db_t*>(c.db);
+    safe_section("Allocating transaction handle", c.error, [&] {
+        if (!*c.transaction)
+            *c.transaction = new rocks_txn_t;
+    });
+    return_if_error_m(c.error);
+
     rocks_txn_t& txn = **reinterpret_cast<rocks_txn_t**>(c.transaction);
+    unlock_all(txn);
+    txn.db = &db;
+    txn.pessimistic = c.options & ukv_option_transaction_pessimistic_k;
+    txn.lock_timeout = lock_table_t::timeout(c.lock_timeout);
+
     rocksdb::OptimisticTransactionOptions txn_options;
     txn_options.set_snapshot = false;
     rocksdb::WriteOptions options;
     options.sync = safe;
     options.disableWAL = !safe;
-    auto new_txn = db.native->BeginTransaction(options, txn_options, &txn);
+    auto new_txn = db.native->BeginTransaction(options, txn_options, txn.native.get());
     if (!new_txn)
         *c.error = "Couldn't start a transaction!";
-    else
-        *c.transaction = new_txn;
+    else if (new_txn != txn.native.get())
+        txn.native.reset(new_txn);
 }
 
 void ukv_transaction_commit(ukv_transaction_commit_t* c_ptr) {
     ukv_transaction_commit_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::transaction_commit_k, c.error);
     if (!c.transaction)
         return;
 
@@ -862,13 +1095,17 @@ void ukv_transaction_commit(ukv_transaction_commit_t* c_ptr) {
 
     if (c.sequence_number)
         db.mutex.lock();
-    rocks_status_t status = txn.Commit();
+    metric_scope_t engine_metric(metric_op_t::engine_commit_k, c.error);
+    rocks_status_t status = txn.native->Commit();
     export_error(status, c.error);
+    engine_metric.stop();
     if (c.sequence_number) {
         if (status.ok())
             *c.sequence_number = db.native->GetLatestSequenceNumber();
         db.mutex.unlock();
     }
+    // Failed commits mustn't keep blocking others until the handle is reset
+    unlock_all(txn);
 }
 
 void ukv_arena_free(ukv_arena_t c_arena) {
@@ -878,7 +1115,9 @@ void ukv_arena_free(ukv_arena_t c_arena) {
 void ukv_transaction_free(ukv_transaction_t c_transaction) {
     if (!c_transaction)
         return;
-    delete reinterpret_cast<rocks_txn_t*>(c_transaction);
+    rocks_txn_t& txn = *reinterpret_cast<rocks_txn_t*>(c_transaction);
+    unlock_all(txn);
+    delete &txn;
 }
 
 void ukv_database_free(ukv_database_t c_db) {
@@ -7,7 +7,8 @@
  * It keeps all the pairs sorted and is pretty fast for a BST-based container.
  */
 
-#include <stdio.h> // Saving/reading from disk
+#include <stdio.h>  // Saving/reading from disk
+#include <unistd.h> // `fdatasync`
 
 #include <map>
 #include <vector>
@@ -15,12 +16,17 @@
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <set>
+#include <deque>
 #include <shared_mutex>
-#include <mutex>      // `std::unique_lock`
-#include <numeric>    // `std::accumulate`
-#include <atomic>     // Thread-safe generation counters
-#include <filesystem> // Enumerating the directory
-#include <fstream>    // Passing file contents to JSON parser
+#include <mutex>              // `std::unique_lock`
+#include <numeric>            // `std::accumulate`
+#include <algorithm>          // `std::sort`
+#include <atomic>             // Thread-safe generation counters
+#include <filesystem>         // Enumerating the directory
+#include <fstream>            // Passing file contents to JSON parser
+#include <thread>             // `std::thread` for background checkpoints
+#include <condition_variable> // `std::condition_variable`
 
 // TODO: These alternative containers need further testing:
 // #include <ucset/consistent_avl.hpp> // `ucset::consistent_avl_gt`
@@ -38,6 +44,9 @@
 #include "helpers/linked_memory.hpp" // `linked_memory_t`
 #include "helpers/linked_array.hpp"  // `unintialized_vector_gt`
 #include "ukv/cpp/ranges_args.hpp"   // `places_arg_t`
+#include "helpers/async.hpp"         // `submit_blocking`
+#include "helpers/full_scan.hpp"     // `ranged_bulk_scan_t`
+#include "helpers/lock_table.hpp"    // `lock_table_t`
 
 /*********************************************************/
 /*****************   Structures & Consts  ****************/
@@ -64,6 +73,10 @@ using json_t = nlohmann::json;
 using blob_allocator_t = std::allocator<byte_t>;
 
 static constexpr char const* config_name_k = "config_umem.json";
+static constexpr char const* checkpoint_manifest_k = "checkpoint.json";
+static constexpr std::size_t default_checkpoint_log_bytes_k = 64ul * 1024ul * 1024ul;
+static constexpr std::size_t checkpoint_chunk_pairs_k = 4096;
+static constexpr std::size_t commits_history_limit_k = 1ul << 20;
 
 struct pair_t {
     collection_key_t collection_key;
@@ -125,9 +138,296 @@ struct pair_compare_t {
 //     std::shared_mutex,
 //     64>;
 using ucset_t = locked_gt<consistent_set_gt<pair_t, pair_compare_t>, std::shared_mutex>;
-using transaction_t = typename ucset_t::transaction_t;
+using set_transaction_t = typename ucset_t::transaction_t;
 using generation_t = typename ucset_t::generation_t;
 
+enum class delta_kind_t : std::uint8_t {
+    upsert_k = 1,
+    erase_k = 2,
+    create_k = 3,
+    drop_k = 4,
+};
+
+/**
+ * @brief Serialized changes, that will be appended to the log as a single frame.
+ * Every record starts with a `delta_kind_t` and the collection ID:
+ *
+ *      upsert: [kind][collection][key][length][bytes...]
+ *      erase:  [kind][collection][key]
+ *      create: [kind][collection][length][name...]
+ *      drop:   [kind][collection][mode]
+ */
+struct delta_t {
+    std::string records;
+
+    template <typename scalar_at>
+    void push(scalar_at scalar) noexcept(false) {
+        records.append(reinterpret_cast<char const*>(&scalar), sizeof(scalar_at));
+    }
+
+    void upsert(collection_key_t key, value_view_t value) noexcept(false) {
+        push(delta_kind_t::upsert_k);
+        push(key.collection);
+        push(key.key);
+        push(static_cast<ukv_length_t>(value.size()));
+        records.append(reinterpret_cast<char const*>(value.data()), value.size());
+    }
+
+    void erase(collection_key_t key) noexcept(false) {
+        push(delta_kind_t::erase_k);
+        push(key.collection);
+        push(key.key);
+    }
+
+    void create(ukv_collection_t collection, std::string_view name) noexcept(false) {
+        push(delta_kind_t::create_k);
+        push(collection);
+        push(static_cast<ukv_length_t>(name.size()));
+        records.append(name.data(), name.size());
+    }
+
+    void drop(ukv_collection_t collection, ukv_drop_mode_t mode) noexcept(false) {
+        push(delta_kind_t::drop_k);
+        push(collection);
+        push(static_cast<std::uint8_t>(mode));
+    }
+
+    bool empty() const noexcept { return records.empty(); }
+    void clear() noexcept { records.clear(); }
+};
+
+using sequence_t = std::uint64_t;
+
+/**
+ * @brief Write-sets of recent commits, against which the read-sets of transactions
+ * are validated. Writes are only recorded while some transaction is watching keys,
+ * and are forgotten once every such transaction has started watching after them.
+ * The history is capped at `commits_history_limit_k` entries, beyond which the oldest
+ * commits are forgotten as well, failing the transactions, that still depend on them.
+ */
+struct commits_history_t {
+    struct commit_t {
+        sequence_t sequence = 0;
+        std::vector<collection_key_t> keys;
+        /// Collections, that were cleared or dropped as a whole.
+        std::vector<ukv_collection_t> collections;
+
+        std::size_t entries() const noexcept { return 1 + keys.size() + collections.size(); }
+    };
+
+    /**
+     * @brief Held exclusively by validating commits, which record their changes before
+     * applying them, so no transaction can start watching in between. Shared by transactions
+     * starting to watch and by non-transactional writers, which record their changes after
+     * applying them. So a transaction either reads the written values, or gets a conflict.
+     */
+    std::shared_mutex ordering_mutex;
+    /// Protects all of the following members.
+    std::mutex mutex;
+    sequence_t last_sequence = 0;
+    /// Transactions, that started watching before this commit, can't be validated.
+    sequence_t forgotten_sequence = 0;
+    std::multiset<sequence_t> watchers;
+    std::atomic<std::size_t> watchers_count = 0;
+    std::deque<commit_t> commits;
+    std::size_t commits_entries = 0;
+};
+
+void start_watching(commits_history_t& history, sequence_t& first_sequence) noexcept(false) {
+    std::shared_lock ordering_lock {history.ordering_mutex};
+    std::lock_guard lock {history.mutex};
+    history.watchers.insert(history.last_sequence);
+    history.watchers_count = history.watchers.size();
+    first_sequence = history.last_sequence;
+}
+
+void pop_commit(commits_history_t& history) noexcept {
+    history.commits_entries -= history.commits.front().entries();
+    history.commits.pop_front();
+}
+
+void stop_watching(commits_history_t& history, sequence_t first_sequence) noexcept {
+    std::lock_guard lock {history.mutex};
+    history.watchers.erase(history.watchers.find(first_sequence));
+    history.watchers_count = history.watchers.size();
+    sequence_t oldest = history.watchers.empty() ? history.last_sequence : *history.watchers.begin();
+    while (!history.commits.empty() && history.commits.front().sequence <= oldest)
+        pop_commit(history);
+}
+
+/**
+ * @brief Must be called under the `ordering_mutex`: exclusively before applying the writes,
+ * or shared after applying them. If the commit can't be recorded, every transaction,
+ * that is watching, will fail to commit.
+ */
+void record_commit(commits_history_t& history,
+                   std::vector<collection_key_t>&& keys,
+                   std::vector<ukv_collection_t>&& collections = {}) noexcept {
+    if (!history.watchers_count)
+        return;
+    std::lock_guard lock {history.mutex};
+    ++history.last_sequence;
+    try {
+        history.commits.push_back({history.last_sequence, std::move(keys), std::move(collections)});
+        history.commits_entries += history.commits.back().entries();
+    }
+    catch (...) {
+        history.forgotten_sequence = history.last_sequence;
+    }
+    while (history.commits_entries > commits_history_limit_k) {
+        history.forgotten_sequence = history.commits.front().sequence;
+        pop_commit(history);
+    }
+}
+
+/**
+ * @brief Fails every transaction, that is watching, when a commit can't even be described.
+ */
+void forget_commit(commits_history_t& history) noexcept {
+    std::lock_guard lock {history.mutex};
+    history.forgotten_sequence = ++history.last_sequence;
+}
+
+/**
+ * @brief Records the changes of a non-transactional write, that was just applied.
+ */
+void record_applied(commits_history_t& history, places_arg_t const& places) noexcept {
+    if (!history.watchers_count)
+        return;
+    std::vector<collection_key_t> keys;
+    try {
+        keys.resize(places.size());
+        for (std::size_t i = 0; i != places.size(); ++i)
+            keys[i] = places[i].collection_key();
+    }
+    catch (...) {
+        return forget_commit(history);
+    }
+    record_commit(history, std::move(keys));
+}
+
+/**
+ * @brief Transactions of persistent DBs also accumulate their changes in a `delta_t`,
+ * so that only those have to be logged on commit.
+ *
+ * Instead of looking up the generation of every read key, like the `watch` of
+ * the underlying set does, the keys are appended to the `watched` read-set.
+ * On commit it is sorted and validated against the `commits_history_t` in one
+ * merged pass. Transactions, that haven't written anything, skip the validation.
+ *
+ * Read-only transactions neither track their reads, nor register in the history.
+ *
+ * Pessimistic transactions also lock every key before reading or writing it,
+ * keeping the `locked` keys until the commit or reset. Scans take no locks,
+ * but are still validated on commit, except for the phantoms inserted since.
+ */
+struct transaction_t : public set_transaction_t {
+    delta_t delta;
+    commits_history_t* history = nullptr;
+    lock_table_t* locks = nullptr;
+
+    bool read_only = false;
+    bool pessimistic = false;
+    lock_table_t::clock_t::duration lock_timeout = lock_table_t::default_timeout_k;
+    std::vector<collection_key_t> locked;
+
+    std::vector<collection_key_t> watched;
+    std::vector<collection_key_t> written;
+    sequence_t first_watched_sequence = 0;
+    bool is_watching = false;
+    /// Set, if a watch couldn't be recorded, failing the commit.
+    bool watches_lost = false;
+
+    transaction_t(set_transaction_t&& txn, commits_history_t& history, lock_table_t& locks) noexcept(false)
+        : set_transaction_t(std::move(txn)), history(&history), locks(&locks) {}
+    ~transaction_t() noexcept { forget(); }
+
+    void lock(places_arg_t const& places, ukv_error_t* c_error) noexcept(false) {
+        std::vector<collection_key_t> keys(places.size());
+        for (std::size_t i = 0; i != places.size(); ++i)
+            keys[i] = places[i].collection_key();
+        lock_keys(*locks, this, keys, lock_timeout, locked, c_error);
+    }
+
+    /**
+     * @brief Must be called before the first `watch`, outside of the locks of the set.
+     */
+    void prepare_watches(std::size_t count) noexcept(false) {
+        if (!is_watching) {
+            start_watching(*history, first_watched_sequence);
+            is_watching = true;
+        }
+        watched.reserve(watched.size() + count);
+    }
+
+    void watch(collection_key_t key) noexcept {
+        try {
+            watched.push_back(key);
+        }
+        catch (...) {
+            watches_lost = true;
+        }
+    }
+
+    void forget() noexcept {
+        if (is_watching)
+            stop_watching(*history, first_watched_sequence);
+        locks->unlock(this, locked);
+        locked.clear();
+        is_watching = false;
+        watches_lost = false;
+        watched.clear();
+        written.clear();
+        delta.clear();
+    }
+};
+
+/**
+ * @brief Checks, if any of the watched keys was changed by a commit,
+ * recorded after the transaction has started watching.
+ */
+bool validate_watches(transaction_t& txn) noexcept(false) {
+    if (txn.watches_lost)
+        return false;
+    if (txn.watched.empty())
+        return true;
+
+    commits_history_t& history = *txn.history;
+    std::vector<collection_key_t> changed_keys;
+    std::vector<ukv_collection_t> changed_collections;
+    {
+        std::lock_guard lock {history.mutex};
+        if (history.forgotten_sequence > txn.first_watched_sequence)
+            return false;
+        for (auto const& commit : history.commits) {
+            if (commit.sequence <= txn.first_watched_sequence)
+                continue;
+            changed_keys.insert(changed_keys.end(), commit.keys.begin(), commit.keys.end());
+            changed_collections.insert(changed_collections.end(), commit.collections.begin(), commit.collections.end());
+        }
+    }
+    if (changed_keys.empty() && changed_collections.empty())
+        return true;
+
+    std::sort(txn.watched.begin(), txn.watched.end());
+    std::sort(changed_keys.begin(), changed_keys.end());
+    std::sort(changed_collections.begin(), changed_collections.end());
+
+    auto key_it = changed_keys.begin();
+    auto collection_it = changed_collections.begin();
+    for (collection_key_t const& watched : txn.watched) {
+        while (collection_it != changed_collections.end() && *collection_it < watched.collection)
+            ++collection_it;
+        if (collection_it != changed_collections.end() && *collection_it == watched.collection)
+            return false;
+        while (key_it != changed_keys.end() && *key_it < watched)
+            ++key_it;
+        if (key_it != changed_keys.end() && *key_it == watched)
+            return false;
+    }
+    return true;
+}
+
 template <typename set_or_transaction_at, typename callback_at>
 ucset::status_t find_and_watch(set_or_transaction_at& set_or_transaction,
                                collection_key_t collection_key,
@@ -137,8 +437,7 @@ ucset::status_t find_and_watch(set_or_transaction_at& set_or_transaction,
     if constexpr (!std::is_same<set_or_transaction_at, ucset_t>()) {
         bool dont_watch = options & ukv_option_transaction_dont_watch_k;
         if (!dont_watch)
-            if (auto watch_status = set_or_transaction.watch(collection_key); !watch_status)
-                return watch_status;
+            set_or_transaction.watch(collection_key);
     }
 
     auto find_status = set_or_transaction.find(
@@ -158,7 +457,6 @@ ucset::status_t scan_and_watch(set_or_transaction_at& set_or_transaction,
     std::size_t match_idx = 0;
     collection_key_t previous = start;
     bool reached_end = false;
-    auto watch_status = ucset::status_t();
     auto callback_pair = [&](pair_t const& pair) noexcept {
         reached_end = pair.collection_key.collection != previous.collection;
         if (reached_end)
@@ -167,8 +465,7 @@ ucset::status_t scan_and_watch(set_or_transaction_at& set_or_transaction,
         if constexpr (!std::is_same<set_or_transaction_at, ucset_t>()) {
             bool dont_watch = options & ukv_option_transaction_dont_watch_k;
             if (!dont_watch)
-                if (watch_status = set_or_transaction.watch(pair); !watch_status)
-                    return;
+                set_or_transaction.watch(pair.collection_key);
         }
 
         callback(pair);
@@ -179,15 +476,11 @@ ucset::status_t scan_and_watch(set_or_transaction_at& set_or_transaction,
     auto find_status = set_or_transaction.find(start, callback_pair, {});
     if (!find_status)
         return find_status;
-    if (!watch_status)
-        return watch_status;
 
     while (match_idx != range_limit && !reached_end) {
         find_status = set_or_transaction.upper_bound(previous, callback_pair, [&]() noexcept { reached_end = true; });
         if (!find_status)
             return find_status;
-        if (!watch_status)
-            return watch_status;
     }
 
     return {};
@@ -242,6 +535,42 @@ struct string_less_t : public std::less<std::string_view> {
     using is_transparent = void;
 };
 
+/**
+ * @brief Append-only log of committed changes, split into numbered segments, like
+ * "delta-000042.log". Every segment is a sequence of frames, each holding the
+ * `delta_t` of a single commit:
+ *
+ *      [length: u32][checksum: u32][records...]
+ *
+ * A frame with a mismatching checksum marks a torn write, where the recovery stops,
+ * discarding the rest of that segment and all the following ones.
+ */
+struct delta_log_t {
+    /**
+     * @brief Orders the appends the same way as the writes are applied.
+     * Held by all the writers of persistent DBs, but never by readers.
+     */
+    std::mutex mutex;
+    std::FILE* file = nullptr;
+    std::size_t segment = 0;
+    std::size_t segment_bytes = 0;
+};
+
+/**
+ * @brief Background thread, that compacts the log into Parquet checkpoints,
+ * once the current segment grows beyond `log_bytes_limit`.
+ */
+struct checkpointer_t {
+    std::mutex mutex;
+    std::condition_variable wake_up;
+    bool requested = false;
+    bool stopping = false;
+    std::thread thread;
+    /// Prevents the final checkpoint on close from overlapping with a background one.
+    std::mutex running_mutex;
+    std::size_t log_bytes_limit = default_checkpoint_log_bytes_k;
+};
+
 struct database_t {
     /**
      * @brief Rarely-used mutex for global reorganizations, like:
@@ -268,11 +597,28 @@ struct database_t {
      */
     std::string persisted_directory;
 
-    database_t(ucset_t&& set) noexcept(false) : pairs(std::move(set)) {}
+    /**
+     * @brief Transactional changes since the last checkpoint.
+     * Only used, if the `persisted_directory` is set.
+     */
+    delta_log_t log;
+    checkpointer_t checkpointer;
+
+    /**
+     * @brief Recent writes, against which transactions validate their reads.
+     */
+    commits_history_t history;
 
-    database_t(database_t&& other) noexcept
-        : pairs(std::move(other.pairs)), names(std::move(other.names)),
-          persisted_directory(std::move(other.persisted_directory)) {}
+    /**
+     * @brief Keys locked by pessimistic transactions.
+     */
+    lock_table_t locks;
+
+    database_t(ucset_t&& set) noexcept(false) : pairs(std::move(set)) {}
+    ~database_t() noexcept {
+        if (log.file)
+            std::fclose(log.file);
+    }
 };
 
 ukv_collection_t new_collection(database_t& db) noexcept {
@@ -298,11 +644,314 @@ void export_error_code(ucset::status_t code, ukv_error_t* c_error) noexcept {
 /*****************	 Writing to Disk	  ****************/
 /*********************************************************/
 
-void write_collection( //
-    database_t const& db,
-    ukv_collection_t collection_id,
-    std::string const& collection_path,
-    ukv_error_t* c_error) noexcept(false) {
+bool ends_with(std::string_view str, std::string_view suffix) noexcept {
+    return str.size() >= suffix.size() &&
+           0 == str.compare(str.size() - suffix.size(), suffix.size(), suffix.data(), suffix.size());
+}
+
+ucset::status_t drop_collection(database_t& db, ukv_collection_t collection, ukv_drop_mode_t mode) noexcept {
+
+    if (mode == ukv_drop_keys_vals_handle_k) {
+        auto status = db.pairs.erase_range(collection, collection + 1, no_op_t {});
+        if (!status)
+            return status;
+
+        for (auto it = db.names.begin(); it != db.names.end(); ++it) {
+            if (collection != it->second)
+                continue;
+            db.names.erase(it);
+            break;
+        }
+        return {};
+    }
+
+    else if (mode == ukv_drop_keys_vals_k)
+        return db.pairs.erase_range(collection, collection + 1, no_op_t {});
+
+    else if (mode == ukv_drop_vals_k)
+        return db.pairs.range(collection, collection + 1, [&](pair_t& pair) noexcept {
+            pair = pair_t {pair.collection_key, value_view_t::make_empty(), nullptr};
+        });
+
+    return {};
+}
+
+std::uint32_t delta_checksum(std::string_view records) noexcept {
+    std::uint32_t hash = 0x811C9DC5u;
+    for (char c : records)
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x01000193u;
+    return hash;
+}
+
+stdfs::path segment_path(stdfs::path const& root, std::size_t segment) noexcept(false) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "delta-%06zu.log", segment);
+    return root / name;
+}
+
+std::string checkpoint_name(std::size_t first_segment) noexcept(false) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "checkpoint-%06zu", first_segment);
+    return name;
+}
+
+/**
+ * @brief Lists the indexes of all the log segments in the directory, in ascending order.
+ */
+std::vector<std::size_t> list_segments(stdfs::path const& root) noexcept(false) {
+    std::vector<std::size_t> segments;
+    for (auto const& dir_entry : stdfs::directory_iterator {root}) {
+        std::string name = dir_entry.path().filename();
+        std::size_t segment = 0;
+        int consumed = 0;
+        if (std::sscanf(name.c_str(), "delta-%zu.log%n", &segment, &consumed) == 1 &&
+            static_cast<std::size_t>(consumed) == name.size())
+            segments.push_back(segment);
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+/**
+ * @brief Closes the current segment of the log and starts appending to a new one.
+ * Must be called under the `delta_log_t::mutex`.
+ */
+void open_segment(database_t& db, std::size_t segment, ukv_error_t* c_error) noexcept(false) {
+    delta_log_t& log = db.log;
+    if (log.file) {
+        bool synced = std::fflush(log.file) == 0 && fdatasync(fileno(log.file)) == 0;
+        std::fclose(log.file);
+        log.file = nullptr;
+        return_error_if_m(synced, c_error, error_unknown_k, "Failed to flush the log");
+    }
+
+    auto path = segment_path(db.persisted_directory, segment);
+    log.file = std::fopen(path.c_str(), "ab");
+    return_error_if_m(log.file, c_error, error_unknown_k, "Failed to open the log");
+    log.segment = segment;
+    log.segment_bytes = 0;
+}
+
+/**
+ * @brief Appends a frame to the current segment of the log, unless it's empty.
+ * With `flush`, also makes all the previously appended frames durable.
+ * Must be called under the `delta_log_t::mutex`, right after the commit.
+ */
+void append_frame(delta_log_t& log, std::string_view records, bool flush, ukv_error_t* c_error) noexcept {
+    return_error_if_m(log.file, c_error, uninitialized_state_k, "The log isn't open");
+    return_error_if_m(records.size() <= std::numeric_limits<std::uint32_t>::max(),
+                      c_error,
+                      args_wrong_k,
+                      "Transaction is too big to be logged");
+
+    if (!records.empty()) {
+        std::uint32_t header[2] = {static_cast<std::uint32_t>(records.size()), delta_checksum(records)};
+        bool written = std::fwrite(header, sizeof(header), 1, log.file) == 1 &&
+                       std::fwrite(records.data(), records.size(), 1, log.file) == 1;
+        return_error_if_m(written, c_error, error_unknown_k, "Failed to append to the log");
+        log.segment_bytes += sizeof(header) + records.size();
+    }
+
+    // Unflushed commits may stay in the user-space buffer
+    if (flush) {
+        bool synced = std::fflush(log.file) == 0 && fdatasync(fileno(log.file)) == 0;
+        return_error_if_m(synced, c_error, error_unknown_k, "Failed to flush the log");
+    }
+}
+
+void request_checkpoint(database_t& db) noexcept {
+    std::lock_guard _ {db.checkpointer.mutex};
+    db.checkpointer.requested = true;
+    db.checkpointer.wake_up.notify_one();
+}
+
+/**
+ * @brief Appends the changes, that were just applied under the `log_lock`, and releases it.
+ * Wakes up the checkpointer, once the current segment grows too big.
+ */
+void append_applied(database_t& db,
+                    std::unique_lock<std::mutex>& log_lock,
+                    std::string_view records,
+                    bool flush,
+                    ukv_error_t* c_error) noexcept {
+    append_frame(db.log, records, flush, c_error);
+    bool should_checkpoint = db.log.segment_bytes >= db.checkpointer.log_bytes_limit;
+    log_lock.unlock();
+    if (should_checkpoint)
+        request_checkpoint(db);
+}
+
+/**
+ * @brief Applies the records of a single logged frame to the in-memory state.
+ */
+void apply_delta(database_t& db, std::string_view records, ukv_error_t* c_error) noexcept(false) {
+
+    auto pop = [&](auto& scalar) noexcept {
+        if (records.size() < sizeof(scalar))
+            return false;
+        std::memcpy(&scalar, records.data(), sizeof(scalar));
+        records.remove_prefix(sizeof(scalar));
+        return true;
+    };
+
+    while (!records.empty()) {
+        delta_kind_t kind;
+        collection_key_t key;
+        ukv_length_t length = 0;
+        std::uint8_t mode = 0;
+        return_error_if_m(pop(kind) && pop(key.collection), c_error, error_unknown_k, "Corrupted log record");
+
+        ucset::status_t status;
+        switch (kind) {
+        case delta_kind_t::upsert_k: {
+            bool valid = pop(key.key) && pop(length) && records.size() >= length;
+            return_error_if_m(valid, c_error, error_unknown_k, "Corrupted log record");
+            auto value = length ? value_view_t {reinterpret_cast<byte_t const*>(records.data()), length}
+                                : value_view_t::make_empty();
+            records.remove_prefix(length);
+            pair_t pair {key, value, c_error};
+            return_if_error_m(c_error);
+            status = db.pairs.upsert(std::move(pair));
+            break;
+        }
+        case delta_kind_t::erase_k: {
+            return_error_if_m(pop(key.key), c_error, error_unknown_k, "Corrupted log record");
+            if (key.key == std::numeric_limits<ukv_key_t>::max())
+                break;
+            collection_key_t next {key.collection, key.key + 1};
+            status = db.pairs.erase_range(key, next, no_op_t {});
+            break;
+        }
+        case delta_kind_t::create_k: {
+            bool valid = pop(length) && records.size() >= length;
+            return_error_if_m(valid, c_error, error_unknown_k, "Corrupted log record");
+            db.names[std::string(records.substr(0, length))] = key.collection;
+            records.remove_prefix(length);
+            break;
+        }
+        case delta_kind_t::drop_k: {
+            return_error_if_m(pop(mode), c_error, error_unknown_k, "Corrupted log record");
+            status = drop_collection(db, key.collection, static_cast<ukv_drop_mode_t>(mode));
+            break;
+        }
+        default: return_error_if_m(false, c_error, error_unknown_k, "Unknown log record");
+        }
+        export_error_code(status, c_error);
+        return_if_error_m(c_error);
+    }
+}
+
+/**
+ * @brief Replays all the intact frames of a log segment.
+ * The first torn or corrupted frame and everything after it are skipped,
+ * as those commits were never acknowledged as flushed. The torn tail is cut off,
+ * so that the frames appended after the recovery aren't hidden behind it.
+ * @return Whether the whole segment was intact.
+ */
+bool replay_segment(database_t& db, stdfs::path const& path, ukv_error_t* c_error) noexcept(false) {
+    std::string contents;
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    std::string_view remaining = contents;
+
+    std::uint32_t header[2];
+    while (remaining.size() >= sizeof(header)) {
+        std::memcpy(header, remaining.data(), sizeof(header));
+        if (remaining.size() - sizeof(header) < header[0])
+            break;
+        std::string_view records = remaining.substr(sizeof(header), header[0]);
+        if (delta_checksum(records) != header[1])
+            break;
+        remaining.remove_prefix(sizeof(header) + header[0]);
+        apply_delta(db, records, c_error);
+        if (*c_error)
+            return false;
+    }
+
+    if (remaining.empty())
+        return true;
+
+    log_warning_m("Skipped a torn tail of the log %s\n", path.c_str());
+    stdfs::resize_file(path, contents.size() - remaining.size());
+    return false;
+}
+
+/**
+ * @brief Bounded chunk of pairs of a single collection, copied
+ * pair by pair, so that it can be dumped to disk without any locks.
+ */
+struct collection_chunk_t {
+    std::vector<ukv_key_t> keys;
+    std::vector<ukv_length_t> lengths;
+    std::string values;
+
+    void clear() noexcept {
+        keys.clear();
+        lengths.clear();
+        values.clear();
+    }
+};
+
+/**
+ * @brief Copies up to `checkpoint_chunk_pairs_k` pairs of a collection, following the `previous` key.
+ * Every pair is fetched with a separate lookup, so the set is never locked for longer than that.
+ * @return Whether the collection was exhausted.
+ */
+bool copy_chunk(database_t& db,
+                collection_key_t& previous,
+                bool& is_first,
+                collection_chunk_t& chunk,
+                ukv_error_t* c_error) noexcept {
+
+    bool out_of_memory = false;
+    bool reached_end = false;
+    auto callback_pair = [&](pair_t const& pair) noexcept {
+        reached_end = pair.collection_key.collection != previous.collection;
+        if (reached_end)
+            return;
+        previous.key = pair.collection_key.key;
+        // Erased keys would otherwise be restored as empty values
+        if (!pair.range)
+            return;
+        try {
+            chunk.keys.push_back(pair.collection_key.key);
+            chunk.lengths.push_back(static_cast<ukv_length_t>(pair.range.size()));
+            chunk.values.append(reinterpret_cast<char const*>(pair.range.data()), pair.range.size());
+        }
+        catch (...) {
+            out_of_memory = true;
+        }
+    };
+    auto callback_nothing = [&]() noexcept {
+        reached_end = true;
+    };
+
+    ucset::status_t status;
+    if (is_first) {
+        is_first = false;
+        status = db.pairs.find(previous, callback_pair, no_op_t {});
+    }
+    while (status && !out_of_memory && !reached_end && chunk.keys.size() < checkpoint_chunk_pairs_k)
+        status = db.pairs.upper_bound(previous, callback_pair, callback_nothing);
+
+    export_error_code(status, c_error);
+    if (*c_error)
+        return true;
+    if (out_of_memory)
+        *c_error = "Failed to copy the collection";
+    return reached_end;
+}
+
+/**
+ * @brief Streams a collection into a Parquet file, chunk by chunk,
+ * keeping only a single chunk of pairs in memory at a time.
+ */
+void dump_collection(database_t& db,
+                     ukv_collection_t collection_id,
+                     std::string const& collection_path,
+                     ukv_error_t* c_error) noexcept(false) {
 
     std::shared_ptr<arrow::io::FileOutputStream> out_file;
     PARQUET_ASSIGN_OR_THROW(out_file, arrow::io::FileOutputStream::Open(collection_path));
@@ -323,95 +972,242 @@ void write_collection( //
     parquet::WriterProperties::Builder builder;
     parquet::StreamWriter os {parquet::ParquetFileWriter::Open(out_file, schema, builder.build())};
 
-    collection_key_t min(collection_id, std::numeric_limits<ukv_key_t>::min());
-    collection_key_t max(collection_id, std::numeric_limits<ukv_key_t>::max());
-    auto status = db.pairs.range(min, max, [&](pair_t& pair) noexcept {
-        std::optional<std::string_view> value;
-        if (pair.range.size())
-            value = std::string_view(pair.range);
-        os << pair.collection_key.key << value << parquet::EndRow;
-    });
-    export_error_code(status, c_error);
-    return_if_error_m(c_error);
+    collection_chunk_t chunk;
+    collection_key_t previous {collection_id, std::numeric_limits<ukv_key_t>::min()};
+    bool is_first = true;
+    bool reached_end = false;
+    while (!reached_end) {
+        chunk.clear();
+        reached_end = copy_chunk(db, previous, is_first, chunk, c_error);
+        return_if_error_m(c_error);
+
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i != chunk.keys.size(); ++i) {
+            std::optional<std::string_view> value;
+            if (chunk.lengths[i])
+                value = std::string_view(chunk.values).substr(offset, chunk.lengths[i]), offset += chunk.lengths[i];
+            os << chunk.keys[i] << value << parquet::EndRow;
+        }
+    }
 }
 
-void write(database_t const& db, std::string const& dir_path, ukv_error_t* c_error) noexcept(false) {
+void read_collection( //
+    database_t& db,
+    ukv_collection_t collection_id,
+    stdfs::path const& collection_path,
+    ukv_error_t* c_error) noexcept(false) {
+
+    std::shared_ptr<arrow::io::ReadableFile> in_file;
+    PARQUET_ASSIGN_OR_THROW(in_file, arrow::io::ReadableFile::Open(collection_path));
+    parquet::StreamReader os {parquet::ParquetFileReader::Open(in_file)};
+
+    ukv_key_t key;
+    std::optional<std::string> value;
+    while (!os.eof()) {
+        os >> key >> value >> parquet::EndRow;
+
+        pair_t pair;
+        pair.collection_key.collection = collection_id;
+        pair.collection_key.key = key;
+
+        // Converting to our internal representation would require a copy
+        if (value) {
+            auto buf_len = value->size();
+            auto buf_ptr = blob_allocator_t {}.allocate(buf_len);
+            return_error_if_m(buf_ptr != nullptr, c_error, out_of_memory_k, "Failed to allocate a blob");
+            pair.range = value_view_t {buf_ptr, buf_len};
+            std::memcpy(buf_ptr, value->data(), value->size());
+        }
+        else
+            pair.range = value_view_t::make_empty();
 
-    // Check if the source directory even exists
-    if (!std::filesystem::is_directory(dir_path))
+        auto status = db.pairs.upsert(std::move(pair));
+        export_error_code(status, c_error);
+        return_if_error_m(c_error);
+    }
+}
+
+/**
+ * @brief Compacts the log into a new checkpoint directory and removes the replaced files.
+ *
+ * The log mutex is held only to rotate the log, marking the cut. The collections are then
+ * dumped in bounded chunks, concurrently with writers, so the dump may already include
+ * some of the changes following the cut. Replaying the log from the cut on top of it still
+ * converges to the same state, as every logged record overwrites, erases or empties keys,
+ * regardless of their previous state.
+ */
+void checkpoint(database_t& db, ukv_error_t* c_error) noexcept(false) {
+
+    std::lock_guard running_lock {db.checkpointer.running_mutex};
+    stdfs::path root = db.persisted_directory;
+    if (!stdfs::is_directory(root))
         return;
 
-    auto main_path = stdfs::path(dir_path) / ".parquet";
-    write_collection(db, ukv_collection_main_k, main_path, c_error);
+    // 1. Cut the log, after which everything will land in the next segment
+    std::size_t first_segment = 0;
+    std::map<std::string, ukv_collection_t, string_less_t> names;
+    {
+        std::shared_lock restructuring_lock {db.restructuring_mutex};
+        std::lock_guard log_lock {db.log.mutex};
+        names = db.names;
+        first_segment = db.log.segment + 1;
+        open_segment(db, first_segment, c_error);
+        return_if_error_m(c_error);
+    }
+
+    // 2. Dump every collection into a fresh directory
+    std::string directory_name = checkpoint_name(first_segment);
+    stdfs::path directory = root / directory_name;
+    stdfs::remove_all(directory);
+    stdfs::create_directories(directory);
+    dump_collection(db, ukv_collection_main_k, directory / ".parquet", c_error);
     return_if_error_m(c_error);
 
-    for (auto const& collection : db.names) {
-        auto const& collection_name = collection.first;
-        auto const collection_path = stdfs::path(dir_path) / (collection_name + ".parquet");
-        write_collection(db, collection.second, collection_path, c_error);
+    json_t collections = json_t::object();
+    for (auto const& [name, id] : names) {
+        dump_collection(db, id, directory / (name + ".parquet"), c_error);
         return_if_error_m(c_error);
+        collections[name] = id;
+    }
+
+    // 3. Atomically switch to the new checkpoint
+    json_t manifest = {
+        {"directory", directory_name},
+        {"segment", first_segment},
+        {"collections", std::move(collections)},
+    };
+    std::string manifest_str = manifest.dump();
+    stdfs::path manifest_path = root / checkpoint_manifest_k;
+    stdfs::path manifest_temporary_path = root / (std::string(checkpoint_manifest_k) + ".tmp");
+    {
+        file_handle_t file;
+        auto opened = file.open(manifest_temporary_path.c_str(), "wb");
+        return_error_if_m(opened, c_error, error_unknown_k, "Failed to write the checkpoint manifest");
+        bool written = std::fwrite(manifest_str.data(), manifest_str.size(), 1, file) == 1 &&
+                       std::fflush(file) == 0 && fdatasync(fileno(file)) == 0;
+        return_error_if_m(written, c_error, error_unknown_k, "Failed to write the checkpoint manifest");
+    }
+    stdfs::rename(manifest_temporary_path, manifest_path);
+
+    // 4. Remove the older checkpoints, segments and dumps of the previous format
+    for (auto const& dir_entry : stdfs::directory_iterator {root}) {
+        std::string name = dir_entry.path().filename();
+        bool is_old_checkpoint = name.rfind("checkpoint-", 0) == 0 && name != directory_name;
+        bool is_old_dump = ends_with(name, ".parquet") && dir_entry.is_regular_file();
+        if (is_old_checkpoint || is_old_dump)
+            stdfs::remove_all(dir_entry.path());
     }
+    for (std::size_t segment : list_segments(root))
+        if (segment < first_segment)
+            stdfs::remove(segment_path(root, segment));
 }
 
-bool ends_with(std::string_view str, std::string_view suffix) noexcept {
-    return str.size() >= suffix.size() &&
-           0 == str.compare(str.size() - suffix.size(), suffix.size(), suffix.data(), suffix.size());
+void checkpoints_loop(database_t& db) noexcept {
+    checkpointer_t& checkpointer = db.checkpointer;
+    std::unique_lock lock {checkpointer.mutex};
+    while (true) {
+        checkpointer.wake_up.wait(lock, [&] { return checkpointer.requested || checkpointer.stopping; });
+        if (checkpointer.stopping)
+            break;
+        checkpointer.requested = false;
+        lock.unlock();
+
+        ukv_error_t c_error = nullptr;
+        safe_section("Checkpointing", &c_error, [&] { checkpoint(db, &c_error); });
+        if (c_error)
+            log_warning_m("Background checkpoint failed: %s\n", c_error);
+        lock.lock();
+    }
+}
+
+void stop_checkpoints(database_t& db) noexcept {
+    {
+        std::lock_guard _ {db.checkpointer.mutex};
+        db.checkpointer.stopping = true;
+        db.checkpointer.wake_up.notify_one();
+    }
+    if (db.checkpointer.thread.joinable())
+        db.checkpointer.thread.join();
 }
 
-void read(database_t& db, std::string const& path, ukv_error_t* c_error) noexcept(false) {
+/**
+ * @brief Restores the state from the last checkpoint and the log segments following it.
+ * Directories with a Parquet file per collection and no checkpoint manifest,
+ * written by the older versions, are loaded as well.
+ * @return Whether a checkpoint was found.
+ */
+bool read(database_t& db, std::string const& path, ukv_error_t* c_error) noexcept(false) {
 
     // Clear the DB, before refilling it
     db.names.clear();
     auto status = db.pairs.clear();
     export_error_code(status, c_error);
-    return_if_error_m(c_error);
+    if (*c_error)
+        return false;
 
     // Check if the source directory even exists
     if (!std::filesystem::is_directory(path))
-        return;
+        return false;
+
+    stdfs::path root = path;
+    stdfs::path manifest_path = root / checkpoint_manifest_k;
+    bool has_checkpoint = stdfs::exists(manifest_path);
+    std::size_t first_segment = 0;
+    if (has_checkpoint) {
+        std::ifstream ifs(manifest_path);
+        json_t manifest = json_t::parse(ifs);
+        stdfs::path directory = root / manifest["directory"].get<std::string>();
+        first_segment = manifest["segment"].get<std::size_t>();
+
+        read_collection(db, ukv_collection_main_k, directory / ".parquet", c_error);
+        if (*c_error)
+            return false;
+        for (auto const& name_and_id : manifest["collections"].items()) {
+            auto collection_id = name_and_id.value().get<ukv_collection_t>();
+            db.names.emplace(name_and_id.key(), collection_id);
+            read_collection(db, collection_id, directory / (name_and_id.key() + ".parquet"), c_error);
+            if (*c_error)
+                return false;
+        }
+    }
+    else {
+        // Loop over all persisted collections, reading them one by one
+        std::string_view extension {".parquet"};
+        for (auto const& dir_entry : std::filesystem::directory_iterator {path}) {
+            auto const& collection_path = dir_entry.path();
+            std::string collection_name = collection_path.filename();
+            if (!ends_with(collection_name, extension))
+                continue;
 
-    // Loop over all persisted collections, reading them one by one
-    std::string_view extension {".parquet"};
-    for (auto const& dir_entry : std::filesystem::directory_iterator {path}) {
-        auto const& collection_path = dir_entry.path();
-        std::string collection_name = collection_path.filename();
-        if (!ends_with(collection_name, extension))
-            continue;
+            collection_name.resize(collection_name.size() - extension.size());
+            ukv_collection_t collection_id = collection_name.empty() ? ukv_collection_main_k : new_collection(db);
+            if (!collection_name.empty())
+                db.names.emplace(collection_name, collection_id);
 
-        collection_name.resize(collection_name.size() - extension.size());
-        ukv_collection_t collection_id = collection_name.empty() ? ukv_collection_main_k : new_collection(db);
-        if (!collection_name.empty())
-            db.names.emplace(collection_name, collection_id);
-
-        std::shared_ptr<arrow::io::ReadableFile> in_file;
-        PARQUET_ASSIGN_OR_THROW(in_file, arrow::io::ReadableFile::Open(collection_path));
-        parquet::StreamReader os {parquet::ParquetFileReader::Open(in_file)};
-
-        ukv_key_t key;
-        std::optional<std::string> value;
-        while (!os.eof()) {
-            os >> key >> value >> parquet::EndRow;
-
-            pair_t pair;
-            pair.collection_key.collection = collection_id;
-            pair.collection_key.key = key;
-
-            // Converting to our internal representation would require a copy
-            if (value) {
-                auto buf_len = value->size();
-                auto buf_ptr = blob_allocator_t {}.allocate(buf_len);
-                return_error_if_m(buf_ptr != nullptr, c_error, out_of_memory_k, "Failed to allocate a blob");
-                pair.range = value_view_t {buf_ptr, buf_len};
-                std::memcpy(buf_ptr, value->data(), value->size());
-            }
-            else
-                pair.range = value_view_t::make_empty();
+            read_collection(db, collection_id, collection_path, c_error);
+            if (*c_error)
+                return false;
+        }
+    }
 
-            auto status = db.pairs.upsert(std::move(pair));
-            export_error_code(status, c_error);
-            return_if_error_m(c_error);
+    // Replay the changes committed after the checkpoint.
+    // Frames following a torn one may depend on the lost changes, so they are dropped as well.
+    db.log.segment = first_segment;
+    bool is_torn = false;
+    for (std::size_t segment : list_segments(root)) {
+        if (segment < first_segment)
+            continue;
+        if (is_torn) {
+            log_warning_m("Skipped the log segment %zu following a torn one\n", segment);
+            stdfs::remove(segment_path(root, segment));
+            continue;
         }
+        is_torn = !replay_segment(db, segment_path(root, segment), c_error);
+        if (*c_error)
+            return false;
+        db.log.segment = segment;
     }
+    return has_checkpoint;
 }
 
 /*********************************************************/
@@ -424,8 +1220,7 @@ void ukv_database_init(ukv_database_init_t* c_ptr) {
     safe_section("Initializing DBMS", c.error, [&] {
         auto maybe_pairs = ucset_t::make();
         return_error_if_m(maybe_pairs, c.error, error_unknown_k, "Couldn't build consistent set");
-        auto db = database_t(std::move(maybe_pairs).value());
-        auto db_ptr = std::make_unique<database_t>(std::move(db)).release();
+        auto db = std::make_unique<database_t>(std::move(maybe_pairs).value());
         auto len = c.config ? std::strlen(c.config) : 0;
         if (len) {
 
@@ -447,12 +1242,27 @@ void ukv_database_init(ukv_database_init_t* c_ptr) {
             else {
                 std::ifstream ifs(config_path.c_str());
                 json_t js = json_t::parse(ifs);
+                db->checkpointer.log_bytes_limit = js.value("checkpoint_log_bytes", default_checkpoint_log_bytes_k);
             }
 
-            db_ptr->persisted_directory = std::string(c.config, len);
-            read(*db_ptr, db_ptr->persisted_directory, c.error);
+            db->persisted_directory = std::string(c.config, len);
+            bool has_checkpoint = read(*db, db->persisted_directory, c.error);
+            return_if_error_m(c.error);
+
+            // Without a checkpoint, the collection IDs aren't persisted yet,
+            // so the log would be impossible to replay after a restart
+            if (!has_checkpoint)
+                checkpoint(*db, c.error);
+            else {
+                std::lock_guard _ {db->log.mutex};
+                open_segment(*db, db->log.segment + 1, c.error);
+            }
+            return_if_error_m(c.error);
+
+            database_t& db_ref = *db;
+            db->checkpointer.thread = std::thread([&db_ref] { checkpoints_loop(db_ref); });
         }
-        *c.db = db_ptr;
+        *c.db = db.release();
     });
 }
 
@@ -471,6 +1281,7 @@ void ukv_snapshot_drop(ukv_snapshot_drop_t*) {
 void ukv_read(ukv_read_t* c_ptr) {
 
     ukv_read_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::read_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     if (!c.tasks_count)
         return;
@@ -492,15 +1303,27 @@ void ukv_read(ukv_read_t* c_ptr) {
     return_if_error_m(c.error);
     auto back_inserter = [&](value_view_t value) noexcept {
         tape.push_back(value, c.error);
+        metric.add_bytes(value.size());
     };
 
     // 2. Pull the data
+    ukv_options_t const options = c.transaction && txn.read_only //
+                                      ? ukv_options_t(c.options | ukv_option_transaction_dont_watch_k)
+                                      : c.options;
+    bool dont_watch = options & ukv_option_transaction_dont_watch_k;
+    if (c.transaction && txn.pessimistic)
+        safe_section("Locking the keys", c.error, [&] { txn.lock(places, c.error); });
+    return_if_error_m(c.error);
+    if (c.transaction && !dont_watch)
+        safe_section("Watching the keys", c.error, [&] { txn.prepare_watches(places.size()); });
+    return_if_error_m(c.error);
+
     for (std::size_t task_idx = 0; task_idx != places.size(); ++task_idx) {
         place_t place = places[task_idx];
         collection_key_t key = place.collection_key();
         auto status = c.transaction //
-                          ? find_and_watch(txn, key, c.options, back_inserter)
-                          : find_and_watch(db.pairs, key, c.options, back_inserter);
+                          ? find_and_watch(txn, key, options, back_inserter)
+                          : find_and_watch(db.pairs, key, options, back_inserter);
         if (!status)
             return export_error_code(status, c.error);
     }
@@ -519,6 +1342,7 @@ void ukv_read(ukv_read_t* c_ptr) {
 void ukv_write(ukv_write_t* c_ptr) {
 
     ukv_write_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::write_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     if (!c.tasks_count)
         return;
@@ -540,20 +1364,34 @@ void ukv_write(ukv_write_t* c_ptr) {
 
     validate_write(c.transaction, places, contents, c.options, c.error);
     return_if_error_m(c.error);
+    if (metric.enabled())
+        for (std::size_t i = 0; i != contents.size(); ++i)
+            metric.add_bytes(contents[i].size());
 
     // Writes are the only operations that significantly differ
     // in terms of transactional and batch operations.
     // The latter will also differ depending on the number
     // pairs you are working with - one or more.
     if (c.transaction) {
+        return_error_if_m(!txn.read_only, c.error, args_combo_k, "Read-only transactions can't write");
         bool dont_watch = c.options & ukv_option_transaction_dont_watch_k;
+        if (txn.pessimistic)
+            safe_section("Locking the keys", c.error, [&] { txn.lock(places, c.error); });
+        return_if_error_m(c.error);
+        safe_section("Watching the keys", c.error, [&] {
+            if (!dont_watch)
+                txn.prepare_watches(places.size());
+            txn.written.reserve(txn.written.size() + places.size());
+        });
+        return_if_error_m(c.error);
+
         for (std::size_t i = 0; i != places.size(); ++i) {
             place_t place = places[i];
             value_view_t content = contents[i];
             collection_key_t key = place.collection_key();
             if (!dont_watch)
-                if (auto watch_status = txn.watch(key); !watch_status)
-                    return export_error_code(watch_status, c.error);
+                txn.watch(key);
+            txn.written.push_back(key);
 
             ucset::status_t status;
             if (content) {
@@ -567,12 +1405,47 @@ void ukv_write(ukv_write_t* c_ptr) {
             if (!status)
                 return export_error_code(status, c.error);
         }
+
+        // Persistent DBs will only log these changes on commit
+        if (!db.persisted_directory.empty())
+            safe_section("Recording the changes", c.error, [&] {
+                for (std::size_t i = 0; i != places.size(); ++i) {
+                    value_view_t content = contents[i];
+                    collection_key_t key = places[i].collection_key();
+                    if (content)
+                        txn.delta.upsert(key, content);
+                    else
+                        txn.delta.erase(key);
+                }
+            });
         return;
     }
 
+    // Persistent DBs log these changes in the same order, as they are applied
+    delta_t delta;
+    std::unique_lock<std::mutex> log_lock;
+    if (!db.persisted_directory.empty()) {
+        safe_section("Logging the changes", c.error, [&] {
+            for (std::size_t i = 0; i != places.size(); ++i) {
+                value_view_t content = contents[i];
+                collection_key_t key = places[i].collection_key();
+                if (content)
+                    delta.upsert(key, content);
+                else
+                    delta.erase(key);
+            }
+        });
+        return_if_error_m(c.error);
+        log_lock = std::unique_lock {db.log.mutex};
+    }
+
+    // Transactions, that have watched any of those keys, will fail to commit
+    std::shared_lock ordering_lock {db.history.ordering_mutex};
+
     // Non-transactional but atomic batch-write operation.
     // It requires producing a copy of input data.
-    else if (c.tasks_count > 1) {
+    ucset::status_t status;
+    if (c.tasks_count > 1) {
         uninitialized_array_gt<pair_t> copies(places.count, arena, c.error);
         return_if_error_m(c.error);
         initialized_range_gt<pair_t> copies_constructed(copies);
@@ -587,8 +1460,7 @@ void ukv_write(ukv_write_t* c_ptr) {
             copies[i] = std::move(pair);
         }
 
-        auto status = db.pairs.upsert(std::make_move_iterator(copies.begin()), std::make_move_iterator(copies.end()));
-        return export_error_code(status, c.error);
+        status = db.pairs.upsert(std::make_move_iterator(copies.begin()), std::make_move_iterator(copies.end()));
     }
 
     // Just a single non-batch write
@@ -599,14 +1471,29 @@ void ukv_write(ukv_write_t* c_ptr) {
 
         pair_t pair {key, content, c.error};
         return_if_error_m(c.error);
-        auto status = db.pairs.upsert(std::move(pair));
-        return export_error_code(status, c.error);
+        status = db.pairs.upsert(std::move(pair));
     }
+
+    export_error_code(status, c.error);
+    return_if_error_m(c.error);
+    record_applied(db.history, places);
+    ordering_lock.unlock();
+    if (log_lock.owns_lock())
+        append_applied(db, log_lock, delta.records, c.options & ukv_option_write_flush_k, c.error);
+}
+
+void ukv_read_async(ukv_read_t* c_ptr, ukv_callback_t callback, ukv_callback_payload_t payload) {
+    submit_blocking(c_ptr, &ukv_read, callback, payload);
+}
+
+void ukv_write_async(ukv_write_t* c_ptr, ukv_callback_t callback, ukv_callback_payload_t payload) {
+    submit_blocking(c_ptr, &ukv_write, callback, payload);
 }
 
 void ukv_scan(ukv_scan_t* c_ptr) {
 
     ukv_scan_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     if (!c.tasks_count)
         return;
@@ -634,7 +1521,23 @@ void ukv_scan(ukv_scan_t* c_ptr) {
     auto keys_output = *c.keys = arena.alloc<ukv_key_t>(total_keys, c.error).begin();
     return_if_error_m(c.error);
 
+    // Values are optional, but are cheap to take from the iterator, that has just visited them
+    bool const needs_values = c.values || c.values_offsets || c.values_lengths;
+    auto values_offsets = arena.alloc_or_dummy(total_keys + 1, c.error, c.values_offsets);
+    return_if_error_m(c.error);
+    auto values_lengths = arena.alloc_or_dummy(total_keys, c.error, c.values_lengths);
+    return_if_error_m(c.error);
+    uninitialized_array_gt<byte_t> contents(arena);
+
     // 2. Fetch the data
+    ukv_options_t const options = c.transaction && txn.read_only //
+                                      ? ukv_options_t(c.options | ukv_option_transaction_dont_watch_k)
+                                      : c.options;
+    bool dont_watch = options & ukv_option_transaction_dont_watch_k;
+    if (c.transaction && !dont_watch)
+        safe_section("Watching the keys", c.error, [&] { txn.prepare_watches(total_keys); });
+    return_if_error_m(c.error);
+
     for (std::size_t task_idx = 0; task_idx != scans.count; ++task_idx) {
         scan_t scan = scans[task_idx];
         offsets[task_idx] = keys_output - *c.keys;
@@ -642,20 +1545,102 @@ void ukv_scan(ukv_scan_t* c_ptr) {
         ukv_length_t matched_pairs_count = 0;
         auto found_pair = [&](pair_t const& pair) noexcept {
             *keys_output = pair.collection_key.key;
+            if (needs_values) {
+                auto entry_idx = keys_output - *c.keys;
+                values_offsets[entry_idx] = static_cast<ukv_length_t>(contents.size());
+                values_lengths[entry_idx] = static_cast<ukv_length_t>(pair.range.size());
+                contents.insert(contents.size(), pair.range.begin(), pair.range.end(), c.error);
+            }
             ++keys_output;
             ++matched_pairs_count;
         };
 
         auto previous_key = collection_key_t {scan.collection, scan.min_key};
         auto status = c.transaction //
-                          ? scan_and_watch(txn, previous_key, scan.limit, c.options, found_pair)
-                          : scan_and_watch(db.pairs, previous_key, scan.limit, c.options, found_pair);
+                          ? scan_and_watch(txn, previous_key, scan.limit, options, found_pair)
+                          : scan_and_watch(db.pairs, previous_key, scan.limit, options, found_pair);
         if (!status)
             return export_error_code(status, c.error);
+        return_if_error_m(c.error);
 
         counts[task_idx] = matched_pairs_count;
     }
     offsets[scans.count] = keys_output - *c.keys;
+    values_offsets[keys_output - *c.keys] = static_cast<ukv_length_t>(contents.size());
+    if (c.values)
+        *c.values = reinterpret_cast<ukv_bytes_ptr_t>(contents.begin());
+}
+
+/**
+ * @brief Splits the keys range into equal-cardinality parts, counting the entries
+ * on the first pass and picking the boundaries on the second one.
+ */
+ucset::status_t split_range(database_t& db,
+                            ukv_collection_t collection,
+                            ukv_key_t start_key,
+                            ukv_key_t end_key,
+                            ptr_range_gt<ukv_key_t> boundaries) noexcept {
+
+    std::size_t const parts_count = boundaries.size() - 1;
+    collection_key_t min(collection, start_key);
+    collection_key_t max(collection, end_key);
+    std::fill(boundaries.begin(), boundaries.end(), end_key);
+    boundaries[0] = start_key;
+
+    std::size_t cardinality = 0;
+    auto status = db.pairs.range(min, max, [&](pair_t&) noexcept { ++cardinality; });
+    if (!status)
+        return status;
+
+    std::size_t pair_idx = 0;
+    std::size_t next_split = 1;
+    return db.pairs.range(min, max, [&](pair_t& pair) noexcept {
+        while (next_split < parts_count && pair_idx == next_split * cardinality / parts_count)
+            boundaries[next_split++] = pair.collection_key.key;
+        ++pair_idx;
+    });
+}
+
+void ukv_scan_bulk_init(ukv_scan_bulk_init_t* c_ptr) {
+
+    ukv_scan_bulk_init_t& c = *c_ptr;
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.scan, c.error, args_wrong_k, "Output handle is missing");
+    return_error_if_m(!c.snapshot, c.error, args_wrong_k, "Snapshots aren't supported!");
+
+    database_t& db = *reinterpret_cast<database_t*>(c.db);
+    std::size_t const partitions_count = std::max<std::size_t>(c.partitions_count, 1u);
+
+    safe_section("Partitioning the collection", c.error, [&] {
+        auto scan = std::make_unique<ranged_bulk_scan_t>();
+        scan->db = c.db;
+        scan->collection = c.collection;
+
+        std::vector<ukv_key_t> boundaries(partitions_count + 1);
+        auto status = split_range(db,
+                                  c.collection,
+                                  std::numeric_limits<ukv_key_t>::min(),
+                                  std::numeric_limits<ukv_key_t>::max(),
+                                  {boundaries.data(), boundaries.size()});
+        export_error_code(status, c.error);
+        return_if_error_m(c.error);
+
+        scan->split({boundaries.data() + 1, partitions_count - 1}, partitions_count);
+        *c.scan = scan.release();
+    });
+}
+
+void ukv_scan_bulk_next(ukv_scan_bulk_next_t* c_ptr) {
+
+    ukv_scan_bulk_next_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_bulk_k, c.error);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.scan, c.error, uninitialized_state_k, "Bulk scan is uninitialized");
+    ranged_bulk_scan_next(*reinterpret_cast<ranged_bulk_scan_t*>(c.scan), c);
+}
+
+void ukv_scan_bulk_free(ukv_scan_bulk_t c_scan) {
+    delete reinterpret_cast<ranged_bulk_scan_t*>(c_scan);
 }
 
 struct key_from_pair_t {
@@ -682,6 +1667,7 @@ struct key_iterator_t {
 void ukv_sample(ukv_sample_t* c_ptr) {
 
     ukv_sample_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::sample_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     return_error_if_m(!c.transaction, c.error, uninitialized_state_k, "Transaction sampling aren't supported!");
     if (!c.tasks_count)
@@ -728,6 +1714,7 @@ void ukv_sample(ukv_sample_t* c_ptr) {
 void ukv_measure(ukv_measure_t* c_ptr) {
 
     ukv_measure_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::measure_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
     if (!c.tasks_count)
         return;
@@ -777,6 +1764,25 @@ void ukv_measure(ukv_measure_t* c_ptr) {
     }
 }
 
+void ukv_collection_split(ukv_collection_split_t* c_ptr) {
+
+    ukv_collection_split_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::split_k, c.error, c.count);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(!c.snapshot, c.error, args_wrong_k, "Snapshots aren't supported!");
+    return_error_if_m(c.count, c.error, args_wrong_k, "Can't split into zero parts");
+
+    linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
+    return_if_error_m(c.error);
+
+    auto boundaries = *c.boundaries = arena.alloc<ukv_key_t>(c.count + 1, c.error).begin();
+    return_if_error_m(c.error);
+
+    database_t& db = *reinterpret_cast<database_t*>(c.db);
+    auto status = split_range(db, c.collection, c.start_key, c.end_key, {boundaries, c.count + 1});
+    export_error_code(status, c.error);
+}
+
 /*********************************************************/
 /*****************	Collections Management	****************/
 /*********************************************************/
@@ -796,7 +1802,16 @@ void ukv_collection_create(ukv_collection_create_t* c_ptr) {
 
     auto new_collection_id = new_collection(db);
     safe_section("Inserting new collection", c.error, [&] { db.names.emplace(collection_name, new_collection_id); });
+    return_if_error_m(c.error);
     *c.id = new_collection_id;
+
+    if (!db.persisted_directory.empty())
+        safe_section("Logging new collection", c.error, [&] {
+            delta_t delta;
+            delta.create(new_collection_id, collection_name);
+            std::lock_guard _ {db.log.mutex};
+            append_frame(db.log, delta.records, true, c.error);
+        });
 }
 
 void ukv_collection_drop(ukv_collection_drop_t* c_ptr) {
@@ -812,31 +1827,31 @@ void ukv_collection_drop(ukv_collection_drop_t* c_ptr) {
 
     database_t& db = *reinterpret_cast<database_t*>(c.db);
     std::unique_lock _ {db.restructuring_mutex};
-
-    if (c.mode == ukv_drop_keys_vals_handle_k) {
-        auto status = db.pairs.erase_range(c.id, c.id + 1, no_op_t {});
-        if (!status)
-            return export_error_code(status, c.error);
-
-        for (auto it = db.names.begin(); it != db.names.end(); ++it) {
-            if (c.id != it->second)
-                continue;
-            db.names.erase(it);
-            break;
+    {
+        std::shared_lock ordering_lock {db.history.ordering_mutex};
+        // Even a failed drop may have erased a part of the collection
+        auto status = drop_collection(db, c.id, c.mode);
+        if (db.history.watchers_count) {
+            std::vector<ukv_collection_t> collections;
+            try {
+                collections.push_back(c.id);
+                record_commit(db.history, {}, std::move(collections));
+            }
+            catch (...) {
+                forget_commit(db.history);
+            }
         }
+        export_error_code(status, c.error);
+        return_if_error_m(c.error);
     }
 
-    else if (c.mode == ukv_drop_keys_vals_k) {
-        auto status = db.pairs.erase_range(c.id, c.id + 1, no_op_t {});
-        return export_error_code(status, c.error);
-    }
-
-    else if (c.mode == ukv_drop_vals_k) {
-        auto status = db.pairs.range(c.id, c.id + 1, [&](pair_t& pair) noexcept {
-            pair = pair_t {pair.collection_key, value_view_t::make_empty(), nullptr};
+    if (!db.persisted_directory.empty())
+        safe_section("Logging dropped collection", c.error, [&] {
+            delta_t delta;
+            delta.drop(c.id, c.mode);
+            std::lock_guard _ {db.log.mutex};
+            append_frame(db.log, delta.records, true, c.error);
         });
-        return export_error_code(status, c.error);
-    }
 }
 
 void ukv_collection_list(ukv_collection_list_t* c_ptr) {
@@ -908,24 +1923,45 @@ void ukv_transaction_init(ukv_transaction_init_t* c_ptr) {
 
         auto maybe_txn = db.pairs.transaction();
         return_error_if_m(maybe_txn, c.error, error_unknown_k, "Couldn't start a transaction");
-        *c.transaction = std::make_unique<transaction_t>(std::move(maybe_txn).value()).release();
+        auto txn = std::make_unique<transaction_t>(std::move(maybe_txn).value(), db.history, db.locks);
+        *c.transaction = txn.release();
     });
     return_if_error_m(c.error);
 
     transaction_t& txn = *reinterpret_cast<transaction_t*>(*c.transaction);
+    txn.forget();
+    txn.read_only = c.options & ukv_option_transaction_read_only_k;
+    txn.pessimistic = c.options & ukv_option_transaction_pessimistic_k;
+    txn.lock_timeout = lock_table_t::timeout(c.lock_timeout);
     auto status = txn.reset();
     return export_error_code(status, c.error);
 }
 
-void ukv_transaction_commit(ukv_transaction_commit_t* c_ptr) {
+void validate_and_apply(database_t& db, transaction_t& txn, ukv_transaction_commit_t& c) noexcept {
+
+    // Persistent DBs log the changes in the same order, as they are committed.
+    // The IO happens under the lock of the log, but not the lock of the set.
+    std::unique_lock<std::mutex> log_lock;
+    if (!db.persisted_directory.empty())
+        log_lock = std::unique_lock {db.log.mutex};
+
+    // Read-only transactions skip the validation, accepting that their reads
+    // may come from different commits, as with `ukv_option_transaction_dont_watch_k`.
+    // The others are validated and applied, while no other writes are in flight.
+    std::unique_lock<std::shared_mutex> ordering_lock;
+    if (!txn.written.empty()) {
+        ordering_lock = std::unique_lock {db.history.ordering_mutex};
+        bool valid = false;
+        safe_section("Validating watched keys", c.error, [&] { valid = validate_watches(txn); });
+        return_if_error_m(c.error);
+        return_error_if_m(valid, c.error, consistency_k, "Watched keys were changed since the read");
 
-    ukv_transaction_commit_t& c = *c_ptr;
-    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
-    database_t& db = *reinterpret_cast<database_t*>(c.db);
+        if (txn.is_watching)
+            stop_watching(db.history, txn.first_watched_sequence);
+        txn.is_watching = false;
+        record_commit(db.history, std::move(txn.written));
+    }
 
-    validate_transaction_commit(c.transaction, c.options, c.error);
-    return_if_error_m(c.error);
-    transaction_t& txn = *reinterpret_cast<transaction_t*>(c.transaction);
     auto status = txn.stage();
     if (!status)
         return export_error_code(status, c.error);
@@ -935,10 +1971,28 @@ void ukv_transaction_commit(ukv_transaction_commit_t* c_ptr) {
 
     if (c.sequence_number)
         *c.sequence_number = txn.generation();
+    if (ordering_lock.owns_lock())
+        ordering_lock.unlock();
+
+    if (log_lock.owns_lock())
+        append_applied(db, log_lock, txn.delta.records, c.options & ukv_option_write_flush_k, c.error);
+}
+
+void ukv_transaction_commit(ukv_transaction_commit_t* c_ptr) {
+
+    ukv_transaction_commit_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::transaction_commit_k, c.error);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    database_t& db = *reinterpret_cast<database_t*>(c.db);
+
+    validate_transaction_commit(c.transaction, c.options, c.error);
+    return_if_error_m(c.error);
+    transaction_t& txn = *reinterpret_cast<transaction_t*>(c.transaction);
 
-    // TODO: Degrade the lock to "shared" state before starting expensive IO
-    if (c.options & ukv_option_write_flush_k)
-        safe_section("Saving to disk", c.error, [&] { write(db, db.persisted_directory, c.error); });
+    // Key locks and watches are released, whether the commit succeeds or not,
+    // so that a failed transaction doesn't block others until it is reset.
+    validate_and_apply(db, txn, c);
+    txn.forget();
 }
 
 /*********************************************************/
@@ -962,8 +2016,9 @@ void ukv_database_free(ukv_database_t c_db) {
 
     database_t& db = *reinterpret_cast<database_t*>(c_db);
     if (!db.persisted_directory.empty()) {
+        stop_checkpoints(db);
         ukv_error_t c_error = nullptr;
-        safe_section("Saving to disk", &c_error, [&] { write(db, db.persisted_directory, &c_error); });
+        safe_section("Saving to disk", &c_error, [&] { checkpoint(db, &c_error); });
     }
 
     delete &db;
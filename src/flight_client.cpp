@@ -7,8 +7,16 @@
  * Understanding the costs of remote communication, might keep a cache.
  */
 
-#include <thread>      // `std::this_thread`
-#include <mutex>       // `std::mutex`
+#include <thread>             // `std::this_thread`
+#include <mutex>              // `std::mutex`
+#include <condition_variable> // `std::condition_variable`
+#include <atomic>             // `std::atomic`
+#include <chrono>             // `std::chrono::microseconds`
+#include <vector>             // `std::vector`
+#include <unordered_map>      // `std::unordered_map`
+#include <algorithm>          // `std::stable_sort`
+#include <tuple>              // `std::make_tuple`
+#include <charconv>    // `std::from_chars`
 #include <string_view> // `std::string_view`
 
 #include <fmt/core.h> // `fmt::format_to`
@@ -17,8 +25,13 @@
 
 #include "ukv/db.h"
 #include "ukv/arrow.h"
+#include "ukv/flight.h"
 #include "ukv/cpp/types.hpp" // `ukv_doc_field()`
 #include "helpers/arrow.hpp"
+#include "helpers/async.hpp"        // `submit_blocking`
+#include "helpers/full_scan.hpp"    // `ranged_bulk_scan_t`
+#include "helpers/cache.hpp"        // `value_cache_t`
+#include "helpers/linked_array.hpp" // `growing_tape_t`
 
 /*********************************************************/
 /*****************   Structures & Consts  ****************/
@@ -38,10 +51,90 @@ bool const ukv_supports_snapshots_k = true;
 using namespace unum::ukv;
 using namespace unum;
 
+/// Reads of up to this many keys can be coalesced with reads from other threads.
+constexpr std::size_t coalesce_max_tasks_k = 256;
+/// Once this many keys are queued, the batch is sent without waiting for the window to end.
+constexpr std::size_t coalesce_max_rows_k = 64 * 1024;
+/// Number of background threads sending coalesced batches, so one can be in flight while the next one fills.
+constexpr std::size_t coalesce_dispatchers_k = 2;
+/// Beyond this many open transactions with tracked writes, the tracking is dropped, see `written_in_transactions_lost`.
+constexpr std::size_t cache_tracked_transactions_k = 1024;
+
+struct rpc_client_t;
+
+/**
+ * @brief Queues small reads for a few microseconds, so that concurrent requests
+ * from different threads can share one `DoExchange` call. Reads, that belong to
+ * the same transaction and snapshot and have identical options, are merged into one batch, and the results
+ * are scattered back into the arenas of every caller.
+ * Dispatcher threads are only started with the first queued read.
+ */
+class read_coalescer_t {
+  public:
+    struct task_t {
+        ukv_read_t* c = nullptr;
+        /// Invoked on completion of asynchronous tasks, which are then deleted.
+        ukv_callback_t callback = nullptr;
+        ukv_callback_payload_t payload = nullptr;
+        /// Signaled on completion of blocking tasks.
+        std::condition_variable* done_signal = nullptr;
+        bool is_done = false;
+    };
+
+  private:
+    rpc_client_t& db_;
+    std::chrono::microseconds window_;
+
+    std::mutex mutex_;
+    std::condition_variable queued_;
+    std::vector<task_t*> pending_;
+    std::size_t pending_rows_ = 0;
+    bool stopping_ = false;
+
+    std::once_flag started_;
+    std::vector<std::thread> dispatchers_;
+
+    void dispatch() noexcept;
+    void execute(task_t** begin, task_t** end, ukv_arena_t& batch_arena) noexcept;
+    void complete(task_t& task) noexcept;
+
+  public:
+    read_coalescer_t(rpc_client_t& db, std::chrono::microseconds window) noexcept : db_(db), window_(window) {}
+    ~read_coalescer_t() noexcept;
+
+    bool is_enabled() const noexcept { return window_.count() > 0; }
+
+    /**
+     * @brief Queues the task. Unless it has a `callback`, blocks until it is completed.
+     */
+    void submit(task_t& task);
+};
+
 struct rpc_client_t {
     std::unique_ptr<arf::FlightClient> flight;
     linked_memory_t arena;
     std::mutex arena_lock;
+
+    /// Server runs on the same host and can pass responses through shared memory.
+    bool is_local = false;
+
+    /// Buffer compression for requests and responses, configured in the connection URI.
+    arrow_compression_t compression;
+    /// Whether to dictionary-encode keys and collection IDs in requests.
+    bool encode_dictionaries = false;
+    /// Milliseconds since a follower has caught up with its primary, after which reads fail.
+    std::optional<std::string> max_staleness;
+
+    /// Hot values, that were read by this client, if enabled in the connection URI.
+    std::unique_ptr<value_cache_t> cache;
+    /// Keys written in every open transaction, to be invalidated in `cache` on commit.
+    std::unordered_map<ukv_transaction_t, std::vector<collection_key_t>> written_in_transactions;
+    std::mutex written_in_transactions_lock;
+    /// Set once the tracking overflows, after which commits of untracked transactions clear the whole `cache`.
+    bool written_in_transactions_lost = false;
+
+    /// Must be destroyed first, to stop the dispatchers, while the connection is still alive.
+    std::unique_ptr<read_coalescer_t> reads;
 };
 
 arf::FlightCallOptions arrow_call_options(arrow_mem_pool_t& pool) {
@@ -57,6 +150,8 @@ void export_options(ukv_options_t options, std::string& cmd) {
         fmt::format_to(std::back_inserter(cmd), "{}&", kParamFlagSharedMemRead);
     if (options & ukv_option_transaction_dont_watch_k)
         fmt::format_to(std::back_inserter(cmd), "{}&", kParamFlagDontWatch);
+    if (options & ukv_option_scan_bulk_k)
+        fmt::format_to(std::back_inserter(cmd), "{}&", kParamFlagScanBulk);
 
     // This flag shouldn't be forwarded to the server.
     // In standalone builds it only applies to the client.
@@ -64,6 +159,132 @@ void export_options(ukv_options_t options, std::string& cmd) {
     //     fmt::format_to(std::back_inserter(cmd), "{}&", kParamFlagDontDiscard);
 }
 
+void export_compression(arrow_compression_t const& compression, std::string& cmd) {
+    if (!compression)
+        return;
+    auto codec = compression.codec == ar::Compression::ZSTD ? kParamCompressionZSTD : kParamCompressionLZ4;
+    fmt::format_to(std::back_inserter(cmd), "{}={}&", kParamCompression, codec);
+    if (compression.level != ar::util::kUseDefaultCompressionLevel)
+        fmt::format_to(std::back_inserter(cmd), "{}={}&", kParamCompressionLevel, compression.level);
+    if (compression.threshold_bytes)
+        fmt::format_to(std::back_inserter(cmd), "{}={}&", kParamCompressionThreshold, compression.threshold_bytes);
+}
+
+void export_staleness(rpc_client_t const& db, std::string& cmd) {
+    if (db.max_staleness)
+        fmt::format_to(std::back_inserter(cmd), "{}={}&", kParamMaxStaleness, *db.max_staleness);
+}
+
+/**
+ * @brief Dictionary-encodes and compresses the request, if it was configured
+ * for this connection, trading client CPU time for network bandwidth.
+ */
+ar::Status prepare_upload( //
+    rpc_client_t const& db,
+    std::shared_ptr<ar::RecordBatch>& batch_ptr,
+    ar::ipc::IpcWriteOptions& options) {
+
+    if (db.encode_dictionaries) {
+        ARROW_ASSIGN_OR_RAISE(batch_ptr, encode_dictionaries(batch_ptr, {kArgCols, kArgKeys}));
+    }
+    return compress_if_worth(options, db.compression, *batch_ptr);
+}
+
+bool starts_with(std::string_view str, std::string_view prefix) noexcept {
+    return str.substr(0, prefix.size()) == prefix;
+}
+
+/**
+ * @brief Checks if the server URI points to the same host.
+ * Only then the results can be passed through shared memory.
+ */
+bool is_local_location(std::string_view uri) noexcept {
+    auto scheme_end = uri.find("://");
+    if (scheme_end == std::string_view::npos)
+        return false;
+    auto scheme = uri.substr(0, scheme_end);
+    if (scheme.find("unix") != std::string_view::npos)
+        return true;
+    auto host = uri.substr(scheme_end + 3);
+    return starts_with(host, "localhost") || starts_with(host, "127.") || starts_with(host, "0.0.0.0") ||
+           starts_with(host, "[::1]");
+}
+
+/**
+ * @brief Checks if the response can be passed through shared memory, instead of the socket.
+ * The `kParamFlagSharedMemRead` flag itself is forwarded with the rest of `options`.
+ */
+bool expects_shared_reply(rpc_client_t const& db, ukv_options_t options) noexcept {
+    return db.is_local && (options & ukv_option_read_shared_memory_k);
+}
+
+/**
+ * @brief Collects the response of a `DoExchange` call. A co-located server may put the
+ * results into a shared memory segment, that it has created. Then only its name and the
+ * length of the IPC stream in it arrive over the network, and the segment is adopted
+ * into our `arena`, to be freed with it.
+ */
+ar::Result<std::shared_ptr<ar::Table>> receive_table( //
+    arf::FlightStreamReader& reader,
+    bool shared_reply,
+    linked_memory_lock_t& arena,
+    arrow_mem_pool_t& pool) {
+
+    if (!shared_reply)
+        return reader.ToTable();
+
+    ARROW_ASSIGN_OR_RAISE(arf::FlightStreamChunk chunk, reader.Next());
+    if (!chunk.data && chunk.app_metadata) {
+        std::string_view reply {reinterpret_cast<char const*>(chunk.app_metadata->data()),
+                                static_cast<std::size_t>(chunk.app_metadata->size())};
+        std::size_t separator = reply.rfind(':');
+        if (separator == std::string_view::npos)
+            return ar::Status::IOError("Malformed shared memory reply");
+
+        std::size_t length = 0;
+        std::string name {reply.substr(0, separator)};
+        std::from_chars(reply.data() + separator + 1, reply.data() + reply.size(), length);
+        byte_t* payload = arena.memory.adopt_shared(name.c_str(), length);
+        if (!payload)
+            return ar::Status::IOError("Can't map the shared memory reply");
+        return import_shared_memory(payload, length, arrow_read_options(pool));
+    }
+
+    std::vector<std::shared_ptr<ar::RecordBatch>> batches;
+    while (chunk.data) {
+        batches.push_back(std::move(chunk.data));
+        ARROW_ASSIGN_OR_RAISE(chunk, reader.Next());
+    }
+    ARROW_ASSIGN_OR_RAISE(auto schema, reader.GetSchema());
+    return ar::Table::FromRecordBatches(schema, batches);
+}
+
+/**
+ * @brief Applies per-collection cache quotas, like "0x1f:1048576,42:0",
+ * where collection IDs are decimal or hexadecimal, and a zero quota disables caching.
+ */
+void limit_cache(value_cache_t& cache, std::string_view quotas) noexcept(false) {
+    while (!quotas.empty()) {
+        std::string_view quota = quotas.substr(0, quotas.find(','));
+        quotas.remove_prefix(std::min(quota.size() + 1, quotas.size()));
+        std::size_t separator = quota.find(':');
+        if (separator == std::string_view::npos)
+            continue;
+
+        std::string_view id = quota.substr(0, separator);
+        std::string_view bytes = quota.substr(separator + 1);
+        int base = 10;
+        if (id.substr(0, 2) == "0x")
+            id.remove_prefix(2), base = 16;
+
+        ukv_collection_t collection = ukv_collection_main_k;
+        std::size_t capacity = 0;
+        std::from_chars(id.data(), id.data() + id.size(), collection, base);
+        std::from_chars(bytes.data(), bytes.data() + bytes.size(), capacity);
+        cache.limit(collection, capacity);
+    }
+}
+
 /*********************************************************/
 /*****************	    C Interface 	  ****************/
 /*********************************************************/
@@ -76,8 +297,14 @@ void ukv_database_init(ukv_database_init_t* c_ptr) {
         if (!c.config || !std::strlen(c.config))
             c.config = "grpc://0.0.0.0:38709";
 
+        // Query parameters configure the connection, rather than address the server:
+        // "grpc://0.0.0.0:38709?compression=zstd&compression_level=3&compression_threshold=4096&dictionaries"
+        std::string_view config {c.config};
+        std::string_view uri = config.substr(0, config.find('?'));
+        std::string_view params = config.substr(uri.size());
+
         auto db_ptr = new rpc_client_t {};
-        auto maybe_location = arf::Location::Parse(c.config);
+        auto maybe_location = arf::Location::Parse(std::string(uri));
         return_error_if_m(maybe_location.ok(), c.error, args_wrong_k, "Server URI");
 
         auto maybe_flight_ptr = arf::FlightClient::Connect(*maybe_location);
@@ -86,14 +313,35 @@ void ukv_database_init(ukv_database_init_t* c_ptr) {
         linked_memory(reinterpret_cast<ukv_arena_t*>(&db_ptr->arena), ukv_option_dont_discard_memory_k, c.error);
         return_error_if_m(maybe_location.ok(), c.error, args_wrong_k, "Failed to allocate default arena.");
         db_ptr->flight = maybe_flight_ptr.MoveValueUnsafe();
+        db_ptr->is_local = is_local_location(uri);
+        db_ptr->compression = parse_compression(params);
+        db_ptr->encode_dictionaries = param_value(params, kParamFlagDictionaries).has_value();
+        if (auto staleness = param_value(params, kParamMaxStaleness); staleness)
+            db_ptr->max_staleness = std::string(*staleness);
+
+        std::size_t coalesce_window = 0;
+        if (auto window = param_value(params, kParamCoalesceWindow); window)
+            std::from_chars(window->data(), window->data() + window->size(), coalesce_window);
+        db_ptr->reads = std::make_unique<read_coalescer_t>(*db_ptr, std::chrono::microseconds(coalesce_window));
+
+        if (auto cache = param_value(params, kParamCache); cache) {
+            std::size_t capacity = 0;
+            std::size_t time_to_live = 0;
+            std::from_chars(cache->data(), cache->data() + cache->size(), capacity);
+            if (auto ttl = param_value(params, kParamCacheTTL); ttl)
+                std::from_chars(ttl->data(), ttl->data() + ttl->size(), time_to_live);
+            db_ptr->cache = std::make_unique<value_cache_t>(capacity, std::chrono::milliseconds(time_to_live));
+            if (auto quotas = param_value(params, kParamCacheQuotas); quotas)
+                limit_cache(*db_ptr->cache, *quotas);
+        }
         *c.db = db_ptr;
     });
 }
 
-void ukv_read(ukv_read_t* c_ptr) {
-
-    ukv_read_t& c = *c_ptr;
-    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+/**
+ * @brief Sends the read to the server right away, without coalescing.
+ */
+void read_remotely(ukv_read_t& c) {
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
     return_if_error_m(c.error);
@@ -132,6 +380,9 @@ void ukv_read(ukv_read_t* c_ptr) {
     if (partial_mode)
         fmt::format_to(std::back_inserter(descriptor.cmd), "{}={}&", kParamReadPart, partial_mode);
     export_options(c.options, descriptor.cmd);
+    export_compression(db.compression, descriptor.cmd);
+    export_staleness(db, descriptor.cmd);
+    bool const shared_reply = expects_shared_reply(db, c.options);
 
     bool const has_collections_column = collections && !same_collection;
     constexpr bool has_keys_column = true;
@@ -190,6 +441,8 @@ void ukv_read(ukv_read_t* c_ptr) {
     return_error_if_m(maybe_batch.ok(), c.error, error_unknown_k, "Can't pack RecordBatch");
 
     std::shared_ptr<ar::RecordBatch> batch_ptr = maybe_batch.ValueUnsafe();
+    ar_status = prepare_upload(db, batch_ptr, options.write_options);
+    return_error_if_m(ar_status.ok(), c.error, error_unknown_k, "Can't encode RecordBatch");
     if (batch_ptr->num_rows() == 0)
         return;
     ar::Result<arf::FlightClient::DoExchangeResult> result = db.flight->DoExchange(options, descriptor);
@@ -209,7 +462,8 @@ void ukv_read(ukv_read_t* c_ptr) {
     // Requesting `ToTable` might be more efficient than concatenating and
     // reallocating directly from our arena, as the underlying Arrow implementation
     // may know the length of the entire dataset.
-    ar_status = unpack_table(result->reader->ToTable(), output_schema_c, output_array_c);
+    auto maybe_table = receive_table(*result->reader, shared_reply, arena, pool);
+    ar_status = unpack_table(maybe_table, output_schema_c, output_array_c);
     return_error_if_m(ar_status.ok(), c.error, network_k, "No response");
 
     // Convert the responses in Arrow C form
@@ -260,11 +514,347 @@ void ukv_read(ukv_read_t* c_ptr) {
     }
 }
 
-void ukv_write(ukv_write_t* c_ptr) {
+/**
+ * @brief Copies a slice of a coalesced batch into the arena of one of the callers,
+ * exporting only the outputs it has asked for.
+ */
+void scatter_read( //
+    ukv_read_t& c,
+    std::size_t first_row,
+    ukv_octet_t const* presences,
+    ukv_length_t const* offsets,
+    ukv_byte_t const* values) {
+
+    std::size_t const count = c.tasks_count;
+    if (!count)
+        return;
 
-    ukv_write_t& c = *c_ptr;
+    linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
+    return_if_error_m(c.error);
+
+    // Missing validity bitmap means all the entries are present
+    auto is_present = [=](std::size_t row) {
+        return !presences || ((presences[row / bits_in_byte_k] >> (row % bits_in_byte_k)) & 1);
+    };
+
+    if (c.presences) {
+        auto bits = arena.alloc<ukv_octet_t>(divide_round_up(count, bits_in_byte_k), c.error);
+        return_if_error_m(c.error);
+        std::fill(bits.begin(), bits.end(), 0);
+        for (std::size_t i = 0; i != count; ++i)
+            bits[i / bits_in_byte_k] |= static_cast<ukv_octet_t>(is_present(first_row + i) << (i % bits_in_byte_k));
+        *c.presences = bits.begin();
+    }
+
+    if (c.lengths) {
+        auto lengths = arena.alloc<ukv_length_t>(count, c.error);
+        return_if_error_m(c.error);
+        for (std::size_t i = 0, row = first_row; i != count; ++i, ++row)
+            lengths[i] = is_present(row) ? offsets[row + 1] - offsets[row] : ukv_length_missing_k;
+        *c.lengths = lengths.begin();
+    }
+
+    if (c.offsets) {
+        auto slice_offsets = arena.alloc<ukv_length_t>(count + 1, c.error);
+        return_if_error_m(c.error);
+        for (std::size_t i = 0; i <= count; ++i)
+            slice_offsets[i] = offsets[first_row + i] - offsets[first_row];
+        *c.offsets = slice_offsets.begin();
+    }
+
+    // Values of neighboring rows are adjacent, so the slice is copied at once
+    if (c.values) {
+        std::size_t slice_length = offsets[first_row + count] - offsets[first_row];
+        auto tape = arena.alloc<ukv_byte_t>(slice_length, c.error, arrow_bytes_alignment_k);
+        return_if_error_m(c.error);
+        if (slice_length)
+            std::memcpy(tape.begin(), values + offsets[first_row], slice_length);
+        *c.values = tape.begin();
+    }
+}
+
+read_coalescer_t::~read_coalescer_t() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queued_.notify_all();
+    for (auto& dispatcher : dispatchers_)
+        dispatcher.join();
+
+    // Nobody will serve the remaining tasks
+    for (task_t* task : pending_) {
+        log_error_m(task->c->error, uninitialized_state_k, "Database was closed before the read was served");
+        complete(*task);
+    }
+}
+
+void read_coalescer_t::submit(task_t& task) {
+    std::call_once(started_, [&] {
+        for (std::size_t i = 0; i != coalesce_dispatchers_k; ++i)
+            dispatchers_.emplace_back(&read_coalescer_t::dispatch, this);
+    });
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool was_empty = pending_.empty();
+    pending_.push_back(&task);
+    pending_rows_ += task.c->tasks_count;
+    if (was_empty || pending_rows_ >= coalesce_max_rows_k)
+        queued_.notify_all();
+    if (task.callback)
+        return;
+
+    std::condition_variable done_signal;
+    task.done_signal = &done_signal;
+    done_signal.wait(lock, [&] { return task.is_done; });
+}
+
+void read_coalescer_t::complete(task_t& task) noexcept {
+    if (task.callback) {
+        task.callback(task.payload);
+        delete &task;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    task.is_done = true;
+    task.done_signal->notify_one();
+}
+
+void read_coalescer_t::dispatch() noexcept {
+
+    std::vector<task_t*> batch;
+    ukv_arena_t batch_arena = nullptr;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        queued_.wait(lock, [&] { return stopping_ || !pending_.empty(); });
+        if (stopping_)
+            break;
+
+        // Give other threads a chance to join the batch
+        auto deadline = std::chrono::steady_clock::now() + window_;
+        queued_.wait_until(lock, deadline, [&] { return stopping_ || pending_rows_ >= coalesce_max_rows_k; });
+        if (pending_.empty())
+            // Another dispatcher took the batch
+            continue;
+
+        batch.swap(pending_);
+        pending_rows_ = 0;
+        lock.unlock();
+
+        // Reads within the same transaction and snapshot can share one request,
+        // as long as they agree on options, like watching the keys or tracking the transaction
+        auto view_of = [](task_t const* task) {
+            return std::make_tuple(reinterpret_cast<std::uintptr_t>(task->c->transaction),
+                                   task->c->snapshot,
+                                   task->c->options);
+        };
+        std::stable_sort(batch.begin(), batch.end(), [&](task_t const* a, task_t const* b) {
+            return view_of(a) < view_of(b);
+        });
+        for (auto group_begin = batch.begin(); group_begin != batch.end();) {
+            auto group_end = std::find_if(group_begin, batch.end(), [&](task_t const* task) {
+                return view_of(task) != view_of(*group_begin);
+            });
+            execute(&*group_begin, &*group_begin + (group_end - group_begin), batch_arena);
+            group_begin = group_end;
+        }
+
+        batch.clear();
+        lock.lock();
+    }
+    lock.unlock();
+    ukv_arena_free(batch_arena);
+}
+
+void read_coalescer_t::execute(task_t** begin, task_t** end, ukv_arena_t& batch_arena) noexcept {
+
+    ukv_read_t const& first = *(*begin)->c;
+    std::size_t rows = 0;
+    for (auto it = begin; it != end; ++it)
+        rows += (*it)->c->tasks_count;
+
+    // Concatenate the inputs of all the reads
+    ukv_error_t error = nullptr;
+    ukv_octet_t* found_presences = nullptr;
+    ukv_length_t* found_offsets = nullptr;
+    ukv_byte_t* found_values = nullptr;
+    {
+        linked_memory_lock_t arena = linked_memory(&batch_arena, ukv_options_default_k, &error);
+        auto collections = arena.alloc<ukv_collection_t>(rows, &error);
+        auto keys = arena.alloc<ukv_key_t>(rows, &error);
+
+        std::size_t row = 0;
+        for (auto it = begin; it != end && !error; ++it) {
+            ukv_read_t const& c = *(*it)->c;
+            strided_iterator_gt<ukv_collection_t const> task_collections {c.collections, c.collections_stride};
+            strided_iterator_gt<ukv_key_t const> task_keys {c.keys, c.keys_stride};
+            for (std::size_t i = 0; i != c.tasks_count; ++i, ++row) {
+                collections[row] = task_collections ? task_collections[i] : ukv_collection_main_k;
+                keys[row] = task_keys[i];
+            }
+        }
+
+        // The batch arena is already locked, so the inputs won't be discarded
+        ukv_read_t read {
+            .db = &db_,
+            .error = &error,
+            .transaction = first.transaction,
+            .snapshot = first.snapshot,
+            .arena = &batch_arena,
+            .options = first.options,
+            .tasks_count = rows,
+            .collections = collections.begin(),
+            .collections_stride = sizeof(ukv_collection_t),
+            .keys = keys.begin(),
+            .keys_stride = sizeof(ukv_key_t),
+            .presences = &found_presences,
+            .offsets = &found_offsets,
+            .values = &found_values,
+        };
+        if (rows && !error)
+            safe_section("Coalesced read", &error, [&] { read_remotely(read); });
+    }
+
+    // Split the results between the callers
+    std::size_t first_row = 0;
+    for (auto it = begin; it != end; ++it) {
+        ukv_read_t& c = *(*it)->c;
+        if (error)
+            *c.error = error;
+        else
+            scatter_read(c, first_row, found_presences, found_offsets, found_values);
+        first_row += c.tasks_count;
+        complete(**it);
+    }
+}
+
+/**
+ * @brief Sends the read to the server, merging it with concurrent reads, if possible.
+ */
+void read_uncached(ukv_read_t& c) {
+
+    // Reads into shared memory are served by the server directly, so they can't be merged
+    rpc_client_t& db = *reinterpret_cast<rpc_client_t*>(c.db);
+    bool const can_coalesce = db.reads->is_enabled() && c.tasks_count <= coalesce_max_tasks_k &&
+                              !(c.options & ukv_option_read_shared_memory_k);
+    if (!can_coalesce)
+        return read_remotely(c);
+
+    read_coalescer_t::task_t task;
+    task.c = &c;
+    safe_section("Coalescing reads", c.error, [&] { db.reads->submit(task); });
+}
+
+/**
+ * @brief Serves the read from the local cache, if all the keys are there.
+ * Otherwise, the whole batch is fetched from the server, and the results are cached.
+ */
+void read_cached(ukv_read_t& c) {
+
+    linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
+    return_if_error_m(c.error);
+
+    rpc_client_t& db = *reinterpret_cast<rpc_client_t*>(c.db);
+    value_cache_t& cache = *db.cache;
+    strided_iterator_gt<ukv_collection_t const> collections {c.collections, c.collections_stride};
+    strided_iterator_gt<ukv_key_t const> keys {c.keys, c.keys_stride};
+    places_arg_t places {collections, keys, {}, c.tasks_count};
+
+    growing_tape_t tape(arena);
+    tape.reserve(places.size(), c.error);
+    return_if_error_m(c.error);
+    auto push_back = [&](value_view_t value) { tape.push_back(value, c.error); };
+    std::size_t hits = 0;
+    while (hits != places.size() && cache.find(places[hits].collection_key(), push_back))
+        ++hits;
+    return_if_error_m(c.error);
+
+    if (hits == places.size()) {
+        if (c.presences)
+            *c.presences = tape.presences().get();
+        if (c.offsets)
+            *c.offsets = tape.offsets().begin().get();
+        if (c.lengths)
+            *c.lengths = tape.lengths().begin().get();
+        *c.values = (ukv_bytes_ptr_t)tape.contents().begin().get();
+        return;
+    }
+
+    // Tickets must be taken before the values are read, to skip the keys overwritten in the meantime
+    auto tickets = arena.alloc<value_cache_t::ticket_t>(places.size(), c.error);
+    return_if_error_m(c.error);
+    for (std::size_t i = 0; i != places.size(); ++i)
+        tickets[i] = cache.ticket(places[i].collection_key());
+
+    ukv_octet_t* found_presences = nullptr;
+    ukv_length_t* found_offsets = nullptr;
+    ukv_bytes_ptr_t found_values = nullptr;
+    ukv_read_t remote = c;
+    remote.presences = &found_presences;
+    remote.offsets = &found_offsets;
+    remote.values = &found_values;
+    read_uncached(remote);
+    return_if_error_m(c.error);
+
+    if (c.presences)
+        *c.presences = found_presences;
+    if (c.offsets)
+        *c.offsets = found_offsets;
+    *c.values = found_values;
+
+    // Missing validity bitmap means all the entries are present
+    bits_view_t presences {found_presences};
+    safe_section("Caching values", c.error, [&] {
+        for (std::size_t i = 0; i != places.size(); ++i) {
+            bool is_present = !presences || presences[i];
+            auto length = found_offsets[i + 1] - found_offsets[i];
+            value_view_t value = is_present ? value_view_t {found_values + found_offsets[i], length} : value_view_t {};
+            cache.insert(places[i].collection_key(), value, tickets[i]);
+        }
+    });
+}
+
+void ukv_read(ukv_read_t* c_ptr) {
+
+    ukv_read_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::read_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
+    // Only the latest committed values of fully-requested entries are cached
+    rpc_client_t& db = *reinterpret_cast<rpc_client_t*>(c.db);
+    bool const can_cache = db.cache && c.values && !c.transaction && !c.snapshot &&
+                           !(c.options & ukv_option_read_shared_memory_k);
+    if (can_cache)
+        return read_cached(c);
+    read_uncached(c);
+}
+
+void ukv_read_async(ukv_read_t* c_ptr, ukv_callback_t callback, ukv_callback_payload_t payload) {
+
+    ukv_read_t& c = *c_ptr;
+    return_error_if_m(callback, c.error, args_wrong_k, "Asynchronous reads need a callback");
+    if (!c.db) {
+        log_error_m(c.error, uninitialized_state_k, "DataBase is uninitialized");
+        return callback(payload);
+    }
+
+    rpc_client_t& db = *reinterpret_cast<rpc_client_t*>(c.db);
+    bool submitted = false;
+    safe_section("Submitting read", c.error, [&] {
+        auto task = std::make_unique<read_coalescer_t::task_t>();
+        task->c = &c;
+        task->callback = callback;
+        task->payload = payload;
+        db.reads->submit(*task);
+        task.release();
+        submitted = true;
+    });
+    if (!submitted)
+        callback(payload);
+}
+
+void write_remotely(ukv_write_t& c) {
+
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
     return_if_error_m(c.error);
 
@@ -427,6 +1017,8 @@ void ukv_write(ukv_write_t* c_ptr) {
     return_error_if_m(maybe_batch.ok(), c.error, error_unknown_k, "Can't pack RecordBatch");
 
     std::shared_ptr<ar::RecordBatch> batch_ptr = maybe_batch.ValueUnsafe();
+    ar_status = prepare_upload(db, batch_ptr, options.write_options);
+    return_error_if_m(ar_status.ok(), c.error, error_unknown_k, "Can't encode RecordBatch");
     ar::Result<arf::FlightClient::DoPutResult> result = db.flight->DoPut(options, descriptor, batch_ptr->schema());
     return_error_if_m(result.ok(), c.error, network_k, "Failed to exchange with Arrow server");
 
@@ -447,9 +1039,76 @@ void ukv_write(ukv_write_t* c_ptr) {
     // return_error_if_m(ar_status.ok(), c.error, network_k, "No response");
 }
 
+/**
+ * @brief Forgets the cached values of written keys. Keys written in transactions
+ * are only forgotten on commit, as until then, other readers still see the old values.
+ */
+void invalidate_written(rpc_client_t& db, ukv_write_t const& c) noexcept(false) {
+    strided_iterator_gt<ukv_collection_t const> collections {c.collections, c.collections_stride};
+    strided_iterator_gt<ukv_key_t const> keys {c.keys, c.keys_stride};
+    places_arg_t places {collections, keys, {}, c.tasks_count};
+    if (!c.transaction) {
+        for (std::size_t i = 0; i != places.size(); ++i)
+            db.cache->invalidate(places[i].collection_key());
+        return;
+    }
+
+    // Abandoned transactions are never committed, so tracking can't grow forever
+    std::lock_guard<std::mutex> lock(db.written_in_transactions_lock);
+    auto it = db.written_in_transactions.find(c.transaction);
+    if (it == db.written_in_transactions.end() &&
+        db.written_in_transactions.size() >= cache_tracked_transactions_k) {
+        db.written_in_transactions.clear();
+        db.written_in_transactions_lost = true;
+    }
+    std::vector<collection_key_t>& written = db.written_in_transactions[c.transaction];
+    for (std::size_t i = 0; i != places.size(); ++i)
+        written.push_back(places[i].collection_key());
+}
+
+/**
+ * @brief Stops tracking the keys written in the `transaction`. If it was `committed`,
+ * the old values of those keys are forgotten.
+ */
+void forget_written(rpc_client_t& db, ukv_transaction_t transaction, bool committed) noexcept {
+    std::vector<collection_key_t> written;
+    {
+        std::lock_guard<std::mutex> lock(db.written_in_transactions_lock);
+        auto it = db.written_in_transactions.find(transaction);
+        if (it == db.written_in_transactions.end()) {
+            if (committed && db.written_in_transactions_lost)
+                db.cache->clear();
+            return;
+        }
+        written = std::move(it->second);
+        db.written_in_transactions.erase(it);
+    }
+    if (committed)
+        for (collection_key_t const& key : written)
+            db.cache->invalidate(key);
+}
+
+void ukv_write(ukv_write_t* c_ptr) {
+
+    ukv_write_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::write_k, c.error, c.tasks_count);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+
+    // Even failed writes may have reached the server, so the cache is invalidated regardless
+    rpc_client_t& db = *reinterpret_cast<rpc_client_t*>(c.db);
+    write_remotely(c);
+    if (db.cache)
+        safe_section("Invalidating cache", c.error, [&] { invalidate_written(db, c); });
+}
+
+void ukv_write_async(ukv_write_t* c_ptr, ukv_callback_t callback, ukv_callback_payload_t payload) {
+    submit_blocking(c_ptr, &ukv_write, callback, payload);
+}
+
 void ukv_paths_write(ukv_paths_write_t* c_ptr) {
 
     ukv_paths_write_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::paths_write_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -578,6 +1237,8 @@ void ukv_paths_write(ukv_paths_write_t* c_ptr) {
     return_error_if_m(maybe_batch.ok(), c.error, error_unknown_k, "Can't pack RecordBatch");
 
     std::shared_ptr<ar::RecordBatch> batch_ptr = maybe_batch.ValueUnsafe();
+    ar_status = prepare_upload(db, batch_ptr, options.write_options);
+    return_error_if_m(ar_status.ok(), c.error, error_unknown_k, "Can't encode RecordBatch");
     ar::Result<arf::FlightClient::DoPutResult> result = db.flight->DoPut(options, descriptor, batch_ptr->schema());
     return_error_if_m(result.ok(), c.error, network_k, "Failed to exchange with Arrow server");
 
@@ -601,6 +1262,7 @@ void ukv_paths_write(ukv_paths_write_t* c_ptr) {
 void ukv_paths_match(ukv_paths_match_t* c_ptr) {
 
     ukv_paths_match_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::paths_match_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -649,6 +1311,9 @@ void ukv_paths_match(ukv_paths_match_t* c_ptr) {
     if (partial_mode)
         fmt::format_to(std::back_inserter(descriptor.cmd), "{}={}&", kParamReadPart, partial_mode);
     export_options(c.options, descriptor.cmd);
+    export_compression(db.compression, descriptor.cmd);
+    export_staleness(db, descriptor.cmd);
+    bool const shared_reply = expects_shared_reply(db, c.options);
 
     bool const has_collections_column = collections && !same_collection;
     bool const has_previous_column = previous != nullptr;
@@ -759,6 +1424,8 @@ void ukv_paths_match(ukv_paths_match_t* c_ptr) {
     return_error_if_m(maybe_batch.ok(), c.error, error_unknown_k, "Can't pack RecordBatch");
 
     std::shared_ptr<ar::RecordBatch> batch_ptr = maybe_batch.ValueUnsafe();
+    ar_status = prepare_upload(db, batch_ptr, options.write_options);
+    return_error_if_m(ar_status.ok(), c.error, error_unknown_k, "Can't encode RecordBatch");
     if (batch_ptr->num_rows() == 0)
         return;
     ar::Result<arf::FlightClient::DoExchangeResult> result = db.flight->DoExchange(options, descriptor);
@@ -778,7 +1445,8 @@ void ukv_paths_match(ukv_paths_match_t* c_ptr) {
     // Requesting `ToTable` might be more efficient than concatenating and
     // reallocating directly from our arena, as the underlying Arrow implementation
     // may know the length of the entire dataset.
-    ar_status = unpack_table(result->reader->ToTable(), output_schema_c, output_array_c);
+    auto maybe_table = receive_table(*result->reader, shared_reply, arena, pool);
+    ar_status = unpack_table(maybe_table, output_schema_c, output_array_c);
     return_error_if_m(ar_status.ok(), c.error, network_k, "No response");
 
     // Convert the responses in Arrow C form
@@ -801,6 +1469,7 @@ void ukv_paths_match(ukv_paths_match_t* c_ptr) {
 void ukv_paths_read(ukv_paths_read_t* c_ptr) {
 
     ukv_paths_read_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::paths_read_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -845,6 +1514,9 @@ void ukv_paths_read(ukv_paths_read_t* c_ptr) {
     if (partial_mode)
         fmt::format_to(std::back_inserter(descriptor.cmd), "{}={}&", kParamReadPart, partial_mode);
     export_options(c.options, descriptor.cmd);
+    export_compression(db.compression, descriptor.cmd);
+    export_staleness(db, descriptor.cmd);
+    bool const shared_reply = expects_shared_reply(db, c.options);
 
     bool const has_collections_column = collections && !same_collection;
     constexpr bool has_paths_column = true;
@@ -910,6 +1582,8 @@ void ukv_paths_read(ukv_paths_read_t* c_ptr) {
     return_error_if_m(maybe_batch.ok(), c.error, error_unknown_k, "Can't pack RecordBatch");
 
     std::shared_ptr<ar::RecordBatch> batch_ptr = maybe_batch.ValueUnsafe();
+    ar_status = prepare_upload(db, batch_ptr, options.write_options);
+    return_error_if_m(ar_status.ok(), c.error, error_unknown_k, "Can't encode RecordBatch");
     if (batch_ptr->num_rows() == 0)
         return;
     ar::Result<arf::FlightClient::DoExchangeResult> result = db.flight->DoExchange(options, descriptor);
@@ -929,7 +1603,8 @@ void ukv_paths_read(ukv_paths_read_t* c_ptr) {
     // Requesting `ToTable` might be more efficient than concatenating and
     // reallocating directly from our arena, as the underlying Arrow implementation
     // may know the length of the entire dataset.
-    ar_status = unpack_table(result->reader->ToTable(), output_schema_c, output_array_c);
+    auto maybe_table = receive_table(*result->reader, shared_reply, arena, pool);
+    ar_status = unpack_table(maybe_table, output_schema_c, output_array_c);
     return_error_if_m(ar_status.ok(), c.error, network_k, "No response");
 
     // Convert the responses in Arrow C form
@@ -983,6 +1658,7 @@ void ukv_paths_read(ukv_paths_read_t* c_ptr) {
 void ukv_scan(ukv_scan_t* c_ptr) {
 
     ukv_scan_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -998,6 +1674,7 @@ void ukv_scan(ukv_scan_t* c_ptr) {
     bool const same_collection = places.same_collection();
     bool const same_named_collection = same_collection && same_collections_are_named(places.collections_begin);
     bool const write_flush = c.options & ukv_option_write_flush_k;
+    bool const request_values = c.values || c.values_offsets || c.values_lengths;
 
     bool const has_collections_column = !same_collection;
     constexpr bool has_start_keys_column = true;
@@ -1086,13 +1763,20 @@ void ukv_scan(ukv_scan_t* c_ptr) {
     fmt::format_to(std::back_inserter(descriptor.cmd), "{}={}&", kParamSnapshotID, c.snapshot);
     if (same_named_collection)
         fmt::format_to(std::back_inserter(descriptor.cmd), "{}=0x{:0>16x}&", kParamCollectionID, collections[0]);
+    if (request_values)
+        fmt::format_to(std::back_inserter(descriptor.cmd), "{}&", kParamFlagScanValues);
     export_options(c.options, descriptor.cmd);
+    export_compression(db.compression, descriptor.cmd);
+    export_staleness(db, descriptor.cmd);
+    bool const shared_reply = expects_shared_reply(db, c.options);
 
     // Send the request to server
     ar::Result<std::shared_ptr<ar::RecordBatch>> maybe_batch = ar::ImportRecordBatch(&input_array_c, &input_schema_c);
     return_error_if_m(maybe_batch.ok(), c.error, error_unknown_k, "Can't pack RecordBatch");
 
     std::shared_ptr<ar::RecordBatch> batch_ptr = maybe_batch.ValueUnsafe();
+    ar_status = prepare_upload(db, batch_ptr, options.write_options);
+    return_error_if_m(ar_status.ok(), c.error, error_unknown_k, "Can't encode RecordBatch");
     if (batch_ptr->num_rows() == 0)
         return;
     ar::Result<arf::FlightClient::DoExchangeResult> result = db.flight->DoExchange(options, descriptor);
@@ -1112,11 +1796,15 @@ void ukv_scan(ukv_scan_t* c_ptr) {
     // Requesting `ToTable` might be more efficient than concatenating and
     // reallocating directly from our arena, as the underlying Arrow implementation
     // may know the length of the entire dataset.
-    ar_status = unpack_table(result->reader->ToTable(), output_schema_c, output_array_c);
+    auto maybe_table = receive_table(*result->reader, shared_reply, arena, pool);
+    ar_status = unpack_table(maybe_table, output_schema_c, output_array_c);
     return_error_if_m(ar_status.ok(), c.error, network_k, "No response");
 
     // Convert the responses in Arrow C form
-    return_error_if_m(output_schema_c.n_children == 1, c.error, error_unknown_k, "Expecting one column");
+    return_error_if_m(output_schema_c.n_children == 1 + request_values,
+                      c.error,
+                      error_unknown_k,
+                      "Expecting keys and optionally values columns");
     return_error_if_m(output_schema_c.children[0]->n_children == 1,
                       c.error,
                       error_unknown_k,
@@ -1135,11 +1823,188 @@ void ukv_scan(ukv_scan_t* c_ptr) {
         for (std::size_t i = 0; i != places.count; ++i)
             lens[i] = offs_ptr[i + 1] - offs_ptr[i];
     }
+
+    if (!request_values)
+        return;
+
+    // The values column is a list of binary strings, aligned with the keys list
+    return_error_if_m(output_schema_c.children[1]->n_children == 1,
+                      c.error,
+                      error_unknown_k,
+                      "Expecting one sub-column");
+
+    ArrowArray const& values_array_c = *output_array_c.children[1]->children[0];
+    auto vals_offs_ptr = (ukv_length_t*)values_array_c.buffers[1];
+    auto vals_data_ptr = (ukv_bytes_ptr_t)values_array_c.buffers[2];
+    ukv_length_t const total_keys = offs_ptr[places.count];
+
+    if (c.values_offsets)
+        *c.values_offsets = vals_offs_ptr;
+    if (c.values)
+        *c.values = vals_data_ptr;
+    if (c.values_lengths) {
+        auto lens = *c.values_lengths = arena.alloc<ukv_length_t>(total_keys, c.error).begin();
+        return_if_error_m(c.error);
+        for (std::size_t i = 0; i != total_keys; ++i)
+            lens[i] = vals_offs_ptr[i + 1] - vals_offs_ptr[i];
+    }
+}
+
+void ukv_collection_split(ukv_collection_split_t* c_ptr) {
+
+    ukv_collection_split_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::split_k, c.error, c.count);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.count, c.error, args_wrong_k, "Can't split into zero parts");
+
+    linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
+    return_if_error_m(c.error);
+
+    rpc_client_t& db = *reinterpret_cast<rpc_client_t*>(c.db);
+
+    arf::Ticket ticket;
+    fmt::format_to(std::back_inserter(ticket.ticket),
+                   "{}?{}=0x{:0>16x}&{}={}&{}={}&{}={}&{}={}&",
+                   kFlightSplit,
+                   kParamCollectionID,
+                   c.collection,
+                   kParamSnapshotID,
+                   c.snapshot,
+                   kParamScanStart,
+                   c.start_key,
+                   kParamScanEnd,
+                   c.end_key,
+                   kParamSplitCount,
+                   c.count);
+    export_staleness(db, ticket.ticket);
+    ar::Result<std::unique_ptr<arf::FlightStreamReader>> maybe_stream = db.flight->DoGet(ticket);
+    return_error_if_m(maybe_stream.ok(), c.error, network_k, "Failed to act on Arrow server");
+
+    auto& stream_ptr = maybe_stream.ValueUnsafe();
+    ar::Result<std::shared_ptr<ar::Table>> maybe_table = stream_ptr->ToTable();
+
+    ArrowSchema schema_c;
+    ArrowArray batch_c;
+    ar::Status ar_status = unpack_table(maybe_table, schema_c, batch_c);
+    return_error_if_m(ar_status.ok(), c.error, network_k, "No response");
+
+    auto keys_column_idx = column_idx(schema_c, kArgKeys);
+    return_error_if_m(keys_column_idx, c.error, args_combo_k, "Expecting one column");
+    return_error_if_m(batch_c.length == static_cast<int64_t>(c.count + 1),
+                      c.error,
+                      error_unknown_k,
+                      "Expecting one more boundary than parts");
+
+    // Copy into the arena, as the imported Arrow buffers don't outlive this call
+    auto boundaries = *c.boundaries = arena.alloc<ukv_key_t>(c.count + 1, c.error).begin();
+    return_if_error_m(c.error);
+    auto received = reinterpret_cast<ukv_key_t const*>(batch_c.children[*keys_column_idx]->buffers[1]);
+    std::copy(received, received + c.count + 1, boundaries);
+}
+
+/**
+ * Partitions are split by the server engine with `ukv_collection_split()`,
+ * and are then drained with regular scans, hinting the server engine with
+ * `ukv_option_scan_bulk_k` to read ahead.
+ */
+void ukv_scan_bulk_init(ukv_scan_bulk_init_t* c_ptr) {
+
+    ukv_scan_bulk_init_t& c = *c_ptr;
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.scan, c.error, args_wrong_k, "Output handle is missing");
+
+    std::size_t const partitions_count = std::max<std::size_t>(c.partitions_count, 1u);
+    ukv_key_t* boundaries = nullptr;
+    ukv_collection_split_t split {};
+    split.db = c.db;
+    split.error = c.error;
+    split.snapshot = c.snapshot;
+    split.arena = c.arena;
+    split.options = c.options;
+    split.collection = c.collection;
+    split.start_key = std::numeric_limits<ukv_key_t>::min();
+    split.end_key = std::numeric_limits<ukv_key_t>::max();
+    split.count = partitions_count;
+    split.boundaries = &boundaries;
+    ukv_collection_split(&split);
+    return_if_error_m(c.error);
+
+    safe_section("Allocating bulk scan", c.error, [&] {
+        auto scan = std::make_unique<ranged_bulk_scan_t>();
+        scan->db = c.db;
+        scan->collection = c.collection;
+        scan->snapshot = c.snapshot;
+        scan->split({boundaries + 1, partitions_count - 1}, partitions_count);
+        *c.scan = scan.release();
+    });
+}
+
+void ukv_scan_bulk_next(ukv_scan_bulk_next_t* c_ptr) {
+
+    ukv_scan_bulk_next_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_bulk_k, c.error);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.scan, c.error, uninitialized_state_k, "Bulk scan is uninitialized");
+    ranged_bulk_scan_next(*reinterpret_cast<ranged_bulk_scan_t*>(c.scan), c);
+}
+
+void ukv_scan_bulk_free(ukv_scan_bulk_t c_scan) {
+    delete reinterpret_cast<ranged_bulk_scan_t*>(c_scan);
+}
+
+/**
+ * The `DoGet` stream is handed to the caller as is, so batches are fetched only
+ * as they are consumed, and are owned by Arrow rather than by any of our arenas.
+ */
+void ukv_scan_stream(ukv_scan_stream_t* c_ptr) {
+
+    ukv_scan_stream_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::scan_k, c.error);
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+    return_error_if_m(c.stream, c.error, args_wrong_k, "Output stream is missing");
+
+    rpc_client_t& db = *reinterpret_cast<rpc_client_t*>(c.db);
+
+    arf::Ticket ticket;
+    fmt::format_to(std::back_inserter(ticket.ticket),
+                   "{}?{}=0x{:0>16x}&{}={}&{}={}&",
+                   kFlightScanStream,
+                   kParamCollectionID,
+                   c.collection,
+                   kParamSnapshotID,
+                   c.snapshot,
+                   kParamScanStart,
+                   c.start_key);
+    if (c.transaction)
+        fmt::format_to(std::back_inserter(ticket.ticket),
+                       "{}=0x{:0>16x}&",
+                       kParamTransactionID,
+                       std::uintptr_t(c.transaction));
+    if (c.count_limit)
+        fmt::format_to(std::back_inserter(ticket.ticket), "{}={}&", kParamScanLimit, c.count_limit);
+    if (c.batch_size)
+        fmt::format_to(std::back_inserter(ticket.ticket), "{}={}&", kParamScanBatchSize, c.batch_size);
+    if (c.values)
+        fmt::format_to(std::back_inserter(ticket.ticket), "{}&", kParamFlagScanValues);
+    export_options(c.options, ticket.ticket);
+    export_compression(db.compression, ticket.ticket);
+    export_staleness(db, ticket.ticket);
+
+    ar::Result<std::unique_ptr<arf::FlightStreamReader>> maybe_stream = db.flight->DoGet(ticket);
+    return_error_if_m(maybe_stream.ok(), c.error, network_k, "Failed to act on Arrow server");
+
+    std::shared_ptr<arf::FlightStreamReader> stream_ptr = std::move(maybe_stream).ValueUnsafe();
+    ar::Result<std::shared_ptr<ar::RecordBatchReader>> maybe_reader = arf::MakeRecordBatchReader(stream_ptr);
+    return_error_if_m(maybe_reader.ok(), c.error, network_k, "No response");
+
+    ar::Status ar_status = ar::ExportRecordBatchReader(maybe_reader.ValueUnsafe(), c.stream);
+    return_error_if_m(ar_status.ok(), c.error, error_unknown_k, "Failed to export the stream");
 }
 
 void ukv_sample(ukv_sample_t* c_ptr) {
 
     ukv_sample_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::sample_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -1171,6 +2036,9 @@ void ukv_sample(ukv_sample_t* c_ptr) {
     if (same_named_collection)
         fmt::format_to(std::back_inserter(descriptor.cmd), "{}=0x{:0>16x}&", kParamCollectionID, collections[0]);
     export_options(c.options, descriptor.cmd);
+    export_compression(db.compression, descriptor.cmd);
+    export_staleness(db, descriptor.cmd);
+    bool const shared_reply = expects_shared_reply(db, c.options);
 
     bool const has_collections_column = collections && !same_collection;
     bool const has_limits_column = true;
@@ -1228,6 +2096,8 @@ void ukv_sample(ukv_sample_t* c_ptr) {
     return_error_if_m(maybe_batch.ok(), c.error, error_unknown_k, "Can't pack RecordBatch");
 
     std::shared_ptr<ar::RecordBatch> batch_ptr = maybe_batch.ValueUnsafe();
+    ar_status = prepare_upload(db, batch_ptr, options.write_options);
+    return_error_if_m(ar_status.ok(), c.error, error_unknown_k, "Can't encode RecordBatch");
     if (batch_ptr->num_rows() == 0)
         return;
     ar::Result<arf::FlightClient::DoExchangeResult> result = db.flight->DoExchange(options, descriptor);
@@ -1247,7 +2117,8 @@ void ukv_sample(ukv_sample_t* c_ptr) {
     // Requesting `ToTable` might be more efficient than concatenating and
     // reallocating directly from our arena, as the underlying Arrow implementation
     // may know the length of the entire dataset.
-    ar_status = unpack_table(result->reader->ToTable(), output_schema_c, output_array_c);
+    auto maybe_table = receive_table(*result->reader, shared_reply, arena, pool);
+    ar_status = unpack_table(maybe_table, output_schema_c, output_array_c);
     return_error_if_m(ar_status.ok(), c.error, network_k, "No response");
 
     // Convert the responses in Arrow C form
@@ -1272,6 +2143,7 @@ void ukv_sample(ukv_sample_t* c_ptr) {
 void ukv_measure(ukv_measure_t* c_ptr) {
 
     ukv_measure_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::measure_k, c.error, c.tasks_count);
     return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
 
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
@@ -1343,6 +2215,8 @@ void ukv_collection_drop(ukv_collection_drop_t* c_ptr) {
     arrow_mem_pool_t pool(db.arena);
     arf::FlightCallOptions options = arrow_call_options(pool);
     ar::Result<std::unique_ptr<arf::ResultStream>> maybe_stream = db.flight->DoAction(options, action);
+    if (db.cache)
+        db.cache->invalidate(c.id);
     return_error_if_m(maybe_stream.ok(), c.error, network_k, "Failed to act on Arrow server");
 }
 
@@ -1499,6 +2373,14 @@ void ukv_transaction_init(ukv_transaction_init_t* c_ptr) {
         fmt::format_to(std::back_inserter(action.type), "{}=0x{:0>16x}&", kParamTransactionID, txn_id);
     if (c.options & ukv_option_transaction_dont_watch_k)
         fmt::format_to(std::back_inserter(action.type), "{}&", kParamFlagDontWatch);
+    if (c.options & ukv_option_transaction_pessimistic_k)
+        fmt::format_to(std::back_inserter(action.type), "{}&", kParamFlagPessimistic);
+    if (c.options & ukv_option_transaction_read_only_k)
+        fmt::format_to(std::back_inserter(action.type), "{}&", kParamFlagReadOnly);
+    if (c.lock_timeout)
+        fmt::format_to(std::back_inserter(action.type), "{}={}&", kParamLockTimeout, c.lock_timeout);
+    if (txn_id != 0 && db.cache)
+        forget_written(db, reinterpret_cast<ukv_transaction_t>(txn_id), false);
 
     ar::Result<std::unique_ptr<arf::ResultStream>> maybe_stream;
     {
@@ -1524,6 +2406,7 @@ void ukv_transaction_init(ukv_transaction_init_t* c_ptr) {
 void ukv_transaction_commit(ukv_transaction_commit_t* c_ptr) {
 
     ukv_transaction_commit_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::transaction_commit_k, c.error);
     return_error_if_m(c.transaction, c.error, uninitialized_state_k, "Transaction is uninitialized");
 
     rpc_client_t& db = *reinterpret_cast<rpc_client_t*>(c.db);
@@ -1541,6 +2424,15 @@ void ukv_transaction_commit(ukv_transaction_commit_t* c_ptr) {
     arrow_mem_pool_t pool(db.arena);
     arf::FlightCallOptions options = arrow_call_options(pool);
     ar::Result<std::unique_ptr<arf::ResultStream>> maybe_stream = db.flight->DoAction(options, action);
+    if (db.cache) {
+        // Wait for the commit to be applied, before forgetting the old values
+        while (maybe_stream.ok()) {
+            ar::Result<std::unique_ptr<arf::Result>> maybe_result = maybe_stream.ValueUnsafe()->Next();
+            if (!maybe_result.ok() || !maybe_result.ValueUnsafe())
+                break;
+        }
+        forget_written(db, c.transaction, true);
+    }
     return_error_if_m(maybe_stream.ok(), c.error, network_k, "Failed to act on Arrow server");
 }
 
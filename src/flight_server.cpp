@@ -10,6 +10,13 @@
  */
 
 #include <mutex>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <memory>
+#include <deque>
+#include <condition_variable>
 #include <charconv> // `std::from_chars`
 #include <chrono>   // `std::time_point`
 #include <cstdio>   // `std::printf`
@@ -17,8 +24,11 @@
 #include <unordered_map>
 #include <unordered_set>
 
-#include <arrow/flight/server.h> // RPC Server Implementation
-#include <clipp.h>               // Command Line Interface
+#include <arrow/flight/server.h>  // RPC Server Implementation
+#include <arrow/flight/client.h>  // Followers replicating a primary
+#include <arrow/ipc/dictionary.h> // `ar::ipc::DictionaryFieldMapper`
+#include <arrow/builder.h>        // `ar::BinaryBuilder`
+#include <clipp.h>                // Command Line Interface
 
 #include "ukv/cpp/db.hpp"
 #include "ukv/cpp/types.hpp" // `hash_combine`
@@ -36,52 +46,33 @@ using sys_time_t = std::chrono::time_point<sys_clock_t>;
 /// https://github.com/apache/arrow/blob/2078af7c710d688c14313b9486b99c981550a7b7/cpp/src/arrow/memory_pool_internal.h#L34
 static std::int64_t const zero_size_data_k[1] = {0};
 
+/// Default number of entries in every `RecordBatch` of a streaming scan.
+static constexpr ukv_length_t scan_stream_batch_size_k = 16 * 1024;
+
+/// Number of entries in the change log, retained for followers to catch up.
+static constexpr std::size_t change_log_capacity_k = 64 * 1024;
+/// Combined size of buffers in the change log, above which the oldest entries are trimmed.
+static constexpr std::size_t change_log_bytes_k = 256ul * 1024ul * 1024ul;
+/// Writes of abandoned transactions are forgotten after this long.
+static constexpr std::chrono::milliseconds change_log_stash_timeout_k {60'000};
+/// Exported shared memory segments, that clients haven't adopted in this long, are unlinked.
+static constexpr std::chrono::milliseconds shared_memory_timeout_k {60'000};
+/// How often the exported shared memory segments are checked for expiration.
+static constexpr std::chrono::milliseconds shared_memory_sweep_interval_k {1'000};
+/// Smaller replies are cheaper to stream, than to pass through a new shared memory segment.
+static constexpr std::size_t shared_memory_min_bytes_k = 256 * 1024;
+/// How often idle replication streams report the latest sequence number to followers.
+static constexpr std::chrono::milliseconds replication_heartbeat_k {100};
+/// How long a follower waits before reconnecting to its primary.
+static constexpr std::chrono::milliseconds replication_retry_k {1'000};
+
 inline static arf::ActionType const kActionColOpen {kFlightColCreate, "Find a collection descriptor by name."};
 inline static arf::ActionType const kActionColDrop {kFlightColDrop, "Delete a named collection."};
 inline static arf::ActionType const kActionSnapOpen {kFlightSnapCreate, "Find a snapshot descriptor by name."};
 inline static arf::ActionType const kActionSnapDrop {kFlightSnapDrop, "Delete a named snapshot."};
 inline static arf::ActionType const kActionTxnBegin {kFlightTxnBegin, "Starts an ACID transaction and returns its ID."};
 inline static arf::ActionType const kActionTxnCommit {kFlightTxnCommit, "Commit a previously started transaction."};
-
-/**
- * @brief Searches for a "value" among key-value pairs passed in URI after path.
- * @param query_params  Must begin with "?" or "/".
- * @param param_name    The name of the URI parameter to match.
- */
-std::optional<std::string_view> param_value(std::string_view query_params, std::string_view param_name) {
-
-    char const* key_begin = query_params.begin();
-    do {
-        key_begin = std::search(key_begin, query_params.end(), param_name.begin(), param_name.end());
-        if (key_begin == query_params.end())
-            return std::nullopt;
-        bool is_suffix = key_begin + param_name.size() == query_params.end();
-        if (is_suffix)
-            return std::string_view {};
-
-        // Check if we have matched a part of bigger key.
-        // In that case skip to next starting point.
-        auto prev_character = *(key_begin - 1);
-        if (prev_character != '?' && prev_character != '&' && prev_character != '/') {
-            key_begin += 1;
-            continue;
-        }
-
-        auto next_character = key_begin[param_name.size()];
-        if (next_character == '&')
-            return std::string_view {};
-
-        if (next_character == '=') {
-            auto value_begin = key_begin + param_name.size() + 1;
-            auto value_end = std::find(value_begin, query_params.end(), '&');
-            return std::string_view {value_begin, static_cast<size_t>(value_end - value_begin)};
-        }
-
-        key_begin += 1;
-    } while (true);
-
-    return std::nullopt;
-}
+inline static arf::ActionType const kActionMetrics {kFlightMetrics, "Export metrics in the Prometheus text format."};
 
 bool is_query(std::string_view uri, std::string_view name) {
     if (uri.size() > name.size())
@@ -175,6 +166,18 @@ client_id_t parse_client_id(arf::ServerCallContext const& ctx) noexcept {
     return static_cast<client_id_t>(std::hash<std::string> {}(peer_addr));
 }
 
+/**
+ * @brief Checks if the gRPC peer, like "ipv4:127.0.0.1:53412" or "unix:/tmp/ukv.sock",
+ * runs on the same machine and can map our shared memory segments.
+ */
+bool is_local_peer(std::string_view peer_addr) noexcept {
+    auto starts_with = [&](std::string_view prefix) {
+        return peer_addr.substr(0, prefix.size()) == prefix;
+    };
+    return starts_with("unix:") || starts_with("ipv4:127.") || starts_with("ipv6:[::1]") ||
+           starts_with("ipv6:%5B::1%5D") || starts_with("ipv6:[::ffff:127.");
+}
+
 base_id_t parse_u64_hex(std::string_view str, base_id_t default_ = 0) noexcept {
     // if (str.size() != 16 + 2)
     //     return default_;
@@ -191,12 +194,22 @@ txn_id_t parse_txn_id(std::string_view str) {
     return txn_id_t {parse_u64_hex(str)};
 }
 
-base_id_t parse_snap_id(std::string_view str, base_id_t default_ = 0) {
+base_id_t parse_u64_dec(std::string_view str, base_id_t default_ = 0) noexcept {
     base_id_t result = default_;
     std::from_chars(str.data(), str.data() + str.size(), result);
     return result;
 }
 
+ukv_key_t parse_key(std::string_view str, ukv_key_t default_) noexcept {
+    ukv_key_t result = default_;
+    std::from_chars(str.data(), str.data() + str.size(), result);
+    return result;
+}
+
+base_id_t parse_snap_id(std::string_view str, base_id_t default_ = 0) {
+    return parse_u64_dec(str, default_);
+}
+
 struct session_id_t {
     client_id_t client_id {0};
     txn_id_t txn_id {0};
@@ -243,12 +256,88 @@ struct aging_txn_order_t {
     }
 };
 
+/**
+ * @brief Bounded lock-free pool of reusable handles.
+ * Implemented as a pair of Treiber stacks over a fixed array of nodes: one links
+ * the nodes holding handles, the other links the vacant ones. Both heads are tagged
+ * with a generation counter in the upper half, to avoid the ABA problem.
+ *
+ * Handles are allowed to be NULL, as arenas and transactions are lazily
+ * initialized by the engine on first use.
+ */
+template <typename handle_at>
+class free_list_gt {
+    using idx_t = std::uint32_t;
+    using head_t = std::uint64_t;
+    static constexpr idx_t missing_k = std::numeric_limits<idx_t>::max();
+
+    struct node_t {
+        handle_at handle {};
+        std::atomic<idx_t> next {missing_k};
+    };
+
+    std::unique_ptr<node_t[]> nodes_;
+    std::atomic<head_t> filled_head_ {missing_k};
+    std::atomic<head_t> vacant_head_ {missing_k};
+
+    static idx_t index(head_t head) noexcept { return static_cast<idx_t>(head); }
+    static head_t retag(head_t old_head, idx_t idx) noexcept { return (((old_head >> 32) + 1) << 32) | idx; }
+
+    idx_t pop_node(std::atomic<head_t>& head) noexcept {
+        head_t old_head = head.load(std::memory_order_acquire);
+        while (index(old_head) != missing_k) {
+            idx_t next = nodes_[index(old_head)].next.load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(old_head,
+                                           retag(old_head, next),
+                                           std::memory_order_acquire,
+                                           std::memory_order_acquire))
+                return index(old_head);
+        }
+        return missing_k;
+    }
+
+    void push_node(std::atomic<head_t>& head, idx_t idx) noexcept {
+        head_t old_head = head.load(std::memory_order_relaxed);
+        do {
+            nodes_[idx].next.store(index(old_head), std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(old_head,
+                                             retag(old_head, idx),
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+    }
+
+  public:
+    free_list_gt(std::size_t capacity) : nodes_(new node_t[capacity]) {
+        for (std::size_t i = 0; i != capacity; ++i)
+            push_node(filled_head_, static_cast<idx_t>(i));
+    }
+
+    bool try_pop(handle_at& handle) noexcept {
+        idx_t idx = pop_node(filled_head_);
+        if (idx == missing_k)
+            return false;
+        handle = nodes_[idx].handle;
+        push_node(vacant_head_, idx);
+        return true;
+    }
+
+    bool try_push(handle_at handle) noexcept {
+        idx_t idx = pop_node(vacant_head_);
+        if (idx == missing_k)
+            return false;
+        nodes_[idx].handle = handle;
+        push_node(filled_head_, idx);
+        return true;
+    }
+};
+
 class sessions_t;
 struct session_lock_t {
     sessions_t& sessions;
     session_id_t session_id;
     ukv_transaction_t txn = nullptr;
     ukv_arena_t arena = nullptr;
+    bool acquired = false;
 
     bool is_txn() const noexcept { return txn; }
     ~session_lock_t() noexcept;
@@ -259,59 +348,165 @@ struct session_lock_t {
  * holds ownership of any "transaction handle" or "memory arena" for too long. So if
  * a client goes mute or disconnects, we can reuse same memory for other connections
  * and clients.
+ *
+ * ## Concurrency
+ *
+ * Every request passes through this registry at least twice, so it can't be
+ * guarded by a single mutex. Reusable handles live in lock-free free-lists,
+ * so stateless requests never lock anything. Running transactions are spread
+ * across shards by the hash of their session ID, each with its own mutex.
+ * Eviction of aging sessions happens in a background thread, locking only
+ * one shard at a time, or inline, once the free-lists are exhausted.
  */
 class sessions_t {
-    std::mutex mutex_;
+    static constexpr std::size_t shards_count_k = 64;
+
+    struct shard_t {
+        std::mutex mutex;
+        /// Links each session to memory used for its operations:
+        client_to_txn_t client_to_txn;
+    };
+
     // Reusable object handles:
-    std::vector<ukv_arena_t> free_arenas_;
-    std::vector<ukv_transaction_t> free_txns_;
-    /// Links each session to memory used for its operations:
-    client_to_txn_t client_to_txn_;
+    free_list_gt<ukv_arena_t> free_arenas_;
+    free_list_gt<ukv_transaction_t> free_txns_;
+    std::array<shard_t, shards_count_k> shards_;
     ukv_database_t db_ = nullptr;
+    /// Cap on the memory of every session arena, or zero, if unlimited.
+    std::size_t arena_limit_ = 0;
     // On Postgre 9.6+ is set to same 30 seconds.
-    std::size_t milliseconds_timeout = 30'000;
+    std::chrono::milliseconds timeout_ {30'000};
+    std::chrono::milliseconds sweep_interval_ {1'000};
 
-    running_txn_t pop(ukv_error_t* c_error) noexcept {
+    std::mutex sweeper_mutex_;
+    std::condition_variable sweeper_wakeup_;
+    bool sweeper_stop_ = false;
+    std::thread sweeper_;
 
-        auto it = std::min_element(client_to_txn_.begin(), client_to_txn_.end(), [](auto left, auto right) {
-            return left.second.last_access < right.second.last_access && !left.second.executing;
-        });
+    shard_t& shard(session_id_t session_id) noexcept {
+        return shards_[session_id_hash_t {}(session_id) % shards_count_k];
+    }
 
-        auto age = std::chrono::duration_cast<std::chrono::milliseconds>(it->second.last_access - sys_clock_t::now());
-        if (age.count() < milliseconds_timeout || it->second.executing) {
-            log_error_m(c_error, error_unknown_k, "Too many concurrent sessions");
-            return {};
+    void submit(shard_t& shard, session_id_t session_id, running_txn_t running_txn) noexcept {
+        running_txn.executing = false;
+        shard.client_to_txn.insert_or_assign(session_id, running_txn);
+    }
+
+    /**
+     * @brief Returns the handles of transactions, that weren't accessed
+     * for longer than the timeout, back into the free-lists.
+     */
+    void sweep() noexcept {
+        sys_time_t const now = sys_clock_t::now();
+        for (shard_t& shard : shards_) {
+            std::unique_lock _ {shard.mutex};
+            auto& sessions = shard.client_to_txn;
+            for (auto it = sessions.begin(); it != sessions.end();) {
+                running_txn_t const& running = it->second;
+                if (running.executing || now - running.last_access < timeout_) {
+                    ++it;
+                    continue;
+                }
+                recycle_arena(running.arena);
+                recycle_txn(running.txn);
+                it = sessions.erase(it);
+            }
         }
+    }
 
-        running_txn_t released = it->second;
-        client_to_txn_.erase(it);
-        released.executing = false;
-        return released;
+    /**
+     * @brief Returns the memory of a finished session to the process-wide pool,
+     * before its arena goes to the free-list, so that one huge request doesn't
+     * keep gigabytes of memory reserved by an idle handle.
+     */
+    void recycle_arena(ukv_arena_t arena) noexcept {
+        ukv_arena_trim(arena);
+        free_arenas_.try_push(arena);
     }
 
-    void submit(session_id_t session_id, running_txn_t running_txn) noexcept {
-        running_txn.executing = false;
-        auto res = client_to_txn_.insert_or_assign(session_id, running_txn);
+    /**
+     * @brief Resets an abandoned or finished transaction, before its handle goes
+     * to the free-list, so that the key locks of pessimistic transactions aren't
+     * held until the handle is reused.
+     */
+    void recycle_txn(ukv_transaction_t txn) noexcept {
+        if (txn) {
+            ukv_error_t c_error = nullptr;
+            ukv_transaction_init_t txn_init {};
+            txn_init.db = db_;
+            txn_init.error = &c_error;
+            txn_init.transaction = &txn;
+            ukv_transaction_init(&txn_init);
+            ukv_error_free(c_error);
+        }
+        free_txns_.try_push(txn);
+    }
+
+    bool limit_arena(ukv_arena_t& arena, ukv_error_t* c_error) noexcept {
+        if (!arena_limit_)
+            return true;
+        ukv_arena_limit(&arena, arena_limit_, c_error);
+        if (!*c_error)
+            return true;
+        free_arenas_.try_push(arena);
+        return false;
+    }
+
+    /**
+     * @brief Pops a handle from the free-list, evicting the aging sessions inline,
+     * if the background sweeper hasn't caught up with a burst of new sessions yet.
+     */
+    template <typename handle_at>
+    bool pop_or_sweep(free_list_gt<handle_at>& free_list, handle_at& handle) noexcept {
+        if (free_list.try_pop(handle))
+            return true;
+        sweep();
+        return free_list.try_pop(handle);
+    }
+
+    void sweep_in_background() noexcept {
+        std::unique_lock lock {sweeper_mutex_};
+        while (!sweeper_wakeup_.wait_for(lock, sweep_interval_, [&] { return sweeper_stop_; }))
+            sweep();
     }
 
   public:
-    sessions_t(ukv_database_t db, std::size_t n) : db_(db), free_arenas_(n), free_txns_(n), client_to_txn_(n) {
-        std::fill_n(free_arenas_.begin(), n, nullptr);
-        std::fill_n(free_txns_.begin(), n, nullptr);
+    sessions_t(ukv_database_t db, std::size_t n, std::size_t arena_limit = 0)
+        : free_arenas_(n), free_txns_(n), db_(db), arena_limit_(arena_limit) {
+        for (shard_t& shard : shards_)
+            shard.client_to_txn.reserve(n / shards_count_k + 1);
+        sweeper_ = std::thread(&sessions_t::sweep_in_background, this);
     }
 
     ~sessions_t() noexcept {
-        for (auto a : free_arenas_)
-            ukv_arena_free(a);
-        for (auto t : free_txns_)
-            ukv_transaction_free(t);
+        {
+            std::unique_lock _ {sweeper_mutex_};
+            sweeper_stop_ = true;
+        }
+        sweeper_wakeup_.notify_all();
+        sweeper_.join();
+
+        for (shard_t& shard : shards_) {
+            for (auto const& [session_id, running] : shard.client_to_txn) {
+                ukv_arena_free(running.arena);
+                ukv_transaction_free(running.txn);
+            }
+        }
+
+        ukv_arena_t arena = nullptr;
+        while (free_arenas_.try_pop(arena))
+            ukv_arena_free(arena);
+        ukv_transaction_t txn = nullptr;
+        while (free_txns_.try_pop(txn))
+            ukv_transaction_free(txn);
     }
 
     running_txn_t continue_txn(session_id_t session_id, ukv_error_t* c_error) noexcept {
-        std::unique_lock _ {mutex_};
+        shard_t& shard = this->shard(session_id);
+        std::unique_lock _ {shard.mutex};
 
-        auto it = client_to_txn_.find(session_id);
-        if (it == client_to_txn_.end()) {
+        auto it = shard.client_to_txn.find(session_id);
+        if (it == shard.client_to_txn.end()) {
             log_error_m(c_error, args_wrong_k, "Transaction was terminated, start a new one");
             return {};
         }
@@ -324,96 +519,108 @@ class sessions_t {
 
         running.executing = true;
         running.last_access = sys_clock_t::now();
-
-        // Update the heap order.
-        // With a single change shouldn't take more than `log2(n)` operations.
         return running;
     }
 
+    /**
+     * @brief Reserves the handles for a new transaction and registers it as executing,
+     * so that concurrent requests with the same session ID fail, instead of overwriting it.
+     * Must be followed by `hold_txn(session_id, ...)` or `cancel_txn(session_id, ...)`.
+     */
     running_txn_t request_txn(session_id_t session_id, ukv_error_t* c_error) noexcept {
-        std::unique_lock _ {mutex_};
-
-        auto it = client_to_txn_.find(session_id);
-        if (it != client_to_txn_.end()) {
-            log_error_m(c_error, args_wrong_k, "Such transaction is already running, just continue using it.");
+        running_txn_t running {};
+        if (!pop_or_sweep(free_arenas_, running.arena)) {
+            log_error_m(c_error, error_unknown_k, "Too many concurrent sessions");
             return {};
         }
-
-        // Consider evicting some of the old sessions, if there are no more empty slots
-        if (free_txns_.empty() || free_arenas_.empty()) {
-            running_txn_t running = pop(c_error);
-            if (*c_error)
-                return {};
-            running.executing = true;
-            running.last_access = sys_clock_t::now();
-            return running;
+        if (!limit_arena(running.arena, c_error))
+            return {};
+        if (!pop_or_sweep(free_txns_, running.txn)) {
+            free_arenas_.try_push(running.arena);
+            log_error_m(c_error, error_unknown_k, "Too many concurrent sessions");
+            return {};
         }
 
-        // If we have free slots
-        running_txn_t running {};
-        running.arena = free_arenas_.back();
-        running.txn = free_txns_.back();
         running.executing = true;
         running.last_access = sys_clock_t::now();
-        free_arenas_.pop_back();
-        free_txns_.pop_back();
+
+        shard_t& shard = this->shard(session_id);
+        std::unique_lock _ {shard.mutex};
+        if (!shard.client_to_txn.try_emplace(session_id, running).second) {
+            free_arenas_.try_push(running.arena);
+            free_txns_.try_push(running.txn);
+            log_error_m(c_error, args_wrong_k, "Such transaction is already running, just continue using it.");
+            return {};
+        }
         return running;
     }
 
     void hold_txn(session_id_t session_id, running_txn_t running_txn) noexcept {
-        std::unique_lock _ {mutex_};
-        submit(session_id, running_txn);
+        shard_t& shard = this->shard(session_id);
+        std::unique_lock _ {shard.mutex};
+        submit(shard, session_id, running_txn);
     }
 
     void release_txn(running_txn_t running_txn) noexcept {
-        std::unique_lock _ {mutex_};
-        free_arenas_.push_back(running_txn.arena);
-        free_txns_.push_back(running_txn.txn);
+        recycle_arena(running_txn.arena);
+        recycle_txn(running_txn.txn);
+    }
+
+    /**
+     * @brief Withdraws the reservation made by `request_txn`, returning the handles,
+     * that may have been reallocated since, into the free-lists.
+     */
+    void cancel_txn(session_id_t session_id, running_txn_t running_txn) noexcept {
+        {
+            shard_t& shard = this->shard(session_id);
+            std::unique_lock _ {shard.mutex};
+            shard.client_to_txn.erase(session_id);
+        }
+        release_txn(running_txn);
     }
 
     void release_txn(session_id_t session_id) noexcept {
-        std::unique_lock _ {mutex_};
-        auto it = client_to_txn_.find(session_id);
-        if (it == client_to_txn_.end())
-            return;
-        it->second.executing = false;
-        free_arenas_.push_back(it->second.arena);
-        free_txns_.push_back(it->second.txn);
-        client_to_txn_.erase(it);
+        running_txn_t running {};
+        {
+            shard_t& shard = this->shard(session_id);
+            std::unique_lock _ {shard.mutex};
+            auto it = shard.client_to_txn.find(session_id);
+            if (it == shard.client_to_txn.end())
+                return;
+            running = it->second;
+            shard.client_to_txn.erase(it);
+        }
+        release_txn(running);
     }
 
     ukv_arena_t request_arena(ukv_error_t* c_error) noexcept {
-        std::unique_lock _ {mutex_};
-        // Consider evicting some of the old sessions, if there are no more empty slots
-        if (free_arenas_.empty()) {
-            running_txn_t running = pop(c_error);
-            if (*c_error)
-                return nullptr;
-            free_txns_.push_back(running.txn);
-            return running.arena;
+        ukv_arena_t arena = nullptr;
+        if (!pop_or_sweep(free_arenas_, arena)) {
+            log_error_m(c_error, error_unknown_k, "Too many concurrent sessions");
+            return nullptr;
         }
-
-        ukv_arena_t arena = free_arenas_.back();
-        free_arenas_.pop_back();
-        return arena;
+        // Stateless requests discard the previous contents of the arena anyway
+        ukv_arena_trim(arena);
+        return limit_arena(arena, c_error) ? arena : nullptr;
     }
 
-    void release_arena(ukv_arena_t arena) noexcept {
-        std::unique_lock _ {mutex_};
-        free_arenas_.push_back(arena);
-    }
+    void release_arena(ukv_arena_t arena) noexcept { free_arenas_.try_push(arena); }
 
     session_lock_t lock(session_id_t id, ukv_error_t* c_error) noexcept {
         if (id.is_txn()) {
             running_txn_t running = continue_txn(id, c_error);
-            return {*this, id, running.txn, running.arena};
+            return {*this, id, running.txn, running.arena, *c_error == nullptr};
+        }
+        else {
+            ukv_arena_t arena = request_arena(c_error);
+            return {*this, id, nullptr, arena, *c_error == nullptr};
         }
-        else
-            return {*this, id, nullptr, request_arena(c_error)};
     }
 };
 
 session_lock_t::~session_lock_t() noexcept {
+    if (!acquired)
+        return;
     if (is_txn())
         sessions.hold_txn( //
             session_id,
@@ -430,12 +637,25 @@ struct session_params_t {
     std::optional<std::string_view> collection_id;
     std::optional<std::string_view> collection_drop_mode;
     std::optional<std::string_view> read_part;
+    std::optional<std::string_view> scan_start;
+    std::optional<std::string_view> scan_limit;
+    std::optional<std::string_view> scan_batch_size;
+    std::optional<std::string_view> scan_end;
+    std::optional<std::string_view> split_count;
+    std::optional<std::string_view> max_staleness;
+    std::optional<std::string_view> replicate_since;
+    arrow_compression_t compression;
 
     std::optional<std::string_view> opt_snapshot;
     std::optional<std::string_view> opt_flush;
     std::optional<std::string_view> opt_dont_watch;
+    std::optional<std::string_view> opt_pessimistic;
+    std::optional<std::string_view> opt_read_only;
+    std::optional<std::string_view> lock_timeout;
     std::optional<std::string_view> opt_shared_memory;
+    std::optional<std::string_view> opt_scan_bulk;
     std::optional<std::string_view> opt_dont_discard_memory;
+    std::optional<std::string_view> opt_scan_values;
 };
 
 session_params_t session_params(arf::ServerCallContext const& server_call, std::string_view uri) noexcept {
@@ -460,9 +680,24 @@ session_params_t session_params(arf::ServerCallContext const& server_call, std::
     result.collection_drop_mode = param_value(params, kParamDropMode);
     result.read_part = param_value(params, kParamReadPart);
 
+    result.scan_start = param_value(params, kParamScanStart);
+    result.scan_limit = param_value(params, kParamScanLimit);
+    result.scan_batch_size = param_value(params, kParamScanBatchSize);
+    result.scan_end = param_value(params, kParamScanEnd);
+    result.split_count = param_value(params, kParamSplitCount);
+    result.opt_scan_values = param_value(params, kParamFlagScanValues);
+    result.compression = parse_compression(params);
+
+    result.max_staleness = param_value(params, kParamMaxStaleness);
+    result.replicate_since = param_value(params, kParamReplicateSince);
+
     result.opt_flush = param_value(params, kParamFlagFlushWrite);
     result.opt_dont_watch = param_value(params, kParamFlagDontWatch);
+    result.opt_pessimistic = param_value(params, kParamFlagPessimistic);
+    result.opt_read_only = param_value(params, kParamFlagReadOnly);
+    result.lock_timeout = param_value(params, kParamLockTimeout);
     result.opt_shared_memory = param_value(params, kParamFlagSharedMemRead);
+    result.opt_scan_bulk = param_value(params, kParamFlagScanBulk);
 
     // This flag shouldn't have been forwarded to the server.
     // In standalone builds it remains on the client.
@@ -474,10 +709,16 @@ ukv_options_t ukv_options(session_params_t const& params) noexcept {
     ukv_options_t result = ukv_options_default_k;
     if (params.opt_dont_watch)
         result = ukv_options_t(result | ukv_option_transaction_dont_watch_k);
+    if (params.opt_pessimistic)
+        result = ukv_options_t(result | ukv_option_transaction_pessimistic_k);
+    if (params.opt_read_only)
+        result = ukv_options_t(result | ukv_option_transaction_read_only_k);
     if (params.opt_flush)
         result = ukv_options_t(result | ukv_option_write_flush_k);
-    if (params.opt_shared_memory)
-        result = ukv_options_t(result | ukv_option_read_shared_memory_k);
+    if (params.opt_scan_bulk)
+        result = ukv_options_t(result | ukv_option_scan_bulk_k);
+    // The `params.opt_shared_memory` isn't forwarded to the engine. Outputs of local
+    // peers are exported into segments, that the server creates and the client adopts.
     return result;
 }
 
@@ -491,6 +732,709 @@ ukv_str_view_t get_null_terminated(std::shared_ptr<ar::Buffer> const& buf_ptr) n
     return buf_ptr ? get_null_terminated(*buf_ptr) : nullptr;
 }
 
+/**
+ * @brief Releases a scanned batch together with the arena, that holds its buffers.
+ */
+void release_scanned_batch(ArrowArray* array) {
+    ukv_arena_t arena = array->private_data;
+    release_malloced_array(array);
+    ukv_arena_free(arena);
+}
+
+/**
+ * @brief Lazily exports a range of a collection, one `RecordBatch` at a time.
+ *
+ * Every batch is materialized in its own arena, which is freed only once Arrow
+ * releases the batch, as the serialized payload references the buffers without copying.
+ * The next batch is requested by the `arf::RecordBatchStream` only after the previous one
+ * was handed to gRPC, so a slow client naturally throttles the scan through flow control.
+ * Keeps the session locked until the stream is destroyed.
+ */
+class scan_stream_t final : public ar::RecordBatchReader {
+    ukv_database_t db_ = nullptr;
+    session_lock_t session_;
+    ukv_collection_t collection_ = ukv_collection_main_k;
+    ukv_snapshot_t snapshot_ = 0;
+    ukv_options_t options_ = ukv_options_default_k;
+    ukv_key_t next_key_ = std::numeric_limits<ukv_key_t>::min();
+    ukv_length_t remaining_ = std::numeric_limits<ukv_length_t>::max();
+    ukv_length_t batch_size_ = scan_stream_batch_size_k;
+    bool export_values_ = false;
+    bool is_end_ = false;
+    std::shared_ptr<ar::Schema> schema_;
+
+  public:
+    scan_stream_t(ukv_database_t db,
+                  sessions_t& sessions,
+                  session_params_t const& params,
+                  ukv_options_t options,
+                  ukv_error_t* c_error) noexcept
+        : db_(db), session_(sessions.lock(params.session_id, c_error)), options_(options) {
+
+        if (params.collection_id)
+            collection_ = parse_u64_hex(*params.collection_id, ukv_collection_main_k);
+        if (params.snapshot_id)
+            snapshot_ = parse_snap_id(*params.snapshot_id);
+        if (params.scan_start) {
+            std::string_view start = *params.scan_start;
+            std::from_chars(start.data(), start.data() + start.size(), next_key_);
+        }
+        if (params.scan_limit)
+            remaining_ = static_cast<ukv_length_t>(parse_u64_dec(*params.scan_limit, remaining_));
+        if (params.scan_batch_size)
+            batch_size_ = static_cast<ukv_length_t>(parse_u64_dec(*params.scan_batch_size, batch_size_));
+        batch_size_ = std::max<ukv_length_t>(batch_size_, 1);
+
+        export_values_ = params.opt_scan_values.has_value();
+        ar::FieldVector fields {ar::field(kArgKeys, ar::int64(), false)};
+        if (export_values_)
+            fields.push_back(ar::field(kArgVals, ar::binary()));
+        schema_ = ar::schema(std::move(fields));
+    }
+
+    std::shared_ptr<ar::Schema> schema() const override { return schema_; }
+
+    ar::Status ReadNext(std::shared_ptr<ar::RecordBatch>* batch_ptr) override {
+
+        *batch_ptr = nullptr;
+        if (is_end_ || !remaining_)
+            return ar::Status::OK();
+
+        status_t status;
+        ukv_length_t count_limit = std::min(batch_size_, remaining_);
+        ukv_length_t* found_counts = nullptr;
+        ukv_key_t* found_keys = nullptr;
+        ukv_length_t* found_offsets = nullptr;
+        ukv_bytes_ptr_t found_values = nullptr;
+
+        // Previous batches may still be in flight, so they keep their own arenas
+        std::unique_ptr<void, void (*)(ukv_arena_t)> batch_arena {nullptr, &ukv_arena_free};
+        ukv_arena_t batch_arena_c = nullptr;
+        ukv_scan_t scan {};
+        scan.db = db_;
+        scan.error = status.member_ptr();
+        scan.transaction = session_.txn;
+        scan.snapshot = snapshot_;
+        scan.arena = &batch_arena_c;
+        scan.options = options_;
+        scan.tasks_count = 1;
+        scan.collections = &collection_;
+        scan.start_keys = &next_key_;
+        scan.count_limits = &count_limit;
+        scan.counts = &found_counts;
+        scan.keys = &found_keys;
+        scan.values_offsets = export_values_ ? &found_offsets : nullptr;
+        scan.values = export_values_ ? &found_values : nullptr;
+
+        ukv_scan(&scan);
+        batch_arena.reset(batch_arena_c);
+        if (!status)
+            return ar::Status::ExecutionError(status.message());
+
+        ukv_length_t const count = found_counts[0];
+        remaining_ -= count;
+        is_end_ = count < count_limit || !count || found_keys[count - 1] == std::numeric_limits<ukv_key_t>::max();
+        if (!count)
+            return ar::Status::OK();
+        next_key_ = found_keys[count - 1] + !is_end_;
+
+        ArrowSchema schema_c;
+        ArrowArray batch_c;
+        ukv_to_arrow_schema(count, 1 + export_values_, &schema_c, &batch_c, status.member_ptr());
+        if (!status)
+            return ar::Status::ExecutionError(status.message());
+
+        ukv_to_arrow_column( //
+            count,
+            kArgKeys.c_str(),
+            ukv_doc_field<ukv_key_t>(),
+            nullptr,
+            nullptr,
+            found_keys,
+            schema_c.children[0],
+            batch_c.children[0],
+            status.member_ptr());
+        if (!status)
+            return ar::Status::ExecutionError(status.message());
+
+        if (export_values_) {
+            // Scanned entries are always present, so no validity bitmap is needed
+            ukv_to_arrow_column( //
+                count,
+                kArgVals.c_str(),
+                ukv_doc_field<value_view_t>(),
+                nullptr,
+                found_offsets,
+                found_values,
+                schema_c.children[1],
+                batch_c.children[1],
+                status.member_ptr());
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+            if (!found_values)
+                batch_c.children[1]->buffers[2] = &zero_size_data_k;
+        }
+
+        batch_c.private_data = batch_arena.release();
+        batch_c.release = &release_scanned_batch;
+        ARROW_ASSIGN_OR_RAISE(*batch_ptr, ar::ImportRecordBatch(&batch_c, &schema_c));
+        return ar::Status::OK();
+    }
+};
+
+/**
+ * @brief Builds the normalized form of a write for the change log: three columns of
+ * `collections`, `keys` and nullable `values`, where NULLs mark removals.
+ */
+ar::Result<std::shared_ptr<ar::RecordBatch>> change_batch( //
+    ukv_size_t tasks_count,
+    strided_iterator_gt<ukv_collection_t> collections,
+    strided_iterator_gt<ukv_key_t> keys,
+    contents_arg_t const& contents) {
+
+    ar::UInt64Builder collections_builder;
+    ar::Int64Builder keys_builder;
+    ar::BinaryBuilder values_builder;
+    ARROW_RETURN_NOT_OK(collections_builder.Reserve(tasks_count));
+    ARROW_RETURN_NOT_OK(keys_builder.Reserve(tasks_count));
+    ARROW_RETURN_NOT_OK(values_builder.Reserve(tasks_count));
+
+    for (ukv_size_t i = 0; i != tasks_count; ++i) {
+        collections_builder.UnsafeAppend(collections ? collections[i] : ukv_collection_main_k);
+        keys_builder.UnsafeAppend(keys[i]);
+        value_view_t value = contents[i];
+        if (value.begin())
+            ARROW_RETURN_NOT_OK(values_builder.Append(reinterpret_cast<std::uint8_t const*>(value.begin()),
+                                                      static_cast<std::int32_t>(value.size())));
+        else
+            values_builder.UnsafeAppendNull();
+    }
+
+    std::shared_ptr<ar::Array> collections_array, keys_array, values_array;
+    ARROW_RETURN_NOT_OK(collections_builder.Finish(&collections_array));
+    ARROW_RETURN_NOT_OK(keys_builder.Finish(&keys_array));
+    ARROW_RETURN_NOT_OK(values_builder.Finish(&values_array));
+    auto schema = ar::schema({
+        ar::field(kArgCols, ar::uint64(), false),
+        ar::field(kArgKeys, ar::int64(), false),
+        ar::field(kArgVals, ar::binary(), true),
+    });
+    return ar::RecordBatch::Make(schema, tasks_count, {collections_array, keys_array, values_array});
+}
+
+/**
+ * @brief Remembers the names of exported shared memory segments, to unlink the
+ * ones that were never adopted, as the client may have disconnected or crashed.
+ * Adopting clients unlink the names themselves, so unlinking again is harmless.
+ * Expired segments are swept in a background thread, even if the server goes idle.
+ */
+class exported_segments_t {
+    struct segment_t {
+        std::string name;
+        sys_time_t exported_at;
+    };
+    std::mutex mutex_;
+    std::deque<segment_t> segments_;
+
+    std::condition_variable sweeper_wakeup_;
+    bool sweeper_stop_ = false;
+    std::thread sweeper_;
+
+    /// Must be called under the `mutex_`.
+    void sweep() noexcept {
+        sys_time_t const now = sys_clock_t::now();
+        while (!segments_.empty() && now - segments_.front().exported_at > shared_memory_timeout_k) {
+            shm_unlink(segments_.front().name.c_str());
+            segments_.pop_front();
+        }
+    }
+
+    void sweep_in_background() noexcept {
+        std::unique_lock lock {mutex_};
+        while (!sweeper_wakeup_.wait_for(lock, shared_memory_sweep_interval_k, [&] { return sweeper_stop_; }))
+            sweep();
+    }
+
+  public:
+    exported_segments_t() : sweeper_(&exported_segments_t::sweep_in_background, this) {}
+
+    ~exported_segments_t() noexcept {
+        {
+            std::lock_guard _ {mutex_};
+            sweeper_stop_ = true;
+        }
+        sweeper_wakeup_.notify_all();
+        sweeper_.join();
+
+        for (auto const& segment : segments_)
+            shm_unlink(segment.name.c_str());
+    }
+
+    void track(std::string_view reply) noexcept(false) {
+        std::lock_guard _ {mutex_};
+        segments_.push_back({std::string(reply.substr(0, reply.rfind(':'))), sys_clock_t::now()});
+    }
+};
+
+/**
+ * @brief Bounded in-memory log of committed changes, that followers replay in order.
+ *
+ * Every entry gets the next sequence number. A committed transaction forms a single
+ * entry of potentially many batches, which followers apply atomically. To make the
+ * order of sequence numbers match the order in which changes became visible, the
+ * engine call and the append must happen under the `order()` lock.
+ *
+ * Only the most recent entries are retained. A follower that has fallen further
+ * behind can't catch up from the log and has to be re-seeded.
+ */
+class change_log_t {
+  public:
+    enum class kind_t { write_k, create_k, drop_k };
+
+    struct entry_t {
+        std::uint64_t seq = 0;
+        kind_t kind = kind_t::write_k;
+        std::vector<std::shared_ptr<ar::RecordBatch>> batches;
+        ukv_collection_t collection = ukv_collection_main_k;
+        /// Collection name for `kind_t::create_k`, or the drop mode for `kind_t::drop_k`.
+        std::string argument;
+        std::size_t bytes = 0;
+    };
+
+    using entry_ptr_t = std::shared_ptr<entry_t const>;
+
+  private:
+    struct stash_t {
+        std::vector<std::shared_ptr<ar::RecordBatch>> batches;
+        sys_time_t last_access {};
+    };
+
+    std::mutex order_mutex_;
+
+    std::mutex entries_mutex_;
+    std::condition_variable appended_;
+    std::deque<entry_ptr_t> entries_;
+    std::uint64_t head_ = 0;
+    std::size_t bytes_ = 0;
+    bool stopping_ = false;
+
+    /// Writes of transactions, that haven't been committed yet.
+    std::mutex stashes_mutex_;
+    std::unordered_map<session_id_t, stash_t, session_id_hash_t> stashes_;
+
+    void append(entry_t&& entry) {
+        for (auto const& batch : entry.batches)
+            entry.bytes += static_cast<std::size_t>(ar::util::TotalBufferSize(*batch));
+        {
+            std::unique_lock _ {entries_mutex_};
+            entry.seq = ++head_;
+            bytes_ += entry.bytes;
+            entries_.push_back(std::make_shared<entry_t const>(std::move(entry)));
+            while (entries_.size() > change_log_capacity_k || (bytes_ > change_log_bytes_k && entries_.size() > 1)) {
+                bytes_ -= entries_.front()->bytes;
+                entries_.pop_front();
+            }
+        }
+        appended_.notify_all();
+    }
+
+  public:
+    ~change_log_t() noexcept { stop(); }
+
+    /**
+     * @brief Must be held around the engine call and the matching `append_*()` or `commit()`.
+     */
+    std::unique_lock<std::mutex> order() noexcept { return std::unique_lock {order_mutex_}; }
+
+    void append_write(std::shared_ptr<ar::RecordBatch> batch) {
+        entry_t entry;
+        entry.batches.push_back(std::move(batch));
+        append(std::move(entry));
+    }
+
+    void append_create(ukv_collection_t collection, std::string_view name) {
+        entry_t entry;
+        entry.kind = kind_t::create_k;
+        entry.collection = collection;
+        entry.argument = name;
+        append(std::move(entry));
+    }
+
+    void append_drop(ukv_collection_t collection, std::string_view mode) {
+        entry_t entry;
+        entry.kind = kind_t::drop_k;
+        entry.collection = collection;
+        entry.argument = mode;
+        append(std::move(entry));
+    }
+
+    /**
+     * @brief Remembers a transactional write until the transaction is committed or discarded.
+     * Stashes of transactions abandoned by their clients are dropped after a timeout.
+     */
+    void stash(session_id_t session_id, std::shared_ptr<ar::RecordBatch> batch) {
+        sys_time_t const now = sys_clock_t::now();
+        std::unique_lock _ {stashes_mutex_};
+        for (auto it = stashes_.begin(); it != stashes_.end();)
+            it = now - it->second.last_access > change_log_stash_timeout_k ? stashes_.erase(it) : std::next(it);
+        stash_t& stash = stashes_[session_id];
+        stash.batches.push_back(std::move(batch));
+        stash.last_access = now;
+    }
+
+    void commit(session_id_t session_id) {
+        entry_t entry;
+        {
+            std::unique_lock _ {stashes_mutex_};
+            auto it = stashes_.find(session_id);
+            if (it == stashes_.end())
+                return;
+            entry.batches = std::move(it->second.batches);
+            stashes_.erase(it);
+        }
+        append(std::move(entry));
+    }
+
+    void discard(session_id_t session_id) noexcept {
+        std::unique_lock _ {stashes_mutex_};
+        stashes_.erase(session_id);
+    }
+
+    /**
+     * @brief Waits for the entry following `seq` to be appended.
+     * @return NULL if nothing was appended in time, or an error if the entry was already trimmed.
+     */
+    ar::Result<entry_ptr_t> next(std::uint64_t seq, std::chrono::milliseconds timeout, std::uint64_t& head) {
+        std::unique_lock lock {entries_mutex_};
+        appended_.wait_for(lock, timeout, [&] { return stopping_ || head_ > seq; });
+        head = head_;
+        if (stopping_)
+            return ar::Status::Cancelled("Server is shutting down");
+        if (head_ <= seq)
+            return entry_ptr_t {};
+        if (entries_.empty() || entries_.front()->seq > seq + 1)
+            return ar::Status::Invalid("Change log was trimmed past sequence number ", seq, ", re-seed the follower");
+        return entries_[seq + 1 - entries_.front()->seq];
+    }
+
+    void stop() noexcept {
+        {
+            std::unique_lock _ {entries_mutex_};
+            stopping_ = true;
+        }
+        appended_.notify_all();
+    }
+};
+
+/**
+ * @brief Endless stream of change log entries, starting after a given sequence number.
+ *
+ * Every batch carries the position of its entry in the `app_metadata`, formatted
+ * like URI parameters: "?seq=12&head=14&op=write&last". Multi-batch entries mark
+ * only the final batch with "last". Collection creations and drops are sent as empty
+ * batches with "op=create&id=...&name=..." and "op=drop&id=...&mode=..." respectively,
+ * where the name is always the final parameter. If nothing is written, an empty batch
+ * with just the "head" is sent every `replication_heartbeat_k`, so the followers can
+ * track their staleness.
+ */
+class replication_stream_t final : public arf::FlightDataStream {
+    change_log_t& log_;
+    std::uint64_t seq_ = 0;
+    ar::ipc::IpcWriteOptions options_;
+    std::shared_ptr<ar::Schema> schema_;
+    std::shared_ptr<ar::RecordBatch> empty_;
+
+    change_log_t::entry_ptr_t entry_;
+    std::size_t next_batch_ = 0;
+
+    ar::Result<arf::FlightPayload> payload(ar::RecordBatch const& batch, std::string metadata) {
+        arf::FlightPayload result;
+        result.app_metadata = ar::Buffer::FromString(std::move(metadata));
+        ARROW_RETURN_NOT_OK(ar::ipc::GetRecordBatchPayload(batch, options_, &result.ipc_message));
+        return result;
+    }
+
+  public:
+    replication_stream_t(change_log_t& log, std::uint64_t seq, ar::ipc::IpcWriteOptions options)
+        : log_(log), seq_(seq), options_(std::move(options)) {
+        ar::UInt64Builder collections;
+        ar::Int64Builder keys;
+        ar::BinaryBuilder values;
+        schema_ = ar::schema({
+            ar::field(kArgCols, ar::uint64(), false),
+            ar::field(kArgKeys, ar::int64(), false),
+            ar::field(kArgVals, ar::binary(), true),
+        });
+        empty_ = ar::RecordBatch::Make(schema_,
+                                       0,
+                                       {collections.Finish().ValueOrDie(),
+                                        keys.Finish().ValueOrDie(),
+                                        values.Finish().ValueOrDie()});
+    }
+
+    std::shared_ptr<ar::Schema> schema() override { return schema_; }
+
+    ar::Result<arf::FlightPayload> GetSchemaPayload() override {
+        arf::FlightPayload result;
+        ar::ipc::DictionaryFieldMapper mapper(*schema_);
+        ARROW_RETURN_NOT_OK(ar::ipc::GetSchemaPayload(*schema_, options_, mapper, &result.ipc_message));
+        return result;
+    }
+
+    ar::Result<arf::FlightPayload> Next() override {
+        std::uint64_t head = 0;
+        if (!entry_) {
+            auto maybe_entry = log_.next(seq_, replication_heartbeat_k, head);
+            if (maybe_entry.status().IsCancelled())
+                return arf::FlightPayload {};
+            ARROW_ASSIGN_OR_RAISE(entry_, std::move(maybe_entry));
+            if (!entry_)
+                return payload(*empty_, "?" + kParamReplicaHead + "=" + std::to_string(head));
+            next_batch_ = 0;
+        }
+
+        change_log_t::entry_t const& entry = *entry_;
+        std::string metadata = "?" + kParamReplicaSeq + "=" + std::to_string(entry.seq) + "&" + kParamReplicaHead +
+                               "=" + std::to_string(std::max(head, entry.seq)) + "&" + kParamReplicaOp + "=";
+        std::string collection = std::to_string(entry.collection);
+        switch (entry.kind) {
+        case change_log_t::kind_t::write_k: {
+            std::shared_ptr<ar::RecordBatch> batch = entry.batches[next_batch_++];
+            metadata += kParamReplicaOpWrite;
+            if (next_batch_ == entry.batches.size()) {
+                metadata += "&" + kParamReplicaLast;
+                seq_ = entry.seq;
+                entry_.reset();
+            }
+            return payload(*batch, std::move(metadata));
+        }
+        case change_log_t::kind_t::create_k:
+            metadata += kParamReplicaOpCreate + "&" + kParamCollectionID + "=" + collection + "&" +
+                        kParamReplicaName + "=" + entry.argument;
+            break;
+        case change_log_t::kind_t::drop_k:
+            metadata += kParamReplicaOpDrop + "&" + kParamCollectionID + "=" + collection + "&" + kParamDropMode +
+                        "=" + entry.argument;
+            break;
+        }
+        seq_ = entry.seq;
+        entry_.reset();
+        return payload(*empty_, std::move(metadata));
+    }
+};
+
+/**
+ * @brief Keeps the local database up to date with a primary server, replaying its
+ * change log in a background thread.
+ *
+ * Every entry is applied in its own transaction, so any snapshot or transaction
+ * on the follower observes a prefix of the primary's history, never a partial batch.
+ * Collections are matched by name, as their IDs differ between the servers.
+ * If the connection breaks, the follower reconnects and resumes after the last
+ * applied entry.
+ */
+class follower_t {
+    database_t& db_;
+    std::string primary_uri_;
+    std::unordered_map<ukv_collection_t, ukv_collection_t> collections_;
+    std::vector<std::shared_ptr<ar::RecordBatch>> pending_;
+    ukv_transaction_t txn_ = nullptr;
+    ukv_arena_t arena_ = nullptr;
+    bool transactional_ = true;
+
+    std::atomic<std::uint64_t> applied_seq_ {0};
+    std::atomic<sys_clock_t::rep> caught_up_at_ {0};
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::atomic<bool> stopping_ {false};
+    std::thread thread_;
+
+    ar::Status apply_writes() {
+        status_t status;
+        if (transactional_) {
+            ukv_transaction_init_t txn_init {};
+            txn_init.db = db_;
+            txn_init.error = status.member_ptr();
+            txn_init.options = ukv_option_transaction_dont_watch_k;
+            txn_init.transaction = &txn_;
+            ukv_transaction_init(&txn_init);
+            // Engines without ACID transactions apply every batch separately
+            transactional_ = status;
+            status = status_t {};
+        }
+
+        std::vector<ukv_collection_t> collections;
+        for (auto const& batch : pending_) {
+            auto const& primary_collections = static_cast<ar::UInt64Array const&>(*batch->column(0));
+            auto const& keys = static_cast<ar::Int64Array const&>(*batch->column(1));
+            auto const& values = static_cast<ar::BinaryArray const&>(*batch->column(2));
+
+            collections.resize(static_cast<std::size_t>(batch->num_rows()));
+            for (std::size_t i = 0; i != collections.size(); ++i) {
+                ukv_collection_t primary = primary_collections.Value(static_cast<std::int64_t>(i));
+                auto it = collections_.find(primary);
+                if (primary != ukv_collection_main_k && it == collections_.end())
+                    return ar::Status::Invalid("Unknown collection: ", primary);
+                collections[i] = primary == ukv_collection_main_k ? ukv_collection_main_k : it->second;
+            }
+
+            // Arrays decoded from IPC always start at zero offset, so the bitmap can be passed as is
+            ukv_bytes_cptr_t contents = values.value_data() && values.value_data()->data()
+                                            ? values.value_data()->data()
+                                            : reinterpret_cast<ukv_bytes_cptr_t>(&zero_size_data_k);
+            ukv_write_t write {};
+            write.db = db_;
+            write.error = status.member_ptr();
+            write.transaction = transactional_ ? txn_ : nullptr;
+            write.arena = &arena_;
+            write.tasks_count = static_cast<ukv_size_t>(batch->num_rows());
+            write.collections = collections.data();
+            write.collections_stride = sizeof(ukv_collection_t);
+            write.keys = keys.raw_values();
+            write.keys_stride = sizeof(ukv_key_t);
+            write.presences = values.null_count() ? values.null_bitmap_data() : nullptr;
+            write.offsets = reinterpret_cast<ukv_length_t const*>(values.raw_value_offsets());
+            write.offsets_stride = sizeof(ukv_length_t);
+            write.values = &contents;
+            ukv_write(&write);
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+        }
+
+        if (transactional_) {
+            ukv_transaction_commit_t txn_commit {};
+            txn_commit.db = db_;
+            txn_commit.error = status.member_ptr();
+            txn_commit.transaction = txn_;
+            ukv_transaction_commit(&txn_commit);
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+        }
+        pending_.clear();
+        return ar::Status::OK();
+    }
+
+    ar::Status apply_create(ukv_collection_t primary, std::string const& name) {
+        auto maybe_collection = db_.find_or_create(name.c_str());
+        if (!maybe_collection)
+            return ar::Status::ExecutionError(maybe_collection.release_status().message());
+        collections_.insert_or_assign(primary, ukv_collection_t(*maybe_collection));
+        return ar::Status::OK();
+    }
+
+    ar::Status apply_drop(ukv_collection_t primary, std::optional<std::string_view> mode) {
+        auto it = collections_.find(primary);
+        if (primary != ukv_collection_main_k && it == collections_.end())
+            return ar::Status::OK();
+
+        status_t status;
+        ukv_collection_drop_t collection_drop {};
+        collection_drop.db = db_;
+        collection_drop.error = status.member_ptr();
+        collection_drop.id = primary == ukv_collection_main_k ? ukv_collection_main_k : it->second;
+        collection_drop.mode = mode == kParamDropModeValues     ? ukv_drop_vals_k
+                               : mode == kParamDropModeContents ? ukv_drop_keys_vals_k
+                                                                : ukv_drop_keys_vals_handle_k;
+        ukv_collection_drop(&collection_drop);
+        if (!status)
+            return ar::Status::ExecutionError(status.message());
+        if (collection_drop.mode == ukv_drop_keys_vals_handle_k && it != collections_.end())
+            collections_.erase(it);
+        return ar::Status::OK();
+    }
+
+    ar::Status apply(arf::FlightStreamChunk const& chunk) {
+        if (!chunk.app_metadata)
+            return ar::Status::Invalid("Replication batch is missing its metadata");
+
+        std::string_view metadata {reinterpret_cast<char const*>(chunk.app_metadata->data()),
+                                   static_cast<std::size_t>(chunk.app_metadata->size())};
+        std::size_t name_offset = metadata.find("&" + kParamReplicaName + "=");
+        std::string_view params = metadata.substr(0, name_offset);
+        std::uint64_t head = parse_u64_dec(param_value(params, kParamReplicaHead).value_or(""));
+        auto op = param_value(params, kParamReplicaOp);
+        if (op) {
+            std::uint64_t seq = parse_u64_dec(param_value(params, kParamReplicaSeq).value_or(""));
+            ukv_collection_t collection = parse_u64_dec(param_value(params, kParamCollectionID).value_or(""));
+            if (*op == kParamReplicaOpWrite) {
+                pending_.push_back(chunk.data);
+                if (!param_value(params, kParamReplicaLast))
+                    return ar::Status::OK();
+                ARROW_RETURN_NOT_OK(apply_writes());
+            }
+            else if (*op == kParamReplicaOpCreate) {
+                if (name_offset == std::string_view::npos)
+                    return ar::Status::Invalid("Created collection is missing its name");
+                std::string name {metadata.substr(name_offset + kParamReplicaName.size() + 2)};
+                ARROW_RETURN_NOT_OK(apply_create(collection, name));
+            }
+            else if (*op == kParamReplicaOpDrop)
+                ARROW_RETURN_NOT_OK(apply_drop(collection, param_value(params, kParamDropMode)));
+            applied_seq_ = seq;
+        }
+
+        if (applied_seq_ >= head)
+            caught_up_at_ = sys_clock_t::now().time_since_epoch().count();
+        return ar::Status::OK();
+    }
+
+    ar::Status replay() {
+        ARROW_ASSIGN_OR_RAISE(arf::Location location, arf::Location::Parse(primary_uri_));
+        ARROW_ASSIGN_OR_RAISE(std::unique_ptr<arf::FlightClient> client, arf::FlightClient::Connect(location));
+
+        arf::Ticket ticket;
+        ticket.ticket = kFlightReplicate + "?" + kParamReplicateSince + "=" + std::to_string(applied_seq_.load());
+        ARROW_ASSIGN_OR_RAISE(std::unique_ptr<arf::FlightStreamReader> reader, client->DoGet(ticket));
+
+        // Batches of a partially received entry will be re-sent
+        pending_.clear();
+        while (!stopping_) {
+            ARROW_ASSIGN_OR_RAISE(arf::FlightStreamChunk chunk, reader->Next());
+            if (!chunk.data && !chunk.app_metadata)
+                return ar::Status::IOError("Primary has closed the replication stream");
+            ARROW_RETURN_NOT_OK(apply(chunk));
+        }
+        reader->Cancel();
+        return ar::Status::OK();
+    }
+
+    void follow() noexcept {
+        while (!stopping_) {
+            ar::Status ar_status = replay();
+            if (stopping_)
+                break;
+            std::cerr << "Replication from " << primary_uri_ << " interrupted: " << ar_status.ToString() << std::endl;
+            std::unique_lock lock {mutex_};
+            wakeup_.wait_for(lock, replication_retry_k, [&] { return stopping_.load(); });
+        }
+    }
+
+  public:
+    follower_t(database_t& db, std::string primary_uri) : db_(db), primary_uri_(std::move(primary_uri)) {
+        thread_ = std::thread(&follower_t::follow, this);
+    }
+
+    ~follower_t() noexcept {
+        {
+            std::unique_lock _ {mutex_};
+            stopping_ = true;
+        }
+        wakeup_.notify_all();
+        thread_.join();
+        ukv_transaction_free(txn_);
+        ukv_arena_free(arena_);
+    }
+
+    /**
+     * @brief Time since the follower has last seen itself fully caught up with the primary.
+     */
+    std::chrono::milliseconds staleness() const noexcept {
+        sys_time_t caught_up_at {sys_clock_t::duration(caught_up_at_.load())};
+        return std::chrono::duration_cast<std::chrono::milliseconds>(sys_clock_t::now() - caught_up_at);
+    }
+};
+
 /**
  * @brief Remote Procedure Call implementation on top of Apache Arrow Flight RPC.
  * Currently only implements only the binary interface, which is enough even for
@@ -506,6 +1450,22 @@ ukv_str_view_t get_null_terminated(std::shared_ptr<ar::Buffer> const& buf_ptr) n
  * - collection_remove?col=x (DoAction): Drops a collection
  * - txn_begin?txn=y (DoAction): Starts a transaction with a potentially custom ID
  * - txn_commit?txn=y (DoAction): Commits a transaction with a given ID
+ * - scan_stream?collection_id=x&start=k&limit=n&batch=m&values (DoGet):
+ *   Streams keys, and optionally values, in batches of `m` entries.
+ * - replicate?since=s (DoGet): Streams the change log after sequence number `s`.
+ * - metrics (DoAction): Returns the Prometheus text exposition of `ukv_metrics()`.
+ *   The first request enables the collection, unless "UKV_METRICS" already has.
+ *
+ * Every exporting endpoint also accepts `compression=lz4|zstd&compression_level=l&compression_threshold=b`
+ * to compress the buffers of responses bigger than `b` bytes. Inputs may be compressed
+ * and may contain dictionary-encoded columns.
+ *
+ * ## Replication
+ *
+ * A primary started with a change log ships every committed write to its followers
+ * through the `replicate` endpoint. Followers reject writes and serve reads from their
+ * local copy. Any read can pass `max_staleness=ms` to fail with "Unavailable" instead
+ * of answering from a follower, that hasn't been caught up with its primary recently.
  *
  * ## Concurrency
  *
@@ -515,15 +1475,54 @@ ukv_str_view_t get_null_terminated(std::shared_ptr<ar::Buffer> const& buf_ptr) n
 class UKVService : public arf::FlightServerBase {
     database_t db_;
     sessions_t sessions_;
+    exported_segments_t exported_segments_;
+    std::unique_ptr<change_log_t> log_;
+    /// Must be destroyed first, to stop applying changes to the database.
+    std::unique_ptr<follower_t> follower_;
+
+    ar::Status check_staleness(session_params_t const& params) const {
+        if (!follower_ || !params.max_staleness)
+            return ar::Status::OK();
+        std::chrono::milliseconds limit(static_cast<std::int64_t>(parse_u64_dec(*params.max_staleness)));
+        if (follower_->staleness() <= limit)
+            return ar::Status::OK();
+        return arf::MakeFlightError(arf::FlightStatusCode::Unavailable, "Follower is staler than requested");
+    }
+
+    ar::Status check_writable() const {
+        if (!follower_)
+            return ar::Status::OK();
+        return ar::Status::Invalid("Followers are read-only, write to the primary");
+    }
 
   public:
-    UKVService(database_t&& db, std::size_t capacity = 4096) : db_(std::move(db)), sessions_(db_, capacity) {}
+    UKVService(database_t&& db,
+               bool replicate = false,
+               std::string primary_uri = {},
+               std::size_t arena_limit = 0,
+               std::size_t capacity = 4096)
+        : db_(std::move(db)), sessions_(db_, capacity, arena_limit) {
+        if (replicate)
+            log_ = std::make_unique<change_log_t>();
+        if (!primary_uri.empty())
+            follower_ = std::make_unique<follower_t>(db_, std::move(primary_uri));
+    }
+
+    ~UKVService() noexcept {
+        if (log_)
+            log_->stop();
+    }
 
     ar::Status ListActions( //
         arf::ServerCallContext const&,
         std::vector<arf::ActionType>* actions) override {
-        *actions =
-            {kActionColOpen, kActionColDrop, kActionSnapOpen, kActionSnapDrop, kActionTxnBegin, kActionTxnCommit};
+        *actions = {kActionColOpen,
+                    kActionColDrop,
+                    kActionSnapOpen,
+                    kActionSnapDrop,
+                    kActionTxnBegin,
+                    kActionTxnCommit,
+                    kActionMetrics};
         return ar::Status::OK();
     }
 
@@ -564,6 +1563,7 @@ class UKVService : public arf::FlightServerBase {
         if (is_query(action.type, kActionColOpen.type)) {
             if (!params.collection_name)
                 return ar::Status::Invalid("Missing collection name argument");
+            ARROW_RETURN_NOT_OK(check_writable());
 
             // The name must be null-terminated.
             // This is not safe:
@@ -580,9 +1580,12 @@ class UKVService : public arf::FlightServerBase {
             collection_init.config = collection_config;
             collection_init.id = &collection_id;
 
+            auto order = log_ ? log_->order() : std::unique_lock<std::mutex> {};
             ukv_collection_create(&collection_init);
             if (!status)
                 return ar::Status::ExecutionError(status.message());
+            if (log_)
+                log_->append_create(collection_id, *params.collection_name);
 
             *results_ptr = return_scalar<ukv_collection_t>(collection_id);
             return ar::Status::OK();
@@ -592,6 +1595,7 @@ class UKVService : public arf::FlightServerBase {
         if (is_query(action.type, kActionColDrop.type)) {
             if (!params.collection_id)
                 return ar::Status::Invalid("Missing collection ID argument");
+            ARROW_RETURN_NOT_OK(check_writable());
 
             ukv_drop_mode_t mode =                                  //
                 params.collection_drop_mode == kParamDropModeValues //
@@ -610,9 +1614,12 @@ class UKVService : public arf::FlightServerBase {
             collection_drop.id = c_collection_id;
             collection_drop.mode = mode;
 
+            auto order = log_ ? log_->order() : std::unique_lock<std::mutex> {};
             ukv_collection_drop(&collection_drop);
             if (!status)
                 return ar::Status::ExecutionError(status.message());
+            if (log_)
+                log_->append_drop(c_collection_id, params.collection_drop_mode.value_or(kParamDropModeCollection));
             *results_ptr = return_empty();
             return ar::Status::OK();
         }
@@ -675,14 +1682,18 @@ class UKVService : public arf::FlightServerBase {
             txn_init.error = status.member_ptr();
             txn_init.options = ukv_options(params);
             txn_init.transaction = &session.txn;
+            if (params.lock_timeout)
+                txn_init.lock_timeout = static_cast<ukv_size_t>(parse_u64_dec(*params.lock_timeout));
 
             ukv_transaction_init(&txn_init);
             if (!status) {
-                sessions_.release_txn(params.session_id);
+                sessions_.cancel_txn(params.session_id, session);
                 return ar::Status::ExecutionError(status.message());
             }
 
             // Don't forget to add the transaction to active sessions
+            if (log_)
+                log_->discard(params.session_id);
             sessions_.hold_txn(params.session_id, session);
             *results_ptr = return_scalar<txn_id_t>(params.session_id.txn_id);
             return ar::Status::OK();
@@ -704,17 +1715,46 @@ class UKVService : public arf::FlightServerBase {
             txn_commit.transaction = session.txn;
             txn_commit.options = ukv_options(params);
 
+            auto order = log_ ? log_->order() : std::unique_lock<std::mutex> {};
             ukv_transaction_commit(&txn_commit);
             if (!status) {
+                if (log_)
+                    log_->discard(params.session_id);
                 sessions_.release_txn(params.session_id);
                 return ar::Status::ExecutionError(status.message());
             }
+            if (log_)
+                log_->commit(params.session_id);
 
             sessions_.release_txn(params.session_id);
             *results_ptr = return_empty();
             return ar::Status::OK();
         }
 
+        // Exporting metrics, which can't be done through Flight tables
+        if (is_query(action.type, kActionMetrics.type)) {
+            ukv_arena_t arena = nullptr;
+            ukv_str_view_t text = nullptr;
+            ukv_metrics_t metrics {
+                .db = db_,
+                .error = status.member_ptr(),
+                .arena = &arena,
+                .collect = true,
+                .prometheus = &text,
+            };
+
+            ukv_metrics(&metrics);
+            std::string text_copy = status ? text : "";
+            ukv_arena_free(arena);
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+
+            auto result = std::make_unique<arf::Result>();
+            result->body = ar::Buffer::FromString(std::move(text_copy));
+            *results_ptr = std::make_unique<SingleResultStream>(std::move(result));
+            return ar::Status::OK();
+        }
+
         return ar::Status::NotImplemented("Unknown action type: ", action.type);
     }
 
@@ -729,6 +1769,7 @@ class UKVService : public arf::FlightServerBase {
         arf::FlightDescriptor const& desc = request.descriptor();
         session_params_t params = session_params(server_call, desc.cmd);
         status_t status;
+        ARROW_RETURN_NOT_OK(check_staleness(params));
 
         ArrowSchema input_schema_c, output_schema_c;
         ArrowArray input_batch_c, output_batch_c;
@@ -1044,10 +2085,12 @@ class UKVService : public arf::FlightServerBase {
 
             // As we are immediately exporting in the Arrow format,
             // we don't need the lengths, just the NULL indicators
+            bool const export_values = params.opt_scan_values.has_value();
             ukv_length_t* found_offsets = nullptr;
-            ukv_length_t* found_lengths = nullptr;
             ukv_length_t* found_counts = nullptr;
             ukv_key_t* found_keys = nullptr;
+            ukv_length_t* found_values_offsets = nullptr;
+            ukv_bytes_ptr_t found_values = nullptr;
             ukv_size_t tasks_count = static_cast<ukv_size_t>(input_batch_c.length);
             ukv_scan_t scan {};
             scan.db = db_;
@@ -1065,12 +2108,14 @@ class UKVService : public arf::FlightServerBase {
             scan.offsets = &found_offsets;
             scan.keys = &found_keys;
             scan.counts = &found_counts;
+            scan.values_offsets = export_values ? &found_values_offsets : nullptr;
+            scan.values = export_values ? &found_values : nullptr;
 
             ukv_scan(&scan);
             if (!status)
                 return ar::Status::ExecutionError(status.message());
 
-            ukv_to_arrow_schema(tasks_count, 1, &output_schema_c, &output_batch_c, status.member_ptr());
+            ukv_to_arrow_schema(tasks_count, 1 + export_values, &output_schema_c, &output_batch_c, status.member_ptr());
             if (!status)
                 return ar::Status::ExecutionError(status.message());
 
@@ -1086,6 +2131,24 @@ class UKVService : public arf::FlightServerBase {
                 status.member_ptr());
             if (!status)
                 return ar::Status::ExecutionError(status.message());
+
+            // Values share the list offsets with keys, but the binary
+            // entries inside the list need their own offsets
+            if (export_values) {
+                ukv_to_arrow_list( //
+                    tasks_count,
+                    kArgVals.c_str(),
+                    ukv_doc_field<value_view_t>(),
+                    nullptr,
+                    found_offsets,
+                    found_values ? found_values : reinterpret_cast<ukv_bytes_ptr_t>(&zero_size_data_k),
+                    output_schema_c.children[1],
+                    output_batch_c.children[1],
+                    status.member_ptr());
+                if (!status)
+                    return ar::Status::ExecutionError(status.message());
+                output_batch_c.children[1]->children[0]->buffers[1] = found_values_offsets;
+            }
         }
         else if (is_query(desc.cmd, kFlightSample)) {
 
@@ -1152,7 +2215,30 @@ class UKVService : public arf::FlightServerBase {
         if (!ar_status.ok())
             return ar_status;
 
-        ar_status = response.Begin(table->schema());
+        // Co-located clients may ask to receive the results in shared memory.
+        // In that case only the name of our segment and the length of the IPC stream go over the network.
+        // Small results are streamed anyway, as mapping a new segment costs more syscalls, than it saves.
+        bool const shared_memory_requested = params.opt_shared_memory && is_local_peer(server_call.peer());
+        bool const shared_memory_worth =
+            static_cast<std::size_t>(ar::util::TotalBufferSize(*table)) >= shared_memory_min_bytes_k;
+        if (shared_memory_requested && shared_memory_worth) {
+            auto maybe_exported = export_shared_memory(*table);
+            if (maybe_exported.ok()) {
+                exported_segments_.track(*maybe_exported);
+                ar_status = response.WriteMetadata(ar::Buffer::FromString(std::move(*maybe_exported)));
+                if (!ar_status.ok())
+                    return ar_status;
+                return response.Close();
+            }
+        }
+
+        // Remote clients may prefer to trade some CPU time for bandwidth
+        ar::ipc::IpcWriteOptions write_options = ar::ipc::IpcWriteOptions::Defaults();
+        ar_status = compress_if_worth(write_options, params.compression, *table);
+        if (!ar_status.ok())
+            return ar_status;
+
+        ar_status = response.Begin(table->schema(), write_options);
         if (!ar_status.ok())
             return ar_status;
 
@@ -1175,6 +2261,8 @@ class UKVService : public arf::FlightServerBase {
         session_params_t params = session_params(server_call, desc.cmd);
         status_t status;
 
+        ARROW_RETURN_NOT_OK(check_writable());
+
         ArrowSchema input_schema_c;
         ArrowArray input_batch_c;
         if (ar_status = unpack_table(request.ToTable(), input_schema_c, input_batch_c); !ar_status.ok())
@@ -1223,12 +2311,26 @@ class UKVService : public arf::FlightServerBase {
             write.values = input_vals.contents_begin.get();
             write.values_stride = input_vals.contents_begin.stride();
 
+            // Followers receive a normalized copy, as the inputs are only borrowed
+            std::shared_ptr<ar::RecordBatch> change;
+            if (log_) {
+                ARROW_ASSIGN_OR_RAISE(change, change_batch(tasks_count, input_collections, input_keys, input_vals));
+            }
+
+            auto order = log_ && !session.is_txn() ? log_->order() : std::unique_lock<std::mutex> {};
             ukv_write(&write);
 
             if (!status)
                 return ar::Status::ExecutionError(status.message());
+            if (log_ && session.is_txn())
+                log_->stash(params.session_id, std::move(change));
+            else if (log_)
+                log_->append_write(std::move(change));
         }
         else if (is_query(desc.cmd, kFlightWritePath)) {
+            if (log_)
+                return ar::Status::NotImplemented("Path writes can't be replicated yet");
+
             /// @param `keys`
             auto input_paths = get_contents(input_schema_c, input_batch_c, kArgPaths.c_str());
             if (!input_paths.contents_begin)
@@ -1292,6 +2394,24 @@ class UKVService : public arf::FlightServerBase {
         session_params_t params = session_params(server_call, ticket.ticket);
         status_t status;
 
+        if (is_query(ticket.ticket, kFlightReplicate)) {
+            if (!log_)
+                return ar::Status::NotImplemented("This server doesn't keep a change log");
+
+            ar::ipc::IpcWriteOptions write_options = ar::ipc::IpcWriteOptions::Defaults();
+            if (params.compression) {
+                auto maybe_codec = ar::util::Codec::Create(params.compression.codec, params.compression.level);
+                if (!maybe_codec.ok())
+                    return maybe_codec.status();
+                write_options.codec = maybe_codec.MoveValueUnsafe();
+            }
+
+            std::uint64_t since = params.replicate_since ? parse_u64_dec(*params.replicate_since) : 0;
+            *response_ptr = std::make_unique<replication_stream_t>(*log_, since, write_options);
+            return ar::Status::OK();
+        }
+
+        ARROW_RETURN_NOT_OK(check_staleness(params));
         if (is_query(ticket.ticket, kFlightListCols)) {
 
             // We will need some temporary memory for exports
@@ -1420,21 +2540,108 @@ class UKVService : public arf::FlightServerBase {
             *response_ptr = std::move(stream);
             return ar::Status::OK();
         }
+        else if (is_query(ticket.ticket, kFlightSplit)) {
+            auto session = sessions_.lock(params.session_id, status.member_ptr());
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+
+            ukv_key_t* boundaries = nullptr;
+            ukv_collection_split_t split {};
+            split.db = db_;
+            split.error = status.member_ptr();
+            split.arena = &session.arena;
+            split.options = ukv_options(params);
+            split.start_key = std::numeric_limits<ukv_key_t>::min();
+            split.end_key = std::numeric_limits<ukv_key_t>::max();
+            split.count = 1;
+            split.boundaries = &boundaries;
+            if (params.collection_id)
+                split.collection = parse_u64_hex(*params.collection_id, ukv_collection_main_k);
+            if (params.snapshot_id)
+                split.snapshot = parse_snap_id(*params.snapshot_id);
+            if (params.scan_start)
+                split.start_key = parse_key(*params.scan_start, split.start_key);
+            if (params.scan_end)
+                split.end_key = parse_key(*params.scan_end, split.end_key);
+            if (params.split_count)
+                split.count = parse_u64_dec(*params.split_count, split.count);
+
+            ukv_collection_split(&split);
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+
+            ArrowSchema schema_c;
+            ArrowArray array_c;
+            ukv_to_arrow_schema(split.count + 1, 1, &schema_c, &array_c, status.member_ptr());
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+
+            ukv_to_arrow_column( //
+                split.count + 1,
+                kArgKeys.c_str(),
+                ukv_doc_field<ukv_key_t>(),
+                nullptr,
+                nullptr,
+                ukv_bytes_ptr_t(boundaries),
+                schema_c.children[0],
+                array_c.children[0],
+                status.member_ptr());
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+
+            auto maybe_batch = ar::ImportRecordBatch(&array_c, &schema_c);
+            if (!maybe_batch.ok())
+                return maybe_batch.status();
+
+            auto maybe_reader = ar::RecordBatchReader::Make({maybe_batch.ValueUnsafe()});
+            if (!maybe_reader.ok())
+                return maybe_reader.status();
+
+            *response_ptr = std::make_unique<arf::RecordBatchStream>(maybe_reader.ValueUnsafe());
+            return ar::Status::OK();
+        }
+        else if (is_query(ticket.ticket, kFlightScanStream)) {
+            // The session stays locked while the stream is alive
+            auto options = ukv_options(params);
+            auto reader = std::make_shared<scan_stream_t>(db_, sessions_, params, options, status.member_ptr());
+            if (!status)
+                return ar::Status::ExecutionError(status.message());
+
+            // Batches are big enough to ignore the compression threshold
+            ar::ipc::IpcWriteOptions write_options = ar::ipc::IpcWriteOptions::Defaults();
+            if (params.compression) {
+                auto maybe_codec = ar::util::Codec::Create(params.compression.codec, params.compression.level);
+                if (!maybe_codec.ok())
+                    return maybe_codec.status();
+                write_options.codec = maybe_codec.MoveValueUnsafe();
+            }
+
+            auto stream = std::make_unique<arf::RecordBatchStream>(reader, write_options);
+            *response_ptr = std::move(stream);
+            return ar::Status::OK();
+        }
         return ar::Status::OK();
     }
 };
 
-ar::Status run_server(ukv_str_view_t config, int port, bool quiet) {
+ar::Status run_server(ukv_str_view_t config,
+                      int port,
+                      bool quiet,
+                      bool replicate,
+                      std::string const& primary_uri,
+                      std::size_t arena_limit) {
 
     database_t db;
     db.open(config).throw_unhandled();
 
     arf::Location server_location = arf::Location::ForGrpcTcp("0.0.0.0", port).ValueUnsafe();
     arf::FlightServerOptions options(server_location);
-    auto server = std::make_unique<UKVService>(std::move(db));
+    auto server = std::make_unique<UKVService>(std::move(db), replicate, primary_uri, arena_limit);
     ARROW_RETURN_NOT_OK(server->Init(options));
     if (!quiet)
         std::printf("Listening on port: %i\n", server->port());
+    if (!quiet && !primary_uri.empty())
+        std::printf("Following: %s\n", primary_uri.c_str());
     return server->Serve();
 }
 
@@ -1446,7 +2653,10 @@ int main(int argc, char* argv[]) {
 
     int port = 38709;
     std::string config;
+    std::string primary_uri;
     bool quiet = false;
+    bool replicate = false;
+    std::size_t arena_limit = 0;
 
 #if defined(UKV_ENGINE_IS_LEVELDB)
     config = "/var/lib/ukv/leveldb/";
@@ -1457,14 +2667,19 @@ int main(int argc, char* argv[]) {
 #endif
 
     auto cli = ( //
-        option("-d", "--dir").set(config).doc("Path to primary directory, potentially containing a configuration file"),
-        option("-p", "--port").set(port).doc("Port to use for connection"),
-        option("-q", "--quiet").set(quiet).doc("Silence outputs"));
-
-    if (!parse(argc, argv, cli)) {
+        option("-d", "--dir") &
+            value("path", config).doc("Path to primary directory, potentially containing a configuration file"),
+        option("-p", "--port") & value("port", port).doc("Port to use for connection"),
+        option("-q", "--quiet").set(quiet).doc("Silence outputs"),
+        option("-r", "--replicate").set(replicate).doc("Keep a change log for followers to replicate"),
+        option("-f", "--follow") & value("uri", primary_uri).doc("Replicate a primary, like grpc://0.0.0.0:38709"),
+        option("-m", "--memory") & value("bytes", arena_limit).doc("Limit of memory per session, unlimited by default"));
+
+    if (!parse(argc, argv, cli) || (replicate && !primary_uri.empty())) {
         std::cerr << make_man_page(cli, argv[0]);
         exit(1);
     }
 
-    return run_server(config.c_str(), port, quiet).ok() ? EXIT_SUCCESS : EXIT_FAILURE;
+    return run_server(config.c_str(), port, quiet, replicate, primary_uri, arena_limit).ok() ? EXIT_SUCCESS
+                                                                                             : EXIT_FAILURE;
 }
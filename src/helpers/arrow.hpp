@@ -7,6 +7,9 @@
 #pragma once
 #include <string>
 #include <string_view>
+#include <optional>  // `std::optional`
+#include <algorithm> // `std::search`
+#include <charconv>  // `std::from_chars`
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
@@ -18,6 +21,12 @@
 #include <arrow/table.h>
 #include <arrow/memory_pool.h>
 #include <arrow/c/bridge.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/util/compression.h>
+#include <arrow/util/byte_size.h>
+#include <arrow/compute/api.h>
 #pragma GCC diagnostic pop
 
 #include "linked_memory.hpp"       // `linked_memory_lock_t`
@@ -43,13 +52,18 @@ inline static std::string const kFlightSnapDrop = "remove_snapshot";   /// `DoAc
 inline static std::string const kFlightTxnBegin = "begin_transaction";   /// `DoAction`
 inline static std::string const kFlightTxnCommit = "commit_transaction"; /// `DoAction`
 
+inline static std::string const kFlightMetrics = "metrics"; /// `DoAction`
+
 inline static std::string const kFlightWrite = "write";          /// `DoPut`
 inline static std::string const kFlightRead = "read";            /// `DoExchange`
 inline static std::string const kFlightWritePath = "write_path"; /// `DoPut`
 inline static std::string const kFlightMatchPath = "match_path"; /// `DoExchange`
 inline static std::string const kFlightReadPath = "read_path";   /// `DoExchange`
 inline static std::string const kFlightScan = "scan";            /// `DoExchange`
+inline static std::string const kFlightScanStream = "scan_stream"; /// `DoGet`
 inline static std::string const kFlightMeasure = "measure";      /// `DoExchange`
+inline static std::string const kFlightSplit = "split";          /// `DoGet`
+inline static std::string const kFlightReplicate = "replicate";  /// `DoGet`
 
 inline static std::string const kArgSnaps = "snapshots";
 inline static std::string const kArgCols = "collections";
@@ -71,10 +85,43 @@ inline static std::string const kParamSnapshotID = "snapshot_id";
 inline static std::string const kParamTransactionID = "transaction_id";
 inline static std::string const kParamReadPart = "part";
 inline static std::string const kParamDropMode = "mode";
+inline static std::string const kParamScanStart = "start";
+inline static std::string const kParamScanLimit = "limit";
+inline static std::string const kParamScanEnd = "end";
+inline static std::string const kParamSplitCount = "count";
+inline static std::string const kParamScanBatchSize = "batch";
 inline static std::string const kParamFlagFlushWrite = "flush";
 inline static std::string const kParamFlagDontWatch = "dont_watch";
+inline static std::string const kParamFlagPessimistic = "pessimistic";
+inline static std::string const kParamFlagReadOnly = "read_only";
+inline static std::string const kParamLockTimeout = "lock_timeout";
 inline static std::string const kParamFlagDontDiscard = "";
 inline static std::string const kParamFlagSharedMemRead = "shared";
+inline static std::string const kParamFlagScanValues = "values";
+inline static std::string const kParamFlagScanBulk = "bulk";
+
+inline static std::string const kParamCompression = "compression";
+inline static std::string const kParamCompressionLevel = "compression_level";
+inline static std::string const kParamCompressionThreshold = "compression_threshold";
+inline static std::string const kParamFlagDictionaries = "dictionaries";
+inline static std::string const kParamCoalesceWindow = "coalesce";
+inline static std::string const kParamMaxStaleness = "max_staleness";
+inline static std::string const kParamCache = "cache";
+inline static std::string const kParamCacheTTL = "cache_ttl";
+inline static std::string const kParamCacheQuotas = "cache_quotas";
+inline static std::string const kParamReplicateSince = "since";
+
+inline static std::string const kParamReplicaSeq = "seq";
+inline static std::string const kParamReplicaHead = "head";
+inline static std::string const kParamReplicaOp = "op";
+inline static std::string const kParamReplicaLast = "last";
+inline static std::string const kParamReplicaName = "name";
+inline static std::string const kParamReplicaOpWrite = "write";
+inline static std::string const kParamReplicaOpCreate = "create";
+inline static std::string const kParamReplicaOpDrop = "drop";
+
+inline static std::string const kParamCompressionLZ4 = "lz4";
+inline static std::string const kParamCompressionZSTD = "zstd";
 
 inline static std::string const kParamReadPartLengths = "lengths";
 inline static std::string const kParamReadPartPresences = "presences";
@@ -83,6 +130,46 @@ inline static std::string const kParamDropModeValues = "values";
 inline static std::string const kParamDropModeContents = "contents";
 inline static std::string const kParamDropModeCollection = "collection";
 
+/**
+ * @brief Searches for a "value" among key-value pairs passed in URI after path.
+ * @param query_params  Must begin with "?" or "/".
+ * @param param_name    The name of the URI parameter to match.
+ */
+inline std::optional<std::string_view> param_value(std::string_view query_params, std::string_view param_name) {
+
+    char const* key_begin = query_params.begin();
+    do {
+        key_begin = std::search(key_begin, query_params.end(), param_name.begin(), param_name.end());
+        if (key_begin == query_params.end())
+            return std::nullopt;
+        bool is_suffix = key_begin + param_name.size() == query_params.end();
+        if (is_suffix)
+            return std::string_view {};
+
+        // Check if we have matched a part of bigger key.
+        // In that case skip to next starting point.
+        auto prev_character = *(key_begin - 1);
+        if (prev_character != '?' && prev_character != '&' && prev_character != '/') {
+            key_begin += 1;
+            continue;
+        }
+
+        auto next_character = key_begin[param_name.size()];
+        if (next_character == '&')
+            return std::string_view {};
+
+        if (next_character == '=') {
+            auto value_begin = key_begin + param_name.size() + 1;
+            auto value_end = std::find(value_begin, query_params.end(), '&');
+            return std::string_view {value_begin, static_cast<size_t>(value_end - value_begin)};
+        }
+
+        key_begin += 1;
+    } while (true);
+
+    return std::nullopt;
+}
+
 class arrow_mem_pool_t final : public ar::MemoryPool {
     linked_memory_t resource_;
     int64_t bytes_allocated_ = 0;
@@ -151,7 +238,12 @@ ar::Status unpack_table( //
     if (!maybe_table.ok())
         return maybe_table.status();
 
-    std::shared_ptr<ar::Table> const& table = maybe_table.ValueUnsafe();
+    // Inputs may have been dictionary-encoded by clients
+    auto maybe_decoded = decode_dictionaries(maybe_table.ValueUnsafe());
+    if (!maybe_decoded.ok())
+        return maybe_decoded.status();
+
+    std::shared_ptr<ar::Table> const& table = maybe_decoded.ValueUnsafe();
     ar::Status ar_status = ar::ExportSchema(*table->schema(), &schema_c);
     if (!ar_status.ok())
         return ar_status;
@@ -166,6 +258,146 @@ ar::Status unpack_table( //
     return ar_status;
 }
 
+/// Upper bound for the IPC stream framing around a single batch: schema message and end-of-stream marker.
+static constexpr std::int64_t shared_memory_schema_overhead_k = 4096;
+
+/**
+ * @brief Serializes a batch as an Arrow IPC stream into a new shared memory segment, which
+ * a co-located client adopts with `linked_memory_t::adopt_shared`, instead of receiving
+ * a copy through the loopback socket. Segments are always created by the server itself,
+ * so clients can't make it write into memory, that it doesn't own.
+ * @return Name of the segment and the length of the stream in it, formatted as "name:length".
+ */
+inline ar::Result<std::string> export_shared_memory(ar::RecordBatch const& batch) {
+
+    std::int64_t batch_size = 0;
+    ARROW_RETURN_NOT_OK(ar::ipc::GetRecordBatchSize(batch, &batch_size));
+    std::size_t capacity = linked_memory_t::shared_payload_offset_k + batch_size + shared_memory_schema_overhead_k;
+    shared_segment_t segment(capacity);
+    if (!segment)
+        return ar::Status::IOError("Can't create a shared memory segment");
+
+    auto region = std::make_shared<ar::MutableBuffer>(reinterpret_cast<uint8_t*>(segment.payload()),
+                                                      static_cast<int64_t>(segment.payload_capacity()));
+    ar::io::FixedSizeBufferWriter stream(region);
+    ARROW_ASSIGN_OR_RAISE(auto writer, ar::ipc::MakeStreamWriter(&stream, batch.schema()));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    ARROW_ASSIGN_OR_RAISE(int64_t written, stream.Tell());
+
+    segment.release();
+    return std::string(segment.name()) + ':' + std::to_string(written);
+}
+
+/**
+ * @brief Wraps an Arrow IPC stream, that the server has put into a shared segment, adopted by our arena,
+ * without copying any of the buffers.
+ */
+inline ar::Result<std::shared_ptr<ar::Table>> import_shared_memory( //
+    void const* begin,
+    std::size_t length,
+    ar::ipc::IpcReadOptions const& options) {
+
+    auto region = std::make_shared<ar::Buffer>(reinterpret_cast<uint8_t const*>(begin), static_cast<int64_t>(length));
+    auto stream = std::make_shared<ar::io::BufferReader>(region);
+    ARROW_ASSIGN_OR_RAISE(auto reader, ar::ipc::RecordBatchStreamReader::Open(stream, options));
+    return reader->ToTable();
+}
+
+/**
+ * @brief Buffer compression settings for IPC payloads, negotiated by the client per request.
+ * Batches smaller than `threshold_bytes` are sent as is, as compressing them
+ * would cost more CPU time than it would save on the wire.
+ */
+struct arrow_compression_t {
+    ar::Compression::type codec = ar::Compression::UNCOMPRESSED;
+    int level = ar::util::kUseDefaultCompressionLevel;
+    std::size_t threshold_bytes = 0;
+
+    explicit operator bool() const noexcept { return codec != ar::Compression::UNCOMPRESSED; }
+};
+
+/**
+ * @brief Parses compression settings from URI query parameters.
+ * @param query_params  Must begin with "?" or "/".
+ */
+inline arrow_compression_t parse_compression(std::string_view query_params) noexcept {
+    arrow_compression_t result;
+    auto codec = param_value(query_params, kParamCompression);
+    if (!codec)
+        return result;
+
+    // Flight only supports those two codecs for IPC buffers
+    if (*codec == kParamCompressionLZ4)
+        result.codec = ar::Compression::LZ4_FRAME;
+    else if (*codec == kParamCompressionZSTD)
+        result.codec = ar::Compression::ZSTD;
+
+    if (auto level = param_value(query_params, kParamCompressionLevel); level)
+        std::from_chars(level->data(), level->data() + level->size(), result.level);
+    if (auto threshold = param_value(query_params, kParamCompressionThreshold); threshold)
+        std::from_chars(threshold->data(), threshold->data() + threshold->size(), result.threshold_bytes);
+    return result;
+}
+
+/**
+ * @brief Configures the IPC @p options to compress the @p batch, if it's big enough.
+ */
+inline ar::Status compress_if_worth( //
+    ar::ipc::IpcWriteOptions& options,
+    arrow_compression_t const& compression,
+    ar::RecordBatch const& batch) {
+
+    options.codec.reset();
+    if (!compression)
+        return ar::Status::OK();
+    if (static_cast<std::size_t>(ar::util::TotalBufferSize(batch)) < compression.threshold_bytes)
+        return ar::Status::OK();
+
+    ARROW_ASSIGN_OR_RAISE(options.codec, ar::util::Codec::Create(compression.codec, compression.level));
+    return ar::Status::OK();
+}
+
+/**
+ * @brief Dictionary-encodes the columns with given names, which is profitable
+ * for low-cardinality inputs, like collection IDs or repeated keys.
+ */
+inline ar::Result<std::shared_ptr<ar::RecordBatch>> encode_dictionaries( //
+    std::shared_ptr<ar::RecordBatch> const& batch,
+    std::initializer_list<std::string_view> names) {
+
+    ar::ArrayVector columns = batch->columns();
+    ar::FieldVector fields = batch->schema()->fields();
+    for (std::size_t i = 0; i != columns.size(); ++i) {
+        if (std::find(names.begin(), names.end(), fields[i]->name()) == names.end())
+            continue;
+        if (columns[i]->type_id() == ar::Type::DICTIONARY)
+            continue;
+
+        ARROW_ASSIGN_OR_RAISE(ar::Datum encoded, ar::compute::DictionaryEncode(columns[i]));
+        columns[i] = encoded.make_array();
+        fields[i] = fields[i]->WithType(columns[i]->type());
+    }
+    return ar::RecordBatch::Make(ar::schema(std::move(fields)), batch->num_rows(), std::move(columns));
+}
+
+/**
+ * @brief Replaces the dictionary-encoded columns with plain ones,
+ * as the rest of the pipeline expects dense inputs.
+ */
+inline ar::Result<std::shared_ptr<ar::Table>> decode_dictionaries(std::shared_ptr<ar::Table> table) {
+    for (int i = 0; i != table->num_columns(); ++i) {
+        std::shared_ptr<ar::Field> const& field = table->schema()->field(i);
+        if (field->type()->id() != ar::Type::DICTIONARY)
+            continue;
+
+        auto const& value_type = static_cast<ar::DictionaryType const&>(*field->type()).value_type();
+        ARROW_ASSIGN_OR_RAISE(ar::Datum decoded, ar::compute::Cast(table->column(i), value_type));
+        ARROW_ASSIGN_OR_RAISE(table, table->SetColumn(i, field->WithType(value_type), decoded.chunked_array()));
+    }
+    return table;
+}
+
 inline expected_gt<std::size_t> column_idx(ArrowSchema const& schema_c, std::string_view name) {
     auto begin = schema_c.children;
     auto end = begin + schema_c.n_children;
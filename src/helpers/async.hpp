@@ -0,0 +1,119 @@
+/**
+ * @file async.hpp
+ * @author Ashot Vardanian
+ *
+ * @brief Blocking fallback for the asynchronous Binary Interface.
+ */
+#pragma once
+#include <algorithm>          // `std::max`
+#include <condition_variable> // `std::condition_variable`
+#include <deque>              // `std::deque`
+#include <functional>         // `std::function`
+#include <mutex>              // `std::mutex`
+#include <thread>             // `std::thread`
+#include <vector>             // `std::vector`
+
+#include "ukv/db.h"
+#include "helpers/linked_memory.hpp" // `safe_section`
+
+namespace unum::ukv {
+
+/**
+ * @brief Runs blocking calls on a small shared pool of threads, for engines
+ * without native asynchronous interfaces. Threads are only started with the
+ * first submission, so purely synchronous applications never pay for them.
+ * On destruction, the queued calls are drained before the threads are joined.
+ */
+class async_executor_t {
+    std::mutex mutex_;
+    std::condition_variable queued_;
+    std::deque<std::function<void()>> pending_;
+    bool stopping_ = false;
+
+    std::once_flag started_;
+    std::vector<std::thread> workers_;
+
+    void work() noexcept {
+        while (true) {
+            std::function<void()> call;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                queued_.wait(lock, [&] { return stopping_ || !pending_.empty(); });
+                if (pending_.empty())
+                    return;
+                call = std::move(pending_.front());
+                pending_.pop_front();
+            }
+            call();
+        }
+    }
+
+  public:
+    /// Blocking calls mostly wait for IO, so we can afford more threads than cores.
+    static constexpr std::size_t min_workers_k = 4;
+
+    async_executor_t() = default;
+    async_executor_t(async_executor_t const&) = delete;
+    async_executor_t& operator=(async_executor_t const&) = delete;
+
+    ~async_executor_t() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        queued_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    static async_executor_t& global() noexcept {
+        static async_executor_t executor;
+        return executor;
+    }
+
+    /**
+     * @brief Queues the `call`, which must not throw.
+     * @throws `std::bad_alloc` or `std::system_error`, if the call can't be queued.
+     */
+    void submit(std::function<void()> call) noexcept(false) {
+        std::call_once(started_, [&] {
+            std::size_t count = std::max<std::size_t>(min_workers_k, std::thread::hardware_concurrency());
+            workers_.reserve(count);
+            for (std::size_t i = 0; i != count; ++i)
+                workers_.emplace_back(&async_executor_t::work, this);
+        });
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(std::move(call));
+        }
+        queued_.notify_one();
+    }
+};
+
+/**
+ * @brief Implements `ukv_read_async()`-like entry points on top of a blocking
+ * `call`, like `ukv_read()`, by running it on the `async_executor_t`.
+ */
+template <typename task_at>
+void submit_blocking(task_at* c_ptr,
+                     void (*call)(task_at*),
+                     ukv_callback_t callback,
+                     ukv_callback_payload_t payload) noexcept {
+
+    task_at& c = *c_ptr;
+    return_error_if_m(callback, c.error, args_wrong_k, "Asynchronous calls need a callback");
+
+    // The `error` can't be checked after submission, as the call may already be running
+    bool submitted = false;
+    safe_section("Submitting asynchronous call", c.error, [&] {
+        async_executor_t::global().submit([=] {
+            call(c_ptr);
+            callback(payload);
+        });
+        submitted = true;
+    });
+    if (!submitted)
+        callback(payload);
+}
+
+} // namespace unum::ukv
@@ -0,0 +1,274 @@
+/**
+ * @file cache.hpp
+ * @author Ashot Vardanian
+ *
+ * @brief Read-through cache of hot values, shared by engines and clients.
+ */
+#pragma once
+#include <array>         // `std::array`
+#include <atomic>        // `std::atomic`
+#include <chrono>        // `std::chrono::steady_clock`
+#include <mutex>         // `std::mutex`
+#include <string>        // `std::string`
+#include <unordered_map> // `std::unordered_map`
+#include <vector>        // `std::vector`
+
+#include "ukv/cpp/types.hpp" // `collection_key_t`, `value_view_t`
+
+namespace unum::ukv {
+
+/**
+ * @brief Sharded cache of values, bounded in bytes and evicted with the CLOCK policy.
+ * Hits only set a "referenced" bit. The hand of the clock sweeps over the entries,
+ * clearing those bits and evicting the entries, that weren't hit since its last pass.
+ * Unlike LRU, hits never reorder any lists, so the shard lock is held very briefly.
+ *
+ * Missing keys are cached as well, as hot keys are often polled before being written.
+ * Every collection may have its own quota in bytes, and a zero quota disables caching.
+ * Entries can expire after a `time_to_live`, if other processes write into the same store.
+ *
+ * A read may race with a write of the same key and fetch the old value after the
+ * write has invalidated the cache. To keep such values out, readers take a `ticket`
+ * before reading from the underlying store, and `insert` is ignored, if the shard
+ * was invalidated since.
+ *
+ * ## Class Specs
+ * - Concurrency: @b Thread-Safe.
+ * - Copyable: No.
+ * - Exceptions: Only `std::bad_alloc` from `insert` and `limit`.
+ */
+class value_cache_t {
+  public:
+    using ticket_t = std::size_t;
+    using clock_t = std::chrono::steady_clock;
+
+    static constexpr std::size_t shards_k = 64;
+    /// Bookkeeping memory of every entry, charged on top of the value length.
+    static constexpr std::size_t entry_overhead_k = 64;
+
+  private:
+    struct key_hash_t {
+        std::size_t operator()(collection_key_t const& key) const noexcept {
+            return std::hash<ukv_key_t> {}(key.key) ^ (std::hash<ukv_collection_t> {}(key.collection) << 1);
+        }
+    };
+
+    struct slot_t {
+        collection_key_t key;
+        std::string value;
+        clock_t::time_point expires;
+        bool occupied = false;
+        bool present = false;
+        bool referenced = false;
+
+        std::size_t cost() const noexcept { return value.size() + entry_overhead_k; }
+    };
+
+    struct shard_t {
+        std::mutex mutex;
+        std::atomic<ticket_t> generation = 0;
+        std::vector<slot_t> slots;
+        std::vector<std::size_t> free_slots;
+        std::unordered_map<collection_key_t, std::size_t, key_hash_t> index;
+        std::unordered_map<ukv_collection_t, std::size_t> used_by_collection;
+        std::unordered_map<ukv_collection_t, std::size_t> quotas;
+        std::size_t used = 0;
+        std::size_t hand = 0;
+    };
+
+    std::size_t shard_capacity_ = 0;
+    clock_t::duration time_to_live_ {};
+    std::array<shard_t, shards_k> shards_;
+
+    shard_t& shard(collection_key_t const& key) noexcept { return shards_[key_hash_t {}(key) % shards_k]; }
+
+    void evict(shard_t& shard, std::size_t idx) noexcept {
+        slot_t& slot = shard.slots[idx];
+        shard.used -= slot.cost();
+        shard.used_by_collection[slot.key.collection] -= slot.cost();
+        shard.index.erase(slot.key);
+        slot.value = std::string {};
+        slot.occupied = false;
+        shard.free_slots.push_back(idx);
+    }
+
+    /**
+     * @brief Advances the hand, until `is_full` returns false, evicting the entries,
+     * that satisfy the `is_evictable` predicate. Two passes are enough to evict all of them.
+     */
+    template <typename is_full_at, typename is_evictable_at>
+    void reclaim(shard_t& shard, is_full_at&& is_full, is_evictable_at&& is_evictable) noexcept {
+        std::size_t const steps_limit = shard.slots.size() * 2;
+        for (std::size_t step = 0; step != steps_limit && is_full(); ++step) {
+            std::size_t idx = shard.hand;
+            shard.hand = (shard.hand + 1) % shard.slots.size();
+            slot_t& slot = shard.slots[idx];
+            if (!slot.occupied || !is_evictable(slot))
+                continue;
+            if (slot.referenced)
+                slot.referenced = false;
+            else
+                evict(shard, idx);
+        }
+    }
+
+    std::size_t quota(shard_t const& shard, ukv_collection_t collection) const noexcept {
+        auto it = shard.quotas.find(collection);
+        return it != shard.quotas.end() ? it->second : shard_capacity_;
+    }
+
+  public:
+    value_cache_t(std::size_t capacity, clock_t::duration time_to_live = {}) noexcept
+        : shard_capacity_(capacity / shards_k), time_to_live_(time_to_live) {}
+    value_cache_t(value_cache_t const&) = delete;
+    value_cache_t& operator=(value_cache_t const&) = delete;
+
+    /**
+     * @brief Must be taken before reading the `key` from the underlying store and passed to `insert`.
+     */
+    ticket_t ticket(collection_key_t const& key) noexcept { return shard(key).generation.load(); }
+
+    /**
+     * @brief Passes the cached value to the `callback`, if the `key` is present in cache.
+     * Keys, that are known to be missing, are reported with an empty `value_view_t {}`.
+     * @return `false` on a cache miss.
+     */
+    template <typename callback_at>
+    bool find(collection_key_t const& key, callback_at&& callback) noexcept {
+        shard_t& shard = this->shard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end())
+            return false;
+
+        slot_t& slot = shard.slots[it->second];
+        if (time_to_live_.count() && clock_t::now() > slot.expires) {
+            evict(shard, it->second);
+            return false;
+        }
+
+        slot.referenced = true;
+        callback(slot.present ? value_view_t {slot.value.data(), slot.value.size()} : value_view_t {});
+        return true;
+    }
+
+    /**
+     * @brief Remembers the `value` of the `key`, unless the shard was invalidated after the `ticket`
+     * was taken, or the value doesn't fit into the quota of its collection.
+     */
+    void insert(collection_key_t const& key, value_view_t value, ticket_t ticket) noexcept(false) {
+        std::size_t const cost = value.size() + entry_overhead_k;
+        if (cost > shard_capacity_)
+            return;
+
+        // Copy the value before taking the lock, to keep the critical section short
+        std::string copy(value.c_str(), value.size());
+        shard_t& shard = this->shard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.generation.load() != ticket)
+            return;
+
+        std::size_t const collection_quota = quota(shard, key.collection);
+        if (cost > collection_quota)
+            return;
+
+        if (auto it = shard.index.find(key); it != shard.index.end())
+            evict(shard, it->second);
+
+        std::size_t& used_by_collection = shard.used_by_collection[key.collection];
+        auto is_same_collection = [&](slot_t const& slot) { return slot.key.collection == key.collection; };
+        reclaim(
+            shard,
+            [&] { return used_by_collection + cost > collection_quota; },
+            is_same_collection);
+        reclaim(
+            shard,
+            [&] { return shard.used + cost > shard_capacity_; },
+            [](slot_t const&) { return true; });
+
+        auto it = shard.index.emplace(key, shard.slots.size()).first;
+        try {
+            if (shard.free_slots.empty())
+                shard.slots.emplace_back();
+            else
+                it->second = shard.free_slots.back(), shard.free_slots.pop_back();
+        }
+        catch (...) {
+            shard.index.erase(it);
+            throw;
+        }
+
+        slot_t& slot = shard.slots[it->second];
+        slot.key = key;
+        slot.value = std::move(copy);
+        slot.expires = clock_t::now() + time_to_live_;
+        slot.occupied = true;
+        slot.present = bool(value);
+        slot.referenced = false;
+        shard.used += cost;
+        used_by_collection += cost;
+    }
+
+    /**
+     * @brief Forgets the `key`. Must be called after the new value is written into the underlying store.
+     */
+    void invalidate(collection_key_t const& key) noexcept {
+        shard_t& shard = this->shard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        ++shard.generation;
+        if (auto it = shard.index.find(key); it != shard.index.end())
+            evict(shard, it->second);
+    }
+
+    /**
+     * @brief Forgets all the keys of the `collection`, for example, when it is dropped.
+     */
+    void invalidate(ukv_collection_t collection) noexcept {
+        for (shard_t& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            ++shard.generation;
+            for (std::size_t idx = 0; idx != shard.slots.size(); ++idx)
+                if (shard.slots[idx].occupied && shard.slots[idx].key.collection == collection)
+                    evict(shard, idx);
+        }
+    }
+
+    void clear() noexcept {
+        for (shard_t& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            ++shard.generation;
+            for (std::size_t idx = 0; idx != shard.slots.size(); ++idx)
+                if (shard.slots[idx].occupied)
+                    evict(shard, idx);
+        }
+    }
+
+    /**
+     * @brief Limits the memory, that the values of the `collection` can occupy.
+     * Zero `capacity` disables caching for the `collection`.
+     */
+    void limit(ukv_collection_t collection, std::size_t capacity) noexcept(false) {
+        std::size_t const collection_quota = capacity / shards_k;
+        for (shard_t& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.quotas[collection] = collection_quota;
+            std::size_t& used_by_collection = shard.used_by_collection[collection];
+            auto is_same_collection = [&](slot_t const& slot) { return slot.key.collection == collection; };
+            reclaim(
+                shard,
+                [&] { return used_by_collection > collection_quota; },
+                is_same_collection);
+        }
+    }
+
+    std::size_t size_bytes() noexcept {
+        std::size_t result = 0;
+        for (shard_t& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            result += shard.used;
+        }
+        return result;
+    }
+};
+
+} // namespace unum::ukv
@@ -6,8 +6,11 @@
  */
 #pragma once
 #include <random>
+#include <vector>    // `std::vector`
+#include <algorithm> // `std::upper_bound`
 
 #include "ukv/blobs.h"
+#include "helpers/trace.hpp" // `trace_span_t`
 
 namespace unum::ukv {
 
@@ -23,10 +26,13 @@ void full_scan_collection( //
     ukv_error_t* error,
     callback_should_continue_at&& callback_should_continue) noexcept {
 
+    trace_span_t span("full_scan_collection");
     read_ahead = std::max<ukv_length_t>(read_ahead, 2u);
     while (!*error) {
         ukv_length_t* found_blobs_count {};
         ukv_key_t* found_blobs_keys {};
+        ukv_length_t* found_blobs_offsets {};
+        ukv_byte_t* found_blobs_data {};
         ukv_scan_t scan {};
         scan.db = db;
         scan.error = error;
@@ -39,6 +45,8 @@ void full_scan_collection( //
         scan.count_limits = &read_ahead;
         scan.counts = &found_blobs_count;
         scan.keys = &found_blobs_keys;
+        scan.values_offsets = &found_blobs_offsets;
+        scan.values = &found_blobs_data;
 
         ukv_scan(&scan);
         if (*error)
@@ -48,27 +56,8 @@ void full_scan_collection( //
             // We have reached the end of collection
             break;
 
-        ukv_length_t* found_blobs_offsets {};
-        ukv_byte_t* found_blobs_data {};
-        ukv_read_t read {};
-        read.db = db;
-        read.error = error;
-        read.transaction = transaction;
-        read.arena = arena;
-        read.options = ukv_options_t(options | ukv_option_dont_discard_memory_k);
-        read.tasks_count = found_blobs_count[0];
-        read.collections = &collection;
-        read.collections_stride = 0;
-        read.keys = found_blobs_keys;
-        read.keys_stride = sizeof(ukv_key_t);
-        read.offsets = &found_blobs_offsets;
-        read.values = &found_blobs_data;
-
-        ukv_read(&read);
-        if (*error)
-            break;
-
         ukv_length_t const count_blobs = found_blobs_count[0];
+        span.add_tasks(count_blobs);
         joined_blobs_iterator_t found_blobs {found_blobs_offsets, found_blobs_data};
         for (std::size_t i = 0; i != count_blobs; ++i, ++found_blobs) {
             value_view_t bucket = *found_blobs;
@@ -80,6 +69,155 @@ void full_scan_collection( //
     }
 }
 
+/**
+ * @brief Partitioned bulk scan, where every partition is a disjoint range of keys,
+ * drained with ordered `ukv_scan()` calls. Serves as the `ukv_scan_bulk_t` for
+ * engines, that can't read their underlying files directly.
+ */
+struct ranged_bulk_scan_t {
+    struct partition_t {
+        ukv_key_t next_key = std::numeric_limits<ukv_key_t>::min();
+        ukv_key_t max_key = std::numeric_limits<ukv_key_t>::max();
+        bool drained = false;
+    };
+
+    ukv_database_t db = nullptr;
+    ukv_collection_t collection = ukv_collection_main_k;
+    ukv_snapshot_t snapshot = 0;
+    std::vector<partition_t> partitions;
+
+    /**
+     * @param split_keys Sorted smallest keys of every partition but the first one.
+     * Repeating split keys produce empty partitions.
+     */
+    void split(ptr_range_gt<ukv_key_t const> split_keys, std::size_t partitions_count) noexcept(false) {
+        partitions.resize(std::max<std::size_t>(partitions_count, 1u));
+        for (std::size_t i = 0; i != split_keys.size() && i + 1 < partitions.size(); ++i) {
+            partitions[i + 1].next_key = split_keys[i];
+            // Nothing precedes the smallest key, so such partitions stay empty
+            if (split_keys[i] == std::numeric_limits<ukv_key_t>::min()) {
+                partitions[i].max_key = split_keys[i];
+                partitions[i].drained = true;
+                continue;
+            }
+            partitions[i].max_key = split_keys[i] - 1;
+            partitions[i].drained = partitions[i].next_key > partitions[i].max_key;
+        }
+        for (std::size_t i = split_keys.size() + 1; i < partitions.size(); ++i)
+            partitions[i].drained = true;
+    }
+};
+
+inline void ranged_bulk_scan_next(ranged_bulk_scan_t& scan, ukv_scan_bulk_next_t& c) noexcept {
+
+    return_error_if_m(c.partition < scan.partitions.size(), c.error, args_wrong_k, "Partition is out of bounds");
+    ranged_bulk_scan_t::partition_t& partition = scan.partitions[c.partition];
+    ukv_length_t* found_counts = nullptr;
+    ukv_key_t* found_keys = nullptr;
+    *c.count = 0;
+    if (partition.drained || !c.count_limit) {
+        *c.keys = nullptr;
+        return;
+    }
+
+    ukv_scan_t scan_one {};
+    scan_one.db = scan.db;
+    scan_one.error = c.error;
+    scan_one.snapshot = scan.snapshot;
+    scan_one.arena = c.arena;
+    scan_one.options = ukv_options_t(c.options | ukv_option_scan_bulk_k);
+    scan_one.tasks_count = 1;
+    scan_one.collections = &scan.collection;
+    scan_one.start_keys = &partition.next_key;
+    scan_one.count_limits = &c.count_limit;
+    scan_one.counts = &found_counts;
+    scan_one.keys = &found_keys;
+    scan_one.values_offsets = c.values_offsets;
+    scan_one.values_lengths = c.values_lengths;
+    scan_one.values = c.values;
+
+    ukv_scan(&scan_one);
+    return_if_error_m(c.error);
+
+    // Neighbouring partition starts right after our `max_key`, so trim the tail
+    ukv_length_t const found_count = found_counts[0];
+    auto count = static_cast<ukv_length_t>(
+        std::upper_bound(found_keys, found_keys + found_count, partition.max_key) - found_keys);
+    *c.count = count;
+    *c.keys = found_keys;
+
+    ukv_key_t const last_key = count ? found_keys[count - 1] : partition.max_key;
+    partition.drained = count != c.count_limit || last_key >= partition.max_key;
+    if (!partition.drained)
+        partition.next_key = last_key + 1;
+}
+
+/**
+ * @brief Bisects the keys range to find the key, before which the `size_between`
+ * estimate reaches the `fraction` of the entire range.
+ * Falls back to uniform splits of the keys range, if the sizes are unknown.
+ */
+template <typename size_between_at>
+ukv_key_t split_by_size(ukv_key_t first, ukv_key_t last, double fraction, size_between_at&& size_between) noexcept {
+    auto midpoint = [](ukv_key_t low, ukv_key_t high, double fraction) {
+        auto span = static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low);
+        return static_cast<ukv_key_t>(static_cast<std::uint64_t>(low) + static_cast<std::uint64_t>(span * fraction));
+    };
+
+    std::uint64_t const total = size_between(first, last);
+    if (!total)
+        return midpoint(first, last, fraction);
+
+    auto const target = static_cast<std::uint64_t>(total * fraction);
+    ukv_key_t low = first, high = last;
+    while (low < high) {
+        ukv_key_t mid = midpoint(low, high, 0.5);
+        if (size_between(first, mid) < target)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+/**
+ * @brief Splits a range of RocksDB or LevelDB keys into parts of similar size on disk.
+ * @see `ukv_collection_split()`.
+ */
+template <typename level_or_rocks_iterator_at, typename size_between_at>
+void split_range_by_size(level_or_rocks_iterator_at&& iterator,
+                         ukv_key_t start_key,
+                         ukv_key_t end_key,
+                         ptr_range_gt<ukv_key_t> boundaries,
+                         size_between_at&& size_between) noexcept {
+
+    using slice_t = decltype(iterator->key());
+    std::size_t const parts_count = boundaries.size() - 1;
+    std::fill(boundaries.begin(), boundaries.end(), end_key);
+    boundaries[0] = start_key;
+
+    // Narrow down the range to the keys, that are actually present
+    ukv_key_t first, last;
+    iterator->Seek(slice_t(reinterpret_cast<char const*>(&start_key), sizeof(ukv_key_t)));
+    if (!iterator->Valid())
+        return;
+    std::memcpy(&first, iterator->key().data(), sizeof(ukv_key_t));
+    if (first >= end_key)
+        return;
+
+    iterator->Seek(slice_t(reinterpret_cast<char const*>(&end_key), sizeof(ukv_key_t)));
+    if (iterator->Valid())
+        iterator->Prev();
+    else
+        iterator->SeekToLast();
+    if (!iterator->Valid())
+        return;
+    std::memcpy(&last, iterator->key().data(), sizeof(ukv_key_t));
+
+    for (std::size_t i = 1; i != parts_count; ++i)
+        boundaries[i] = split_by_size(first, last, double(i) / parts_count, size_between);
+}
+
 /**
  * @brief Implements reservoir sampling for RocksDB or LevelDB collections.
  * @see https://en.wikipedia.org/wiki/Reservoir_sampling
@@ -5,9 +5,15 @@
  * @brief Helper functions Polymorphic Memory Allocators.
  */
 #pragma once
-#include <sys/mman.h> // `mmap`
+#include <sys/mman.h> // `mmap`, `shm_open`
+#include <sys/stat.h> // `fstat`
+#include <fcntl.h>    // `O_CREAT`
+#include <unistd.h>   // `ftruncate`, `getpid`
 #include <limits.h>   // `CHAR_BIT`
 #include <cstring>    // `std::memcpy`
+#include <cstdio>     // `std::snprintf`
+#include <atomic>     // `std::atomic`
+#include <string>     // `std::string`
 #include <stdexcept>  // `std::runtime_error`
 #include <memory>     // `std::allocator`
 #include <vector>     // `std::vector`
@@ -16,12 +22,37 @@
 #include "ukv/cpp/types.hpp"  // `byte_t`, `next_power_of_two`
 #include "ukv/cpp/ranges.hpp" // `strided_range_gt`
 #include "ukv/cpp/status.hpp" // `out_of_memory_k`
+#include "helpers/metrics.hpp"  // `metric_scope_t`
 
 namespace unum::ukv {
 
+/**
+ * @brief Memory chunk of the process-wide pool, shared by all the arenas.
+ * Released chunks are kept for reuse up to a limit, instead of being freed,
+ * so that periodic large requests don't keep hitting the system allocator.
+ *
+ * The pool is configured with environment variables:
+ * - "UKV_ARENA_POOL_BYTES": Limit of idle memory kept, 256 MB by default.
+ * - "UKV_ARENA_HUGE_PAGES": Back chunks of 2 MB and more with transparent huge pages.
+ */
+struct pooled_chunk_t {
+    void* begin = nullptr;
+    std::size_t capacity = 0;
+    /// Whether the chunk was mapped with `mmap`, rather than `malloc`-ed.
+    bool mapped = false;
+};
+
+/// Takes a chunk with capacity between `min_length` and `max_length` from the pool or the system.
+pooled_chunk_t pooled_chunk_acquire(std::size_t min_length, std::size_t max_length) noexcept;
+/// Returns a chunk into the pool, or to the system, if the pool is full.
+void pooled_chunk_release(pooled_chunk_t chunk) noexcept;
+/// Total capacity of idle chunks in the pool.
+std::size_t pooled_chunks_capacity() noexcept;
+
 struct linked_memory_t {
     static constexpr std::size_t initial_size_k = 1024ul * 1024ul;
     static constexpr std::size_t growth_factor_k = 2ul;
+    static constexpr std::size_t shared_name_capacity_k = 32ul;
 
     struct arena_header_t;
     arena_header_t* first_ptr_ = nullptr;
@@ -33,6 +64,17 @@ struct linked_memory_t {
         std::size_t used = 0;
         kind_t kind = kind_t::sys_k;
         bool can_release_memory = false;
+        /// Only for `kind_t::sys_k`: whether the chunk came mapped from the `pooled_chunk_acquire`.
+        bool mapped = false;
+        /// Only for `kind_t::shared_k`: the POSIX name, other processes can map this arena by.
+        char name[shared_name_capacity_k] = {};
+
+        /// Only in the first chunk: the sum of capacities of all the chunks.
+        std::size_t total_capacity = 0;
+        /// Only in the first chunk: the largest `total_capacity` ever reached.
+        std::size_t peak_capacity = 0;
+        /// Only in the first chunk: the cap on `total_capacity`, or zero, if unlimited.
+        std::size_t limit = 0;
 
         void* alloc_internally(std::size_t length, std::size_t alignment) noexcept {
             auto arena_start = std::intptr_t(this);
@@ -47,30 +89,65 @@ struct linked_memory_t {
         }
     };
 
-    static arena_header_t* alloc_arena(std::size_t length, kind_t kind) noexcept {
-        void* begin = nullptr;
+    /// Offset of the payload in segments, that other processes prepare for `adopt_shared`.
+    static constexpr std::size_t shared_payload_offset_k = 256ul;
+
+    /**
+     * @brief Creates a named POSIX shared memory segment, that co-located processes can map.
+     * Only processes of the same user can open it.
+     */
+    static void* alloc_shared(std::size_t length, char* name) noexcept {
+        static std::atomic<std::size_t> segments_count {0};
+        std::snprintf(name, shared_name_capacity_k, "/ukv-%d-%zu", int(getpid()), segments_count++);
+        int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd < 0)
+            return nullptr;
+
+        void* begin = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(length)) == 0)
+            begin = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (begin != MAP_FAILED)
+            return begin;
+
+        shm_unlink(name);
+        return nullptr;
+    }
+
+    /**
+     * @brief Allocates a chunk of at least `length` bytes. Pooled chunks
+     * can be bigger, but never exceed the `max_length`.
+     */
+    static arena_header_t* alloc_arena(std::size_t length, std::size_t max_length, kind_t kind) noexcept {
+        metric_scope_t metric(metric_op_t::arena_alloc_k, nullptr);
+        metric.add_bytes(length);
+        pooled_chunk_t chunk;
+        char name[shared_name_capacity_k] = {};
         switch (kind) {
-        case kind_t::sys_k: begin = std::malloc(length); break;
-        case kind_t::shared_k:
-            begin = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_SHARED, -1, 0);
-            break;
+        case kind_t::sys_k: chunk = pooled_chunk_acquire(length, max_length); break;
+        case kind_t::shared_k: chunk = {alloc_shared(length, name), length, false}; break;
         case kind_t::unified_k: break;
         }
-        auto header_ptr = (arena_header_t*)begin;
+        auto header_ptr = (arena_header_t*)chunk.begin;
         if (!header_ptr)
             return nullptr;
 
         std::memset(header_ptr, 0, sizeof(arena_header_t));
+        std::memcpy(header_ptr->name, name, shared_name_capacity_k);
         header_ptr->kind = kind;
-        header_ptr->capacity = length;
+        header_ptr->mapped = chunk.mapped;
+        header_ptr->capacity = chunk.capacity;
         header_ptr->used = sizeof(arena_header_t);
         return header_ptr;
     }
 
     static void release_arena(arena_header_t* arena) noexcept {
         switch (arena->kind) {
-        case kind_t::sys_k: std::free(arena); break;
-        case kind_t::shared_k: munmap(arena, arena->capacity); break;
+        case kind_t::sys_k: pooled_chunk_release({arena, arena->capacity, arena->mapped}); break;
+        case kind_t::shared_k:
+            shm_unlink(arena->name);
+            munmap(arena, arena->capacity);
+            break;
         case kind_t::unified_k: break;
         }
     }
@@ -81,9 +158,72 @@ struct linked_memory_t {
         if (first_ptr_ && first_ptr_->kind == kind)
             return true;
 
-        first_ptr_ = alloc_arena(initial_size_k, kind);
+        // The limit survives switching between kinds of memory
+        std::size_t limit = first_ptr_ ? first_ptr_->limit : 0;
+        release_all();
+        first_ptr_ = alloc_arena(initial_size_k, initial_size_k, kind);
+        if (!first_ptr_)
+            return false;
+
         first_ptr_->can_release_memory = true;
-        return first_ptr_;
+        first_ptr_->total_capacity = first_ptr_->capacity;
+        first_ptr_->peak_capacity = first_ptr_->capacity;
+        first_ptr_->limit = limit;
+        return true;
+    }
+
+    /**
+     * @brief Maps a segment, that a co-located process has created with `alloc_shared`,
+     * and links it into this arena, so it lives exactly as long as other allocations.
+     * The name is unlinked right away, so the segment can't be opened by anyone else.
+     * @return Address of the payload of `length` bytes at `shared_payload_offset_k`, or NULL.
+     */
+    byte_t* adopt_shared(char const* name, std::size_t length) noexcept {
+        static_assert(sizeof(arena_header_t) <= shared_payload_offset_k);
+        if (!first_ptr_ || std::strlen(name) >= shared_name_capacity_k || std::strncmp(name, "/ukv-", 5) != 0)
+            return nullptr;
+
+        int fd = shm_open(name, O_RDWR, 0);
+        if (fd < 0)
+            return nullptr;
+        shm_unlink(name);
+
+        struct stat info;
+        void* begin = MAP_FAILED;
+        std::size_t capacity = 0;
+        if (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= shared_payload_offset_k + length) {
+            capacity = static_cast<std::size_t>(info.st_size);
+            begin = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (begin == MAP_FAILED)
+            return nullptr;
+
+        // The whole segment is occupied by the payload, so nothing else is allocated in it
+        auto header_ptr = reinterpret_cast<arena_header_t*>(begin);
+        std::memset(header_ptr, 0, sizeof(arena_header_t));
+        std::strncpy(header_ptr->name, name, shared_name_capacity_k - 1);
+        header_ptr->kind = kind_t::shared_k;
+        header_ptr->capacity = capacity;
+        header_ptr->used = capacity;
+        header_ptr->next = std::exchange(first_ptr_->next, header_ptr);
+        first_ptr_->total_capacity += capacity;
+        first_ptr_->peak_capacity = std::max(first_ptr_->peak_capacity, first_ptr_->total_capacity);
+        return reinterpret_cast<byte_t*>(begin) + shared_payload_offset_k;
+    }
+
+    /**
+     * @brief Locates the arena, containing the given address.
+     * Is used to describe shared memory regions to other processes.
+     */
+    arena_header_t const* find(void const* ptr) const noexcept {
+        for (arena_header_t const* current = first_ptr_; current != nullptr; current = current->next) {
+            auto begin = reinterpret_cast<byte_t const*>(current);
+            auto it = reinterpret_cast<byte_t const*>(ptr);
+            if (it >= begin && it < begin + current->capacity)
+                return current;
+        }
+        return nullptr;
     }
 
     bool lock_release_calls() noexcept { return std::exchange(first_ref().can_release_memory, false); }
@@ -117,13 +257,26 @@ struct linked_memory_t {
             current = current->next;
         }
 
-        // We need to append a new even bigger bucket.
-        auto new_capacity = std::max(last->capacity * growth_factor_k, length + alignment + sizeof(arena_header_t));
-        auto new_arena = alloc_arena(new_capacity, first_ref().kind);
+        // We need to append a new even bigger bucket, if the limit allows.
+        arena_header_t& first = first_ref();
+        auto min_capacity = length + alignment + sizeof(arena_header_t);
+        auto new_capacity = std::max(last->capacity * growth_factor_k, min_capacity);
+        auto max_capacity = new_capacity * growth_factor_k;
+        if (first.limit) {
+            auto remaining = first.limit > first.total_capacity ? first.limit - first.total_capacity : 0ul;
+            if (min_capacity > remaining)
+                return nullptr;
+            new_capacity = std::min(new_capacity, remaining);
+            max_capacity = remaining;
+        }
+
+        auto new_arena = alloc_arena(new_capacity, max_capacity, first.kind);
         if (!new_arena)
             return nullptr;
 
         last->next = new_arena;
+        first.total_capacity += new_arena->capacity;
+        first.peak_capacity = std::max(first.peak_capacity, first.total_capacity);
         return new_arena->alloc_internally(length, alignment);
     }
 
@@ -142,9 +295,48 @@ struct linked_memory_t {
             release_arena(std::exchange(current, current->next));
         first_ptr_->next = nullptr;
         first_ptr_->used = sizeof(arena_header_t);
+        first_ptr_->total_capacity = first_ptr_->capacity;
     }
 };
 
+/**
+ * @brief Shared memory segment, prepared for a co-located process, that takes it over
+ * with `linked_memory_t::adopt_shared`. Unless `release`-d, the segment is removed on destruction.
+ */
+class shared_segment_t {
+    byte_t* begin_ = nullptr;
+    std::size_t length_ = 0;
+    char name_[linked_memory_t::shared_name_capacity_k] = {};
+    bool released_ = false;
+
+  public:
+    shared_segment_t(std::size_t length) noexcept {
+        begin_ = reinterpret_cast<byte_t*>(linked_memory_t::alloc_shared(length, name_));
+        length_ = begin_ ? length : 0;
+    }
+
+    shared_segment_t(shared_segment_t const&) = delete;
+    shared_segment_t& operator=(shared_segment_t const&) = delete;
+
+    ~shared_segment_t() noexcept {
+        if (!begin_)
+            return;
+        munmap(begin_, length_);
+        if (!released_)
+            shm_unlink(name_);
+    }
+
+    /**
+     * @brief Keeps the segment after destruction, for the other process to adopt.
+     */
+    void release() noexcept { released_ = true; }
+
+    char const* name() const noexcept { return name_; }
+    byte_t* payload() const noexcept { return begin_ + linked_memory_t::shared_payload_offset_k; }
+    std::size_t payload_capacity() const noexcept { return length_ - linked_memory_t::shared_payload_offset_k; }
+    explicit operator bool() const noexcept { return begin_; }
+};
+
 template <typename range_at>
 struct range_or_dummy_gt {
     using range_t = range_at;
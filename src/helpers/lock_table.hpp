@@ -0,0 +1,183 @@
+/**
+ * @file lock_table.hpp
+ * @author Ashot Vardanian
+ *
+ * @brief Key locks for pessimistic transactions.
+ */
+#pragma once
+#include <algorithm>          // `std::sort`
+#include <array>              // `std::array`
+#include <chrono>             // `std::chrono::steady_clock`
+#include <condition_variable> // `std::condition_variable`
+#include <mutex>              // `std::mutex`
+#include <unordered_map>      // `std::unordered_map`
+#include <vector>             // `std::vector`
+
+#include "ukv/cpp/types.hpp"  // `collection_key_t`
+#include "ukv/cpp/status.hpp" // `return_error_if_m`
+
+namespace unum::ukv {
+
+/**
+ * @brief Exclusive locks on individual keys, held by pessimistic transactions
+ * until they commit or reset. Lock owners are identified by transaction handles.
+ *
+ * Before blocking, the owner adds an edge to the "wait-for" graph, pointing to the
+ * current holder of the key. If the chain of edges leads back to the owner, it is
+ * a deadlock, and the lock fails right away, instead of waiting for the timeout.
+ * Every transaction waits for at most one key at a time, so chains are short.
+ *
+ * There are no range or gap locks, so scans of pessimistic transactions
+ * don't prevent phantoms: keys inserted into a scanned range by others.
+ *
+ * ## Class Specs
+ * - Concurrency: @b Thread-Safe.
+ * - Copyable: No.
+ * - Exceptions: Only `std::bad_alloc` from `lock`.
+ */
+class lock_table_t {
+  public:
+    using owner_t = void const*;
+    using clock_t = std::chrono::steady_clock;
+
+    enum class outcome_t {
+        acquired_k,
+        owned_k,
+        timeout_k,
+        deadlock_k,
+    };
+
+    static constexpr std::chrono::milliseconds default_timeout_k {1000};
+
+    /**
+     * @brief Converts the `ukv_transaction_init_t::lock_timeout`, where zero means the default.
+     */
+    static clock_t::duration timeout(ukv_size_t milliseconds) noexcept {
+        return milliseconds ? clock_t::duration(std::chrono::milliseconds(milliseconds)) : default_timeout_k;
+    }
+
+  private:
+    struct key_hash_t {
+        std::size_t operator()(collection_key_t const& key) const noexcept {
+            return std::hash<ukv_key_t> {}(key.key) ^ (std::hash<ukv_collection_t> {}(key.collection) << 1);
+        }
+    };
+
+    struct shard_t {
+        std::mutex mutex;
+        std::condition_variable released;
+        std::unordered_map<collection_key_t, owner_t, key_hash_t> owners;
+    };
+
+    static constexpr std::size_t shards_k = 64;
+
+    std::array<shard_t, shards_k> shards_;
+    std::mutex graph_mutex_;
+    std::unordered_map<owner_t, owner_t> waits_for_;
+
+    shard_t& shard(collection_key_t const& key) noexcept { return shards_[key_hash_t {}(key) % shards_k]; }
+
+    /**
+     * @brief Adds the `owner -> holder` edge, unless it closes a cycle.
+     * Edges to released holders are removed in `unlock`, and the waiters
+     * add new ones once they wake up, so no cycle is ever missed.
+     */
+    bool closes_cycle(owner_t owner, owner_t holder) noexcept(false) {
+        std::lock_guard lock {graph_mutex_};
+        owner_t current = holder;
+        for (std::size_t steps = 0; steps <= waits_for_.size(); ++steps) {
+            if (current == owner)
+                return true;
+            auto it = waits_for_.find(current);
+            if (it == waits_for_.end())
+                break;
+            current = it->second;
+        }
+        waits_for_[owner] = holder;
+        return false;
+    }
+
+    void stop_waiting(owner_t owner) noexcept {
+        std::lock_guard lock {graph_mutex_};
+        waits_for_.erase(owner);
+    }
+
+  public:
+    lock_table_t() = default;
+    lock_table_t(lock_table_t const&) = delete;
+    lock_table_t& operator=(lock_table_t const&) = delete;
+
+    /**
+     * @brief Blocks until the `key` is free or the `timeout` expires.
+     * Returns `outcome_t::owned_k`, if the `owner` already holds it.
+     */
+    outcome_t lock(owner_t owner, collection_key_t key, clock_t::duration timeout) noexcept(false) {
+        shard_t& key_shard = shard(key);
+        clock_t::time_point deadline = clock_t::now() + timeout;
+        std::unique_lock lock {key_shard.mutex};
+        bool waited = false;
+        while (true) {
+            auto [it, inserted] = key_shard.owners.try_emplace(key, owner);
+            if (inserted || it->second == owner) {
+                if (waited)
+                    stop_waiting(owner);
+                return inserted ? outcome_t::acquired_k : outcome_t::owned_k;
+            }
+
+            waited = true;
+            bool deadlocked = closes_cycle(owner, it->second);
+            if (deadlocked || clock_t::now() >= deadline) {
+                stop_waiting(owner);
+                return deadlocked ? outcome_t::deadlock_k : outcome_t::timeout_k;
+            }
+            key_shard.released.wait_until(lock, deadline);
+        }
+    }
+
+    /**
+     * @brief Releases the `keys`, previously acquired by the `owner`.
+     */
+    void unlock(owner_t owner, std::vector<collection_key_t> const& keys) noexcept {
+        for (collection_key_t const& key : keys) {
+            shard_t& key_shard = shard(key);
+            {
+                std::lock_guard lock {key_shard.mutex};
+                auto it = key_shard.owners.find(key);
+                if (it == key_shard.owners.end() || it->second != owner)
+                    continue;
+                key_shard.owners.erase(it);
+            }
+            key_shard.released.notify_all();
+        }
+
+        std::lock_guard lock {graph_mutex_};
+        for (auto it = waits_for_.begin(); it != waits_for_.end();)
+            it = it->second == owner ? waits_for_.erase(it) : std::next(it);
+    }
+};
+
+/**
+ * @brief Sorts and deduplicates the `keys`, locking them one after another,
+ * so that batches of the same transactions never deadlock with each other.
+ * The acquired keys are appended to `locked`, even if a later one fails.
+ */
+inline void lock_keys(lock_table_t& table,
+                      lock_table_t::owner_t owner,
+                      std::vector<collection_key_t>& keys,
+                      lock_table_t::clock_t::duration timeout,
+                      std::vector<collection_key_t>& locked,
+                      ukv_error_t* c_error) noexcept(false) {
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    locked.reserve(locked.size() + keys.size());
+    for (collection_key_t const& key : keys) {
+        auto outcome = table.lock(owner, key, timeout);
+        if (outcome == lock_table_t::outcome_t::acquired_k)
+            locked.push_back(key);
+        return_error_if_m(outcome != lock_table_t::outcome_t::deadlock_k, c_error, consistency_k, "Deadlock detected");
+        return_error_if_m(outcome != lock_table_t::outcome_t::timeout_k, c_error, consistency_k, "Lock wait timeout");
+    }
+}
+
+} // namespace unum::ukv
@@ -0,0 +1,197 @@
+/**
+ * @file metrics.hpp
+ * @author Ashot Vardanian
+ *
+ * @brief Opt-in counters and latency histograms for every entry point.
+ *
+ * Every thread updates its own `thread_metrics_t`, so recording needs
+ * no locks and no atomic read-modify-write operations. `ukv_metrics()`
+ * sums them up on demand. Collection is off by default. It is enabled by
+ * the "UKV_METRICS" environment variable or by `ukv_metrics_t::collect`.
+ */
+#pragma once
+#include <array>   // `std::array`
+#include <atomic>  // `std::atomic`
+#include <chrono>  // `std::chrono::steady_clock`
+#include <cstdint> // `std::uint64_t`
+
+#include "ukv/db.h"
+#include "helpers/trace.hpp" // `trace_span_t`
+
+namespace unum::ukv {
+
+enum class metric_op_t : std::uint8_t {
+    read_k = 0,
+    write_k,
+    scan_k,
+    scan_bulk_k,
+    sample_k,
+    measure_k,
+    split_k,
+    transaction_commit_k,
+
+    docs_read_k,
+    docs_write_k,
+    docs_gist_k,
+    docs_gather_k,
+    graph_find_edges_k,
+    graph_upsert_edges_k,
+    graph_remove_edges_k,
+    graph_upsert_vertices_k,
+    graph_remove_vertices_k,
+    paths_read_k,
+    paths_write_k,
+    paths_match_k,
+    vectors_read_k,
+    vectors_write_k,
+    vectors_search_k,
+
+    /// Calls into the underlying engine, like RocksDB, to separate its latency from ours.
+    engine_read_k,
+    engine_write_k,
+    engine_seek_k,
+    engine_commit_k,
+
+    /// Allocations of new chunks in `linked_memory_t` arenas.
+    arena_alloc_k,
+
+    count_k,
+};
+
+inline char const* metric_name(metric_op_t op) noexcept {
+    switch (op) {
+    case metric_op_t::read_k: return "read";
+    case metric_op_t::write_k: return "write";
+    case metric_op_t::scan_k: return "scan";
+    case metric_op_t::scan_bulk_k: return "scan_bulk";
+    case metric_op_t::sample_k: return "sample";
+    case metric_op_t::measure_k: return "measure";
+    case metric_op_t::split_k: return "collection_split";
+    case metric_op_t::transaction_commit_k: return "transaction_commit";
+    case metric_op_t::docs_read_k: return "docs_read";
+    case metric_op_t::docs_write_k: return "docs_write";
+    case metric_op_t::docs_gist_k: return "docs_gist";
+    case metric_op_t::docs_gather_k: return "docs_gather";
+    case metric_op_t::graph_find_edges_k: return "graph_find_edges";
+    case metric_op_t::graph_upsert_edges_k: return "graph_upsert_edges";
+    case metric_op_t::graph_remove_edges_k: return "graph_remove_edges";
+    case metric_op_t::graph_upsert_vertices_k: return "graph_upsert_vertices";
+    case metric_op_t::graph_remove_vertices_k: return "graph_remove_vertices";
+    case metric_op_t::paths_read_k: return "paths_read";
+    case metric_op_t::paths_write_k: return "paths_write";
+    case metric_op_t::paths_match_k: return "paths_match";
+    case metric_op_t::vectors_read_k: return "vectors_read";
+    case metric_op_t::vectors_write_k: return "vectors_write";
+    case metric_op_t::vectors_search_k: return "vectors_search";
+    case metric_op_t::engine_read_k: return "read";
+    case metric_op_t::engine_write_k: return "write";
+    case metric_op_t::engine_seek_k: return "seek";
+    case metric_op_t::engine_commit_k: return "transaction_commit";
+    case metric_op_t::arena_alloc_k: return "arena_alloc";
+    default: return "unknown";
+    }
+}
+
+inline char const* metric_layer(metric_op_t op) noexcept {
+    if (op == metric_op_t::arena_alloc_k)
+        return "memory";
+    if (op >= metric_op_t::engine_read_k)
+        return "engine";
+    return "api";
+}
+
+/**
+ * @brief Log-linear bucketing of nanosecond latencies, like in HDR histograms.
+ * Every power of two is split into 8 buckets, so the relative error stays under 12.5%,
+ * and everything beyond ~18 minutes lands in the last bucket.
+ */
+struct latency_buckets_t {
+    static constexpr std::size_t sub_bits_k = 3;
+    static constexpr std::size_t sub_count_k = 1ul << sub_bits_k;
+    static constexpr std::size_t max_power_k = 40;
+    static constexpr std::size_t count_k = (max_power_k - sub_bits_k + 2) * sub_count_k;
+
+    static std::size_t index(std::uint64_t nanos) noexcept {
+        if (nanos < sub_count_k)
+            return static_cast<std::size_t>(nanos);
+        std::size_t power = 63 - __builtin_clzll(nanos);
+        if (power > max_power_k)
+            return count_k - 1;
+        std::size_t mantissa = (nanos >> (power - sub_bits_k)) & (sub_count_k - 1);
+        return (power - sub_bits_k + 1) * sub_count_k + mantissa;
+    }
+
+    /// The largest latency, that falls into the bucket with the given `index`.
+    static std::uint64_t upper_bound(std::size_t index) noexcept {
+        if (index < sub_count_k)
+            return index;
+        std::size_t power = index / sub_count_k + sub_bits_k - 1;
+        std::uint64_t mantissa = index % sub_count_k;
+        return ((sub_count_k + mantissa + 1) << (power - sub_bits_k)) - 1;
+    }
+};
+
+/**
+ * @brief Counters of a single operation, updated by a single thread and read by any.
+ */
+struct metric_counters_t {
+    std::atomic<std::uint64_t> calls;
+    std::atomic<std::uint64_t> errors;
+    std::atomic<std::uint64_t> bytes;
+    std::atomic<std::uint64_t> nanos;
+    std::array<std::atomic<std::uint64_t>, latency_buckets_t::count_k> latencies;
+};
+
+struct thread_metrics_t {
+    std::array<metric_counters_t, static_cast<std::size_t>(metric_op_t::count_k)> ops;
+};
+
+bool metrics_enabled() noexcept;
+void record_metric(metric_op_t op, std::uint64_t nanos, bool failed, std::uint64_t bytes) noexcept;
+
+/**
+ * @brief Times the enclosing scope of an entry point. The call is counted
+ * as failed, if the `error` is set by the time the scope ends.
+ * With `UKV_TRACING` it also opens a `trace_span_t`, labeled with the
+ * number of `tasks` in the call.
+ */
+class metric_scope_t {
+    using clock_t = std::chrono::steady_clock;
+
+    metric_op_t op_;
+    ukv_error_t* error_;
+    bool enabled_;
+    std::uint64_t bytes_ = 0;
+    clock_t::time_point start_;
+    trace_span_t span_;
+
+  public:
+    metric_scope_t(metric_op_t op, ukv_error_t* error, std::size_t tasks = 0) noexcept
+        : op_(op), error_(error), enabled_(metrics_enabled()), span_(metric_name(op), metric_layer(op), tasks) {
+        if (enabled_)
+            start_ = clock_t::now();
+    }
+    metric_scope_t(metric_scope_t const&) = delete;
+    metric_scope_t& operator=(metric_scope_t const&) = delete;
+
+    ~metric_scope_t() noexcept { stop(); }
+
+    /// Records the call before the end of the scope, if the rest shouldn't be timed.
+    void stop() noexcept {
+        span_.stop();
+        if (!enabled_)
+            return;
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - start_).count();
+        record_metric(op_, static_cast<std::uint64_t>(nanos), error_ && *error_, bytes_);
+        enabled_ = false;
+    }
+
+    /// Whether the bytes and other details are worth counting.
+    bool enabled() const noexcept { return enabled_ || tracing_k; }
+    void add_bytes(std::size_t bytes) noexcept {
+        bytes_ += bytes;
+        span_.add_bytes(bytes);
+    }
+};
+
+} // namespace unum::ukv
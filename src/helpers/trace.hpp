@@ -0,0 +1,90 @@
+/**
+ * @file trace.hpp
+ * @author Ashot Vardanian
+ *
+ * @brief Nested trace spans, compiled out unless built with `UKV_TRACING`.
+ *
+ * Every finished span is appended into a ring buffer of its thread,
+ * overwriting the oldest ones. `ukv_metrics()` dumps the recent spans of
+ * all threads in the Chrome Trace Event format, which can be opened with
+ * "chrome://tracing" or "ui.perfetto.dev". Spans of nested calls, like
+ * `ukv_graph_upsert_edges` calling `ukv_read` and `ukv_write`, are shown
+ * as a call tree.
+ */
+#pragma once
+#include <cstddef> // `std::size_t`
+#include <cstdint> // `std::uint64_t`
+
+namespace unum::ukv {
+
+struct trace_event_t {
+    /// Static string, like "read" or "update_neighborhoods".
+    char const* name = nullptr;
+    /// Static string, like "api", "engine" or "internal".
+    char const* category = nullptr;
+    std::uint64_t start_nanos = 0;
+    std::uint64_t duration_nanos = 0;
+    std::uint64_t tasks = 0;
+    std::uint64_t bytes = 0;
+    /// Number of spans, that were open on this thread, when this one started.
+    std::uint32_t depth = 0;
+};
+
+#if defined(UKV_TRACING)
+
+static constexpr bool tracing_k = true;
+
+std::uint64_t trace_now() noexcept;
+/// Opens a span on the current thread, returning its depth.
+std::uint32_t trace_enter() noexcept;
+/// Closes the last span of the current thread and appends it into its ring.
+void trace_exit(trace_event_t const& event) noexcept;
+
+class trace_span_t {
+    trace_event_t event_;
+    bool open_ = true;
+
+  public:
+    trace_span_t(char const* name, char const* category = "internal", std::size_t tasks = 0) noexcept {
+        event_.name = name;
+        event_.category = category;
+        event_.tasks = tasks;
+        event_.depth = trace_enter();
+        event_.start_nanos = trace_now();
+    }
+    trace_span_t(trace_span_t const&) = delete;
+    trace_span_t& operator=(trace_span_t const&) = delete;
+
+    ~trace_span_t() noexcept { stop(); }
+
+    void stop() noexcept {
+        if (!open_)
+            return;
+        event_.duration_nanos = trace_now() - event_.start_nanos;
+        trace_exit(event_);
+        open_ = false;
+    }
+
+    void add_tasks(std::size_t tasks) noexcept { event_.tasks += tasks; }
+    void add_bytes(std::size_t bytes) noexcept { event_.bytes += bytes; }
+};
+
+#else
+
+static constexpr bool tracing_k = false;
+
+/// Compiled out, so that all the calls are inlined into nothing.
+class trace_span_t {
+  public:
+    trace_span_t(char const*, char const* = nullptr, std::size_t = 0) noexcept {}
+    trace_span_t(trace_span_t const&) = delete;
+    trace_span_t& operator=(trace_span_t const&) = delete;
+
+    void stop() noexcept {}
+    void add_tasks(std::size_t) noexcept {}
+    void add_bytes(std::size_t) noexcept {}
+};
+
+#endif
+
+} // namespace unum::ukv
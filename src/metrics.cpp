@@ -0,0 +1,316 @@
+/**
+ * @file metrics.cpp
+ * @author Ashot Vardanian
+ *
+ * @brief Instrumentation layer, shared by all the engines.
+ * Aggregates the per-thread counters from "helpers/metrics.hpp" and
+ * exports them in the Prometheus text exposition format. If built with
+ * `UKV_TRACING`, also keeps the per-thread rings of "helpers/trace.hpp"
+ * and exports them in the Chrome Trace Event format.
+ */
+#include <cstdarg>   // `va_list`
+#include <cstdio>    // `std::vsnprintf`
+#include <cstdlib>   // `std::getenv`
+#include <cstring>   // `std::memcpy`
+#include <algorithm> // `std::clamp`
+#include <memory>    // `std::unique_ptr`
+#include <mutex>     // `std::mutex`
+#include <string>    // `std::string`
+#include <vector>    // `std::vector`
+
+#include "ukv/db.h"
+#include "helpers/linked_memory.hpp" // `linked_memory_lock_t`
+#include "helpers/metrics.hpp"       // `thread_metrics_t`
+
+/*********************************************************/
+/*****************	 C++ Implementation	  ****************/
+/*********************************************************/
+
+using namespace unum::ukv;
+using namespace unum;
+
+static constexpr std::size_t metric_ops_k = static_cast<std::size_t>(metric_op_t::count_k);
+static constexpr double metric_quantiles_k[] = {0.5, 0.9, 0.99, 0.999};
+
+static std::atomic<bool> metrics_collected {std::getenv("UKV_METRICS") != nullptr};
+
+/**
+ * @brief Owns the counters of every thread, that has ever recorded anything.
+ * Counters of finished threads are handed to new ones, instead of being
+ * freed, so the totals never go down and the memory usage stays bounded
+ * by the peak number of concurrent threads.
+ * Never destroyed, as detached threads may record during the shutdown.
+ */
+template <typename per_thread_at>
+struct thread_registry_gt {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<per_thread_at>> all;
+    std::vector<per_thread_at*> released;
+
+    static thread_registry_gt& global() noexcept {
+        static thread_registry_gt* registry = new thread_registry_gt;
+        return *registry;
+    }
+};
+
+template <typename per_thread_at>
+struct thread_slot_gt {
+    using registry_t = thread_registry_gt<per_thread_at>;
+    per_thread_at* owned = nullptr;
+
+    ~thread_slot_gt() noexcept {
+        if (!owned)
+            return;
+        registry_t& registry = registry_t::global();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.released.push_back(owned);
+    }
+
+    per_thread_at* acquire() noexcept {
+        if (owned)
+            return owned;
+
+        registry_t& registry = registry_t::global();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        try {
+            if (!registry.released.empty()) {
+                owned = registry.released.back();
+                registry.released.pop_back();
+            }
+            else {
+                registry.all.push_back(std::make_unique<per_thread_at>());
+                owned = registry.all.back().get();
+            }
+        }
+        catch (...) {
+        }
+        return owned;
+    }
+};
+
+using metrics_registry_t = thread_registry_gt<thread_metrics_t>;
+static thread_local thread_slot_gt<thread_metrics_t> thread_metrics_slot;
+
+/// Only the owning thread updates its counters, so a plain store is enough.
+static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+bool unum::ukv::metrics_enabled() noexcept {
+    return metrics_collected.load(std::memory_order_relaxed);
+}
+
+void unum::ukv::record_metric(metric_op_t op, std::uint64_t nanos, bool failed, std::uint64_t bytes) noexcept {
+    thread_metrics_t* metrics = thread_metrics_slot.acquire();
+    if (!metrics)
+        return;
+
+    metric_counters_t& counters = metrics->ops[static_cast<std::size_t>(op)];
+    bump(counters.calls, 1);
+    bump(counters.errors, failed);
+    bump(counters.bytes, bytes);
+    bump(counters.nanos, nanos);
+    bump(counters.latencies[latency_buckets_t::index(nanos)], 1);
+}
+
+/// Sums of the counters of every thread, for a single operation.
+struct metric_totals_t {
+    std::uint64_t calls = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t nanos = 0;
+    std::array<std::uint64_t, latency_buckets_t::count_k> latencies {};
+
+    double quantile_seconds(double quantile) const noexcept {
+        auto const rank = static_cast<std::uint64_t>(quantile * calls);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i != latencies.size(); ++i) {
+            seen += latencies[i];
+            if (seen > rank)
+                return latency_buckets_t::upper_bound(i) / 1e9;
+        }
+        return latency_buckets_t::upper_bound(latencies.size() - 1) / 1e9;
+    }
+};
+
+static std::vector<metric_totals_t> sum_metrics() noexcept(false) {
+    std::vector<metric_totals_t> totals(metric_ops_k);
+    metrics_registry_t& registry = metrics_registry_t::global();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto const& metrics : registry.all) {
+        for (std::size_t op = 0; op != metric_ops_k; ++op) {
+            metric_counters_t const& counters = metrics->ops[op];
+            metric_totals_t& total = totals[op];
+            total.calls += counters.calls.load(std::memory_order_relaxed);
+            total.errors += counters.errors.load(std::memory_order_relaxed);
+            total.bytes += counters.bytes.load(std::memory_order_relaxed);
+            total.nanos += counters.nanos.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i != latency_buckets_t::count_k; ++i)
+                total.latencies[i] += counters.latencies[i].load(std::memory_order_relaxed);
+        }
+    }
+    return totals;
+}
+
+static void append_line(std::string& text, char const* format, ...) noexcept(false) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    text.append(line, static_cast<std::size_t>(std::clamp<int>(length, 0, sizeof(line) - 1)));
+}
+
+static std::string export_prometheus(std::vector<metric_totals_t> const& totals) noexcept(false) {
+    std::string text;
+    auto for_each_called = [&](auto callback) {
+        for (std::size_t op = 0; op != metric_ops_k; ++op)
+            if (totals[op].calls)
+                callback(metric_name(static_cast<metric_op_t>(op)),
+                         metric_layer(static_cast<metric_op_t>(op)),
+                         totals[op]);
+    };
+
+    text += "# HELP ukv_calls_total Number of completed calls.\n# TYPE ukv_calls_total counter\n";
+    for_each_called([&](char const* name, char const* layer, metric_totals_t const& total) {
+        append_line(text, "ukv_calls_total{op=\"%s\",layer=\"%s\"} %lu\n", name, layer, total.calls);
+    });
+    text += "# HELP ukv_errors_total Number of failed calls.\n# TYPE ukv_errors_total counter\n";
+    for_each_called([&](char const* name, char const* layer, metric_totals_t const& total) {
+        append_line(text, "ukv_errors_total{op=\"%s\",layer=\"%s\"} %lu\n", name, layer, total.errors);
+    });
+    text += "# HELP ukv_bytes_total Bytes of values passed.\n# TYPE ukv_bytes_total counter\n";
+    for_each_called([&](char const* name, char const* layer, metric_totals_t const& total) {
+        append_line(text, "ukv_bytes_total{op=\"%s\",layer=\"%s\"} %lu\n", name, layer, total.bytes);
+    });
+    text += "# HELP ukv_latency_seconds Latency of calls.\n# TYPE ukv_latency_seconds summary\n";
+    for_each_called([&](char const* name, char const* layer, metric_totals_t const& total) {
+        for (double quantile : metric_quantiles_k)
+            append_line(text,
+                        "ukv_latency_seconds{op=\"%s\",layer=\"%s\",quantile=\"%g\"} %.9f\n",
+                        name,
+                        layer,
+                        quantile,
+                        total.quantile_seconds(quantile));
+        append_line(text, "ukv_latency_seconds_sum{op=\"%s\",layer=\"%s\"} %.9f\n", name, layer, total.nanos / 1e9);
+        append_line(text, "ukv_latency_seconds_count{op=\"%s\",layer=\"%s\"} %lu\n", name, layer, total.calls);
+    });
+    return text;
+}
+
+#if defined(UKV_TRACING)
+
+/**
+ * @brief Ring of the latest finished spans of a single thread.
+ * Only the owning thread appends, but the mutex lets `ukv_metrics()`
+ * copy the events of threads, that are still running.
+ */
+struct trace_ring_t {
+    static constexpr std::size_t capacity_k = 4096;
+
+    std::mutex mutex;
+    std::uint32_t thread_id = 0;
+    /// Number of open spans, only accessed by the owning thread.
+    std::uint32_t depth = 0;
+    std::uint64_t pushed = 0;
+    std::array<trace_event_t, capacity_k> events;
+
+    trace_ring_t() noexcept {
+        static std::atomic<std::uint32_t> rings {0};
+        thread_id = ++rings;
+    }
+};
+
+using trace_registry_t = thread_registry_gt<trace_ring_t>;
+static thread_local thread_slot_gt<trace_ring_t> thread_trace_slot;
+
+std::uint64_t unum::ukv::trace_now() noexcept {
+    auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count());
+}
+
+std::uint32_t unum::ukv::trace_enter() noexcept {
+    trace_ring_t* ring = thread_trace_slot.acquire();
+    return ring ? ring->depth++ : 0;
+}
+
+void unum::ukv::trace_exit(trace_event_t const& event) noexcept {
+    trace_ring_t* ring = thread_trace_slot.acquire();
+    if (!ring)
+        return;
+    --ring->depth;
+    std::lock_guard<std::mutex> lock(ring->mutex);
+    ring->events[ring->pushed % trace_ring_t::capacity_k] = event;
+    ++ring->pushed;
+}
+
+static std::string export_chrome_trace() noexcept(false) {
+    std::string text = "{\"traceEvents\":[";
+    char const* separator = "\n";
+    trace_registry_t& registry = trace_registry_t::global();
+    std::lock_guard<std::mutex> registry_lock(registry.mutex);
+    for (auto const& ring : registry.all) {
+        std::lock_guard<std::mutex> ring_lock(ring->mutex);
+        std::uint64_t count = std::min<std::uint64_t>(ring->pushed, trace_ring_t::capacity_k);
+        for (std::uint64_t i = ring->pushed - count; i != ring->pushed; ++i) {
+            trace_event_t const& event = ring->events[i % trace_ring_t::capacity_k];
+            append_line(text,
+                        "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,"
+                        "\"tid\":%u,\"args\":{\"tasks\":%lu,\"bytes\":%lu,\"depth\":%u}}",
+                        separator,
+                        event.name,
+                        event.category,
+                        event.start_nanos / 1e3,
+                        event.duration_nanos / 1e3,
+                        ring->thread_id,
+                        event.tasks,
+                        event.bytes,
+                        event.depth);
+            separator = ",\n";
+        }
+    }
+    text += "\n]}\n";
+    return text;
+}
+
+#else
+
+static std::string export_chrome_trace() noexcept(false) {
+    return "{\"traceEvents\":[]}\n";
+}
+
+#endif
+
+/// Copies the `text` into the `arena`, so that it outlives the call.
+static ukv_str_view_t export_text(std::string const& text, linked_memory_lock_t& arena, ukv_error_t* c_error) {
+    auto exported = arena.alloc<char>(text.size() + 1, c_error);
+    if (*c_error)
+        return nullptr;
+    std::memcpy(exported.begin(), text.c_str(), text.size() + 1);
+    return exported.begin();
+}
+
+/*********************************************************/
+/*****************	    C Interface 	  ****************/
+/*********************************************************/
+
+void ukv_metrics(ukv_metrics_t* c_ptr) {
+
+    ukv_metrics_t& c = *c_ptr;
+    return_error_if_m(c.db, c.error, uninitialized_state_k, "DataBase is uninitialized");
+
+    metrics_collected.store(c.collect, std::memory_order_relaxed);
+    if (!c.prometheus && !c.chrome_trace)
+        return;
+
+    linked_memory_lock_t arena = linked_memory(c.arena, ukv_options_default_k, c.error);
+    return_if_error_m(c.error);
+
+    safe_section("Exporting metrics", c.error, [&] {
+        if (c.prometheus)
+            *c.prometheus = export_text(export_prometheus(sum_metrics()), arena, c.error);
+        return_if_error_m(c.error);
+        if (c.chrome_trace)
+            *c.chrome_trace = export_text(export_chrome_trace(), arena, c.error);
+    });
+}
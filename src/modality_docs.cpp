@@ -1410,6 +1410,8 @@ void read_modify_docs( //
     ukv_error_t* c_error,
     callback_at callback) {
 
+    trace_span_t span("read_modify_docs", "internal", places.count);
+
     // Handle the common case of requesting the non-colliding
     // all-ascending input sequences of document IDs received
     // during scans without the sort and extra memory.
@@ -1502,6 +1504,7 @@ void read_modify_write( //
     linked_memory_lock_t& arena,
     ukv_error_t* c_error) noexcept {
 
+    trace_span_t span("read_modify_write", "internal", places.size());
     growing_tape_t growing_tape {arena};
     growing_tape.reserve(places.size(), c_error);
     return_if_error_m(c_error);
@@ -1558,6 +1561,7 @@ void read_modify_write( //
 void ukv_docs_write(ukv_docs_write_t* c_ptr) {
 
     ukv_docs_write_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::docs_write_k, c.error, c.tasks_count);
     if (!c.tasks_count)
         return;
 
@@ -1633,6 +1637,7 @@ void ukv_docs_write(ukv_docs_write_t* c_ptr) {
 void ukv_docs_read(ukv_docs_read_t* c_ptr) {
 
     ukv_docs_read_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::docs_read_k, c.error, c.tasks_count);
     if (!c.tasks_count)
         return;
 
@@ -1812,6 +1817,7 @@ void gist_recursively(yyjson_val* node,
 void ukv_docs_gist(ukv_docs_gist_t* c_ptr) {
 
     ukv_docs_gist_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::docs_gist_k, c.error, c.docs_count);
     if (!c.docs_count)
         return;
 
@@ -1958,6 +1964,7 @@ struct column_begin_t {
 void ukv_docs_gather(ukv_docs_gather_t* c_ptr) {
 
     ukv_docs_gather_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::docs_gather_k, c.error, c.docs_count);
     if (!c.docs_count || !c.fields_count)
         return;
 
@@ -435,6 +435,8 @@ void pull_and_link_for_updates( //
     linked_memory_lock_t& arena,
     ukv_error_t* c_error) {
 
+    trace_span_t span("pull_and_link_for_updates", "internal", unique_entries.size());
+
     // Fetch the existing entries
     ukv_bytes_ptr_t found_binary_begin = nullptr;
     ukv_length_t* found_binary_offs = nullptr;
@@ -491,6 +493,9 @@ void update_neighborhoods( //
     linked_memory_lock_t& arena,
     ukv_error_t* c_error) {
 
+    trace_span_t span(erase_ak ? "update_neighborhoods<erase>" : "update_neighborhoods<insert>",
+                      "internal",
+                      c_tasks_count);
     strided_iterator_gt<ukv_collection_t const> edge_collections {c_collections, c_collections_stride};
     strided_iterator_gt<ukv_key_t const> edges_ids {c_edges_ids, c_edges_stride};
     strided_iterator_gt<ukv_key_t const> sources_ids {c_sources_ids, c_sources_stride};
@@ -589,6 +594,7 @@ void update_neighborhoods( //
 void ukv_graph_find_edges(ukv_graph_find_edges_t* c_ptr) {
 
     ukv_graph_find_edges_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::graph_find_edges_k, c.error, c.tasks_count);
     if (!c.tasks_count)
         return;
 
@@ -620,6 +626,7 @@ void ukv_graph_find_edges(ukv_graph_find_edges_t* c_ptr) {
 void ukv_graph_upsert_edges(ukv_graph_upsert_edges_t* c_ptr) {
 
     ukv_graph_upsert_edges_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::graph_upsert_edges_k, c.error, c.tasks_count);
     if (!c.tasks_count)
         return;
 
@@ -646,6 +653,7 @@ void ukv_graph_upsert_edges(ukv_graph_upsert_edges_t* c_ptr) {
 void ukv_graph_remove_edges(ukv_graph_remove_edges_t* c_ptr) {
 
     ukv_graph_remove_edges_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::graph_remove_edges_k, c.error, c.tasks_count);
     if (!c.tasks_count)
         return;
 
@@ -672,6 +680,7 @@ void ukv_graph_remove_edges(ukv_graph_remove_edges_t* c_ptr) {
 void ukv_graph_upsert_vertices(ukv_graph_upsert_vertices_t* c_ptr) {
 
     ukv_graph_upsert_vertices_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::graph_upsert_vertices_k, c.error, c.tasks_count);
     if (!c.tasks_count)
         return;
 
@@ -726,6 +735,7 @@ void ukv_graph_upsert_vertices(ukv_graph_upsert_vertices_t* c_ptr) {
 void ukv_graph_remove_vertices(ukv_graph_remove_vertices_t* c_ptr) {
 
     ukv_graph_remove_vertices_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::graph_remove_vertices_k, c.error, c.tasks_count);
     if (!c.tasks_count)
         return;
 
@@ -247,6 +247,7 @@ void upsert_in_bucket( //
 void ukv_paths_write(ukv_paths_write_t* c_ptr) {
 
     ukv_paths_write_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::paths_write_k, c.error, c.tasks_count);
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
     return_if_error_m(c.error);
 
@@ -350,6 +351,7 @@ void ukv_paths_write(ukv_paths_write_t* c_ptr) {
 void ukv_paths_read(ukv_paths_read_t* c_ptr) {
 
     ukv_paths_read_t& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::paths_read_k, c.error, c.tasks_count);
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
     return_if_error_m(c.error);
 
@@ -607,6 +609,7 @@ void full_scan_w_regex( //
 void ukv_paths_match(ukv_paths_match_t* c_ptr) {
 
     ukv_paths_match_t const& c = *c_ptr;
+    metric_scope_t metric(metric_op_t::paths_match_k, c.error, c.tasks_count);
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
     return_if_error_m(c.error);
 
@@ -156,6 +156,7 @@ struct vectors_arg_t {
 void ukv_vectors_write(ukv_vectors_write_t* c_ptr) {
 
     ukv_vectors_write_t& c = *c_ptr;
+    metric_scope_t timing(metric_op_t::vectors_write_k, c.error, c.tasks_count);
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
     return_if_error_m(c.error);
 
@@ -277,6 +278,7 @@ void ukv_vectors_write(ukv_vectors_write_t* c_ptr) {
 void ukv_vectors_read(ukv_vectors_read_t* c_ptr) {
 
     ukv_vectors_read_t& c = *c_ptr;
+    metric_scope_t timing(metric_op_t::vectors_read_k, c.error, c.tasks_count);
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
     return_if_error_m(c.error);
 
@@ -311,6 +313,7 @@ void ukv_vectors_read(ukv_vectors_read_t* c_ptr) {
 void ukv_vectors_search(ukv_vectors_search_t* c_ptr) {
 
     ukv_vectors_search_t const& c = *c_ptr;
+    metric_scope_t timing(metric_op_t::vectors_search_k, c.error, c.tasks_count);
     linked_memory_lock_t arena = linked_memory(c.arena, c.options, c.error);
     return_if_error_m(c.error);
 
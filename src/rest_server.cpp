@@ -9,11 +9,19 @@
  */
 
 #include <cstdlib>
+#include <cstring>
+#include <climits>  // `CHAR_BIT`
+#include <limits>
 #include <memory>
+#include <memory_resource> // `std::pmr::monotonic_buffer_resource`
+#include <optional>
+#include <array>
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <functional>
+#include <deque>    // Pipelined responses
+#include <cctype>   // `std::isspace`
 #include <thread>   // Thread pool
 #include <charconv> // Parsing integers
 #include <iostream> // Logging to `std::cerr`
@@ -46,7 +54,10 @@
 #elif defined(_MSC_VER)
 #endif
 
+#include <nlohmann/json.hpp>
+
 #include "ukv/ukv.hpp"
+#include "ukv/media.h" // `ukv_format_field_type_t`
 
 namespace beast = boost::beast;   // from <boost/beast.hpp>
 namespace http = beast::http;     // from <boost/beast/http.hpp>
@@ -55,6 +66,7 @@ using tcp = boost::asio::ip::tcp; // from <boost/asio/ip/tcp.hpp>
 
 using namespace unum::ukv;
 using namespace unum;
+using json_t = nlohmann::json;
 
 static constexpr char const* server_name_k = "unum-cloud/ukv/beast_server";
 static constexpr char const* mime_binary_k = "application/octet-stream";
@@ -63,8 +75,44 @@ static constexpr char const* mime_msgpack_k = "application/msgpack";
 static constexpr char const* mime_cbor_k = "application/cbor";
 static constexpr char const* mime_bson_k = "application/bson";
 static constexpr char const* mime_ubjson_k = "application/ubjson";
+static constexpr char const* mime_ndjson_k = "application/x-ndjson";
+
+/**
+ * @brief Number of entries fetched from the DB per chunk of a streamed response.
+ * Every chunk costs exactly one `ukv_read` or `ukv_scan` call.
+ */
+static constexpr std::size_t stream_page_entries_k = 4096;
+
+/**
+ * @brief Number of pipelined HTTP/1.1 requests a single connection can have
+ * in flight, before we stop reading new ones and wait for responses to drain.
+ */
+static constexpr std::size_t pipeline_depth_k = 16;
+
+/**
+ * @brief Number of idle arenas every I/O thread keeps warm for the next requests.
+ */
+static constexpr std::size_t arenas_per_thread_k = 64;
+
+/**
+ * @brief Initial capacity of the per-connection buffers for headers and bodies.
+ * Most requests fit, so their parsing doesn't touch the global allocator.
+ */
+static constexpr std::size_t request_buffer_size_k = 16 * 1024;
+
+/**
+ * @brief Default upper bound for request bodies, as Beast would otherwise reject
+ * anything above 1 MB. Can be overridden by the last command-line argument.
+ */
+static constexpr std::uint64_t body_limit_k = 64ul * 1024ul * 1024ul;
+
+/**
+ * @brief Idle connections are dropped after this long, whether we are waiting
+ * for the next request, or for the client to accept the bytes of a response.
+ */
+static constexpr std::chrono::seconds session_timeout_k {30};
 
-ukv_doc_field_type_t mime_to_format(beast::string_view mime) {
+ukv_format_field_type_t mime_to_format(beast::string_view mime) {
     if (mime == mime_json_k)
         return ukv_field_json_k;
     else if (mime == "application/json-patch+json")
@@ -82,12 +130,77 @@ ukv_doc_field_type_t mime_to_format(beast::string_view mime) {
     else if (mime == "application/vnd.apache.parquet")
         return ukv_format_parquet_k;
     else
-        return ukv_doc_field_default_k;
+        return ukv_format_field_default_k;
 }
 
 struct db_w_clients_t : public std::enable_shared_from_this<db_w_clients_t> {
     database_t session;
-    int running_transactions;
+    int running_transactions = 0;
+};
+
+/**
+ * @brief Arena, borrowed from a pool local to the current I/O thread.
+ * Returns into the pool of whichever thread releases it, so the
+ * memory chunks of an arena stay warm from one request to the next.
+ */
+class pooled_arena_t {
+
+    struct pool_t {
+        std::vector<ukv_arena_t> arenas;
+        pool_t() { arenas.reserve(arenas_per_thread_k); }
+        ~pool_t() {
+            for (ukv_arena_t arena : arenas)
+                ukv_arena_free(arena);
+        }
+    };
+
+    static pool_t& local_pool() noexcept {
+        thread_local pool_t pool;
+        return pool;
+    }
+
+    ukv_arena_t raw_ = nullptr;
+
+  public:
+    pooled_arena_t() noexcept {
+        auto& arenas = local_pool().arenas;
+        if (arenas.empty())
+            return;
+        raw_ = arenas.back();
+        arenas.pop_back();
+    }
+
+    ~pooled_arena_t() noexcept {
+        if (!raw_)
+            return;
+        auto& arenas = local_pool().arenas;
+        if (arenas.size() < arenas_per_thread_k) {
+            // Keep only the first chunk warm, returning the rest into the shared pool
+            ukv_arena_trim(raw_);
+            arenas.push_back(raw_);
+        }
+        else
+            ukv_arena_free(raw_);
+    }
+
+    pooled_arena_t(pooled_arena_t const&) = delete;
+    pooled_arena_t& operator=(pooled_arena_t const&) = delete;
+    pooled_arena_t(pooled_arena_t&& other) noexcept : raw_(std::exchange(other.raw_, nullptr)) {}
+    pooled_arena_t& operator=(pooled_arena_t&& other) noexcept {
+        std::swap(raw_, other.raw_);
+        return *this;
+    }
+
+    ukv_arena_t* member_ptr() noexcept { return &raw_; }
+};
+
+/**
+ * @brief A response with a body, that points to a value in an arena.
+ * The arena travels with the response, until the last byte is sent.
+ */
+struct arena_response_t {
+    http::response<http::buffer_body> message;
+    pooled_arena_t arena;
 };
 
 void log_failure(beast::error_code ec, char const* what) {
@@ -115,32 +228,253 @@ http::response<http::string_body> make_error(http::request<body_at, http::basic_
  */
 std::optional<beast::string_view> param_value(beast::string_view query_params, beast::string_view param_name) {
 
-    auto key_begin = std::search(query_params.begin(), query_params.end(), param_name.begin(), param_name.end());
-    if (key_begin == query_params.end())
-        return std::nullopt;
-
-    char preceding_char = *(key_begin - 1);
-    bool isnt_part_of_bigger_key = (preceding_char != '?') & (preceding_char != '&') & (preceding_char != '/');
-    if (!isnt_part_of_bigger_key)
-        return std::nullopt;
+    auto key_begin = query_params.begin();
+    while (true) {
+        key_begin = std::search(key_begin, query_params.end(), param_name.begin(), param_name.end());
+        if (key_begin == query_params.end())
+            return std::nullopt;
+
+        char preceding_char = key_begin == query_params.begin() ? '?' : *(key_begin - 1);
+        bool is_part_of_bigger_key = (preceding_char != '?') & (preceding_char != '&') & (preceding_char != '/');
+        if (!is_part_of_bigger_key)
+            break;
+        ++key_begin;
+    }
 
     auto value_begin = key_begin + param_name.size();
     auto value_end = std::find(value_begin, query_params.end(), '&');
     return beast::string_view {value_begin, static_cast<size_t>(value_end - value_begin)};
 }
 
+/**
+ * @brief Parses an optional integer query parameter, keeping the default if it's missing.
+ * @return `false` only if the parameter is present, but malformed.
+ */
+template <typename int_at>
+bool parse_param(beast::string_view query_params, beast::string_view param_name, int_at& result) {
+    auto param_val = param_value(query_params, param_name);
+    if (!param_val)
+        return true;
+    auto parse_result = std::from_chars(param_val->data(), param_val->data() + param_val->size(), result);
+    return parse_result.ec == std::errc() && parse_result.ptr == param_val->data() + param_val->size();
+}
+
+/**
+ * @brief Fills the next chunk of a streamed response, appending to the passed string.
+ * An empty chunk with a successful status marks the end of the stream.
+ * On failure the connection is dropped before the last chunk is sent,
+ * so clients can't mistake a truncated response for a complete one.
+ */
+using chunk_producer_t = std::function<status_t(std::string&)>;
+
+/**
+ * @brief A response with a body of unknown length, generated page-by-page
+ * and sent with "Transfer-Encoding: chunked" to HTTP/1.1 clients.
+ */
+struct streamed_response_t {
+    http::response<http::empty_body> head;
+    chunk_producer_t next_chunk;
+};
+
+template <typename body_at, typename allocator_at>
+streamed_response_t make_stream(http::request<body_at, http::basic_fields<allocator_at>> const& req,
+                                beast::string_view mime,
+                                chunk_producer_t next_chunk) {
+
+    http::response<http::empty_body> res {http::status::ok, req.version()};
+    res.set(http::field::server, server_name_k);
+    res.set(http::field::content_type, mime);
+    // HTTP/1.0 has no chunked encoding, so the end of the body is signaled by closing the connection.
+    bool supports_chunks = req.version() >= 11;
+    res.keep_alive(req.keep_alive() && supports_chunks);
+    res.chunked(supports_chunks);
+    return {std::move(res), std::move(next_chunk)};
+}
+
+/**
+ * @brief Streamed entries are either NDJSON objects, like `{"key":42,"value":"..."}`,
+ * or binary frames, if the client `Accept`s @c mime_binary_k. Every binary frame
+ * is an 8-byte key, followed by a 4-byte length, followed by that many bytes.
+ * Missing values have their length set to @c ukv_length_missing_k and no bytes.
+ */
+enum class stream_format_t {
+    ndjson_k,
+    binary_k,
+};
+
+template <typename body_at, typename allocator_at>
+stream_format_t accepted_format(http::request<body_at, http::basic_fields<allocator_at>> const& req) {
+    return req[http::field::accept] == mime_binary_k ? stream_format_t::binary_k : stream_format_t::ndjson_k;
+}
+
+/**
+ * @param value  Can be `NULL`, if the entry is missing.
+ * @param with_value Whether to export the value or just the key, like for key-only scans.
+ */
+void append_entry(std::string& chunk,
+                  stream_format_t format,
+                  ukv_key_t key,
+                  ukv_bytes_cptr_t value,
+                  ukv_length_t length,
+                  bool with_value) {
+
+    if (format == stream_format_t::binary_k) {
+        chunk.append(reinterpret_cast<char const*>(&key), sizeof(key));
+        if (!with_value)
+            return;
+        if (!value)
+            length = ukv_length_missing_k;
+        chunk.append(reinterpret_cast<char const*>(&length), sizeof(length));
+        if (value)
+            chunk.append(reinterpret_cast<char const*>(value), length);
+        return;
+    }
+
+    char key_buffer[24];
+    auto key_end = std::to_chars(key_buffer, key_buffer + sizeof(key_buffer), key).ptr;
+    chunk.append("{\"key\":");
+    chunk.append(key_buffer, key_end);
+    if (with_value) {
+        chunk.append(",\"value\":");
+        if (value)
+            chunk.append(json_t(std::string_view(reinterpret_cast<char const*>(value), length))
+                             .dump(-1, ' ', false, json_t::error_handler_t::replace));
+        else
+            chunk.append("null");
+    }
+    chunk.append("}\n");
+}
+
+/**
+ * @brief Parses integer keys from a JSON array, like `[1,2,3]`,
+ * or from NDJSON with one key per line.
+ */
+bool parse_keys(beast::string_view body, std::vector<ukv_key_t>& keys) {
+    char const* it = body.data();
+    char const* end = it + body.size();
+    while (it != end) {
+        if (*it == '[' || *it == ']' || *it == ',' || std::isspace(static_cast<unsigned char>(*it))) {
+            ++it;
+            continue;
+        }
+        ukv_key_t key = 0;
+        auto result = std::from_chars(it, end, key);
+        if (result.ec != std::errc())
+            return false;
+        keys.push_back(key);
+        it = result.ptr;
+    }
+    return true;
+}
+
+/**
+ * @brief Parses NDJSON upserts, one `{"key":42,"value":"..."}` object per line.
+ * Strings are stored as-is, `null`-s remove the entry, and other values
+ * are stored in their serialized JSON form.
+ *
+ * @param tape       Concatenated values, addressed by `offsets` and `lengths`.
+ * @param presences  Bitmask, where unset bits mark removals.
+ */
+bool parse_upserts(beast::string_view body,
+                   std::vector<ukv_key_t>& keys,
+                   std::string& tape,
+                   std::vector<ukv_length_t>& offsets,
+                   std::vector<ukv_length_t>& lengths,
+                   std::vector<ukv_octet_t>& presences) {
+
+    char const* it = body.data();
+    char const* end = it + body.size();
+    while (it != end) {
+        char const* line_end = std::find(it, end, '\n');
+        bool is_blank = std::all_of(it, line_end, [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+        if (is_blank) {
+            it = line_end + (line_end != end);
+            continue;
+        }
+
+        json_t line = json_t::parse(it, line_end, nullptr, false);
+        if (line.is_discarded() || !line.is_object())
+            return false;
+        auto key_it = line.find("key");
+        auto value_it = line.find("value");
+        if (key_it == line.end() || !key_it->is_number_integer() || value_it == line.end())
+            return false;
+
+        std::size_t idx = keys.size();
+        keys.push_back(key_it->get<ukv_key_t>());
+        presences.resize(idx / CHAR_BIT + 1);
+        offsets.push_back(static_cast<ukv_length_t>(tape.size()));
+        if (!value_it->is_null()) {
+            presences[idx / CHAR_BIT] |= static_cast<ukv_octet_t>(1u << (idx % CHAR_BIT));
+            if (value_it->is_string())
+                tape.append(value_it->get_ref<std::string const&>());
+            else
+                tape.append(value_it->dump());
+        }
+        lengths.push_back(static_cast<ukv_length_t>(tape.size() - offsets.back()));
+        it = line_end + (line_end != end);
+    }
+    return true;
+}
+
+/**
+ * @brief Resolves the collection name passed in the "col=" query parameter,
+ * defaulting to the main collection, if none is specified.
+ * Missing collections are created, as creating an existing one would fail.
+ */
+status_t find_collection(ukv_database_t db, beast::string_view params, ukv_collection_t& collection) {
+    status_t status;
+    collection = ukv_collection_main_k;
+    auto collection_val = param_value(params, "col=");
+    if (!collection_val || collection_val->empty())
+        return status;
+
+    pooled_arena_t arena;
+    ukv_size_t count = 0;
+    ukv_collection_t* ids = nullptr;
+    ukv_length_t* offsets = nullptr;
+    ukv_char_t* names = nullptr;
+    ukv_collection_list_t collection_list {};
+    collection_list.db = db;
+    collection_list.error = status.member_ptr();
+    collection_list.arena = arena.member_ptr();
+    collection_list.count = &count;
+    collection_list.ids = &ids;
+    collection_list.offsets = &offsets;
+    collection_list.names = &names;
+    ukv_collection_list(&collection_list);
+    if (!status)
+        return status;
+
+    std::string_view requested_name {collection_val->data(), collection_val->size()};
+    for (ukv_size_t i = 0; i != count; ++i) {
+        if (requested_name != std::string_view(names + offsets[i]))
+            continue;
+        collection = ids[i];
+        return status;
+    }
+
+    std::string name {requested_name};
+    ukv_collection_create_t collection_init {};
+    collection_init.db = db;
+    collection_init.error = status.member_ptr();
+    collection_init.name = name.c_str();
+    collection_init.id = &collection;
+    ukv_collection_create(&collection_init);
+    return status;
+}
+
 template <typename body_at, typename allocator_at, typename send_response_at>
-void respond_to_one(db_session_t& session,
+void respond_to_one(ukv_database_t db,
                     http::request<body_at, http::basic_fields<allocator_at>>&& req,
                     send_response_at&& send_response) {
 
     http::verb received_verb = req.method();
     beast::string_view received_path = req.target();
 
-    transaction_t txn(session.db());
-    blobs_collection_t collection;
+    ukv_collection_t collection = ukv_collection_main_k;
     ukv_key_t key = 0;
-    ukv_options_t options = ukv_options_default_k;
+    pooled_arena_t arena;
 
     // Parse the `key`
     auto key_begin = received_path.substr(5).begin();
@@ -159,22 +493,8 @@ void respond_to_one(db_session_t& session,
     }
 
     // Parse the collection name string.
-    if (auto collection_val = param_value(params_str, "col="); collection_val) {
-        char collection_name_buffer[65] = {0};
-        std::memcpy(collection_name_buffer, collection_val->data(), std::min(collection_val->size(), 64ul));
-
-        status_t status;
-        ukv_collection_create_t collection_init {
-            .db = session.db(),
-            .error = error.member_ptr(),
-            .name = collection_name_buffer,
-            .id = &collection.raw,
-        };
-
-        ukv_collection_create(&collection_init);
-        if (!status)
-            return send_response(make_error(req, http::status::internal_server_error, error.raw));
-    }
+    if (status_t status = find_collection(db, params_str, collection); !status)
+        return send_response(make_error(req, http::status::internal_server_error, status.message()));
 
     // Once we know, which collection, key and transaction user is
     // interested in - perform the actions depending on verbs.
@@ -183,73 +503,72 @@ void respond_to_one(db_session_t& session,
         // Read the data:
     case http::verb::get: {
 
-        arena_t tape(session.db());
         status_t status;
-        ukv_read_t read {
-            .db = session.db(),
-            .error = error.member_ptr(),
-            .transaction = txn.raw,
-            .options = options,
-            .collections = &collection.raw,
-            .keys = &key,
-            .keys_stride = 1,
-            .lengths = &tape.capacity,
-            .values = &tape.ptr,
-        };
+        ukv_length_t* found_lengths = nullptr;
+        ukv_byte_t* found_values = nullptr;
+        ukv_read_t read {};
+        read.db = db;
+        read.error = status.member_ptr();
+        read.arena = arena.member_ptr();
+        read.tasks_count = 1;
+        read.collections = &collection;
+        read.keys = &key;
+        read.lengths = &found_lengths;
+        read.values = &found_values;
 
         ukv_read(&read);
         if (!status)
-            return send_response(make_error(req, http::status::internal_server_error, error.raw));
+            return send_response(make_error(req, http::status::internal_server_error, status.message()));
 
-        ukv_bytes_ptr_t begin = tape.ptr + sizeof(ukv_length_t);
-        ukv_length_t len = reinterpret_cast<ukv_length_t*>(tape.ptr)[0];
-        if (!len)
+        ukv_length_t len = found_lengths[0];
+        if (len == ukv_length_missing_k)
             return send_response(make_error(req, http::status::not_found, "Missing key"));
 
+        // The body points straight into the arena, which we pass along with the
+        // response, instead of copying the value into a string.
         http::buffer_body::value_type body;
-        body.data = begin;
+        body.data = found_values;
         body.size = len;
         body.more = false;
 
-        http::response<http::buffer_body> res {
-            std::piecewise_construct,
-            std::make_tuple(std::move(body)),
-            std::make_tuple(http::status::ok, req.version()),
+        arena_response_t res {
+            http::response<http::buffer_body> {
+                std::piecewise_construct,
+                std::make_tuple(std::move(body)),
+                std::make_tuple(http::status::ok, req.version()),
+            },
+            std::move(arena),
         };
-        res.set(http::field::server, server_name_k);
-        res.set(http::field::content_type, mime_binary_k);
-        res.content_length(len);
-        res.keep_alive(req.keep_alive());
+        res.message.set(http::field::server, server_name_k);
+        res.message.set(http::field::content_type, mime_binary_k);
+        res.message.content_length(len);
+        res.message.keep_alive(req.keep_alive());
         return send_response(std::move(res));
     }
 
         // Check the data:
     case http::verb::head: {
 
-        arena_t tape(session.db());
         status_t status;
-        options = ukv_option_read_lengths_k;
-        ukv_read_t read {
-            .db = session.db(),
-            .transaction = txn.raw,
-            .collections = &collection.raw,
-            .keys = &key,
-            .keys_stride = 1,
-            .options = options,
-            .lengths = &tape.capacity,
-            .values = &tape.ptr,
-            .error = error.member_ptr(),
-        };
+        ukv_length_t* found_lengths = nullptr;
+        ukv_read_t read {};
+        read.db = db;
+        read.error = status.member_ptr();
+        read.arena = arena.member_ptr();
+        read.tasks_count = 1;
+        read.collections = &collection;
+        read.keys = &key;
+        read.lengths = &found_lengths;
 
         ukv_read(&read);
         if (!status)
-            return send_response(make_error(req, http::status::internal_server_error, error.raw));
+            return send_response(make_error(req, http::status::internal_server_error, status.message()));
 
-        ukv_length_t len = reinterpret_cast<ukv_length_t*>(tape.ptr)[0];
-        if (!len)
+        ukv_length_t len = found_lengths[0];
+        if (len == ukv_length_missing_k)
             return send_response(make_error(req, http::status::not_found, "Missing key"));
 
-        http::response<http::empty_body> res;
+        http::response<http::empty_body> res {http::status::ok, req.version()};
         res.set(http::field::server, server_name_k);
         res.set(http::field::content_type, mime_binary_k);
         res.content_length(len);
@@ -259,27 +578,23 @@ void respond_to_one(db_session_t& session,
 
     // Insert data if it's missing:
     case http::verb::post: {
-        arena_t tape(session.db());
+
         status_t status;
-        options = ukv_option_read_lengths_k;
-        ukv_read_t read {
-            .db = session.db(),
-            .transaction = txn.raw,
-            .collections = &collection.raw,
-            .keys = &key,
-            .keys_stride = 1,
-            .options = options,
-            .lengths = &tape.capacity,
-            .values = &tape.ptr,
-            .error = error.member_ptr(),
-        };
+        ukv_octet_t* found_presences = nullptr;
+        ukv_read_t read {};
+        read.db = db;
+        read.error = status.member_ptr();
+        read.arena = arena.member_ptr();
+        read.tasks_count = 1;
+        read.collections = &collection;
+        read.keys = &key;
+        read.presences = &found_presences;
 
         ukv_read(&read);
         if (!status)
-            return send_response(make_error(req, http::status::internal_server_error, error.raw));
+            return send_response(make_error(req, http::status::internal_server_error, status.message()));
 
-        ukv_length_t len = reinterpret_cast<ukv_length_t*>(tape.ptr)[0];
-        if (len)
+        if (found_presences[0] & 1)
             return send_response(make_error(req, http::status::conflict, "Duplicate key"));
 
         [[fallthrough]];
@@ -300,61 +615,46 @@ void respond_to_one(db_session_t& session,
                 make_error(req, http::status::unsupported_media_type, "Only binary payload is allowed"));
 
         status_t status;
-        auto value = req.body();
-        auto value_ptr = reinterpret_cast<ukv_bytes_ptr_t>(value.data());
+        auto value_ptr = reinterpret_cast<ukv_bytes_cptr_t>(req.body().data());
         auto value_len = static_cast<ukv_length_t>(*opt_payload_len);
-        ukv_length_t value_off = 0;
-
-        ukv_write_t write {
-            .db = session.db(),
-            .error = error.member_ptr(),
-            .transaction = txn.raw,
-            .options = options.collections = &collection.raw,
-            .keys = &key,
-            .keys_stride = 1,
-            .offsets = &value_off,
-            .lengths = &value_len,
-            .values = &value_ptr,
-        };
+        ukv_write_t write {};
+        write.db = db;
+        write.error = status.member_ptr();
+        write.arena = arena.member_ptr();
+        write.tasks_count = 1;
+        write.collections = &collection;
+        write.keys = &key;
+        write.lengths = &value_len;
+        write.values = &value_ptr;
 
         ukv_write(&write);
         if (!status)
-            return send_response(make_error(req, http::status::internal_server_error, error.raw));
+            return send_response(make_error(req, http::status::internal_server_error, status.message()));
 
-        http::response<http::empty_body> res;
+        http::response<http::empty_body> res {http::status::ok, req.version()};
         res.set(http::field::server, server_name_k);
-        res.set(http::field::content_type, mime_binary_k);
         res.keep_alive(req.keep_alive());
         return send_response(std::move(res));
     }
 
-        // Upsert data:
+        // Remove data:
     case http::verb::delete_: {
 
         status_t status;
-        ukv_bytes_ptr_t value_ptr = nullptr;
-        ukv_length_t value_len = 0;
-        ukv_length_t value_off = 0;
-
-        ukv_write_t write {
-            .db = session.db(),
-            .error = error.member_ptr(),
-            .transaction = txn.raw,
-            .options = options.collections = &collection.raw,
-            .keys = &key,
-            .keys_stride = 1,
-            .offsets = &value_off,
-            .lengths = &value_len,
-            .values = &value_ptr,
-        };
+        ukv_write_t write {};
+        write.db = db;
+        write.error = status.member_ptr();
+        write.arena = arena.member_ptr();
+        write.tasks_count = 1;
+        write.collections = &collection;
+        write.keys = &key;
 
         ukv_write(&write);
         if (!status)
-            return send_response(make_error(req, http::status::internal_server_error, error.raw));
+            return send_response(make_error(req, http::status::internal_server_error, status.message()));
 
-        http::response<http::empty_body> res;
+        http::response<http::empty_body> res {http::status::ok, req.version()};
         res.set(http::field::server, server_name_k);
-        res.set(http::field::content_type, mime_binary_k);
         res.keep_alive(req.keep_alive());
         return send_response(std::move(res));
     }
@@ -367,18 +667,12 @@ void respond_to_one(db_session_t& session,
 }
 
 template <typename body_at, typename allocator_at, typename send_response_at>
-void respond_to_aos(db_session_t& session,
+void respond_to_aos(ukv_database_t db,
                     http::request<body_at, http::basic_fields<allocator_at>>&& req,
                     send_response_at&& send_response) {
 
-    http::verb received_verb = req.method();
     beast::string_view received_path = req.target();
 
-    transaction_t txn(session.db());
-    std::vector<blobs_collection_t> collections(session.db());
-    ukv_options_t options = ukv_options_default_k;
-    std::vector<ukv_key_t> keys;
-
     // Parse the free-order parameters, starting with transaction identifier.
     auto params_begin = std::find(received_path.begin(), received_path.end(), '?');
     auto params_str = beast::string_view {params_begin, static_cast<size_t>(received_path.end() - params_begin)};
@@ -390,30 +684,12 @@ void respond_to_aos(db_session_t& session,
     }
 
     // Parse the collection name string.
-    if (auto collection_val = param_value(params_str, "col="); collection_val) {
-        char collection_name_buffer[65] = {0};
-        std::memcpy(collection_name_buffer, collection_val->data(), std::min(collection_val->size(), 64ul));
-
-        status_t status;
-        blobs_collection_t collection(session.db());
-        ukv_collection_create_t collection_init {
-            .db = session.db(),
-            .error = error.member_ptr(),
-            .name = collection_name_buffer,
-            .id = &collection.raw,
-        };
-
-        ukv_collection_create(&collection_init);
-        if (!status)
-            return send_response(make_error(req, http::status::internal_server_error, error.raw));
-
-        collections.raw_array.emplace_back(std::exchange(collection.raw, nullptr));
-        // ukv_option_read_colocated(&options, true);
-    }
+    ukv_collection_t collection = ukv_collection_main_k;
+    if (status_t status = find_collection(db, params_str, collection); !status)
+        return send_response(make_error(req, http::status::internal_server_error, status.message()));
 
     // Make sure we support the requested content type
     auto payload_type = req[http::field::content_type];
-    auto payload_format = mime_to_format(payload_type);
     if (payload_type != mime_json_k && payload_type != mime_msgpack_k && payload_type != mime_cbor_k &&
         payload_type != mime_bson_k && payload_type != mime_ubjson_k)
         return send_response(make_error(req,
@@ -425,12 +701,13 @@ void respond_to_aos(db_session_t& session,
     if (!opt_payload_len)
         return send_response(make_error(req, http::status::length_required, "Chunk Transfer Encoding isn't supported"));
 
+#if 0
     // Parse the payload, that will contain auxiliary data
+    auto payload_format = mime_to_format(payload_type);
     auto payload = req.body();
     auto payload_ptr = reinterpret_cast<char const*>(payload.data());
     auto payload_len = static_cast<ukv_size_t>(*opt_payload_len);
 
-#if 0
     // Once we know, which collection, key and transaction user is
     // interested in - perform the actions depending on verbs.
     //
@@ -527,7 +804,7 @@ void respond_to_aos(db_session_t& session,
         return send_response(make_error(req, http::status::bad_request, "Unsupported HTTP verb"));
     }
     }
-#endif
+
     // Export the response dictionary into the desired format
     std::string response_str;
     http::response<http::string_body> res {
@@ -540,6 +817,293 @@ void respond_to_aos(db_session_t& session,
     res.content_length(response_str.size());
     res.keep_alive(req.keep_alive());
     return send_response(std::move(res));
+#endif
+    return send_response(make_error(req, http::status::not_implemented, "Document batches aren't implemented yet"));
+}
+
+/**
+ * @brief Serves batches of entries, addressed by lists of keys, under "/batch/".
+ * Lists of keys can be passed as a JSON array or NDJSON body, or in the "keys=" parameter.
+ *
+ * - GET and POST stream back the values, fetching @c stream_page_entries_k per `ukv_read`.
+ * - PUT upserts NDJSON `{"key":42,"value":"..."}` lines in a single `ukv_write`.
+ * - DELETE removes all the listed keys in a single `ukv_write`.
+ */
+template <typename body_at, typename allocator_at, typename send_response_at>
+void respond_to_batch(ukv_database_t db,
+                      http::request<body_at, http::basic_fields<allocator_at>>&& req,
+                      send_response_at&& send_response) {
+
+    http::verb received_verb = req.method();
+    beast::string_view received_path = req.target();
+    auto params_begin = std::find(received_path.begin(), received_path.end(), '?');
+    auto params_str = beast::string_view {params_begin, static_cast<size_t>(received_path.end() - params_begin)};
+    auto payload = beast::string_view {req.body().data(), req.body().size()};
+    if (payload.empty())
+        payload = param_value(params_str, "keys=").value_or(beast::string_view {});
+
+    ukv_collection_t collection = ukv_collection_main_k;
+    if (status_t status = find_collection(db, params_str, collection); !status)
+        return send_response(make_error(req, http::status::internal_server_error, status.message()));
+
+    switch (received_verb) {
+
+        // Read the data:
+    case http::verb::get:
+    case http::verb::post: {
+
+        std::vector<ukv_key_t> keys;
+        if (!parse_keys(payload, keys))
+            return send_response(make_error(req, http::status::bad_request, "Couldn't parse the list of integer keys"));
+
+        stream_format_t format = accepted_format(req);
+        chunk_producer_t next_chunk = [=,
+                                       keys = std::move(keys),
+                                       arena = std::make_shared<pooled_arena_t>(),
+                                       passed_keys = std::size_t(0)](std::string& chunk) mutable -> status_t {
+            status_t status;
+            auto count = std::min(stream_page_entries_k, keys.size() - passed_keys);
+            if (!count)
+                return status;
+
+            ukv_length_t* found_offsets = nullptr;
+            ukv_length_t* found_lengths = nullptr;
+            ukv_byte_t* found_values = nullptr;
+            ukv_read_t read {};
+            read.db = db;
+            read.error = status.member_ptr();
+            read.arena = arena->member_ptr();
+            read.tasks_count = static_cast<ukv_size_t>(count);
+            read.collections = &collection;
+            read.keys = keys.data() + passed_keys;
+            read.keys_stride = sizeof(ukv_key_t);
+            read.offsets = &found_offsets;
+            read.lengths = &found_lengths;
+            read.values = &found_values;
+
+            ukv_read(&read);
+            if (!status)
+                return status;
+
+            for (std::size_t i = 0; i != count; ++i) {
+                bool is_present = found_lengths[i] != ukv_length_missing_k;
+                ukv_bytes_cptr_t value = is_present ? found_values + found_offsets[i] : nullptr;
+                append_entry(chunk, format, keys[passed_keys + i], value, found_lengths[i], true);
+            }
+            passed_keys += count;
+            return status;
+        };
+
+        auto mime = format == stream_format_t::binary_k ? mime_binary_k : mime_ndjson_k;
+        return send_response(make_stream(req, mime, std::move(next_chunk)));
+    }
+
+        // Upsert data:
+    case http::verb::put: {
+
+        std::vector<ukv_key_t> keys;
+        std::string tape;
+        std::vector<ukv_length_t> offsets;
+        std::vector<ukv_length_t> lengths;
+        std::vector<ukv_octet_t> presences;
+        if (!parse_upserts(payload, keys, tape, offsets, lengths, presences))
+            return send_response(make_error(req,
+                                            http::status::bad_request,
+                                            "PUT batches must be NDJSON objects with a \"key\" and a \"value\""));
+
+        status_t status;
+        pooled_arena_t arena;
+        auto tape_ptr = reinterpret_cast<ukv_bytes_cptr_t>(tape.data());
+        ukv_write_t write {};
+        write.db = db;
+        write.error = status.member_ptr();
+        write.arena = arena.member_ptr();
+        write.tasks_count = static_cast<ukv_size_t>(keys.size());
+        write.collections = &collection;
+        write.keys = keys.data();
+        write.keys_stride = sizeof(ukv_key_t);
+        write.presences = presences.data();
+        write.offsets = offsets.data();
+        write.offsets_stride = sizeof(ukv_length_t);
+        write.lengths = lengths.data();
+        write.lengths_stride = sizeof(ukv_length_t);
+        write.values = &tape_ptr;
+
+        if (!keys.empty())
+            ukv_write(&write);
+        if (!status)
+            return send_response(make_error(req, http::status::internal_server_error, status.message()));
+
+        http::response<http::empty_body> res {http::status::ok, req.version()};
+        res.set(http::field::server, server_name_k);
+        res.keep_alive(req.keep_alive());
+        return send_response(std::move(res));
+    }
+
+        // Remove data:
+    case http::verb::delete_: {
+
+        std::vector<ukv_key_t> keys;
+        if (!parse_keys(payload, keys))
+            return send_response(make_error(req, http::status::bad_request, "Couldn't parse the list of integer keys"));
+
+        status_t status;
+        pooled_arena_t arena;
+        ukv_write_t write {};
+        write.db = db;
+        write.error = status.member_ptr();
+        write.arena = arena.member_ptr();
+        write.tasks_count = static_cast<ukv_size_t>(keys.size());
+        write.collections = &collection;
+        write.keys = keys.data();
+        write.keys_stride = sizeof(ukv_key_t);
+
+        if (!keys.empty())
+            ukv_write(&write);
+        if (!status)
+            return send_response(make_error(req, http::status::internal_server_error, status.message()));
+
+        http::response<http::empty_body> res {http::status::ok, req.version()};
+        res.set(http::field::server, server_name_k);
+        res.keep_alive(req.keep_alive());
+        return send_response(std::move(res));
+    }
+
+    default: {
+        return send_response(make_error(req, http::status::bad_request, "Unsupported HTTP verb"));
+    }
+    }
+}
+
+/**
+ * @brief Streams ranges of keys, and optionally their values, under "/scan/".
+ *
+ * Query parameters:
+ * - "col=": Collection name, defaulting to the main one.
+ * - "min=": Inclusive lower bound for keys.
+ * - "max=": Exclusive upper bound for keys.
+ * - "limit=": Maximum number of entries to export.
+ * - "values": Flag, that makes us export values alongside keys.
+ *
+ * Every chunk of the response costs one `ukv_scan` of @c stream_page_entries_k
+ * keys, that also exports the values, if those were requested.
+ */
+template <typename body_at, typename allocator_at, typename send_response_at>
+void respond_to_scan(ukv_database_t db,
+                     http::request<body_at, http::basic_fields<allocator_at>>&& req,
+                     send_response_at&& send_response) {
+
+    if (req.method() != http::verb::get)
+        return send_response(make_error(req, http::status::bad_request, "Unsupported HTTP verb"));
+
+    beast::string_view received_path = req.target();
+    auto params_begin = std::find(received_path.begin(), received_path.end(), '?');
+    auto params_str = beast::string_view {params_begin, static_cast<size_t>(received_path.end() - params_begin)};
+
+    ukv_key_t min_key = std::numeric_limits<ukv_key_t>::min();
+    ukv_key_t max_key = std::numeric_limits<ukv_key_t>::max();
+    std::size_t limit = std::numeric_limits<std::size_t>::max();
+    if (!parse_param(params_str, "min=", min_key) || !parse_param(params_str, "max=", max_key) ||
+        !parse_param(params_str, "limit=", limit))
+        return send_response(make_error(req, http::status::bad_request, "Couldn't parse the range bounds"));
+    bool with_values = param_value(params_str, "values").has_value();
+
+    ukv_collection_t collection = ukv_collection_main_k;
+    if (status_t status = find_collection(db, params_str, collection); !status)
+        return send_response(make_error(req, http::status::internal_server_error, status.message()));
+
+    stream_format_t format = accepted_format(req);
+    chunk_producer_t next_chunk = [=,
+                                   arena = std::make_shared<pooled_arena_t>(),
+                                   next_key = min_key,
+                                   remaining = limit](std::string& chunk) mutable -> status_t {
+        status_t status;
+        if (!remaining || next_key >= max_key)
+            return status;
+
+        auto count_limit = static_cast<ukv_length_t>(std::min(stream_page_entries_k, remaining));
+        ukv_length_t* found_counts = nullptr;
+        ukv_key_t* found_keys = nullptr;
+        ukv_length_t* found_offsets = nullptr;
+        ukv_length_t* found_lengths = nullptr;
+        ukv_byte_t* found_values = nullptr;
+        ukv_scan_t scan {};
+        scan.db = db;
+        scan.error = status.member_ptr();
+        scan.arena = arena->member_ptr();
+        scan.tasks_count = 1;
+        scan.collections = &collection;
+        scan.start_keys = &next_key;
+        scan.count_limits = &count_limit;
+        scan.counts = &found_counts;
+        scan.keys = &found_keys;
+        scan.values_offsets = with_values ? &found_offsets : nullptr;
+        scan.values_lengths = with_values ? &found_lengths : nullptr;
+        scan.values = with_values ? &found_values : nullptr;
+
+        ukv_scan(&scan);
+        if (!status)
+            return status;
+
+        // The scan isn't bounded from above, so trim the keys beyond the range.
+        auto count = static_cast<ukv_length_t>(std::lower_bound(found_keys, found_keys + found_counts[0], max_key) -
+                                               found_keys);
+        if (!count) {
+            remaining = 0;
+            return status;
+        }
+
+        for (ukv_length_t i = 0; i != count; ++i) {
+            ukv_bytes_cptr_t value = with_values ? found_values + found_offsets[i] : nullptr;
+            append_entry(chunk, format, found_keys[i], value, with_values ? found_lengths[i] : 0, with_values);
+        }
+
+        remaining -= count;
+        ukv_key_t last_key = found_keys[count - 1];
+        bool is_exhausted = count != count_limit || last_key == std::numeric_limits<ukv_key_t>::max();
+        if (is_exhausted)
+            remaining = 0;
+        else
+            next_key = last_key + 1;
+        return status;
+    };
+
+    auto mime = format == stream_format_t::binary_k ? mime_binary_k : mime_ndjson_k;
+    return send_response(make_stream(req, mime, std::move(next_chunk)));
+}
+
+/**
+ * @brief Exports the counters and latencies of all calls under "/metrics",
+ * in the Prometheus text format. The first scrape enables the collection.
+ */
+template <typename body_at, typename allocator_at, typename send_response_at>
+void respond_to_metrics(ukv_database_t db,
+                        http::request<body_at, http::basic_fields<allocator_at>>&& req,
+                        send_response_at&& send_response) {
+
+    if (req.method() != http::verb::get)
+        return send_response(make_error(req, http::status::bad_request, "Unsupported HTTP verb"));
+
+    status_t status;
+    pooled_arena_t arena;
+    ukv_str_view_t text = nullptr;
+    ukv_metrics_t metrics {};
+    metrics.db = db;
+    metrics.error = status.member_ptr();
+    metrics.arena = arena.member_ptr();
+    metrics.collect = true;
+    metrics.prometheus = &text;
+    ukv_metrics(&metrics);
+    if (!status)
+        return send_response(make_error(req, http::status::internal_server_error, status.message()));
+
+    http::response<http::string_body> res {http::status::ok, req.version()};
+    res.set(http::field::server, server_name_k);
+    res.set(http::field::content_type, "text/plain; version=0.0.4");
+    res.keep_alive(req.keep_alive());
+    res.body() = std::string(text);
+    res.prepare_payload();
+    return send_response(std::move(res));
 }
 
 /**
@@ -547,19 +1111,15 @@ void respond_to_aos(db_session_t& session,
  *        into underlying UKV calls, preparing results and sending back.
  */
 template <typename body_at, typename allocator_at, typename send_response_at>
-void route_request(db_session_t& session,
+void route_request(ukv_database_t db,
                    http::request<body_at, http::basic_fields<allocator_at>>&& req,
                    send_response_at&& send_response) {
 
-    http::verb received_verb = req.method();
     beast::string_view received_path = req.target();
-    fmt::print("Received path: {} {}\n",
-               std::string(beast::http::to_string(received_verb)),
-               std::string(received_path));
 
     // Modifying single entries:
     if (received_path.starts_with("/one/"))
-        return respond_to_one(session, std::move(req), send_response);
+        return respond_to_one(db, std::move(req), send_response);
 
     // Modifying collections:
     else if (received_path.starts_with("/col/")) {
@@ -573,9 +1133,21 @@ void route_request(db_session_t& session,
     else if (received_path.starts_with("/txn/"))
         return send_response(make_error(req, http::status::bad_request, "Transactions aren't implemented yet"));
 
+    // Batches of entries, addressed by lists of keys:
+    else if (received_path.starts_with("/batch/"))
+        return respond_to_batch(db, std::move(req), send_response);
+
+    // Ranges of keys:
+    else if (received_path.starts_with("/scan/"))
+        return respond_to_scan(db, std::move(req), send_response);
+
+    // Monitoring:
+    else if (received_path.starts_with("/metrics"))
+        return respond_to_metrics(db, std::move(req), send_response);
+
     // Array-of-Structures:
     else if (received_path.starts_with("/aos/"))
-        return respond_to_aos(session, std::move(req), send_response);
+        return respond_to_aos(db, std::move(req), send_response);
 
     // Structure-of-Arrays:
     else if (received_path.starts_with("/soa/"))
@@ -590,45 +1162,123 @@ void route_request(db_session_t& session,
 
 /**
  * @brief A communication channel/session for a single client.
+ * Supports HTTP/1.1 keep-alive and pipelining: up to @c pipeline_depth_k
+ * requests are read ahead, while the responses are sent strictly in order.
  */
 class web_db_session_t : public std::enable_shared_from_this<web_db_session_t> {
-    // This is the C++11 equivalent of a generic lambda.
-    // The function object is used to send an HTTP message.
-    struct send_request_t {
+
+    /**
+     * @brief A streamed response in flight. Outlives the async operations,
+     * as the serializer keeps a reference to the header.
+     */
+    struct stream_t {
+        http::response<http::empty_body> head;
+        http::response_serializer<http::empty_body> serializer;
+        chunk_producer_t next_chunk;
+        std::string chunk;
+        bool is_finished = false;
+
+        stream_t(streamed_response_t&& response)
+            : head(std::move(response.head)), serializer(head), next_chunk(std::move(response.next_chunk)) {}
+    };
+
+    /**
+     * @brief Queue of responses to pipelined requests.
+     * This is the C++11 equivalent of a generic lambda, used to send HTTP messages.
+     * The first queued response is being written, the rest are waiting for their turn.
+     */
+    class pipeline_t {
         web_db_session_t& self_;
+        std::deque<std::function<void()>> pending_;
 
-        explicit send_request_t(web_db_session_t& self) noexcept : self_(self) {}
+      public:
+        explicit pipeline_t(web_db_session_t& self) noexcept : self_(self) {}
+
+        bool is_full() const noexcept { return pending_.size() >= pipeline_depth_k; }
+        bool is_empty() const noexcept { return pending_.empty(); }
+
+        /**
+         * @brief Drops the response, that was just written, and starts writing the next one.
+         */
+        void pop() {
+            pending_.pop_front();
+            if (!pending_.empty())
+                write_front();
+        }
 
         template <bool ir_request_ak, typename body_at, typename fields_at>
-        void operator()(http::message<ir_request_ak, body_at, fields_at>&& msg) const {
+        void operator()(http::message<ir_request_ak, body_at, fields_at>&& msg) {
             // The lifetime of the message has to extend
             // for the duration of the async operation so
             // we use a `std::shared_ptr` to manage it.
             auto sp = std::make_shared<http::message<ir_request_ak, body_at, fields_at>>(std::move(msg));
+            push([&self = self_, sp] {
+                http::async_write(
+                    self.stream_,
+                    *sp,
+                    beast::bind_front_handler(&web_db_session_t::on_write, self.shared_from_this(), sp->need_eof()));
+            });
+        }
 
-            // Store a type-erased version of the shared
-            // pointer in the class to keep it alive.
-            self_.res_ = sp;
+        void operator()(arena_response_t&& response) {
+            auto sp = std::make_shared<arena_response_t>(std::move(response));
+            push([&self = self_, sp] {
+                http::async_write(self.stream_,
+                                  sp->message,
+                                  beast::bind_front_handler(&web_db_session_t::on_write,
+                                                            self.shared_from_this(),
+                                                            sp->message.need_eof()));
+            });
+        }
 
-            // Write the response
-            http::async_write(
-                self_.stream_,
-                *sp,
-                beast::bind_front_handler(&web_db_session_t::on_write, self_.shared_from_this(), sp->need_eof()));
+        void operator()(streamed_response_t&& response) {
+            auto sp = std::make_shared<stream_t>(std::move(response));
+            push([&self = self_, sp] {
+                http::async_write_header(
+                    self.stream_,
+                    sp->serializer,
+                    beast::bind_front_handler(&web_db_session_t::on_stream_write, self.shared_from_this(), sp));
+            });
+        }
+
+      private:
+        void push(std::function<void()> write) {
+            pending_.push_back(std::move(write));
+            if (pending_.size() == 1)
+                write_front();
+        }
+
+        void write_front() {
+            // Slow readers get as much time per response, as slow writers get per request
+            self_.stream_.expires_after(session_timeout_k);
+            pending_.front()();
         }
     };
 
+    using fields_allocator_t = std::pmr::polymorphic_allocator<char>;
+    using request_parser_t = http::request_parser<http::string_body, fields_allocator_t>;
+
     beast::tcp_stream stream_;
     beast::flat_buffer buffer_;
     std::shared_ptr<db_w_clients_t> db_;
-    db_session_t db_session_;
-    http::request<http::string_body> req_;
-    std::shared_ptr<void> res_;
-    send_request_t send_request_;
+    pipeline_t pipeline_;
+    std::uint64_t body_limit_ = body_limit_k;
+    bool reading_finished_ = false;
+
+    /// @brief Memory for the header fields, rewound before every request.
+    std::array<char, request_buffer_size_k> fields_memory_;
+    std::pmr::monotonic_buffer_resource fields_resource_;
+    std::optional<request_parser_t> parser_;
+    /// @brief Body string of the last request, which keeps its capacity for the next one.
+    std::string body_buffer_;
 
   public:
-    web_db_session_t(tcp::socket&& socket, std::shared_ptr<db_w_clients_t> const& session)
-        : stream_(std::move(socket)), db_(session), db_session_(session->session()), send_request_(*this) {}
+    web_db_session_t(tcp::socket&& socket, std::shared_ptr<db_w_clients_t> const& session, std::uint64_t body_limit)
+        : stream_(std::move(socket)), db_(session), pipeline_(*this), body_limit_(body_limit),
+          fields_resource_(fields_memory_.data(), fields_memory_.size()) {
+        buffer_.reserve(request_buffer_size_k);
+        body_buffer_.reserve(request_buffer_size_k);
+    }
 
     /**
      * @brief Start the asynchronous operation.
@@ -643,32 +1293,60 @@ class web_db_session_t : public std::enable_shared_from_this<web_db_session_t> {
     }
 
     void do_read() {
-        // Make the request empty before reading,
-        // otherwise the operation behavior is undefined.
-        req_ = {};
+        // Parsers can't be reused, but re-emplacing one in place costs nothing.
+        // The fields of the previous request are gone, so their memory can be rewound,
+        // while the body string is recycled with all of its capacity.
+        parser_.reset();
+        fields_resource_.release();
+        parser_.emplace(std::piecewise_construct,
+                        std::make_tuple(std::move(body_buffer_)),
+                        std::make_tuple(fields_allocator_t {&fields_resource_}));
+        parser_->get().body().clear();
+        parser_->body_limit(body_limit_);
 
         // Set the timeout.
-        stream_.expires_after(std::chrono::seconds(30));
+        stream_.expires_after(session_timeout_k);
 
-        // Read a request
+        // Read a request. Pipelined requests may already be in the `buffer_`.
         http::async_read(stream_,
                          buffer_,
-                         req_,
+                         *parser_,
                          beast::bind_front_handler(&web_db_session_t::on_read, shared_from_this()));
     }
 
     void on_read(beast::error_code ec, std::size_t bytes_transferred) {
         boost::ignore_unused(bytes_transferred);
 
-        if (ec == http::error::end_of_stream)
-            // This means they closed the connection
-            return do_close();
+        if (ec == http::error::end_of_stream) {
+            // This means they closed the connection,
+            // but we may still owe them some responses.
+            reading_finished_ = true;
+            if (pipeline_.is_empty())
+                do_close();
+            return;
+        }
+
+        // The headers are already parsed, so we can explain why we hang up.
+        if (ec == http::error::body_limit) {
+            reading_finished_ = true;
+            auto& req = parser_->get();
+            req.keep_alive(false);
+            return pipeline_(make_error(req, http::status::payload_too_large, "Request body is too large"));
+        }
 
         if (ec)
             return log_failure(ec, "read");
 
-        // send_at the response
-        route_request(db_session_, std::move(req_), send_request_);
+        // Queue the response and read ahead, unless too many are in flight.
+        // Handlers only borrow the request, so we can take the body string back.
+        auto& req = parser_->get();
+        bool keep_alive = req.keep_alive();
+        route_request(db_->session, std::move(req), pipeline_);
+        body_buffer_ = std::move(req.body());
+        if (!keep_alive)
+            reading_finished_ = true;
+        else if (!pipeline_.is_full())
+            do_read();
     }
 
     void on_write(bool close, beast::error_code ec, std::size_t bytes_transferred) {
@@ -682,11 +1360,47 @@ class web_db_session_t : public std::enable_shared_from_this<web_db_session_t> {
             // the response indicated the "Connection: close" semantic.
             return do_close();
 
-        // We're done with the response so delete it
-        res_ = nullptr;
+        // We're done with the response so delete it, and send the next one
+        bool was_full = pipeline_.is_full();
+        pipeline_.pop();
+        if (reading_finished_) {
+            if (pipeline_.is_empty())
+                do_close();
+        }
+        else if (was_full)
+            // Read another request, if we were throttled
+            do_read();
+    }
+
+    void on_stream_write(std::shared_ptr<stream_t> stream, beast::error_code ec, std::size_t bytes_transferred) {
+        boost::ignore_unused(bytes_transferred);
+
+        if (ec)
+            return log_failure(ec, "write");
+
+        if (stream->is_finished)
+            return on_write(stream->head.need_eof(), ec, 0);
+
+        // Fetch the next page from the DB. If we fail midway, the status
+        // code is already sent, so the only way to report it is to hang up.
+        stream->chunk.clear();
+        status_t status = stream->next_chunk(stream->chunk);
+        if (!status)
+            return do_close();
 
-        // Read another request
-        do_read();
+        bool is_chunked = stream->head.chunked();
+        stream->is_finished = stream->chunk.empty();
+        auto on_chunk = beast::bind_front_handler(&web_db_session_t::on_stream_write, shared_from_this(), stream);
+        if (stream->is_finished && !is_chunked)
+            return on_write(stream->head.need_eof(), ec, 0);
+
+        stream_.expires_after(session_timeout_k);
+        if (stream->is_finished)
+            net::async_write(stream_, http::make_chunk_last(), std::move(on_chunk));
+        else if (is_chunked)
+            net::async_write(stream_, http::make_chunk(net::buffer(stream->chunk)), std::move(on_chunk));
+        else
+            net::async_write(stream_, net::buffer(stream->chunk), std::move(on_chunk));
     }
 
     void do_close() {
@@ -705,10 +1419,14 @@ class listener_t : public std::enable_shared_from_this<listener_t> {
     net::io_context& io_context_;
     tcp::acceptor acceptor_;
     std::shared_ptr<db_w_clients_t> db_;
+    std::uint64_t body_limit_ = body_limit_k;
 
   public:
-    listener_t(net::io_context& io_context, tcp::endpoint endpoint, std::shared_ptr<db_w_clients_t> const& session)
-        : io_context_(io_context), acceptor_(net::make_strand(io_context)), db_(session) {
+    listener_t(net::io_context& io_context,
+               tcp::endpoint endpoint,
+               std::shared_ptr<db_w_clients_t> const& session,
+               std::uint64_t body_limit)
+        : io_context_(io_context), acceptor_(net::make_strand(io_context)), db_(session), body_limit_(body_limit) {
         connect_to(endpoint);
     }
 
@@ -728,7 +1446,7 @@ class listener_t : public std::enable_shared_from_this<listener_t> {
             return log_failure(ec, "accept");
 
         // Create the web_db_session_t and run it
-        std::make_shared<web_db_session_t>(std::move(socket), db_)->run();
+        std::make_shared<web_db_session_t>(std::move(socket), db_, body_limit_)->run();
         // Accept another connection
         do_accept();
     }
@@ -764,10 +1482,11 @@ int main(int argc, char* argv[]) {
 
     // Check command line arguments
     if (argc < 4) {
-        std::cerr << "Usage: ukv_beast_server <address> <port> <threads> <db_config_path>?\n"
+        std::cerr << "Usage: ukv_rest_server_<engine> <address> <port> <threads> <db_config_path>? <max_body_bytes>?\n"
                   << "Example:\n"
-                  << "    ukv_beast_server 0.0.0.0 8080 1\n"
-                  << "    ukv_beast_server 0.0.0.0 8080 1 ./config.json\n"
+                  << "    ukv_rest_server_umem 0.0.0.0 8080 1\n"
+                  << "    ukv_rest_server_umem 0.0.0.0 8080 1 ./config.json\n"
+                  << "    ukv_rest_server_umem 0.0.0.0 8080 1 \"\" 268435456\n"
                   << "";
         return EXIT_FAILURE;
     }
@@ -777,6 +1496,9 @@ int main(int argc, char* argv[]) {
     auto const port = static_cast<unsigned short>(std::atoi(argv[2]));
     auto const threads = std::max<int>(1, std::atoi(argv[3]));
     auto db_config = std::string();
+    auto body_limit = body_limit_k;
+    if (argc >= 6)
+        body_limit = std::strtoull(argv[5], nullptr, 10);
 
     // Read the configuration file
     if (argc >= 5) {
@@ -789,22 +1511,15 @@ int main(int argc, char* argv[]) {
 
     // Check if we can initialize the DB
     auto session = std::make_shared<db_w_clients_t>();
-    status_t status;
-    ukv_database_init_t database {
-        .config = db_config.c_str(),
-        .db = &session->raw,
-        .error = error.member_ptr(),
-    };
-
-    ukv_database_init(&database);
+    status_t status = session->session.open(db_config.c_str());
     if (!status) {
-        std::cerr << "Couldn't initialize DB: " << error.raw << std::endl;
+        std::cerr << "Couldn't initialize DB: " << status.message() << std::endl;
         return EXIT_FAILURE;
     }
 
     // Create and launch a listening port
     auto io_context = net::io_context {threads};
-    std::make_shared<listener_t>(io_context, tcp::endpoint {address, port}, session)->run();
+    std::make_shared<listener_t>(io_context, tcp::endpoint {address, port}, session, body_limit)->run();
 
     // Run the I/O service on the requested number of threads
     std::vector<std::thread> v;
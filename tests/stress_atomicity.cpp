@@ -2,8 +2,10 @@
 #include <random>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <chrono>
 #include <charconv>
+#include <cstring>
 #include <filesystem>
 #include <unordered_map>
 
@@ -108,6 +110,121 @@ TEST(db, inserts_and_deletes) {
     insert_atomic_isolated<16, 10, 3>(10'000);
 }
 
+struct contention_stats_t {
+    std::size_t commits = 0;
+    std::size_t aborts = 0;
+    double seconds = 0;
+};
+
+/**
+ * @brief Compares optimistic and pessimistic transactions on a few hot counters.
+ *
+ * T threads increment two random counters out of H in every transaction,
+ * retrying until the commit succeeds. The sum of all the counters must then
+ * match the number of increments. Optimistic transactions fail on commit, if
+ * the counters have changed since the read, while pessimistic ones wait for
+ * each others locks. Both counters are read in one batch, so that the locks
+ * are always taken in the same order.
+ *
+ * @tparam threads_count_ak Number of competing threads.
+ * @tparam hot_keys_ak Number of counters, shared by all threads.
+ */
+template <std::size_t threads_count_ak, std::size_t hot_keys_ak>
+contention_stats_t increment_contended(bool pessimistic, std::size_t increments_per_thread) {
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    EXPECT_TRUE(db.clear());
+
+    std::atomic<std::size_t> aborts = 0;
+    auto task = [&](size_t thread_idx) {
+        std::mt19937 random_generator(static_cast<std::uint32_t>(thread_idx));
+        std::uniform_int_distribution<ukv_key_t> random_key(0, hot_keys_ak - 1);
+        std::uniform_int_distribution<ukv_key_t> random_offset(1, hot_keys_ak - 1);
+
+        for (std::size_t idx = 0; idx != increments_per_thread; ++idx) {
+            ukv_key_t const first_key = random_key(random_generator);
+            ukv_key_t const second_key = (first_key + random_offset(random_generator)) % hot_keys_ak;
+            std::array<ukv_key_t, 2> keys {first_key, second_key};
+
+            while (true) {
+                transaction_t txn = db.transact(pessimistic).throw_or_release();
+                auto collection = txn.main();
+                auto maybe_values = collection[keys].value();
+                if (!maybe_values) {
+                    ++aborts;
+                    continue;
+                }
+
+                std::array<std::uint64_t, 2> counters {0, 0};
+                embedded_blobs_t values = *maybe_values;
+                for (std::size_t i = 0; i != keys.size(); ++i) {
+                    value_view_t value = values[i];
+                    if (value.size() == sizeof(std::uint64_t))
+                        std::memcpy(&counters[i], value.begin(), sizeof(std::uint64_t));
+                    ++counters[i];
+                }
+
+                value_view_t first_value((byte_t const*)&counters[0], sizeof(std::uint64_t));
+                value_view_t second_value((byte_t const*)&counters[1], sizeof(std::uint64_t));
+                status_t status = collection[first_key].assign(first_value);
+                if (status)
+                    status = collection[second_key].assign(second_value);
+                if (status)
+                    status = txn.commit();
+                if (status)
+                    break;
+                ++aborts;
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::array<std::thread, threads_count_ak> threads;
+    for (std::size_t i = 0; i < threads_count_ak; ++i)
+        threads[i] = std::thread(task, i);
+    for (std::size_t i = 0; i < threads_count_ak; ++i)
+        threads[i].join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::array<ukv_key_t, hot_keys_ak> hot_keys;
+    std::iota(hot_keys.begin(), hot_keys.end(), 0);
+    blobs_collection_t collection = db.main();
+    embedded_blobs_t retrieved = collection[hot_keys].value().throw_or_release();
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i != hot_keys_ak; ++i) {
+        std::uint64_t counter = 0;
+        value_view_t value = retrieved[i];
+        if (value.size() == sizeof(std::uint64_t))
+            std::memcpy(&counter, value.begin(), sizeof(std::uint64_t));
+        sum += counter;
+    }
+    std::size_t const commits = threads_count_ak * increments_per_thread;
+    EXPECT_EQ(sum, commits * 2);
+
+    EXPECT_TRUE(db.clear());
+    db.close();
+    return {commits, aborts.load(), elapsed.count()};
+}
+
+template <std::size_t threads_count_ak, std::size_t hot_keys_ak>
+void compare_contended(std::size_t increments_per_thread) {
+    for (bool pessimistic : {false, true}) {
+        auto stats = increment_contended<threads_count_ak, hot_keys_ak>(pessimistic, increments_per_thread);
+        std::printf("%-11s %2zu threads, %2zu hot keys: %8.0f commits/s, %6.2f%% aborted\n",
+                    pessimistic ? "pessimistic" : "optimistic",
+                    threads_count_ak,
+                    hot_keys_ak,
+                    stats.commits / stats.seconds,
+                    100.0 * stats.aborts / (stats.commits + stats.aborts));
+    }
+}
+
+TEST(db, contention) {
+    compare_contended<4, 16>(2'000);
+    compare_contended<8, 4>(2'000);
+    compare_contended<16, 2>(1'000);
+}
+
 int main(int argc, char** argv) {
 
     if (!ukv_supports_transactions_k) {
@@ -7,13 +7,16 @@
  */
 
 #include <vector>
+#include <algorithm>
 #include <unordered_set>
+#include <unordered_map>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <unistd.h>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <shared_mutex>
 
 #include <gtest/gtest.h>
@@ -21,6 +24,10 @@
 #include <bson.h>
 
 #include "ukv/ukv.hpp"
+#if defined(UKV_FLIGHT_CLIENT)
+#include "ukv/flight.h"
+#include "ukv/arrow.h"
+#endif
 
 using namespace unum::ukv;
 using namespace unum;
@@ -394,6 +401,95 @@ TEST(db, persistency) {
     }
 }
 
+/**
+ * Checks that flushed transactional commits, including the ones
+ * following the last checkpoint, survive a reopening of the DB.
+ */
+TEST(db, persistency_of_flushed_commits) {
+
+    if (!path() || !ukv_supports_transactions_k)
+        return;
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+
+    triplet_t triplet;
+    {
+        transaction_t txn = *db.transact();
+        auto txn_ref = txn[triplet.keys];
+        round_trip(txn_ref, triplet);
+        EXPECT_TRUE(txn.commit(true));
+
+        EXPECT_TRUE(txn.reset());
+        auto erased_ref = txn[triplet.keys[1]];
+        EXPECT_TRUE(erased_ref.erase());
+        EXPECT_TRUE(txn.commit(true));
+    }
+    db.close();
+    {
+        EXPECT_TRUE(db.open(path()));
+
+        blobs_collection_t main_collection = db.main();
+        EXPECT_EQ(main_collection.keys().size(), 2ul);
+        auto value = *main_collection[triplet.keys[0]].value();
+        EXPECT_EQ(value.size(), triplet_t::val_size_k);
+        EXPECT_FALSE(*main_collection[triplet.keys[1]].present());
+        EXPECT_TRUE(*main_collection[triplet.keys[2]].present());
+    }
+}
+
+#if defined(UKV_ENGINE_IS_UMEM)
+/**
+ * Simulates a crash by copying the directory of a DB, that is still open,
+ * so that the copy is recovered only from the log, following the initial checkpoint.
+ * Both transactional and plain flushed writes must be replayed.
+ */
+TEST(db, persistency_after_crash) {
+
+    if (!path())
+        return;
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t main_collection = db.main();
+    blobs_collection_t named_collection = *db["logged"];
+
+    triplet_t triplet;
+    {
+        transaction_t txn = *db.transact();
+        auto txn_ref = txn[triplet.keys];
+        round_trip(txn_ref, triplet);
+        EXPECT_TRUE(txn.commit(true));
+    }
+    EXPECT_TRUE(main_collection[triplet.keys[1]].erase(true));
+    EXPECT_TRUE(main_collection[100].assign(value_view_t("plain"), true));
+    EXPECT_TRUE(named_collection[101].assign(value_view_t("named"), true));
+
+    namespace stdfs = std::filesystem;
+    std::string copy_path = std::string(path()) + "-crashed";
+    stdfs::remove_all(copy_path);
+    stdfs::copy(path(), copy_path, stdfs::copy_options::recursive);
+    {
+        database_t recovered;
+        EXPECT_TRUE(recovered.open(copy_path.c_str()));
+
+        blobs_collection_t recovered_main = recovered.main();
+        EXPECT_EQ(recovered_main.keys().size(), 3ul);
+        EXPECT_EQ(*recovered_main[triplet.keys[0]].value(), "A");
+        EXPECT_FALSE(*recovered_main[triplet.keys[1]].present());
+        EXPECT_EQ(*recovered_main[100].value(), "plain");
+
+        EXPECT_TRUE(*recovered.contains("logged"));
+        blobs_collection_t recovered_named = *recovered["logged"];
+        EXPECT_EQ(*recovered_named[101].value(), "named");
+    }
+    stdfs::remove_all(copy_path);
+    db.close();
+}
+#endif
+
 /**
  * Creates news collections under unique names.
  * Tests collection lookup by name, dropping/clearing existing collections.
@@ -564,6 +660,608 @@ TEST(db, batch_scan) {
     EXPECT_TRUE(stream.is_end());
 }
 
+/**
+ * Scans, that export the values alongside the keys, instead of a follow-up read.
+ */
+TEST(db, scan_values) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t collection = db.main();
+
+    triplet_t triplet;
+    auto ref = collection[triplet.keys];
+    EXPECT_TRUE(ref.assign(triplet.contents()));
+
+    arena_t arena(db);
+    status_t status;
+    ukv_key_t start_key = std::numeric_limits<ukv_key_t>::min();
+    ukv_length_t count_limit = 16;
+    ukv_length_t* found_counts = nullptr;
+    ukv_key_t* found_keys = nullptr;
+    ukv_length_t* found_offsets = nullptr;
+    ukv_length_t* found_lengths = nullptr;
+    ukv_bytes_ptr_t found_values = nullptr;
+
+    ukv_scan_t scan {};
+    scan.db = db;
+    scan.error = status.member_ptr();
+    scan.arena = arena.member_ptr();
+    scan.tasks_count = 1;
+    scan.start_keys = &start_key;
+    scan.count_limits = &count_limit;
+    scan.counts = &found_counts;
+    scan.keys = &found_keys;
+    scan.values_offsets = &found_offsets;
+    scan.values_lengths = &found_lengths;
+    scan.values = &found_values;
+
+    ukv_scan(&scan);
+    EXPECT_TRUE(status);
+    EXPECT_EQ(found_counts[0], triplet.keys.size());
+    for (std::size_t i = 0; i != triplet.keys.size(); ++i) {
+        EXPECT_EQ(found_keys[i], triplet.keys[i]);
+        EXPECT_EQ(found_lengths[i], found_offsets[i + 1] - found_offsets[i]);
+        value_view_t found {found_values + found_offsets[i], found_lengths[i]};
+        value_view_t expected {reinterpret_cast<ukv_bytes_cptr_t>(&triplet.vals[i]), triplet.lengths[i]};
+        EXPECT_EQ(found, expected);
+    }
+    EXPECT_TRUE(db.clear());
+}
+
+/**
+ * Drains every partition of a bulk scan on its own thread,
+ * reporting duplicate keys as failures.
+ */
+static std::unordered_map<ukv_key_t, std::string> scan_bulk_entries(database_t& db, ukv_size_t partitions_count) {
+
+    status_t status;
+    ukv_scan_bulk_t scan = nullptr;
+    ukv_scan_bulk_init_t init {};
+    init.db = db;
+    init.error = status.member_ptr();
+    init.partitions_count = partitions_count;
+    init.scan = &scan;
+    ukv_scan_bulk_init(&init);
+    EXPECT_TRUE(status);
+
+    std::mutex found_mutex;
+    std::unordered_map<ukv_key_t, std::string> found_entries;
+    std::vector<std::thread> threads;
+    for (ukv_size_t partition = 0; partition != partitions_count; ++partition)
+        threads.emplace_back([&, partition] {
+            arena_t arena(db);
+            status_t thread_status;
+            while (thread_status) {
+                ukv_length_t count = 0;
+                ukv_key_t* keys = nullptr;
+                ukv_length_t* offsets = nullptr;
+                ukv_bytes_ptr_t values = nullptr;
+                ukv_scan_bulk_next_t next {};
+                next.db = db;
+                next.error = thread_status.member_ptr();
+                next.arena = arena.member_ptr();
+                next.scan = scan;
+                next.partition = partition;
+                next.count_limit = 256;
+                next.count = &count;
+                next.keys = &keys;
+                next.values_offsets = &offsets;
+                next.values = &values;
+                ukv_scan_bulk_next(&next);
+                if (!thread_status || !count)
+                    break;
+
+                std::lock_guard<std::mutex> lock(found_mutex);
+                for (ukv_length_t i = 0; i != count; ++i) {
+                    auto value = reinterpret_cast<char const*>(values) + offsets[i];
+                    bool inserted = found_entries.emplace(keys[i], std::string(value, offsets[i + 1] - offsets[i])).second;
+                    EXPECT_TRUE(inserted);
+                }
+            }
+            EXPECT_TRUE(thread_status);
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    ukv_scan_bulk_free(scan);
+    return found_entries;
+}
+
+/**
+ * Unordered partitioned scans, drained by separate threads.
+ */
+TEST(db, scan_bulk) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t collection = db.main();
+
+    constexpr std::size_t keys_size = 10000;
+    std::vector<ukv_key_t> keys(keys_size);
+    std::iota(keys.begin(), keys.end(), -static_cast<ukv_key_t>(keys_size / 2));
+    EXPECT_TRUE(collection[keys].assign(value_view_t("value")));
+
+    auto found_entries = scan_bulk_entries(db, 4);
+    EXPECT_EQ(found_entries.size(), keys_size);
+    for (auto const& [key, value] : found_entries)
+        EXPECT_EQ(value, "value");
+    EXPECT_TRUE(db.clear());
+}
+
+/**
+ * Bulk scans must export only the latest version of every present key,
+ * even when the older versions and the deletions are persisted separately.
+ * Reopening a persistent DB moves the logged updates into new files.
+ */
+TEST(db, scan_bulk_after_updates) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    auto reopen = [&] {
+        if (!path())
+            return;
+        db.close();
+        EXPECT_TRUE(db.open(path()));
+    };
+
+    constexpr std::size_t keys_size = 10000;
+    std::vector<ukv_key_t> keys(keys_size);
+    std::iota(keys.begin(), keys.end(), 0);
+    EXPECT_TRUE(db.main()[keys].assign(value_view_t("old")));
+    reopen();
+
+    std::vector<ukv_key_t> overwritten_keys, erased_keys;
+    for (ukv_key_t key : keys)
+        if (key % 3 == 0)
+            overwritten_keys.push_back(key);
+        else if (key % 3 == 1)
+            erased_keys.push_back(key);
+    EXPECT_TRUE(db.main()[overwritten_keys].assign(value_view_t("newer")));
+    reopen();
+    EXPECT_TRUE(db.main()[erased_keys].erase());
+    reopen();
+
+    auto found_entries = scan_bulk_entries(db, 4);
+    EXPECT_EQ(found_entries.size(), keys_size - erased_keys.size());
+    for (auto const& [key, value] : found_entries) {
+        EXPECT_NE(key % 3, 1);
+        EXPECT_EQ(value, key % 3 == 0 ? "newer" : "old");
+    }
+    EXPECT_TRUE(db.clear());
+}
+
+TEST(db, collection_split) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t collection = db.main();
+
+    constexpr std::size_t keys_size = 10000;
+    std::vector<ukv_key_t> keys(keys_size);
+    std::iota(keys.begin(), keys.end(), 0);
+    EXPECT_TRUE(collection[keys].assign(value_view_t("value")));
+
+    constexpr std::size_t parts_count = 8;
+    arena_t arena(db);
+    blobs_range_t range(db, nullptr, 0, collection, 100, 9000);
+    auto maybe_boundaries = range.split(parts_count, arena.member_ptr());
+    EXPECT_TRUE(maybe_boundaries);
+    auto boundaries = *maybe_boundaries;
+    EXPECT_EQ(boundaries.size(), parts_count + 1);
+    EXPECT_EQ(boundaries[0], 100);
+    EXPECT_EQ(boundaries[parts_count], 9000);
+    EXPECT_TRUE(std::is_sorted(boundaries.begin(), boundaries.end()));
+    EXPECT_TRUE(db.clear());
+}
+
+TEST(db, async) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+
+    constexpr std::size_t keys_size = 1000;
+    std::vector<ukv_key_t> keys(keys_size);
+    std::iota(keys.begin(), keys.end(), 0);
+    ukv_bytes_cptr_t value = reinterpret_cast<ukv_bytes_cptr_t>("value");
+    ukv_length_t value_length = 5;
+
+    status_t status;
+    arena_t arena(db);
+    ukv_write_t write {};
+    write.db = db;
+    write.error = status.member_ptr();
+    write.arena = arena.member_ptr();
+    write.tasks_count = keys_size;
+    write.keys = keys.data();
+    write.keys_stride = sizeof(ukv_key_t);
+    write.lengths = &value_length;
+    write.values = &value;
+    completion_t written;
+    submit(write, written).wait();
+    EXPECT_TRUE(written.ready());
+    EXPECT_TRUE(status);
+
+    ukv_length_t* lengths = nullptr;
+    ukv_read_t read {};
+    read.db = db;
+    read.error = status.member_ptr();
+    read.arena = arena.member_ptr();
+    read.tasks_count = keys_size;
+    read.keys = keys.data();
+    read.keys_stride = sizeof(ukv_key_t);
+    read.lengths = &lengths;
+    completion_t done;
+    submit(read, done).wait();
+    EXPECT_TRUE(status);
+    for (std::size_t i = 0; i != keys_size; ++i)
+        EXPECT_EQ(lengths[i], value_length);
+    EXPECT_TRUE(db.clear());
+}
+
+TEST(db, arena_limit) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+
+    constexpr std::size_t keys_size = 16;
+    std::string const big_value(1024 * 1024, 'x');
+    blobs_collection_t collection = db.main();
+    for (ukv_key_t k = 0; k != keys_size; ++k)
+        collection[k] = big_value.c_str();
+
+    std::vector<ukv_key_t> keys(keys_size);
+    std::iota(keys.begin(), keys.end(), 0);
+    status_t status;
+    arena_t arena(db);
+    ukv_arena_limit(arena.member_ptr(), 4 * big_value.size(), status.member_ptr());
+    EXPECT_TRUE(status);
+
+    ukv_byte_t* values = nullptr;
+    ukv_read_t read {};
+    read.db = db;
+    read.error = status.member_ptr();
+    read.arena = arena.member_ptr();
+    read.tasks_count = keys_size;
+    read.keys = keys.data();
+    read.keys_stride = sizeof(ukv_key_t);
+    read.values = &values;
+    ukv_read(&read);
+    EXPECT_FALSE(status);
+    status.release_error();
+
+    ukv_arena_stats_t stats;
+    ukv_arena_stats(*arena.member_ptr(), &stats);
+    EXPECT_LE(stats.capacity, 4 * big_value.size());
+    EXPECT_EQ(stats.limit, 4 * big_value.size());
+
+    ukv_arena_limit(arena.member_ptr(), 0, status.member_ptr());
+    ukv_read(&read);
+    EXPECT_TRUE(status);
+    ukv_arena_stats(*arena.member_ptr(), &stats);
+    EXPECT_GE(stats.used, keys_size * big_value.size());
+    EXPECT_GT(stats.chunks, 1u);
+
+    ukv_arena_trim(*arena.member_ptr());
+    ukv_arena_stats(*arena.member_ptr(), &stats);
+    EXPECT_EQ(stats.chunks, 1u);
+    EXPECT_GE(stats.peak_capacity, keys_size * big_value.size());
+    EXPECT_TRUE(db.clear());
+}
+
+TEST(db, metrics) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+
+    status_t status;
+    arena_t arena(db);
+    ukv_metrics_t metrics {
+        .db = db,
+        .error = status.member_ptr(),
+        .arena = arena.member_ptr(),
+        .collect = true,
+    };
+    ukv_metrics(&metrics);
+    EXPECT_TRUE(status);
+
+    blobs_collection_t collection = db.main();
+    collection[42] = "some";
+    EXPECT_EQ(*collection[42].value(), "some");
+
+    ukv_str_view_t text = nullptr;
+    metrics.prometheus = &text;
+    ukv_metrics(&metrics);
+    EXPECT_TRUE(status);
+    EXPECT_NE(text, nullptr);
+    std::string exported(text);
+    EXPECT_NE(exported.find("ukv_calls_total{op=\"write\",layer=\"api\"}"), std::string::npos);
+    EXPECT_NE(exported.find("ukv_latency_seconds{op=\"read\",layer=\"api\",quantile=\"0.99\"}"),
+              std::string::npos);
+
+    ukv_str_view_t trace = nullptr;
+    metrics.collect = false;
+    metrics.prometheus = nullptr;
+    metrics.chrome_trace = &trace;
+    ukv_metrics(&metrics);
+    EXPECT_TRUE(status);
+    EXPECT_EQ(std::string(trace).rfind("{\"traceEvents\":[", 0), 0u);
+
+    metrics.chrome_trace = nullptr;
+    ukv_metrics(&metrics);
+    EXPECT_TRUE(status);
+    EXPECT_TRUE(db.clear());
+}
+
+/**
+ * Reads through shared memory segments, that co-located servers export and clients adopt,
+ * without passing the results through the loopback socket.
+ */
+TEST(db, read_shared_memory) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t collection = db.main();
+
+    triplet_t triplet;
+    auto ref = collection[triplet.keys];
+    EXPECT_TRUE(ref.assign(triplet.contents()));
+
+    arena_t arena(db);
+    status_t status;
+    ukv_length_t* found_offsets = nullptr;
+    ukv_bytes_ptr_t found_values = nullptr;
+
+    ukv_read_t read {};
+    read.db = db;
+    read.error = status.member_ptr();
+    read.arena = arena.member_ptr();
+    read.options = ukv_option_read_shared_memory_k;
+    read.tasks_count = triplet.keys.size();
+    read.keys = triplet.keys.data();
+    read.keys_stride = sizeof(ukv_key_t);
+    read.offsets = &found_offsets;
+    read.values = &found_values;
+    ukv_read(&read);
+    EXPECT_TRUE(status);
+
+    for (std::size_t i = 0; i != triplet.keys.size(); ++i) {
+        EXPECT_EQ(found_offsets[i + 1] - found_offsets[i], 1u);
+        EXPECT_EQ(char(found_values[found_offsets[i]]), triplet.vals[i]);
+    }
+}
+
+#if defined(UKV_FLIGHT_CLIENT)
+/**
+ * Streams a range in many small batches, keeping all of them alive till the end,
+ * so that a batch, reusing the memory of a previous one, would be caught.
+ */
+TEST(db, scan_stream) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+
+    constexpr std::size_t keys_count = 100;
+    std::vector<ukv_key_t> keys(keys_count);
+    std::vector<ukv_length_t> offsets(keys_count);
+    std::iota(keys.begin(), keys.end(), 0);
+    for (std::size_t i = 0; i != keys_count; ++i)
+        offsets[i] = static_cast<ukv_length_t>(i * sizeof(ukv_key_t));
+
+    // Every value is the binary representation of its key
+    arena_t arena(db);
+    status_t status;
+    ukv_length_t value_length = sizeof(ukv_key_t);
+    auto values = reinterpret_cast<ukv_bytes_cptr_t>(keys.data());
+    ukv_write_t write {};
+    write.db = db;
+    write.error = status.member_ptr();
+    write.arena = arena.member_ptr();
+    write.tasks_count = keys_count;
+    write.keys = keys.data();
+    write.keys_stride = sizeof(ukv_key_t);
+    write.offsets = offsets.data();
+    write.offsets_stride = sizeof(ukv_length_t);
+    write.lengths = &value_length;
+    write.values = &values;
+    ukv_write(&write);
+    EXPECT_TRUE(status);
+
+    ArrowArrayStream stream {};
+    ukv_scan_stream_t scan {};
+    scan.db = db;
+    scan.error = status.member_ptr();
+    scan.start_key = 10;
+    scan.count_limit = 75;
+    scan.batch_size = 16;
+    scan.values = true;
+    scan.stream = &stream;
+    ukv_scan_stream(&scan);
+    EXPECT_TRUE(status);
+    ASSERT_TRUE(stream.release);
+
+    std::vector<ArrowArray> batches;
+    while (true) {
+        ArrowArray batch {};
+        ASSERT_EQ(stream.get_next(&stream, &batch), 0);
+        if (!batch.release)
+            break;
+        EXPECT_LE(batch.length, 16);
+        batches.push_back(batch);
+    }
+    stream.release(&stream);
+    EXPECT_EQ(batches.size(), 5u);
+
+    ukv_key_t expected = 10;
+    for (ArrowArray& batch : batches) {
+        ASSERT_EQ(batch.n_children, 2);
+        ArrowArray const& keys_column = *batch.children[0];
+        ArrowArray const& vals_column = *batch.children[1];
+        auto found_keys = reinterpret_cast<ukv_key_t const*>(keys_column.buffers[1]) + keys_column.offset;
+        auto found_offsets = reinterpret_cast<std::int32_t const*>(vals_column.buffers[1]) + vals_column.offset;
+        auto found_values = reinterpret_cast<ukv_bytes_cptr_t>(vals_column.buffers[2]);
+        for (std::int64_t i = 0; i != batch.length; ++i, ++expected) {
+            EXPECT_EQ(found_keys[i], expected);
+            EXPECT_EQ(found_offsets[i + 1] - found_offsets[i], std::int32_t(sizeof(ukv_key_t)));
+            ukv_key_t found_value = 0;
+            std::memcpy(&found_value, found_values + found_offsets[i], sizeof(ukv_key_t));
+            EXPECT_EQ(found_value, expected);
+        }
+        batch.release(&batch);
+    }
+    EXPECT_EQ(expected, 85);
+    EXPECT_TRUE(db.clear());
+}
+
+/**
+ * Single-key reads from different threads are coalesced into shared batches,
+ * and asynchronous reads go through the same queue.
+ */
+TEST(db, read_coalesced) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open("grpc://0.0.0.0:38709?coalesce=100"));
+    blobs_collection_t collection = db.main();
+
+    triplet_t triplet;
+    auto ref = collection[triplet.keys];
+    EXPECT_TRUE(ref.assign(triplet.contents()));
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i != triplet.keys.size(); ++i)
+        threads.emplace_back([&, i] {
+            arena_t thread_arena(db);
+            for (std::size_t repeat = 0; repeat != 100; ++repeat) {
+                auto maybe_value = collection[triplet.keys[i]].on(thread_arena).value();
+                EXPECT_TRUE(maybe_value);
+                EXPECT_EQ(maybe_value->size(), 1u);
+                EXPECT_EQ(char(maybe_value->begin()[0]), triplet.vals[i]);
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    arena_t arena(db);
+    status_t status;
+    ukv_length_t* found_lengths = nullptr;
+    ukv_read_t read {};
+    read.db = db;
+    read.error = status.member_ptr();
+    read.arena = arena.member_ptr();
+    read.tasks_count = triplet.keys.size();
+    read.keys = triplet.keys.data();
+    read.keys_stride = sizeof(ukv_key_t);
+    read.lengths = &found_lengths;
+
+    std::atomic_bool is_done = false;
+    ukv_read_async(&read, [](void* payload) { reinterpret_cast<std::atomic_bool*>(payload)->store(true); }, &is_done);
+    while (!is_done.load())
+        std::this_thread::yield();
+    EXPECT_TRUE(status);
+    for (std::size_t i = 0; i != triplet.keys.size(); ++i)
+        EXPECT_EQ(found_lengths[i], 1u);
+}
+
+/**
+ * Repeated reads are served from the client-side cache, which must be invalidated
+ * by the writes of the same client and by the commits of its transactions.
+ */
+TEST(db, read_cached) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open("grpc://0.0.0.0:38709?cache=1048576"));
+    blobs_collection_t collection = db.main();
+
+    triplet_t triplet;
+    auto ref = collection[triplet.keys];
+    check_length(ref, ukv_length_missing_k);
+    round_trip(ref, triplet);
+    check_equalities(ref, triplet);
+
+    triplet.vals = {'D', 'E', 'F'};
+    round_trip(ref, triplet);
+    check_equalities(ref, triplet);
+
+    if (ukv_supports_transactions_k) {
+        transaction_t txn = *db.transact();
+        triplet.vals = {'G', 'H', 'I'};
+        auto txn_ref = txn[triplet.keys];
+        EXPECT_TRUE(txn_ref.assign(triplet.contents()));
+        EXPECT_TRUE(txn.commit());
+        check_equalities(ref, triplet);
+    }
+
+    EXPECT_TRUE(ref.erase());
+    check_length(ref, ukv_length_missing_k);
+}
+
+/**
+ * A follower server replays the writes of its primary and rejects its own.
+ * Once the primary is gone, reads with a staleness bound start failing.
+ */
+TEST(db, read_replicated) {
+
+    pid_t primary_id = fork();
+    if (primary_id == 0) {
+        execl(srv_path.c_str(), srv_path.c_str(), "--quiet", "--port", "38719", "--replicate", (char*)(NULL));
+        exit(0);
+    }
+    usleep(100000); // 0.1 sec
+    pid_t follower_id = fork();
+    if (follower_id == 0) {
+        execl(srv_path.c_str(),
+              srv_path.c_str(),
+              "--quiet",
+              "--port",
+              "38720",
+              "--follow",
+              "grpc://0.0.0.0:38719",
+              (char*)(NULL));
+        exit(0);
+    }
+    usleep(100000); // 0.1 sec
+
+    database_t primary, follower;
+    EXPECT_TRUE(primary.open("grpc://0.0.0.0:38719"));
+    EXPECT_TRUE(follower.open("grpc://0.0.0.0:38720?max_staleness=300"));
+    blobs_collection_t primary_collection = primary.main();
+    blobs_collection_t follower_collection = follower.main();
+
+    triplet_t triplet;
+    auto primary_ref = primary_collection[triplet.keys];
+    EXPECT_TRUE(primary_ref.assign(triplet.contents()));
+
+    auto follower_ref = follower_collection[triplet.keys];
+    for (std::size_t attempt = 0; attempt != 100; ++attempt) {
+        auto maybe_value = follower_collection[triplet.keys.back()].value();
+        if (maybe_value && maybe_value->size())
+            break;
+        usleep(10000); // 0.01 sec
+    }
+    check_equalities(follower_ref, triplet);
+    EXPECT_FALSE(follower_ref.assign(triplet.contents()));
+
+    kill(primary_id, SIGKILL);
+    waitpid(primary_id, nullptr, 0);
+    usleep(600000); // 0.6 sec
+    EXPECT_FALSE(follower_ref.value());
+
+    kill(follower_id, SIGKILL);
+    waitpid(follower_id, nullptr, 0);
+}
+#endif
+
 /**
  * Checks the "Read Commited" consistency guarantees of transactions.
  * Readers can't see the contents of pending (not committed) transactions.
@@ -849,6 +1547,135 @@ TEST(db, transaction_write_conflicting) {
     EXPECT_FALSE(txn2.commit());
 }
 
+/**
+ * Transactions that write must fail to commit, if the keys they have read
+ * were changed since, but not if unrelated keys were changed.
+ */
+TEST(db, transaction_read_conflicting) {
+    if (!ukv_supports_transactions_k)
+        return;
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t collection = db.main();
+    EXPECT_TRUE(collection[6].assign("b"));
+
+    transaction_t txn = *db.transact();
+    EXPECT_EQ(*txn.main().at(6).value(), "b");
+    EXPECT_TRUE(collection[6].assign("c"));
+    EXPECT_TRUE(txn.main().at(7).assign("d"));
+    EXPECT_FALSE(txn.commit());
+
+    EXPECT_TRUE(txn.reset());
+    EXPECT_EQ(*txn.main().at(6).value(), "c");
+    EXPECT_TRUE(collection[8].assign("e"));
+    EXPECT_TRUE(txn.main().at(7).assign("d"));
+    EXPECT_TRUE(txn.commit());
+}
+
+/**
+ * Pessimistic transactions must release their key locks, even if the commit fails,
+ * so that other transactions can lock the same keys before the handle is reset.
+ */
+TEST(db, transaction_pessimistic_failed_commit) {
+    if (!ukv_supports_transactions_k)
+        return;
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t collection = db.main();
+    EXPECT_TRUE(collection[6].assign("b"));
+
+    transaction_t failed = *db.transact(true);
+    EXPECT_EQ(*failed.main().at(6).value(), "b");
+    EXPECT_TRUE(failed.main().at(7).assign("d"));
+    EXPECT_TRUE(collection[6].assign("c"));
+    EXPECT_FALSE(failed.commit());
+
+    transaction_t txn = *db.transact(true);
+    EXPECT_TRUE(txn.main().at(6).assign("e"));
+    EXPECT_TRUE(txn.main().at(7).assign("f"));
+    EXPECT_TRUE(txn.commit());
+    EXPECT_EQ(*collection[6].value(), "e");
+    EXPECT_EQ(*collection[7].value(), "f");
+}
+
+/**
+ * Pessimistic transactions lock only the individual keys they access.
+ * Scans take no range locks, so others can insert into a scanned range,
+ * while the keys, that were read directly, still block other transactions.
+ */
+TEST(db, transaction_pessimistic_scan_phantoms) {
+    if (!ukv_supports_transactions_k)
+        return;
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t collection = db.main();
+    EXPECT_TRUE(collection[6].assign("b"));
+    EXPECT_TRUE(collection[8].assign("c"));
+
+    transaction_t txn = *db.transact(true);
+    EXPECT_EQ(txn.main().keys().size(), 2ul);
+    EXPECT_EQ(*txn.main().at(6).value(), "b");
+
+    transaction_t writer = *db.transact(true);
+    EXPECT_TRUE(writer.main().at(7).assign("phantom"));
+    EXPECT_TRUE(writer.commit());
+    EXPECT_EQ(txn.main().keys().size(), 3ul);
+
+    status_t status;
+    ukv_transaction_t raw = nullptr;
+    ukv_transaction_init_t txn_init {};
+    txn_init.db = db;
+    txn_init.error = status.member_ptr();
+    txn_init.options = ukv_option_transaction_pessimistic_k;
+    txn_init.lock_timeout = 10;
+    txn_init.transaction = &raw;
+    ukv_transaction_init(&txn_init);
+    EXPECT_TRUE(status);
+
+    transaction_t blocked {db, raw};
+    EXPECT_FALSE(blocked.main().at(6).value());
+    EXPECT_TRUE(txn.commit());
+}
+
+#if defined(UKV_ENGINE_IS_UMEM)
+/**
+ * Read-only transactions don't track their reads, so the keys changed
+ * since are not a conflict, but their own writes are rejected.
+ */
+TEST(db, transaction_read_only) {
+
+    clear_environment();
+    database_t db;
+    EXPECT_TRUE(db.open(path()));
+    blobs_collection_t collection = db.main();
+    EXPECT_TRUE(collection[6].assign("b"));
+    EXPECT_TRUE(collection[7].assign("c"));
+
+    status_t status;
+    ukv_transaction_t raw = nullptr;
+    ukv_transaction_init_t txn_init {};
+    txn_init.db = db;
+    txn_init.error = status.member_ptr();
+    txn_init.options = ukv_option_transaction_read_only_k;
+    txn_init.transaction = &raw;
+    ukv_transaction_init(&txn_init);
+    EXPECT_TRUE(status);
+
+    transaction_t txn {db, raw};
+    EXPECT_EQ(*txn.main().at(6).value(), "b");
+    EXPECT_EQ(txn.main().keys().size(), 2ul);
+    EXPECT_TRUE(collection[6].assign("d"));
+    EXPECT_FALSE(txn.main().at(8).assign("e"));
+    EXPECT_TRUE(txn.commit());
+}
+#endif
+
 /**
  *
  */